@@ -0,0 +1,178 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <mutex>
+#include <atomic>
+
+#include <easy3d/viewer/offscreen.h>
+#include <easy3d/core/model.h>
+#include <easy3d/renderer/opengl.h>
+#include <easy3d/renderer/async_readback.h>
+#include <easy3d/fileio/image_io.h>
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+#include <easy3d/util/stop_watch.h>
+
+
+using namespace easy3d;
+
+
+// BatchRenderer renders a large number of models into images (e.g., thumbnails for a model archive), without
+// a window. A single OpenGL context is created and reused for all the models, and so are the shader programs.
+// The images are read back asynchronously and saved on a worker thread, while the next models are being loaded
+// and rendered.
+
+
+void print_usage(const char *app) {
+    std::cout << "Usage: " << app << " [options] <file|directory|@list_file> ...\n"
+              << "Options:\n"
+              << "  -o <directory>    output directory (default: the directory of each model)\n"
+              << "  -f <format>       image format: png, jpg, bmp, ppm, or tga (default: png)\n"
+              << "  -w <width>        image width (default: 512)\n"
+              << "  -h <height>       image height (default: 512)\n"
+              << "  -s <samples>      samples for multisample antialiasing (default: 4)\n"
+              << "A directory is rendered recursively, and a list file contains one model file name per line."
+              << std::endl;
+}
+
+
+// collects the model files from the command line arguments
+void collect_files(const std::string &arg, std::vector<std::string> &files) {
+    if (!arg.empty() && arg[0] == '@') {
+        std::ifstream input(arg.substr(1).c_str());
+        if (input.fail()) {
+            LOG(ERROR) << "could not open list file: " << arg.substr(1);
+            return;
+        }
+        std::string line;
+        while (std::getline(input, line)) {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!line.empty())
+                files.push_back(line);
+        }
+    }
+    else if (file_system::is_directory(arg)) {
+        file_system::get_files(arg, files, true);
+    }
+    else
+        files.push_back(arg);
+}
+
+
+int main(int argc, char **argv) {
+    // Initialize logging.
+    logging::initialize();
+
+    std::string output_dir;
+    std::string format = "png";
+    int width = 512, height = 512, samples = 4;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        const bool has_value = (i + 1 < argc);
+        if (arg == "-o" && has_value) output_dir = argv[++i];
+        else if (arg == "-f" && has_value) format = argv[++i];
+        else if (arg == "-w" && has_value) width = std::atoi(argv[++i]);
+        else if (arg == "-h" && has_value) height = std::atoi(argv[++i]);
+        else if (arg == "-s" && has_value) samples = std::atoi(argv[++i]);
+        else if (arg.size() > 1 && arg[0] == '-') {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+            collect_files(arg, files);
+    }
+
+    if (files.empty() || width <= 0 || height <= 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!output_dir.empty() && !file_system::is_directory(output_dir) && !file_system::create_directory(output_dir)) {
+        LOG(ERROR) << "could not create the output directory: " << output_dir;
+        return EXIT_FAILURE;
+    }
+
+    OffScreen os(width, height, samples);
+    if (!os.is_valid()) {
+        LOG(ERROR) << "failed to create an OpenGL context for offscreen rendering";
+        return EXIT_FAILURE;
+    }
+
+    // the image file of each frame of the readback
+    std::vector<std::string> image_files;
+    std::mutex image_files_mutex;
+    std::atomic<std::size_t> num_saved(0);
+
+    const bool is_ppm = (format == "ppm");
+    AsyncReadback readback([&](std::size_t frame, std::vector<unsigned char> &pixels, int iw, int ih) {
+        std::string image_file;
+        {
+            std::lock_guard<std::mutex> lock(image_files_mutex);
+            image_file = image_files[frame];
+        }
+        const bool saved = is_ppm ? io::save_ppm(image_file, pixels, iw, ih) : ImageIO::save(image_file, pixels, iw, ih, 4);
+        if (saved) {
+            LOG(INFO) << "saved: " << image_file;
+            ++num_saved;
+        }
+        else
+            LOG(WARNING) << "failed to save: " << image_file;
+    });
+
+    StopWatch w;
+    for (const auto &file : files) {
+        if (!os.add_model(file)) {
+            LOG(WARNING) << "skipped (failed to load): " << file;
+            continue;
+        }
+
+        const std::string dir = output_dir.empty() ? file_system::parent_directory(file) : output_dir;
+        {
+            std::lock_guard<std::mutex> lock(image_files_mutex);
+            image_files.push_back(dir + "/" + file_system::base_name(file) + "." + format);
+        }
+        if (!os.render(readback, is_ppm ? GL_RGB : GL_RGBA)) {
+            LOG(WARNING) << "failed to render: " << file;
+            std::lock_guard<std::mutex> lock(image_files_mutex);
+            image_files.pop_back();
+        }
+
+        os.clear_models();
+    }
+    readback.finish();
+
+    const std::size_t num_rendered = num_saved;
+    LOG(INFO) << num_rendered << " of " << files.size() << " models rendered. Time: " << w.time_string();
+    return num_rendered == files.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
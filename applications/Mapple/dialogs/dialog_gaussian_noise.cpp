@@ -35,6 +35,7 @@
 #include <QIntValidator>
 #include "paint_canvas.h"
 #include "main_window.h"
+#include "undo_stack.h"
 
 
 using namespace easy3d;
@@ -69,10 +70,12 @@ void DialogGaussianNoise::apply() {
 
     const float sigma = lineEditGaussianNoiseSigma->text().toFloat();
     if (dynamic_cast<SurfaceMesh *>(model)) {
+        window_->undoStack()->push(model, "add Gaussian noise");
         GaussianNoise::apply(dynamic_cast<SurfaceMesh *>(model), sigma);
         model->renderer()->update();
         viewer_->update();
     } else if (dynamic_cast<PointCloud *>(model)) {
+        window_->undoStack()->push(model, "add Gaussian noise");
         GaussianNoise::apply(dynamic_cast<PointCloud *>(model), sigma);
         model->renderer()->update();
         viewer_->update();
@@ -28,6 +28,7 @@
 #include "dialog_poisson_reconstruction.h"
 #include "main_window.h"
 #include "paint_canvas.h"
+#include "job_runner.h"
 
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/surface_mesh.h>
@@ -88,18 +89,26 @@ void DialogPoissonReconstruction::reconstruct() {
         int octree_depth = spinBoxOctreeDepth->value();
         float sampers_per_node = spinBoxSamplesPerNode->value();
 
-        PoissonReconstruction recon;
-        recon.set_depth(octree_depth);
-        recon.set_sampers_per_node(sampers_per_node);
-
-        SurfaceMesh *mesh = recon.apply(cloud, density_attr_name_);
-        if (mesh) {
-            const std::string &name = file_system::name_less_extension(cloud->name()) + "_poisson_reconstruction.ply";
-            mesh->set_name(name);
-            viewer_->addModel(mesh);
-            window_->updateUi();
-            viewer_->update();
-        }
+        // the reconstruction runs in the background on a snapshot of the point cloud
+        auto copy = std::make_shared<PointCloud>(*cloud);
+        auto result = std::make_shared<std::unique_ptr<SurfaceMesh> >();
+        const std::string &name = file_system::name_less_extension(cloud->name()) + "_poisson_reconstruction.ply";
+        const std::string density_attr_name = density_attr_name_;
+        window_->jobs()->run("Poisson surface reconstruction", cloud,
+                             [=](const CancellationToken &token) -> bool {
+                                 PoissonReconstruction recon;
+                                 recon.set_depth(octree_depth);
+                                 recon.set_sampers_per_node(sampers_per_node);
+
+                                 result->reset(recon.apply(copy.get(), density_attr_name, token));
+                                 if (!*result || token.is_canceled())
+                                     return false;
+                                 (*result)->set_name(name);
+                                 return true;
+                             },
+                             [this, result]() {
+                                 viewer_->addModel(result->release());
+                             });
     }
 }
 
@@ -213,6 +213,25 @@ void DialogProperties::modelChanged(const QString &text) {
 }
 
 
+namespace details {
+
+    // the computed properties are not listed by the xxx_properties() methods of the models
+    inline void add_computed_property_names(const PropertyContainer &props, QComboBox *comboBox) {
+        for (const auto &name : props.computed_properties())
+            comboBox->addItem(QString::fromStdString(name));
+    }
+
+    // returns the type of a property (either stored or computed)
+    inline const std::type_info &property_type(const PropertyContainer &props, const std::string &name) {
+        const std::type_info &type = props.get_type(name);
+        if (type != typeid(void))
+            return type;
+        return props.get_computed_type(name);
+    }
+
+}
+
+
 void DialogProperties::locationChanged(const QString &text) {
     comboBoxPropertyName->clear();
 
@@ -228,6 +247,7 @@ void DialogProperties::locationChanged(const QString &text) {
             for (const auto &name : cloud->vertex_properties())
                 if (std::find(key_words.begin(), key_words.end(), name) == key_words.end())
                     comboBoxPropertyName->addItem(QString::fromStdString(name));
+            details::add_computed_property_names(cloud->vertex_property_container(), comboBoxPropertyName);
         }
     } else if (dynamic_cast<Graph *>(model)) {
         auto graph = dynamic_cast<Graph *>(model);
@@ -236,11 +256,13 @@ void DialogProperties::locationChanged(const QString &text) {
             for (const auto &name : graph->vertex_properties())
                 if (std::find(key_words.begin(), key_words.end(), name) == key_words.end())
                     comboBoxPropertyName->addItem(QString::fromStdString(name));
+            details::add_computed_property_names(graph->vertex_property_container(), comboBoxPropertyName);
         } else if (location == "Edge") {
             lineEditNewPropertyName->setText("e:");
             for (const auto &name : graph->edge_properties())
                 if (std::find(key_words.begin(), key_words.end(), name) == key_words.end())
                     comboBoxPropertyName->addItem(QString::fromStdString(name));
+            details::add_computed_property_names(graph->edge_property_container(), comboBoxPropertyName);
         }
     } else if (dynamic_cast<SurfaceMesh *>(model)) {
         auto mesh = dynamic_cast<SurfaceMesh *>(model);
@@ -249,16 +271,19 @@ void DialogProperties::locationChanged(const QString &text) {
             for (const auto &name : mesh->vertex_properties())
                 if (std::find(key_words.begin(), key_words.end(), name) == key_words.end())
                     comboBoxPropertyName->addItem(QString::fromStdString(name));
+            details::add_computed_property_names(mesh->vertex_property_container(), comboBoxPropertyName);
         } else if (location == "Edge") {
             lineEditNewPropertyName->setText("e:");
             for (const auto &name : mesh->edge_properties())
                 if (std::find(key_words.begin(), key_words.end(), name) == key_words.end())
                     comboBoxPropertyName->addItem(QString::fromStdString(name));
+            details::add_computed_property_names(mesh->edge_property_container(), comboBoxPropertyName);
         } else if (location == "Face") {
             lineEditNewPropertyName->setText("f:");
             for (const auto &name : mesh->face_properties())
                 if (std::find(key_words.begin(), key_words.end(), name) == key_words.end())
                     comboBoxPropertyName->addItem(QString::fromStdString(name));
+            details::add_computed_property_names(mesh->face_property_container(), comboBoxPropertyName);
         } else if (location == "Halfedge") {
             lineEditNewPropertyName->setText("h:");
             for (const auto &name : mesh->halfedge_properties())
@@ -1091,31 +1116,31 @@ void DialogProperties::propertyChanged(const QString &name) {
     if (dynamic_cast<PointCloud *>(model)) {
         auto cloud = dynamic_cast<PointCloud *>(model);
         if (location == "Vertex") {
-            const auto &info = cloud->get_vertex_property_type(name.toStdString());
+            const auto &info = details::property_type(cloud->vertex_property_container(), name.toStdString());
             type = details::type_info_to_string(info);
         }
     } else if (dynamic_cast<Graph *>(model)) {
         auto graph = dynamic_cast<Graph *>(model);
         if (location == "Vertex") {
-            const auto &info = graph->get_vertex_property_type(name.toStdString());
+            const auto &info = details::property_type(graph->vertex_property_container(), name.toStdString());
             type = details::type_info_to_string(info);
         } else if (location == "Edge") {
-            const auto &info = graph->get_edge_property_type(name.toStdString());
+            const auto &info = details::property_type(graph->edge_property_container(), name.toStdString());
             type = details::type_info_to_string(info);
         }
     } else if (dynamic_cast<SurfaceMesh *>(model)) {
         auto mesh = dynamic_cast<SurfaceMesh *>(model);
         if (location == "Vertex") {
-            const auto &info = mesh->get_vertex_property_type(name.toStdString());
+            const auto &info = details::property_type(mesh->vertex_property_container(), name.toStdString());
             type = details::type_info_to_string(info);
         } else if (location == "Edge") {
-            const auto &info = mesh->get_edge_property_type(name.toStdString());
+            const auto &info = details::property_type(mesh->edge_property_container(), name.toStdString());
             type = details::type_info_to_string(info);
         } else if (location == "Face") {
-            const auto &info = mesh->get_face_property_type(name.toStdString());
+            const auto &info = details::property_type(mesh->face_property_container(), name.toStdString());
             type = details::type_info_to_string(info);
         } else if (location == "Halfedge") {
-            const auto &info = mesh->get_halfedge_property_type(name.toStdString());
+            const auto &info = details::property_type(mesh->halfedge_property_container(), name.toStdString());
             type = details::type_info_to_string(info);
         }
     }
@@ -33,6 +33,7 @@
 
 #include "main_window.h"
 #include "paint_canvas.h"
+#include "undo_stack.h"
 
 
 using namespace easy3d;
@@ -59,6 +60,7 @@ void DialogSurfaceMeshFairing::apply() {
     if (!mesh)
         return;
 
+    window_->undoStack()->push(mesh, "fairing");
     SurfaceMeshFairing fair(mesh);
     if (comboBoxCriterion->currentText() == "Minimize Area") {
         LOG(INFO) << "fairing by minimizing area ...";
@@ -34,6 +34,8 @@
 
 #include "main_window.h"
 #include "paint_canvas.h"
+#include "job_runner.h"
+#include "undo_stack.h"
 
 
 using namespace easy3d;
@@ -73,31 +75,48 @@ void DialogSurfaceMeshRemeshing::apply() {
     if (!mesh)
         return;
 
-    if (checkBoxUseFeatures->isChecked()) {
-        const int feature_angle = spinBoxDihedralAngle->value();
-        SurfaceMeshFeatures sf(mesh);
-        sf.clear();
-        sf.detect_angle(feature_angle);
-        sf.detect_boundary();
-    }
-
-    if (comboBoxScheme->currentText() == "Uniform Remeshing") {
-        float len(0.0f);
-        for (auto eit : mesh->edges())
-            len += distance(mesh->position(mesh->vertex(eit, 0)),
-                            mesh->position(mesh->vertex(eit, 1)));
-        len /= (float) mesh->n_edges();
-        SurfaceMeshRemeshing(mesh).uniform_remeshing(len * doubleSpinBoxEdgeLength->value());
-    } else { // Adaptive remeshing
-        auto bb = mesh->bounding_box().diagonal_length();
-        SurfaceMeshRemeshing(mesh).adaptive_remeshing(
-                0.001 * bb,  // min length
-                0.100 * bb,  // max length
-                0.001 * bb); // approx. error
-    }
-
-    mesh->renderer()->update();
-    viewer_->update();
-    window_->updateUi();
+    const bool use_features = checkBoxUseFeatures->isChecked();
+    const int feature_angle = spinBoxDihedralAngle->value();
+    const bool uniform = (comboBoxScheme->currentText() == "Uniform Remeshing");
+    const double edge_length = doubleSpinBoxEdgeLength->value();
+
+    // the remeshing runs in the background on a copy of the mesh, which is copied back when done
+    auto copy = std::make_shared<SurfaceMesh>(*mesh);
+    window_->jobs()->run("remeshing surface mesh", mesh,
+                         [=](const CancellationToken &token) -> bool {
+                             SurfaceMesh *m = copy.get();
+                             if (use_features) {
+                                 SurfaceMeshFeatures sf(m);
+                                 sf.clear();
+                                 sf.detect_angle(feature_angle);
+                                 sf.detect_boundary();
+                             }
+                             if (token.is_canceled())
+                                 return false;
+
+                             if (uniform) {
+                                 float len(0.0f);
+                                 for (auto eit : m->edges())
+                                     len += distance(m->position(m->vertex(eit, 0)),
+                                                     m->position(m->vertex(eit, 1)));
+                                 len /= (float) m->n_edges();
+                                 SurfaceMeshRemeshing(m).uniform_remeshing(len * edge_length, 10, true, token);
+                             } else { // Adaptive remeshing
+                                 auto bb = m->bounding_box().diagonal_length();
+                                 SurfaceMeshRemeshing(m).adaptive_remeshing(
+                                         0.001 * bb,  // min length
+                                         0.100 * bb,  // max length
+                                         0.001 * bb,  // approx. error
+                                         10, true, token);
+                             }
+                             return !token.is_canceled();
+                         },
+                         [this, mesh, copy]() {
+                             if (!viewer_->hasModel(mesh))
+                                 return;
+                             window_->undoStack()->push(mesh, "remeshing");
+                             *mesh = *copy;
+                             mesh->renderer()->update();
+                         });
 }
 
@@ -34,6 +34,7 @@
 
 #include "main_window.h"
 #include "paint_canvas.h"
+#include "job_runner.h"
 
 
 using namespace easy3d;
@@ -61,12 +62,18 @@ void DialogSurfaceMeshSampling::apply() {
         return;
     }
 
-    SurfaceMeshSampler sampler;
-    PointCloud *cloud = sampler.apply(mesh, num);
-    if (cloud) {
-        viewer_->addModel(cloud);
-        window_->updateUi();
-        viewer_->update();
-    }
+    // the sampling runs in the background on a snapshot of the mesh
+    auto copy = std::make_shared<SurfaceMesh>(*mesh);
+    copy->set_name(mesh->name());
+    auto result = std::make_shared<std::unique_ptr<PointCloud> >();
+    window_->jobs()->run("sampling surface mesh", mesh,
+                         [copy, result, num](const CancellationToken &token) -> bool {
+                             SurfaceMeshSampler sampler;
+                             result->reset(sampler.apply(copy.get(), num, token));
+                             return *result && !token.is_canceled();
+                         },
+                         [this, result]() {
+                             viewer_->addModel(result->release());
+                         });
 }
 
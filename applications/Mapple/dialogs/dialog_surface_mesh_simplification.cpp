@@ -35,6 +35,8 @@
 
 #include "main_window.h"
 #include "paint_canvas.h"
+#include "job_runner.h"
+#include "undo_stack.h"
 
 
 using namespace easy3d;
@@ -70,12 +72,23 @@ void DialogSurfaceMeshSimplification::apply() {
     const int aspect_ratio = 10;
 
     const int expected_vertex_number = lineEditVertexNumber->text().toInt();
-    SurfaceMeshSimplification ss(mesh);
-    ss.initialize(aspect_ratio, 0.0, 0.0, normal_deviation, 0.0);
-    ss.simplify(expected_vertex_number);
-
-    mesh->renderer()->update();
-    viewer_->update();
-    window_->updateUi();
+    // the simplification runs in the background on a copy of the mesh, which is copied back when done
+    auto copy = std::make_shared<SurfaceMesh>(*mesh);
+    window_->jobs()->run("simplifying surface mesh", mesh,
+                         [=](const CancellationToken &token) -> bool {
+                             SurfaceMeshSimplification ss(copy.get());
+                             ss.initialize(aspect_ratio, 0.0, 0.0, normal_deviation, 0.0);
+                             if (token.is_canceled())
+                                 return false;
+                             ss.simplify(expected_vertex_number, token);
+                             return !token.is_canceled();
+                         },
+                         [this, mesh, copy]() {
+                             if (!viewer_->hasModel(mesh))
+                                 return;
+                             window_->undoStack()->push(mesh, "simplification");
+                             *mesh = *copy;
+                             mesh->renderer()->update();
+                         });
 }
 
@@ -34,6 +34,7 @@
 
 #include "main_window.h"
 #include "paint_canvas.h"
+#include "undo_stack.h"
 
 
 using namespace easy3d;
@@ -76,6 +77,7 @@ void DialogSurfaceMeshSmoothing::apply() {
 
     const bool uniform_laplace = checkBoxUniformLaplace->isChecked();
 
+    window_->undoStack()->push(mesh, "smoothing");
     SurfaceMeshSmoothing smoother(mesh);
 
     if (comboBoxScheme->currentText() == "Explicit Smoothing") {
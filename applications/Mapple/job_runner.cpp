@@ -0,0 +1,124 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include "job_runner.h"
+
+#include <easy3d/util/logging.h>
+#include <easy3d/util/stop_watch.h>
+
+
+using namespace easy3d;
+
+
+JobRunner::JobRunner(QObject *parent)
+        : QObject(parent)
+        , next_id_(0)
+{
+    // the workers emit workDone(), which is delivered in the GUI thread
+    connect(this, SIGNAL(workDone(int, bool)), this, SLOT(finishJob(int, bool)), Qt::QueuedConnection);
+}
+
+
+JobRunner::~JobRunner() {
+    cancel();
+    for (auto &job : jobs_) {
+        if (job.second.thread.joinable())
+            job.second.thread.join();
+    }
+}
+
+
+bool JobRunner::run(const QString &name, Model *model, Work work, Finish finish) {
+    if (model && isBusy(model)) {
+        LOG(WARNING) << "the model is being processed by another job. Please wait or cancel it";
+        return false;
+    }
+
+    const int id = next_id_++;
+    Job &job = jobs_[id];
+    job.name = name;
+    job.model = model;
+    job.finish = finish;
+
+    const CancellationToken token = job.token;
+    const std::string job_name = name.toStdString();
+    job.thread = std::thread([this, id, token, work, job_name]() {
+        StopWatch w;
+        bool success = false;
+        try {
+            success = work(token);
+        }
+        catch (const std::exception &e) {
+            LOG(ERROR) << job_name << " failed: " << e.what();
+        }
+        catch (...) {
+            LOG(ERROR) << job_name << " failed";
+        }
+        if (token.is_canceled())
+            LOG(WARNING) << job_name << " cancelled";
+        else if (success)
+            LOG(INFO) << job_name << " done. " << w.time_string();
+        emit workDone(id, success);
+    });
+
+    LOG(INFO) << job_name << " started in the background...";
+    emit jobStarted(name);
+    return true;
+}
+
+
+bool JobRunner::isBusy(const Model *model) const {
+    for (const auto &job : jobs_) {
+        if (job.second.model == model)
+            return true;
+    }
+    return false;
+}
+
+
+void JobRunner::cancel() {
+    for (auto &job : jobs_)
+        job.second.token.cancel();
+}
+
+
+void JobRunner::finishJob(int id, bool success) {
+    auto pos = jobs_.find(id);
+    if (pos == jobs_.end())
+        return;
+
+    Job &job = pos->second;
+    if (job.thread.joinable())
+        job.thread.join();  // the work has returned, so this doesn't block
+
+    success = success && !job.token.is_canceled();
+    if (success && job.finish)
+        job.finish();
+
+    const QString name = job.name;
+    jobs_.erase(pos);
+    emit jobFinished(name, success);
+}
@@ -0,0 +1,121 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef JOB_RUNNER_H
+#define JOB_RUNNER_H
+
+#include <map>
+#include <thread>
+#include <functional>
+
+#include <QObject>
+#include <QString>
+
+#include <easy3d/util/progress.h>
+
+
+namespace easy3d {
+    class Model;
+}
+
+
+/**
+ * \brief Runs (long) jobs on worker threads so they do not block the GUI thread.
+ * \details A job consists of the work, which runs on a worker thread, and a finish function, which runs in the GUI
+ *      thread when the work has succeeded (and was not canceled), e.g., to add the result to the viewer and to update
+ *      the GPU buffers. The work must not access anything owned by the GUI, so it should operate on a snapshot (i.e.,
+ *      a copy) of the model, which the finish function copies back. A model can only be used by one job at a time.
+ *      The work reports its progress through ProgressLogger (the status bar is updated from the worker threads) and
+ *      it should check the cancellation token it receives.
+ *
+ *      Example usage:
+ *      \code
+ *          auto copy = std::make_shared<SurfaceMesh>(*mesh);
+ *          jobs->run("simplification", mesh,
+ *              [copy](const CancellationToken& token) -> bool {
+ *                  SurfaceMeshSimplification(copy.get()).simplify(1000);
+ *                  return !token.is_canceled();
+ *              },
+ *              [=]() {
+ *                  *mesh = *copy;
+ *                  mesh->renderer()->update();
+ *              });
+ *      \endcode
+ */
+class JobRunner : public QObject {
+    Q_OBJECT
+public:
+    typedef std::function<bool(const easy3d::CancellationToken &)> Work;
+    typedef std::function<void()> Finish;
+
+public:
+    explicit JobRunner(QObject *parent = nullptr);
+    /// Cancels the running jobs and waits for them. Their finish functions are not called.
+    ~JobRunner() override;
+
+    /// Starts a job with the given \p name on a worker thread.
+    /// \param model The model the job works on (can be nullptr). The job is rejected if the model is being used by
+    ///     another job.
+    /// \param work The work running on the worker thread. It returns \c true on success.
+    /// \param finish The function called in the GUI thread when the work has succeeded and was not canceled.
+    /// \return \c true if the job has been started.
+    bool run(const QString &name, easy3d::Model *model, Work work, Finish finish);
+
+    /// Returns whether \p model is being used by a job.
+    bool isBusy(const easy3d::Model *model) const;
+    /// Returns the number of running jobs.
+    std::size_t numJobs() const { return jobs_.size(); }
+
+public slots:
+    /// Cancels all the running jobs.
+    void cancel();
+
+signals:
+    /// Emitted when a job has started.
+    void jobStarted(const QString &name);
+    /// Emitted (in the GUI thread) when a job has finished. \p success is \c false if it failed or was canceled.
+    void jobFinished(const QString &name, bool success);
+
+    // emitted by the worker threads
+    void workDone(int id, bool success);
+
+private slots:
+    void finishJob(int id, bool success);
+
+private:
+    struct Job {
+        QString name;
+        easy3d::Model *model;
+        Finish finish;
+        easy3d::CancellationToken token;
+        std::thread thread;
+    };
+    std::map<int, Job> jobs_;   // only accessed in the GUI thread
+    int next_id_;
+};
+
+
+#endif // JOB_RUNNER_H
@@ -46,6 +46,7 @@
 
 #include <easy3d/fileio/resources.h>
 #include <easy3d/util/logging.h>
+#include <easy3d/util/tracing.h>
 
 
 using namespace easy3d;
@@ -89,6 +90,9 @@ int main(int argc, char *argv[])
 {
     // initialize logging at the very beginning to make sure everything will be logged into the log file.
     logging::initialize(true, true, true, "default", 9);
+    // profile the session if requested (by the environment variable EASY3D_TRACE_FILE)
+    if (tracing::initialize_from_environment())
+        tracing::set_thread_name("main");
 
     //Locale management
     {
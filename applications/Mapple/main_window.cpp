@@ -31,6 +31,7 @@
 #include <iostream>
 
 #include <QMutex>
+#include <QThread>
 #include <QFileDialog>
 #include <QDropEvent>
 #include <QMimeData>
@@ -49,6 +50,7 @@
 #include <easy3d/core/poly_mesh.h>
 #include <easy3d/core/random.h>
 #include <easy3d/core/surface_mesh_builder.h>
+#include <easy3d/core/vec3_kernels.h>
 #include <easy3d/renderer/setting.h>
 #include <easy3d/renderer/camera.h>
 #include <easy3d/renderer/renderer.h>
@@ -86,6 +88,8 @@
 
 #include "paint_canvas.h"
 #include "walk_through.h"
+#include "job_runner.h"
+#include "undo_stack.h"
 
 #include "dialogs/dialog_snapshot.h"
 #include "dialogs/dialog_properties.h"
@@ -126,6 +130,13 @@ MainWindow::MainWindow(QWidget *parent)
     viewer_ = new PaintCanvas(this);
     setCentralWidget(viewer_);
 
+    jobs_ = new JobRunner(this);
+    connect(jobs_, SIGNAL(jobStarted(const QString&)), this, SLOT(onJobStarted(const QString&)));
+    connect(jobs_, SIGNAL(jobFinished(const QString&, bool)), this, SLOT(onJobFinished(const QString&, bool)));
+
+    undo_ = new UndoStack(this);
+    connect(undo_, SIGNAL(changed()), this, SLOT(updateUndoActions()));
+
     // ----- the width of the rendering panel ------
     // sizeHint() doesn't suggest a good value
     // const QSize& size = ui->dockWidgetRendering->sizeHint();
@@ -208,11 +219,22 @@ MainWindow::MainWindow(QWidget *parent)
 
 
 MainWindow::~MainWindow() {
+    // stop the jobs before the window (i.e., the progress client) is destroyed
+    delete jobs_;
     LOG(INFO) << "Mapple terminated. Bye!";
 }
 
 
 void MainWindow::notify(std::size_t percent, bool update_viewer) {
+    // the progress may be reported from a worker thread, in which case the widgets are updated in the GUI thread.
+    if (QThread::currentThread() != thread()) {
+        const bool visible = percent > 0 && percent < 100;
+        QMetaObject::invokeMethod(progress_bar_, "setValue", Qt::QueuedConnection, Q_ARG(int, int(percent)));
+        QMetaObject::invokeMethod(progress_bar_, "setVisible", Qt::QueuedConnection, Q_ARG(bool, visible));
+        QMetaObject::invokeMethod(cancelTaskButton_, "setVisible", Qt::QueuedConnection, Q_ARG(bool, visible));
+        return;
+    }
+
     progress_bar_->setValue(int(percent));
     cancelTaskButton_->setVisible(percent > 0 && percent < 100);
     progress_bar_->setVisible(percent > 0 && percent < 100);
@@ -363,6 +385,7 @@ void MainWindow::updateStatusBar()
 
 void MainWindow::cancelTask() {
     cancel();
+    jobs_->cancel();
     cancelTaskButton_->setVisible(false);
     progress_bar_->reset();
     progress_bar_->setTextVisible(false);
@@ -371,6 +394,21 @@ void MainWindow::cancelTask() {
 }
 
 
+void MainWindow::onJobStarted(const QString&) {
+    cancelTaskButton_->setVisible(true);
+}
+
+
+void MainWindow::onJobFinished(const QString&, bool) {
+    if (jobs_->numJobs() == 0) {
+        cancelTaskButton_->setVisible(false);
+        progress_bar_->setVisible(false);
+    }
+    updateUi();
+    viewer_->update();
+}
+
+
 void MainWindow::dragEnterEvent(QDragEnterEvent *e) {
     if (e->mimeData()->hasUrls())
         e->acceptProposedAction();
@@ -937,6 +975,8 @@ void MainWindow::createActionsForPropertyMenu() {
 
 
 void MainWindow::createActionsForEditMenu() {
+    connect(ui->actionUndo, SIGNAL(triggered()), this, SLOT(undo()));
+    connect(ui->actionRedo, SIGNAL(triggered()), this, SLOT(redo()));
     connect(ui->actionTranslationalRecenter, SIGNAL(triggered()), this, SLOT(translationalRecenter()));
     connect(ui->actionAddGaussianNoise, SIGNAL(triggered()), this, SLOT(addGaussianNoise()));
     connect(ui->actionApplyManipulatedTransformation, SIGNAL(triggered()), this, SLOT(applyManipulatedTransformation()));
@@ -1249,6 +1289,7 @@ void MainWindow::surfaceMeshReverseOrientation() {
     if (!mesh)
         return;
 
+    undo_->push(mesh, "reverse orientation");
     mesh->reverse_orientation();
 
     mesh->renderer()->update();
@@ -1264,6 +1305,7 @@ void MainWindow::surfaceMeshRemoveIsolatedVertices() {
 
     unsigned int prev_num_vertices = mesh->n_vertices();
 
+    undo_->push(mesh, "remove isolated vertices");
     // clean: remove isolated vertices
     for (auto v : mesh->vertices()) {
         if (mesh->is_isolated(v))
@@ -1523,10 +1565,21 @@ void MainWindow::pointCloudEstimateNormals() {
     DialogPointCloudNormalEstimation dlg(this);
     if (dlg.exec() == QDialog::Accepted) {
         unsigned int k = dlg.lineEditNeighborSize->text().toUInt();
-        PointCloudNormals pcn;
-        pcn.estimate(cloud, k);
-        cloud->renderer()->update();
-        viewer()->update();
+        // the normals are estimated (in the background) for a snapshot of the points
+        auto copy = std::make_shared<PointCloud>();
+        for (const auto& p : cloud->points())
+            copy->add_vertex(p);
+        jobs_->run("estimating normals", cloud,
+                   [copy, k](const CancellationToken& token) -> bool {
+                       return PointCloudNormals().estimate(copy.get(), k, false, token);
+                   },
+                   [this, cloud, copy]() {
+                       if (!viewer_->hasModel(cloud) || cloud->n_vertices() != copy->n_vertices())
+                           return;
+                       undo_->push(cloud, "estimate normals");
+                       cloud->vertex_property<vec3>("v:normal").vector() = copy->get_vertex_property<vec3>("v:normal").vector();
+                       cloud->renderer()->update();
+                   });
     }
 }
 
@@ -1536,13 +1589,31 @@ void MainWindow::pointCloudReorientNormals() {
     if (!cloud)
         return;
 
+    auto normals = cloud->get_vertex_property<vec3>("v:normal");
+    if (!normals) {
+        LOG(WARNING) << "normal information does not exist";
+        return;
+    }
+
     DialogPointCloudNormalEstimation dlg(this);
     if (dlg.exec() == QDialog::Accepted) {
         unsigned int k = dlg.lineEditNeighborSize->text().toUInt();
-        PointCloudNormals pcn;
-        pcn.reorient(cloud, k);
-        cloud->renderer()->update();
-        viewer()->update();
+        // the normals are reoriented (in the background) for a snapshot of the points and normals
+        auto copy = std::make_shared<PointCloud>();
+        for (const auto& p : cloud->points())
+            copy->add_vertex(p);
+        copy->add_vertex_property<vec3>("v:normal").vector() = normals.vector();
+        jobs_->run("reorienting normals", cloud,
+                   [copy, k](const CancellationToken& token) -> bool {
+                       return PointCloudNormals().reorient(copy.get(), k) && !token.is_canceled();
+                   },
+                   [this, cloud, copy]() {
+                       if (!viewer_->hasModel(cloud) || cloud->n_vertices() != copy->n_vertices())
+                           return;
+                       undo_->push(cloud, "reorient normals");
+                       cloud->vertex_property<vec3>("v:normal").vector() = copy->get_vertex_property<vec3>("v:normal").vector();
+                       cloud->renderer()->update();
+                   });
     }
 }
 
@@ -1605,6 +1676,22 @@ void MainWindow::polymeshExtractBoundary() {
 }
 
 
+namespace internal {
+    // Adds (or replaces) the scalar fields "<prefix>height_x", "<prefix>height_y", and "<prefix>height_z". They are
+    // computed properties, i.e., the values are computed from the element centers whenever they are accessed (e.g.,
+    // for rendering), so no memory is allocated for them and they follow changes of the geometry.
+    void add_height_fields(PropertyContainer& props, const std::string& prefix,
+                           const std::function<vec3(std::size_t)>& center) {
+        const char* axes[3] = {"x", "y", "z"};
+        for (int i = 0; i < 3; ++i) {
+            const std::string name = prefix + "height_" + axes[i];
+            props.remove(name); // the fields may have been added before
+            props.add_computed<float>(name, [center, i](std::size_t idx) -> float { return center(idx)[i]; });
+        }
+    }
+}
+
+
 void MainWindow::computeHeightField() {
     auto model = viewer_->currentModel();
     if (!model)
@@ -1614,48 +1701,22 @@ void MainWindow::computeHeightField() {
     if (dynamic_cast<SurfaceMesh*>(model)) {
         SurfaceMesh* mesh = dynamic_cast<SurfaceMesh*>(model);
 
-        ProgressLogger progress(4, false, false);
-
-        auto v_height_x = mesh->vertex_property<float>("v:height_x");
-        auto v_height_y = mesh->vertex_property<float>("v:height_y");
-        auto v_height_z = mesh->vertex_property<float>("v:height_z");
-        for (auto v : mesh->vertices()) {
-            const auto& p = mesh->position(v);
-            v_height_x[v] = p.x;
-            v_height_y[v] = p.y;
-            v_height_z[v] = p.z;
-        }
-        progress.next();
-
-        auto e_height_x = mesh->edge_property<float>("e:height_x");
-        auto e_height_y = mesh->edge_property<float>("e:height_y");
-        auto e_height_z = mesh->edge_property<float>("e:height_z");
-        for (auto e : mesh->edges()) {
-            const auto& s = mesh->vertex(e, 0);
-            const auto& t = mesh->vertex(e, 1);
-            const auto& c = 0.5 * (mesh->position(s) + mesh->position(t));
-            e_height_x[e] = c.x;
-            e_height_y[e] = c.y;
-            e_height_z[e] = c.z;
-        }
-        progress.next();
-
-        auto f_height_x = mesh->face_property<float>("f:height_x");
-        auto f_height_y = mesh->face_property<float>("f:height_y");
-        auto f_height_z = mesh->face_property<float>("f:height_z");
-        for (auto f : mesh->faces()) {
+        internal::add_height_fields(mesh->vertex_property_container(), "v:", [mesh](std::size_t i) -> vec3 {
+            return mesh->position(SurfaceMesh::Vertex(static_cast<int>(i)));
+        });
+        internal::add_height_fields(mesh->edge_property_container(), "e:", [mesh](std::size_t i) -> vec3 {
+            const SurfaceMesh::Edge e(static_cast<int>(i));
+            return 0.5f * (mesh->position(mesh->vertex(e, 0)) + mesh->position(mesh->vertex(e, 1)));
+        });
+        internal::add_height_fields(mesh->face_property_container(), "f:", [mesh](std::size_t i) -> vec3 {
             vec3 c(0,0,0);
             float count = 0.0f;
-            for (auto v : mesh->vertices(f)) {
+            for (auto v : mesh->vertices(SurfaceMesh::Face(static_cast<int>(i)))) {
                 c += mesh->position(v);
                 ++count;
             }
-            c /= count;
-            f_height_x[f] = c.x;
-            f_height_y[f] = c.y;
-            f_height_z[f] = c.z;
-        }
-        progress.next();
+            return c / count;
+        });
 
         // add a vector field to the faces
         mesh->update_face_normals();
@@ -1678,49 +1739,27 @@ void MainWindow::computeHeightField() {
             }
             enormals[e] = n.normalize();
         }
-        progress.next();
     }
 
     else if (dynamic_cast<PointCloud*>(model)) {
         PointCloud* cloud = dynamic_cast<PointCloud*>(model);
-
-        auto v_height_x = cloud->vertex_property<float>("v:height_x");
-        auto v_height_y = cloud->vertex_property<float>("v:height_y");
-        auto v_height_z = cloud->vertex_property<float>("v:height_z");
-        for (auto v : cloud->vertices()) {
-            const auto& p = cloud->position(v);
-            v_height_x[v] = p.x;
-            v_height_y[v] = p.y;
-            v_height_z[v] = p.z;
-        }
+        internal::add_height_fields(cloud->vertex_property_container(), "v:", [cloud](std::size_t i) -> vec3 {
+            return cloud->position(PointCloud::Vertex(static_cast<int>(i)));
+        });
     }
 
     else if (dynamic_cast<Graph*>(model)) {
         Graph* graph = dynamic_cast<Graph*>(model);
-
-        auto v_height_x = graph->vertex_property<float>("v:height_x");
-        auto v_height_y = graph->vertex_property<float>("v:height_y");
-        auto v_height_z = graph->vertex_property<float>("v:height_z");
-        for (auto v : graph->vertices()) {
-            const auto& p = graph->position(v);
-            v_height_x[v] = p.x;
-            v_height_y[v] = p.y;
-            v_height_z[v] = p.z;
-        }
-
-        auto e_height_x = graph->edge_property<float>("e:height_x");
-        auto e_height_y = graph->edge_property<float>("e:height_y");
-        auto e_height_z = graph->edge_property<float>("e:height_z");
-        for (auto e : graph->edges()) {
-            const auto& s = graph->vertex(e, 0);
-            const auto& t = graph->vertex(e, 1);
-            const auto& c = 0.5 * (graph->position(s) + graph->position(t));
-            e_height_x[e] = c.x;
-            e_height_y[e] = c.y;
-            e_height_z[e] = c.z;
-        }
+        internal::add_height_fields(graph->vertex_property_container(), "v:", [graph](std::size_t i) -> vec3 {
+            return graph->position(Graph::Vertex(static_cast<int>(i)));
+        });
+        internal::add_height_fields(graph->edge_property_container(), "e:", [graph](std::size_t i) -> vec3 {
+            const Graph::Edge e(static_cast<int>(i));
+            return 0.5f * (graph->position(graph->vertex(e, 0)) + graph->position(graph->vertex(e, 1)));
+        });
     }
     // add 3 scalar fields defined on vertices, edges, and faces respectively.
+    // Note: the scalar fields are stored, because the renderer of polyhedral meshes does not support computed properties.
     else if (dynamic_cast<PolyMesh*>(model)) {
         PolyMesh* mesh = dynamic_cast<PolyMesh*>(model);
 
@@ -1947,8 +1986,7 @@ namespace details {
     template<typename MODEL>
     void translate(MODEL* model, const vec3& p) {
         auto points = model->template get_vertex_property<vec3>("v:point");
-        for (auto v : model->vertices())
-            points[v] -= p;
+        kernels::translate(points.vector(), -p);
     }
 }
 
@@ -1957,6 +1995,7 @@ void MainWindow::translationalRecenter() {
 
     const vec3 origin = first_model->bounding_box().center();
     for (auto model : viewer_->models()) {
+        undo_->push(model, "translational recenter");
         if (dynamic_cast<SurfaceMesh*>(model))
             details::translate(dynamic_cast<SurfaceMesh*>(model), origin);
         else if (dynamic_cast<PointCloud*>(model))
@@ -1975,6 +2014,44 @@ void MainWindow::translationalRecenter() {
 }
 
 
+void MainWindow::undo() {
+    Model* model = undo_->undoModel();
+    if (!model)
+        return;
+    if (jobs_->isBusy(model)) {
+        LOG(WARNING) << "the model is being processed by a job. Please wait or cancel it";
+        return;
+    }
+
+    undo_->undo();
+    viewer_->update();
+    updateUi();
+}
+
+
+void MainWindow::redo() {
+    Model* model = undo_->redoModel();
+    if (!model)
+        return;
+    if (jobs_->isBusy(model)) {
+        LOG(WARNING) << "the model is being processed by a job. Please wait or cancel it";
+        return;
+    }
+
+    undo_->redo();
+    viewer_->update();
+    updateUi();
+}
+
+
+void MainWindow::updateUndoActions() {
+    ui->actionUndo->setEnabled(undo_->canUndo());
+    ui->actionUndo->setText(undo_->canUndo() ? QString("Undo %1").arg(undo_->undoText()) : QString("Undo"));
+    ui->actionRedo->setEnabled(undo_->canRedo());
+    ui->actionRedo->setText(undo_->canRedo() ? QString("Redo %1").arg(undo_->redoText()) : QString("Redo"));
+}
+
+
 void MainWindow::addGaussianNoise() {
     static DialogGaussianNoise* dialog = nullptr;
     if (!dialog)
@@ -1988,27 +2065,8 @@ void MainWindow::applyManipulatedTransformation() {
     if (!model)
         return;
 
-    mat4 manip = model->manipulator()->matrix();
-    auto& points = model->points();
-    for (auto& p : points)
-        p = manip * p;
-
-    if (dynamic_cast<SurfaceMesh*>(model)) {
-        dynamic_cast<SurfaceMesh *>(model)->update_vertex_normals();
-    }
-    else if (dynamic_cast<PointCloud*>(model)) {
-        PointCloud* cloud = dynamic_cast<PointCloud*>(model);
-        auto normal = cloud->get_vertex_property<vec3>("v:normal");
-        if (normal) {
-            const mat3& N = transform::normal_matrix(manip);
-            for (auto v : cloud->vertices())
-                normal[v] = N * normal[v];
-            // vector fields...
-        }
-    }
-
-    model->manipulator()->reset();
-    model->renderer()->update();
+    undo_->push(model, "apply transformation");
+    model->manipulator()->apply();
     viewer_->update();
 }
 
@@ -2217,38 +2275,45 @@ void MainWindow::pointCloudDelaunayTriangulation2D() {
     if (!cloud)
         return;
 
-    const std::vector<vec3>& pts = cloud->points();
-
-    std::vector<vec2> points;
-    for (std::size_t i = 0; i < pts.size(); ++i) {
-        points.push_back(vec2(pts[i]));
-    }
-
-    Delaunay2 delaunay;
-    delaunay.set_vertices(points);
-
-    SurfaceMesh* mesh = new SurfaceMesh;
-    const std::string &name = file_system::name_less_extension(mesh->name()) + "_delaunay_XY.ply";
-    mesh->set_name(name);
-
-    for (std::size_t i = 0; i < points.size(); i++) {
-        mesh->add_vertex(vec3(points[i], pts[i].z));
-    }
-
-    for (unsigned int i = 0; i < delaunay.nb_triangles(); i++) {
-        std::vector<SurfaceMesh::Vertex> vts(3);
-        for (int j = 0; j < 3; j++) {
-            const int v = delaunay.tri_vertex(i, j);
-            assert(v >= 0);
-            assert(v < points.size());
-            vts[j] = SurfaceMesh::Vertex(v);
-        }
-        mesh->add_face(vts);
-    }
-
-    viewer_->addModel(mesh);
-    updateUi();
-    viewer_->update();
+    // the triangulation runs in the background on a snapshot of the points
+    auto pts = std::make_shared<std::vector<vec3> >(cloud->points());
+    auto result = std::make_shared<std::unique_ptr<SurfaceMesh> >();
+    const std::string &name = file_system::name_less_extension(cloud->name()) + "_delaunay_XY.ply";
+    jobs_->run("Delaunay triangulation 2D", cloud,
+               [pts, result, name](const CancellationToken& token) -> bool {
+                   std::vector<vec2> points;
+                   for (std::size_t i = 0; i < pts->size(); ++i) {
+                       points.push_back(vec2(pts->at(i)));
+                   }
+
+                   Delaunay2 delaunay;
+                   delaunay.set_vertices(points);
+                   if (token.is_canceled())
+                       return false;
+
+                   SurfaceMesh* mesh = new SurfaceMesh;
+                   result->reset(mesh);
+                   mesh->set_name(name);
+
+                   for (std::size_t i = 0; i < points.size(); i++) {
+                       mesh->add_vertex(vec3(points[i], pts->at(i).z));
+                   }
+
+                   for (unsigned int i = 0; i < delaunay.nb_triangles(); i++) {
+                       std::vector<SurfaceMesh::Vertex> vts(3);
+                       for (int j = 0; j < 3; j++) {
+                           const int v = delaunay.tri_vertex(i, j);
+                           assert(v >= 0);
+                           assert(v < points.size());
+                           vts[j] = SurfaceMesh::Vertex(v);
+                       }
+                       mesh->add_face(vts);
+                   }
+                   return true;
+               },
+               [this, result]() {
+                   viewer_->addModel(result->release());
+               });
 }
 
 
@@ -2257,33 +2322,43 @@ void MainWindow::pointCloudDelaunayTriangulation3D() {
     if (!cloud)
         return;
 
-    const std::vector<vec3>& points = cloud->points();
-    Delaunay3 delaunay;
-    delaunay.set_vertices(points);
-
-    PolyMesh* mesh = new PolyMesh;
+    // the triangulation runs in the background on a snapshot of the points
+    auto points = std::make_shared<std::vector<vec3> >(cloud->points());
+    auto result = std::make_shared<std::unique_ptr<PolyMesh> >();
     const std::string &name = file_system::name_less_extension(cloud->name()) + "_delaunay.ply";
-    mesh->set_name(name);
-
-    for (std::size_t i = 0; i < points.size(); i++) {
-        mesh->add_vertex(points[i]);
-    }
-
-    LOG(INFO) << "building tetrahedral mesh with " << delaunay.nb_tets() << " tetrahedra...";
-    StopWatch w;
-    for (unsigned int i = 0; i < delaunay.nb_tets(); i++) {
-        PolyMesh::Vertex vts[4];
-        for (int j = 0; j < 4; j++) {
-            int v = delaunay.tet_vertex(i, j);
-            assert(v >= 0);
-            assert(v < points.size());
-            vts[j] = PolyMesh::Vertex(v);
-        }
-        mesh->add_tetra(vts[0], vts[1], vts[2], vts[3]);
-    }
-    LOG(INFO) << "done. " << w.time_string();
-
-    viewer_->addModel(mesh);
-    updateUi();
-    viewer_->update();
+    jobs_->run("Delaunay triangulation 3D", cloud,
+               [points, result, name](const CancellationToken& token) -> bool {
+                   Delaunay3 delaunay;
+                   delaunay.set_vertices(*points);
+                   if (token.is_canceled())
+                       return false;
+
+                   PolyMesh* mesh = new PolyMesh;
+                   result->reset(mesh);
+                   mesh->set_name(name);
+
+                   for (std::size_t i = 0; i < points->size(); i++) {
+                       mesh->add_vertex(points->at(i));
+                   }
+
+                   LOG(INFO) << "building tetrahedral mesh with " << delaunay.nb_tets() << " tetrahedra...";
+                   StopWatch w;
+                   for (unsigned int i = 0; i < delaunay.nb_tets(); i++) {
+                       if (token.is_canceled())
+                           return false;
+                       PolyMesh::Vertex vts[4];
+                       for (int j = 0; j < 4; j++) {
+                           int v = delaunay.tet_vertex(i, j);
+                           assert(v >= 0);
+                           assert(v < points->size());
+                           vts[j] = PolyMesh::Vertex(v);
+                       }
+                       mesh->add_tetra(vts[0], vts[1], vts[2], vts[3]);
+                   }
+                   LOG(INFO) << "done. " << w.time_string();
+                   return true;
+               },
+               [this, result]() {
+                   viewer_->addModel(result->release());
+               });
 }
\ No newline at end of file
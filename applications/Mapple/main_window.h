@@ -47,6 +47,8 @@ class WidgetPointsDrawable;
 class WidgetLinesDrawable;
 class WidgetTrianglesDrawable;
 class WidgetModelList;
+class JobRunner;
+class UndoStack;
 
 namespace Ui {
     class MainWindow;
@@ -70,6 +72,12 @@ public:
 
     PaintCanvas* viewer() { return viewer_; }
 
+    // runs long algorithms on worker threads
+    JobRunner* jobs() { return jobs_; }
+
+    // records the models before they are modified, for undo/redo
+    UndoStack* undoStack() { return undo_; }
+
     void setCurrentFile(const QString &fileName);
 
     void updateUi(); // entire ui: window tile, rendering panel, model panel
@@ -117,6 +125,9 @@ public slots:
     void reportTopologyStatistics();
 
     // edit
+    void undo();
+    void redo();
+    void updateUndoActions();
     void translationalRecenter();
     void addGaussianNoise();
     void applyManipulatedTransformation();
@@ -174,6 +185,8 @@ public slots:
     // status bar
     void updateStatusBar();
     void cancelTask();
+    void onJobStarted(const QString& name);
+    void onJobFinished(const QString& name, bool success);
 
     // about
     void onAbout();
@@ -214,6 +227,8 @@ private:
 
 private:
     PaintCanvas*   viewer_;
+    JobRunner*     jobs_;
+    UndoStack*     undo_;
 
     QStringList recentFiles_;
     QString		curDataDirectory_;
@@ -28,9 +28,11 @@
 #include "paint_canvas.h"
 #include "main_window.h"
 #include "walk_through.h"
+#include "undo_stack.h"
 
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/core/selection_set.h>
 #include <easy3d/core/graph.h>
 #include <easy3d/core/poly_mesh.h>
 #include <easy3d/renderer/drawable_points.h>
@@ -42,6 +44,7 @@
 #include <easy3d/renderer/shapes.h>
 #include <easy3d/renderer/transform.h>
 #include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/culling.h>
 #include <easy3d/renderer/manipulated_camera_frame.h>
 #include <easy3d/renderer/key_frame_interpolator.h>
 #include <easy3d/renderer/ambient_occlusion.h>
@@ -67,6 +70,7 @@
 #include <easy3d/util/string.h>
 #include <easy3d/util/line_stream.h>
 #include <easy3d/util/dialogs.h>
+#include <easy3d/util/tracing.h>
 
 #include <QKeyEvent>
 #include <QPainter>
@@ -91,6 +95,7 @@ PaintCanvas::PaintCanvas(MainWindow* window)
         , dpi_scaling_(1.0)
         , samples_(0)
         , camera_(nullptr)
+        , culler_(nullptr)
         , background_color_(1.0f, 1.0f, 1.0f, 1.0f)
         , pressed_button_(Qt::NoButton)
         , modifiers_(Qt::NoModifier)
@@ -128,6 +133,8 @@ PaintCanvas::PaintCanvas(MainWindow* window)
     easy3d::connect(&camera_->frame_modified, this, static_cast<void (PaintCanvas::*)(void)>(&PaintCanvas::update));
 
     walk_through_ = new WalkThrough(camera_);
+
+    culler_ = new Culler;
 }
 
 
@@ -150,6 +157,7 @@ void PaintCanvas::cleanup() {
     }
 
     delete camera_;
+    delete culler_;
     delete walkThrough();
     delete drawable_axes_;
     delete drawable_manip_sphere_;
@@ -969,6 +977,7 @@ void PaintCanvas::deleteModel(Model *model) {
     auto pos = std::find(models_.begin(), models_.end(), model);
     if (pos != models_.end()) {
         const std::string name = model->name();
+        window_->undoStack()->remove(model);
         models_.erase(pos);
         makeCurrent();
         delete model->renderer();
@@ -982,6 +991,11 @@ void PaintCanvas::deleteModel(Model *model) {
 }
 
 
+bool PaintCanvas::hasModel(const Model *model) const {
+    return std::find(models_.begin(), models_.end(), model) != models_.end();
+}
+
+
 void PaintCanvas::fitScreen(const easy3d::Model *model) {
     if (!model && models_.empty())
         return;
@@ -1094,6 +1108,7 @@ vec3 PaintCanvas::pointUnderPixel(const QPoint &p, bool &found) const {
 
 
 void PaintCanvas::paintGL() {
+    EASY3D_TRACE_ZONE_CATEGORY("PaintCanvas::paintGL", "viewer");
     easy3d_debug_log_gl_error;
 
 #if 1
@@ -1510,27 +1525,14 @@ void PaintCanvas::invertSelection() {
     } else if (dynamic_cast<PointCloud*>(currentModel())) {
         auto cloud = dynamic_cast<PointCloud*>(currentModel());
         auto d = cloud->renderer()->get_points_drawable("vertices");
-        if (d->coloring_method() != easy3d::State::SCALAR_FIELD || d->property_name() != "v:select") {
-            auto select = cloud->get_vertex_property<bool>("v:select");
-            if (!select)
-                select = cloud->add_vertex_property<bool>("v:select", false);
-            for(auto v : cloud->vertices())
-                select[v] = !select[v];
-            d->set_coloring(State::SCALAR_FIELD, State::VERTEX, "v:select");
+        auto select = cloud->vertex_property<bool>("v:select", false);
+        SelectionSet selection(select.vector());
+        selection.flip();
+        selection.get(select.vector());
+        // the selected points are highlighted using a bit buffer, so the coloring of the points is kept
+        d->update_selection_buffer(selection);
+        if (d->coloring_method() == State::SCALAR_FIELD && d->property_name() == "v:select")
             buffers::update(cloud, d);
-        }
-        else {
-            auto select = cloud->vertex_property<bool>("v:select");
-            for (auto v : cloud->vertices())
-                select[v] = !select[v];
-
-            // update the drawable's texcoord buffer
-            std::vector<vec2> texcoords(d->num_vertices());
-            for (auto v : cloud->vertices())
-                texcoords[v.idx()] = vec2(select[v], 0.5f);
-            d->update_texcoord_buffer(texcoords);
-            d->set_coloring(State::SCALAR_FIELD, State::VERTEX, "v:select");
-        }
     }
     doneCurrent();
 
@@ -1914,8 +1916,11 @@ void PaintCanvas::draw() {
 
     easy3d_debug_log_gl_error;
 
+    // models (and thus their drawables) outside the view frustum or too small on screen are skipped
+    culler_->cull(models_, camera());
+
     for (const auto m : models_) {
-        if (!m->renderer()->is_visible())
+        if (!m->renderer()->is_visible() || culler_->test(m) != Culler::VISIBLE)
             continue;
 
         // Let's check if edges and surfaces are both shown. If true, we
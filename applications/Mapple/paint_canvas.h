@@ -39,6 +39,7 @@
 
 namespace easy3d {
     class Camera;
+    class Culler;
     class Model;
     class LinesDrawable;
     class TrianglesDrawable;
@@ -79,12 +80,16 @@ public:
 	void deleteModel(easy3d::Model* model);
 
 	const std::vector<easy3d::Model*>& models() const override { return models_; }
+	// returns whether the model is (still) in the viewer
+	bool hasModel(const easy3d::Model* model) const;
     easy3d::Model* currentModel();
 	void setCurrentModel(easy3d::Model* m);
 
     // the camera
     easy3d::Camera* camera() override { return camera_; }
     const easy3d::Camera* camera() const override { return camera_; }
+    // the culler (frustum culling and small-feature culling)
+    easy3d::Culler* culler() { return culler_; }
     // the walkthrough
     WalkThrough* walkThrough() { return walk_through_; }
     const WalkThrough* walkThrough() const { return walk_through_; }
@@ -299,6 +304,7 @@ protected:
     int     samples_;
 
     easy3d::Camera*	camera_;
+    easy3d::Culler*	culler_;
     easy3d::vec4	background_color_;
 
     Qt::MouseButton pressed_button_;
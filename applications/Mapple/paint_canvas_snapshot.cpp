@@ -25,14 +25,12 @@
  ********************************************************************/
 
 
-#define USE_QT_FBO
 #define SHOW_PROGRESS
 
-#ifdef  USE_QT_FBO
-#include <QOpenGLFramebufferObject>
-#else
-#include <easy3d/renderer/framebuffer_object.h>
-#endif
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <algorithm>
 
 #include <QOpenGLFunctions>
 #include <QMessageBox>
@@ -43,6 +41,8 @@
 #include "walk_through.h"
 
 #include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/async_readback.h>
 #include <easy3d/renderer/transform.h>
 #include <easy3d/renderer/key_frame_interpolator.h>
 #include <easy3d/core//model.h>
@@ -119,17 +119,25 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
 
     makeCurrent();
 
-#ifdef USE_QT_FBO
-    QOpenGLFramebufferObjectFormat format;
-    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-    format.setSamples(samples);
-    QOpenGLFramebufferObject *fbo = new QOpenGLFramebufferObject(sub_w, sub_h, format);
-    fbo->addColorAttachment(sub_w, sub_h);
-#else
     FramebufferObject* fbo = new FramebufferObject(sub_w, sub_h, samples);
     fbo->add_color_buffer();
     fbo->add_depth_buffer();
-#endif
+
+    // The tiles are read back asynchronously (while the next tiles are being rendered) and copied into the image on
+    // a worker thread. The tiles are rendered column by column, so tile 'k' is at column k / nbY and row k % nbY.
+    uchar* image_bits = image.bits();
+    const int bytes_per_line = image.bytesPerLine();
+    auto readback = new AsyncReadback([&](std::size_t tile, std::vector<unsigned char>& pixels, int tw, int th) {
+        const int i = static_cast<int>(tile) / nbY;
+        const int j = static_cast<int>(tile) % nbY;
+        const int num_columns = std::min(tw, w - i * sub_w);
+        for (int jj = 0; jj < th; jj++) {
+            int fj = j * sub_h + jj;
+            if (fj >= h)
+                break;
+            std::memcpy(image_bits + fj * bytes_per_line + i * sub_w * 4, pixels.data() + jj * tw * 4, num_columns * 4);
+        }
+    });
 
     int count = 0;
 #ifdef SHOW_PROGRESS
@@ -176,31 +184,8 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
             //---------------------------------------------------------------------------
 
 
-#ifdef USE_QT_FBO
-            const QImage subImage = fbo->toImage();
-#else
-            QImage subImage(sub_w, sub_h, QImage::Format_RGBA8888);
-            fbo->read_color(0, const_cast<unsigned char*>(subImage.constBits()), GL_RGBA);
-#endif
-
-            // Copy subImage in image
-            for (int ii = 0; ii < sub_w; ii++) {
-                int fi = i * sub_w + ii;
-                if (fi == image.width())
-                    break;
-                for (int jj = 0; jj < sub_h; jj++) {
-                    int fj = j * sub_h + jj;
-                    if (fj == image.height())
-                        break;
-                    image.setPixel(fi, fj, subImage.pixel(ii, jj));
-                }
-            }
-            /************************************************************************/
-            // save each tile (mainly for debug purpose)
-            //QString name = QString("tmp-%1.png").arg(count);
-            //subImage.save(name);
-            //std::cout << "tile: " << count << "/" << nbX * nbY << std::endl;
-            /************************************************************************/
+            // start reading the tile (it will be copied into the image when its pixels are available)
+            readback->read_color(fbo, 0, GL_RGBA);
             ++count;
 
 #ifdef SHOW_PROGRESS
@@ -211,7 +196,10 @@ bool PaintCanvas::saveSnapshot(int w, int h, int samples, const QString &file_na
 
     // this very important (the progress bar may interfere the framebuffer)
     makeCurrent();
+    // wait for the remaining tiles to be copied into the image
+    readback->finish();
     // clean
+    delete readback;
     delete fbo;
     // restore the clear color
     func_->glClearColor(background_color_[0], background_color_[1], background_color_[2], background_color_[3]);
@@ -273,19 +261,26 @@ void PaintCanvas::recordAnimation(const QString &file_name, int fps, int bit_rat
     const auto &frames = kfi->interpolate();
     makeCurrent();
 
-#ifdef USE_QT_FBO
-    QOpenGLFramebufferObjectFormat format;
-    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-    format.setSamples(samples());
-    QOpenGLFramebufferObject *fbo = new QOpenGLFramebufferObject(fw, fh, format);
-    fbo->addColorAttachment(fw, fh);
-#else
     FramebufferObject* fbo = new FramebufferObject(fw, fh, samples());
     fbo->add_color_buffer();
     fbo->add_depth_buffer();
-#endif
 
-    const QString ext_less_name = file_name.left(file_name.lastIndexOf('.'));
+    // The frames are read back asynchronously (while the next frames are being rendered) and encoded on a worker
+    // thread. QVideoEncoder only accepts Format_RGB32, Format_ARGB32, or Format_ARGB32_Premultiplied, whose memory
+    // layout (on little-endian machines) is BGRA.
+    std::atomic<bool> encoding_failed(false);
+    QString encoding_error;
+    auto readback = new AsyncReadback([&](std::size_t frame_index, std::vector<unsigned char>& pixels, int iw, int ih) {
+        if (encoding_failed)
+            return;
+        const QImage image(pixels.data(), iw, ih, QImage::Format_ARGB32);
+        QString errorString;
+        if (!encoder.encodeImage(image, static_cast<int>(frame_index), &errorString)) {
+            encoding_error = QString("Failed to encode frame #%1: %2").arg(frame_index + 1).arg(errorString);
+            encoding_failed = true;
+        }
+    });
+
 #ifdef SHOW_PROGRESS
     ProgressLogger progress(frames.size(), true, false);
 #endif
@@ -297,6 +292,10 @@ void PaintCanvas::recordAnimation(const QString &file_name, int fps, int bit_rat
             break;
         }
 #endif
+        if (encoding_failed) {
+            success = false;
+            break;
+        }
 
         const auto &f = frames[frame_index];
         camera_->setPosition(f.position());
@@ -320,28 +319,7 @@ void PaintCanvas::recordAnimation(const QString &file_name, int fps, int bit_rat
 
         //---------------------------------------------------------------------------
 
-#ifdef USE_QT_FBO
-        const QImage image = fbo->toImage();
-        if (image.isNull()) {
-            QMessageBox::critical(this, "Error", "Failed to grab the framebuffer!");
-            success = false;
-            break;
-        }
-#else
-        QImage image(fw, fh, QImage::Format_RGBA8888);
-        fbo->read_color(0, const_cast<unsigned char*>(image.constBits()), GL_RGBA);
-
-        // QVideoEncoder only accepted Format_RGB32, Format_ARGB32, or Format_ARGB32_Premultiplied
-        image.convertTo(QImage::Format_ARGB32);
-#endif
-
-        QString errorString;
-        if (!encoder.encodeImage(image, frame_index, &errorString)) {
-            QMessageBox::critical(this, "Error",
-                                  QString("Failed to encode frame #%1: %2").arg(frame_index + 1).arg(errorString));
-            success = false;
-            break;
-        }
+        readback->read_color(fbo, 0, GL_BGRA);
 
 #ifdef SHOW_PROGRESS
         progress.next();
@@ -350,12 +328,20 @@ void PaintCanvas::recordAnimation(const QString &file_name, int fps, int bit_rat
 
     // this very important (the progress bar may interfere the framebuffer)
     makeCurrent();
+    // wait for the remaining frames to be encoded
+    readback->finish();
     // clean
+    delete readback;
     delete fbo;
     // restore the clear color
     func_->glClearColor(background_color_[0], background_color_[1], background_color_[2], background_color_[3]);
     doneCurrent();
 
+    if (encoding_failed) {
+        QMessageBox::critical(this, "Error", encoding_error);
+        success = false;
+    }
+
     encoder.close();
 
     // enable updating the rendering
@@ -409,20 +395,27 @@ void PaintCanvas::recordAnimation(const QString &file_name, int, int, bool bk_wh
     const auto &frames = kfi->interpolate();
     makeCurrent();
 
-#ifdef USE_QT_FBO
-    QOpenGLFramebufferObjectFormat format;
-    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-    format.setSamples(samples());
-    QOpenGLFramebufferObject *fbo = new QOpenGLFramebufferObject(fw, fh, format);
-    fbo->addColorAttachment(fw, fh);
-#else
     FramebufferObject* fbo = new FramebufferObject(fw, fh, samples());
     fbo->add_color_buffer();
     fbo->add_depth_buffer();
-#endif
 
     bool success = true;
     const QString ext_less_name = file_name.left(file_name.lastIndexOf('.'));
+
+    // The frames are read back asynchronously (while the next frames are being rendered) and saved on a worker thread.
+    std::atomic<bool> saving_failed(false);
+    std::atomic<std::size_t> failed_frame(0);
+    auto readback = new AsyncReadback([&](std::size_t frame_index, std::vector<unsigned char>& pixels, int iw, int ih) {
+        if (saving_failed)
+            return;
+        const QImage image(pixels.data(), iw, ih, QImage::Format_RGBA8888);
+        const QString full_name = ext_less_name + QString("-%1.png").arg(frame_index, 4, 10, QChar('0'));
+        if (!image.save(full_name)) {
+            failed_frame = frame_index;
+            saving_failed = true;
+        }
+    });
+
 #ifdef SHOW_PROGRESS
     ProgressLogger progress(frames.size(), true, false);
 #endif
@@ -434,6 +427,10 @@ void PaintCanvas::recordAnimation(const QString &file_name, int, int, bool bk_wh
             break;
         }
 #endif
+        if (saving_failed) {
+            success = false;
+            break;
+        }
 
         const auto &f = frames[frame_index];
         camera_->setPosition(f.position());
@@ -457,24 +454,7 @@ void PaintCanvas::recordAnimation(const QString &file_name, int, int, bool bk_wh
 
         //---------------------------------------------------------------------------
 
-#ifdef USE_QT_FBO
-        const QImage image = fbo->toImage();
-        if (image.isNull()) {
-            QMessageBox::critical(this, "Error", "Failed to grab the framebuffer!");
-            success = false;
-            break;
-        }
-#else
-        QImage image(fw, fh, QImage::Format_RGBA8888);
-        fbo->read_color(0, const_cast<unsigned char*>(image.constBits()), GL_RGBA);
-#endif
-
-        const QString full_name = ext_less_name + QString("-%1.png").arg(frame_index, 4, 10, QChar('0'));
-        if (!image.save(full_name)) {
-            QMessageBox::critical(this, "Error", QString("failed to save the %1-th frame").arg(frame_index));
-            success = false;
-            break;
-        }
+        readback->read_color(fbo, 0, GL_RGBA);
 
 #ifdef SHOW_PROGRESS
         progress.next();
@@ -483,12 +463,20 @@ void PaintCanvas::recordAnimation(const QString &file_name, int, int, bool bk_wh
 
     // this very important (the progress bar may interfere the framebuffer)
     makeCurrent();
+    // wait for the remaining frames to be saved
+    readback->finish();
     // clean
+    delete readback;
     delete fbo;
     // restore the clear color
     func_->glClearColor(background_color_[0], background_color_[1], background_color_[2], background_color_[3]);
     doneCurrent();
 
+    if (saving_failed) {
+        QMessageBox::critical(this, "Error", QString("failed to save the %1-th frame").arg(failed_frame.load()));
+        success = false;
+    }
+
     // enable updating the rendering
     easy3d::connect(&camera_->frame_modified, this, static_cast<void (PaintCanvas::*)(void)>(&PaintCanvas::update));
 
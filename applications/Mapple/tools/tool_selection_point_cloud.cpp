@@ -35,6 +35,7 @@
 #include <easy3d/renderer/buffers.h>
 #include <easy3d/renderer/setting.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/core/selection_set.h>
 #include <easy3d/util/logging.h>
 
 
@@ -52,21 +53,11 @@ namespace easy3d {
 
         void ToolPointCloudSelection::update_render_buffer(PointCloud* cloud) const {
             auto d = cloud->renderer()->get_points_drawable("vertices");
-            if ((d->coloring_method() != easy3d::State::SCALAR_FIELD) || (d->property_location() != State::VERTEX) || (d->property_name() != "v:select")) {
-                if (!cloud->get_vertex_property<bool>("v:select"))
-                    cloud->add_vertex_property<bool>("v:select", false);
-                d->set_coloring(State::SCALAR_FIELD, State::VERTEX, "v:select");
+            auto select = cloud->vertex_property<bool>("v:select", false);
+            // the selected points are highlighted using a bit buffer, so the coloring of the points is kept
+            d->update_selection_buffer(SelectionSet(select.vector()));
+            if (d->coloring_method() == State::SCALAR_FIELD && d->property_name() == "v:select")
                 buffers::update(cloud, d);
-            }
-            else {
-                auto select = cloud->vertex_property<bool>("v:select", false);
-                // update the drawable's texcoord buffer
-                std::vector<vec2> texcoords(d->num_vertices());
-                for (auto v : cloud->vertices())
-                    texcoords[v.idx()] = vec2(select[v], 0.5f);
-                d->update_texcoord_buffer(texcoords);
-                d->set_coloring(State::SCALAR_FIELD, State::VERTEX, "v:select");
-            }
         }
 
         // -------------------- Rect Select ----------------------
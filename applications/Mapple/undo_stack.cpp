@@ -0,0 +1,183 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include "undo_stack.h"
+
+#include <algorithm>
+
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/core/model_diff.h>
+#include <easy3d/renderer/renderer.h>
+#include <easy3d/util/logging.h>
+
+
+using namespace easy3d;
+
+
+namespace details {
+
+    // a copy of the model
+    Model *snapshot(const Model *model) {
+        if (dynamic_cast<const SurfaceMesh *>(model))
+            return new SurfaceMesh(*dynamic_cast<const SurfaceMesh *>(model));
+        else if (dynamic_cast<const PointCloud *>(model))
+            return new PointCloud(*dynamic_cast<const PointCloud *>(model));
+        else if (dynamic_cast<const Graph *>(model))
+            return new Graph(*dynamic_cast<const Graph *>(model));
+        else if (dynamic_cast<const PolyMesh *>(model))
+            return new PolyMesh(*dynamic_cast<const PolyMesh *>(model));
+        return nullptr;
+    }
+}
+
+
+UndoStack::UndoStack(QObject *parent, std::size_t max_steps)
+        : QObject(parent)
+        , max_steps_(max_steps)
+{
+}
+
+
+UndoStack::~UndoStack() = default;
+
+
+void UndoStack::push(Model *model, const QString &text) {
+    if (!model || max_steps_ == 0)
+        return;
+
+    std::unique_ptr<Model> before(details::snapshot(model));
+    if (!before) {
+        LOG(WARNING) << "undo is not supported for model: " << model->name();
+        return;
+    }
+
+    // the current state of the model is the result of its previous step
+    complete(model);
+    undo_.push_back({text, model, std::move(before), std::make_shared<ModelDiff>()});
+    if (undo_.size() > max_steps_)
+        undo_.pop_front();
+    redo_.clear();
+    emit changed();
+}
+
+
+QString UndoStack::undoText() const {
+    return undo_.empty() ? QString() : undo_.back().text;
+}
+
+
+QString UndoStack::redoText() const {
+    return redo_.empty() ? QString() : redo_.back().text;
+}
+
+
+Model *UndoStack::undoModel() const {
+    return undo_.empty() ? nullptr : undo_.back().model;
+}
+
+
+Model *UndoStack::redoModel() const {
+    return redo_.empty() ? nullptr : redo_.back().model;
+}
+
+
+void UndoStack::remove(const Model *model) {
+    auto is_of_model = [model](const Step &step) { return step.model == model; };
+    const std::size_t size = undo_.size() + redo_.size();
+    undo_.erase(std::remove_if(undo_.begin(), undo_.end(), is_of_model), undo_.end());
+    redo_.erase(std::remove_if(redo_.begin(), redo_.end(), is_of_model), redo_.end());
+    if (undo_.size() + redo_.size() != size)
+        emit changed();
+}
+
+
+void UndoStack::setMaxSteps(std::size_t n) {
+    max_steps_ = n;
+    if (undo_.size() > max_steps_) {
+        undo_.erase(undo_.begin(), undo_.end() - static_cast<std::ptrdiff_t>(max_steps_));
+        emit changed();
+    }
+}
+
+
+void UndoStack::undo() {
+    if (undo_.empty())
+        return;
+    LOG(INFO) << "undo: " << undo_.back().text.toStdString();
+    restore(undo_, redo_);
+}
+
+
+void UndoStack::redo() {
+    if (redo_.empty())
+        return;
+    LOG(INFO) << "redo: " << redo_.back().text.toStdString();
+    restore(redo_, undo_);
+}
+
+
+void UndoStack::clear() {
+    if (undo_.empty() && redo_.empty())
+        return;
+    undo_.clear();
+    redo_.clear();
+    emit changed();
+}
+
+
+void UndoStack::complete(Model *model) {
+    for (auto it = undo_.rbegin(); it != undo_.rend(); ++it) {
+        if (it->model == model) {
+            if (it->before)
+                it->diff->record(it->before.release(), model);
+            return;
+        }
+    }
+}
+
+
+void UndoStack::restore(std::deque<Step> &from, std::deque<Step> &to) {
+    Model *model = from.back().model;
+    if (&from == &undo_)
+        complete(model);
+
+    // applying the difference restores the model, and the difference becomes the one for going back
+    Step step = std::move(from.back());
+    from.pop_back();
+    if (!step.diff->apply(model)) {
+        LOG(ERROR) << "failed to restore model: " << model->name();
+        emit changed();
+        return;
+    }
+    to.push_back(std::move(step));
+
+    if (model->renderer())
+        model->renderer()->update();
+    emit changed();
+}
@@ -0,0 +1,127 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef UNDO_STACK_H
+#define UNDO_STACK_H
+
+#include <deque>
+#include <memory>
+
+#include <QObject>
+#include <QString>
+
+
+namespace easy3d {
+    class Model;
+    class ModelDiff;
+}
+
+
+/**
+ * \brief An undo/redo stack of the modifications of models.
+ * \details Before a model is modified, push() records a copy of it. When the step is complete (i.e., when the next
+ *      step of the model is pushed or when it is undone), the copy is reduced to the difference between the two
+ *      states (see ModelDiff), which keeps only the properties modified by the operation, e.g., only the points when
+ *      the model is smoothed. Undoing and redoing exchange the recorded properties with the model. The oldest steps
+ *      are discarded when the maximum number of steps is reached.
+ *
+ *      The steps of a model must be recorded for all its modifications, because a difference can only be applied
+ *      to the state it was recorded against.
+ *
+ *      Example usage:
+ *      \code
+ *          window->undoStack()->push(mesh, "smoothing");
+ *          SurfaceMeshSmoothing(mesh).explicit_smoothing();
+ *          mesh->renderer()->update();
+ *      \endcode
+ */
+class UndoStack : public QObject {
+    Q_OBJECT
+public:
+    explicit UndoStack(QObject *parent = nullptr, std::size_t max_steps = 50);
+    ~UndoStack() override;
+
+    /// Records the current state of \p model, which is about to be modified by the operation named \p text. It
+    /// discards the steps that can be redone.
+    void push(easy3d::Model *model, const QString &text);
+
+    /// Returns whether there is a step to undo.
+    bool canUndo() const { return !undo_.empty(); }
+    /// Returns whether there is a step to redo.
+    bool canRedo() const { return !redo_.empty(); }
+
+    /// Returns the name of the operation to undo (empty if there is none).
+    QString undoText() const;
+    /// Returns the name of the operation to redo (empty if there is none).
+    QString redoText() const;
+
+    /// Returns the model affected by undo() (nullptr if there is no step to undo).
+    easy3d::Model *undoModel() const;
+    /// Returns the model affected by redo() (nullptr if there is no step to redo).
+    easy3d::Model *redoModel() const;
+
+    /// Discards the steps of \p model, e.g., when it is deleted.
+    void remove(const easy3d::Model *model);
+
+    /// Sets the maximum number of steps that can be undone.
+    void setMaxSteps(std::size_t n);
+    /// Returns the maximum number of steps that can be undone.
+    std::size_t maxSteps() const { return max_steps_; }
+
+public slots:
+    /// Restores the model of the last step.
+    void undo();
+    /// Redoes the last undone step.
+    void redo();
+    /// Discards all the steps.
+    void clear();
+
+signals:
+    /// Emitted when the steps have changed, e.g., to update the undo/redo actions.
+    void changed();
+
+private:
+    struct Step {
+        QString text;
+        easy3d::Model *model;
+        std::unique_ptr<easy3d::Model> before;  // the state before the operation, until the step is complete
+        std::shared_ptr<easy3d::ModelDiff> diff;
+    };
+
+    // reduces the last step of \p model to the difference of the states, if it is not complete yet
+    void complete(easy3d::Model *model);
+
+    // moves the last step of \p from to \p to, and applies its difference to the model
+    void restore(std::deque<Step> &from, std::deque<Step> &to);
+
+private:
+    std::deque<Step> undo_;
+    std::deque<Step> redo_;
+    std::size_t max_steps_;
+};
+
+
+#endif // UNDO_STACK_H
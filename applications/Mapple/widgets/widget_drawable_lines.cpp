@@ -390,6 +390,12 @@ namespace lines_details {
             else if (model->template get_edge_property<bool>(name) && name == "e:select")
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
         }
+        // computed scalar fields defined on edges
+        for (const auto &name : model->edge_property_container().computed_properties()) {
+            const std::type_info &type = model->edge_property_container().get_computed_type(name);
+            if (type == typeid(float) || type == typeid(double))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
+        }
         // scalar fields defined on vertices
         for (const auto &name : model->vertex_properties()) {
             if (model->template get_vertex_property<float>(name))
@@ -405,6 +411,12 @@ namespace lines_details {
             else if (model->template get_vertex_property<char>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
         }
+        // computed scalar fields defined on vertices
+        for (const auto &name : model->vertex_property_container().computed_properties()) {
+            const std::type_info &type = model->vertex_property_container().get_computed_type(name);
+            if (type == typeid(float) || type == typeid(double))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
+        }
     }
 
     // vector fields defined on edges
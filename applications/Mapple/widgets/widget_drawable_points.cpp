@@ -196,6 +196,12 @@ namespace points_details {
             else if (model->template get_vertex_property<bool>(name) && name == "v:select")
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
         }
+        // computed scalar fields defined on vertices
+        for (const auto &name : model->vertex_property_container().computed_properties()) {
+            const std::type_info &type = model->vertex_property_container().get_computed_type(name);
+            if (type == typeid(float) || type == typeid(double))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
+        }
     }
 
     // vector fields defined on vertices
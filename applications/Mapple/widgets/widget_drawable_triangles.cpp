@@ -327,6 +327,12 @@ namespace triangles_details {
             else if (model->template get_face_property<bool>(name) && name == "f:select")
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
         }
+        // computed scalar fields defined on faces
+        for (const auto &name : model->face_property_container().computed_properties()) {
+            const std::type_info &type = model->face_property_container().get_computed_type(name);
+            if (type == typeid(float) || type == typeid(double))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
+        }
 
         // scalar fields defined on vertices
         for (const auto &name : model->vertex_properties()) {
@@ -343,6 +349,12 @@ namespace triangles_details {
             else if (model->template get_vertex_property<unsigned char>(name))
                 schemes.push_back(scalar_prefix + QString::fromStdString(name));
         }
+        // computed scalar fields defined on vertices
+        for (const auto &name : model->vertex_property_container().computed_properties()) {
+            const std::type_info &type = model->vertex_property_container().get_computed_type(name);
+            if (type == typeid(float) || type == typeid(double))
+                schemes.push_back(scalar_prefix + QString::fromStdString(name));
+        }
     }
 
     // vector fields defined on faces
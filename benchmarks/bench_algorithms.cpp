@@ -0,0 +1,225 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+// Benchmarks of the (expensive) algorithms: normal estimation, simplification, remeshing, curvature, and surface
+// reconstruction. The algorithms modifying their input run on a fresh copy in each iteration (not measured).
+
+#include "benchmark.h"
+#include "synthetic_data.h"
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/algo/point_cloud_normals.h>
+#include <easy3d/algo/point_cloud_simplification.h>
+#include <easy3d/algo/point_cloud_poisson_reconstruction.h>
+#include <easy3d/algo/surface_mesh_simplification.h>
+#include <easy3d/algo/surface_mesh_remeshing.h>
+#include <easy3d/algo/surface_mesh_curvature.h>
+#include <easy3d/algo/surface_mesh_geometry.h>
+#include <easy3d/algo/reordering.h>
+
+
+using namespace easy3d;
+
+
+void point_cloud_normals(benchmark::State &state) {
+    PointCloud *cloud = benchmark::torus_cloud(state.arg(), false);
+    PointCloudNormals estimator;
+    while (state.keep_running())
+        estimator.estimate(cloud, 16);
+    state.set_items_processed(state.iterations() * cloud->n_vertices());
+    delete cloud;
+}
+EASY3D_BENCHMARK(point_cloud_normals)->arg(100000)->arg(1000000)->max_iterations(10);
+
+
+void point_cloud_grid_simplification(benchmark::State &state) {
+    PointCloud *cloud = benchmark::torus_cloud(state.arg(), false);
+    while (state.keep_running()) {
+        const auto points = PointCloudSimplification::grid_simplification(cloud, 0.01f);
+        benchmark::do_not_optimize(points.data());
+    }
+    state.set_items_processed(state.iterations() * cloud->n_vertices());
+    delete cloud;
+}
+EASY3D_BENCHMARK(point_cloud_grid_simplification)->arg(1000000);
+
+
+void point_cloud_uniform_simplification(benchmark::State &state) {
+    PointCloud *cloud = benchmark::torus_cloud(state.arg(), false);
+    while (state.keep_running()) {
+        const auto points = PointCloudSimplification::uniform_simplification(cloud, 0.01f);
+        benchmark::do_not_optimize(points.data());
+    }
+    state.set_items_processed(state.iterations() * cloud->n_vertices());
+    delete cloud;
+}
+EASY3D_BENCHMARK(point_cloud_uniform_simplification)->arg(1000000)->max_iterations(10);
+
+
+void poisson_reconstruction(benchmark::State &state) {
+    PointCloud *cloud = benchmark::torus_cloud(state.arg(), true);
+    PoissonReconstruction algo;
+    algo.set_depth(8);
+    while (state.keep_running()) {
+        SurfaceMesh *mesh = algo.apply(cloud);
+        state.pause_timing();
+        if (mesh)
+            state.counters["faces"] = mesh->n_faces();
+        delete mesh;
+        state.resume_timing();
+    }
+    state.set_items_processed(state.iterations() * cloud->n_vertices());
+    delete cloud;
+}
+EASY3D_BENCHMARK(poisson_reconstruction)->arg(100000)->max_iterations(1);
+
+
+// decimates the mesh to 10% of its vertices
+void surface_mesh_simplification(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    while (state.keep_running()) {
+        state.pause_timing();
+        SurfaceMesh copy(*mesh);
+        state.resume_timing();
+        SurfaceMeshSimplification simplifier(&copy);
+        simplifier.initialize(5.0f);
+        simplifier.simplify(mesh->n_vertices() / 10);
+    }
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_simplification)->arg(100000)->arg(1000000)->max_iterations(5);
+
+
+// uniform remeshing with the average edge length of the input
+void surface_mesh_remeshing(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    float length = 0.0f;
+    for (auto e : mesh->edges())
+        length += mesh->edge_length(e);
+    length /= static_cast<float>(mesh->n_edges());
+
+    while (state.keep_running()) {
+        state.pause_timing();
+        SurfaceMesh copy(*mesh);
+        state.resume_timing();
+        SurfaceMeshRemeshing(&copy).uniform_remeshing(length, 3);
+    }
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_remeshing)->arg(100000)->max_iterations(5);
+
+
+void surface_mesh_curvature(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    while (state.keep_running()) {
+        SurfaceMeshCurvature curvature(mesh);
+        curvature.analyze_tensor(1, false);
+        curvature.compute_mean_curvature();
+    }
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_curvature)->arg(100000)->arg(1000000)->max_iterations(10);
+
+
+// the cotan-Laplace curvatures with smoothing (the cotan weights and Voronoi areas are shared by all passes)
+void surface_mesh_curvature_cotan(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    while (state.keep_running()) {
+        SurfaceMeshCurvature curvature(mesh);
+        curvature.analyze(3);
+        curvature.compute_mean_curvature();
+    }
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_curvature_cotan)->arg(100000)->arg(1000000)->max_iterations(10);
+
+
+// the curvatures of all vertices at once vs. geom::vertex_curvature() for each vertex
+void surface_mesh_vertex_curvatures(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    std::vector<geom::VertexCurvature> curvatures;
+    while (state.keep_running())
+        geom::vertex_curvatures(mesh, curvatures);
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_vertex_curvatures)->arg(100000)->arg(1000000)->max_iterations(10);
+
+
+void surface_mesh_vertex_curvature(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    while (state.keep_running()) {
+        for (auto v : mesh->vertices())
+            benchmark::do_not_optimize(geom::vertex_curvature(mesh, v));
+    }
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_vertex_curvature)->arg(100000)->arg(1000000)->max_iterations(10);
+
+
+// the curvature of a mesh with the elements in random order, e.g., a scanned mesh
+void surface_mesh_curvature_shuffled(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    benchmark::shuffle(mesh);
+    while (state.keep_running()) {
+        SurfaceMeshCurvature curvature(mesh);
+        curvature.analyze_tensor(1, false);
+        curvature.compute_mean_curvature();
+    }
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_curvature_shuffled)->arg(1000000)->max_iterations(10);
+
+
+// reorders the shuffled elements along the Hilbert curve
+void reordering_hilbert(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    benchmark::shuffle(mesh);
+    while (state.keep_running())
+        Reordering::apply(mesh);
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(reordering_hilbert)->arg(1000000)->max_iterations(10);
+
+
+// reorders the shuffled faces for the vertex cache (and the vertices and edges in the order of their use)
+void reordering_vertex_cache(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    benchmark::shuffle(mesh);
+    while (state.keep_running())
+        Reordering::optimize_vertex_cache(mesh);
+    state.set_items_processed(state.iterations() * mesh->n_faces());
+    delete mesh;
+}
+EASY3D_BENCHMARK(reordering_vertex_cache)->arg(1000000)->max_iterations(10);
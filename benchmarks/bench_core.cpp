@@ -0,0 +1,492 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+// Benchmarks of the core data structures: construction and traversal of surface meshes, property access, and bulk
+// operations on points.
+
+#include "benchmark.h"
+#include "synthetic_data.h"
+
+#include <random>
+#include <algorithm>
+
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/scalar_statistics.h>
+#include <easy3d/core/vec3_kernels.h>
+#include <easy3d/algo/reordering.h>
+#include <easy3d/util/tracing.h>
+
+
+using namespace easy3d;
+
+
+// add_vertex() and add_triangle(), including the halfedge connectivity
+void surface_mesh_add_face(benchmark::State &state) {
+    std::size_t num_faces = 0;
+    while (state.keep_running()) {
+        SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+        num_faces = mesh->n_faces();
+        state.pause_timing();
+        delete mesh;
+        state.resume_timing();
+    }
+    state.set_items_processed(state.iterations() * num_faces);
+}
+EASY3D_BENCHMARK(surface_mesh_add_face)->arg(10000)->arg(1000000);
+
+
+// the one-ring neighbors of each vertex
+void surface_mesh_vertex_ring(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    auto points = mesh->get_vertex_property<vec3>("v:point");
+    while (state.keep_running()) {
+        for (auto v : mesh->vertices()) {
+            vec3 sum(0, 0, 0);
+            for (auto vv : mesh->vertices(v))
+                sum += points[vv];
+            benchmark::do_not_optimize(sum);
+        }
+    }
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_vertex_ring)->arg(10000)->arg(1000000);
+
+
+namespace details {
+    void vertex_ring(benchmark::State &state, SurfaceMesh *mesh) {
+        auto points = mesh->get_vertex_property<vec3>("v:point");
+        while (state.keep_running()) {
+            for (auto v : mesh->vertices()) {
+                vec3 sum(0, 0, 0);
+                for (auto vv : mesh->vertices(v))
+                    sum += points[vv];
+                benchmark::do_not_optimize(sum);
+            }
+        }
+        state.set_items_processed(state.iterations() * mesh->n_vertices());
+    }
+}
+
+
+// the one-ring neighbors of each vertex, with the elements in random order
+void surface_mesh_vertex_ring_shuffled(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    benchmark::shuffle(mesh);
+    details::vertex_ring(state, mesh);
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_vertex_ring_shuffled)->arg(10000)->arg(1000000);
+
+
+// the one-ring neighbors of each vertex, with the shuffled elements reordered along the Hilbert curve
+void surface_mesh_vertex_ring_reordered(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    benchmark::shuffle(mesh);
+    Reordering::apply(mesh);
+    details::vertex_ring(state, mesh);
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_vertex_ring_reordered)->arg(10000)->arg(1000000);
+
+
+// the vertices of each face
+void surface_mesh_face_vertices(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    auto points = mesh->get_vertex_property<vec3>("v:point");
+    while (state.keep_running()) {
+        for (auto f : mesh->faces()) {
+            vec3 sum(0, 0, 0);
+            for (auto v : mesh->vertices(f))
+                sum += points[v];
+            benchmark::do_not_optimize(sum);
+        }
+    }
+    state.set_items_processed(state.iterations() * mesh->n_faces());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_face_vertices)->arg(10000)->arg(1000000);
+
+
+// the edges, their end points, and their incident faces
+void surface_mesh_edge_traversal(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    while (state.keep_running()) {
+        float length = 0.0f;
+        for (auto e : mesh->edges()) {
+            if (!mesh->is_border(e))
+                length += mesh->edge_length(e);
+        }
+        benchmark::do_not_optimize(length);
+    }
+    state.set_items_processed(state.iterations() * mesh->n_edges());
+    delete mesh;
+}
+EASY3D_BENCHMARK(surface_mesh_edge_traversal)->arg(10000)->arg(1000000);
+
+
+namespace details {
+    // a point cloud with a number of scalar fields, so lookups by name are not trivially fast
+    PointCloud *cloud_with_properties(std::size_t num_points, int num_properties = 20) {
+        PointCloud *cloud = benchmark::torus_cloud(num_points, false);
+        for (int i = 0; i < num_properties; ++i)
+            cloud->add_vertex_property<float>("v:scalar_" + std::to_string(i), static_cast<float>(i));
+        return cloud;
+    }
+
+    // looks up a property (in the middle of the properties) by name for each access
+    void access_by_name(benchmark::State &state, int num_properties) {
+        PointCloud *cloud = cloud_with_properties(state.arg(), num_properties);
+        const std::string name = "v:scalar_" + std::to_string(num_properties / 2);
+        const int n = static_cast<int>(cloud->n_vertices());
+        while (state.keep_running()) {
+            float sum = 0.0f;
+            for (int i = 0; i < n; ++i)
+                sum += cloud->get_vertex_property<float>(name)[PointCloud::Vertex(i)];
+            benchmark::do_not_optimize(sum);
+        }
+        state.set_items_processed(state.iterations() * n);
+        delete cloud;
+    }
+}
+
+
+// looks up the property by comparing the name of each property (as done before the properties were indexed by name)
+void property_access_linear_search(benchmark::State &state) {
+    PointCloud *cloud = details::cloud_with_properties(state.arg());
+    const int n = static_cast<int>(cloud->n_vertices());
+    const PropertyContainer &container = cloud->vertex_property_container();
+    const std::string name = "v:scalar_10";
+    while (state.keep_running()) {
+        float sum = 0.0f;
+        for (int i = 0; i < n; ++i) {
+            for (auto array : container.arrays()) {
+                if (array->name() == name) {
+                    sum += dynamic_cast<const PropertyArray<float> *>(array)->data()[i];
+                    break;
+                }
+            }
+        }
+        benchmark::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * n);
+    delete cloud;
+}
+EASY3D_BENCHMARK(property_access_linear_search)->arg(100000);
+
+
+// looks up the property by name for each access (searched linearly, as there are only a few properties)
+void property_access_by_name(benchmark::State &state) {
+    details::access_by_name(state, 20);
+}
+EASY3D_BENCHMARK(property_access_by_name)->arg(100000);
+
+
+// looks up the property by name for each access (using the name index, as there are many properties)
+void property_access_by_name_many_properties(benchmark::State &state) {
+    details::access_by_name(state, 64);
+}
+EASY3D_BENCHMARK(property_access_by_name_many_properties)->arg(100000);
+
+
+// looks up the property by a cached handle for each access
+void property_access_cached(benchmark::State &state) {
+    PointCloud *cloud = details::cloud_with_properties(state.arg());
+    const std::size_t n = cloud->n_vertices();
+    const PropertyContainer &container = cloud->vertex_property_container();
+    CachedProperty<float> scalar("v:scalar_10");
+    while (state.keep_running()) {
+        float sum = 0.0f;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += scalar.get(container)[i];
+        benchmark::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * n);
+    delete cloud;
+}
+EASY3D_BENCHMARK(property_access_cached)->arg(100000);
+
+
+// accesses the property through a handle (i.e., operator[])
+void property_access_handle(benchmark::State &state) {
+    PointCloud *cloud = details::cloud_with_properties(state.arg());
+    auto scalar = cloud->get_vertex_property<float>("v:scalar_10");
+    while (state.keep_running()) {
+        float sum = 0.0f;
+        for (auto v : cloud->vertices())
+            sum += scalar[v];
+        benchmark::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * cloud->n_vertices());
+    delete cloud;
+}
+EASY3D_BENCHMARK(property_access_handle)->arg(100000)->arg(10000000);
+
+
+// computes the values on demand (i.e., without a cache)
+void property_access_computed(benchmark::State &state) {
+    PointCloud *cloud = benchmark::torus_cloud(state.arg(), false);
+    auto points = cloud->get_vertex_property<vec3>("v:point");
+    auto height = cloud->vertex_property_container().add_computed<float>("v:height", [points](std::size_t i) {
+        return points.vector()[i].z;
+    });
+    while (state.keep_running()) {
+        float sum = 0.0f;
+        for (auto v : cloud->vertices())
+            sum += height[v];
+        benchmark::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * cloud->n_vertices());
+    delete cloud;
+}
+EASY3D_BENCHMARK(property_access_computed)->arg(100000)->arg(10000000);
+
+
+// copies all the properties, e.g., when copying a model
+void property_container_copy(benchmark::State &state) {
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    while (state.keep_running()) {
+        SurfaceMesh copy(*mesh);
+        benchmark::do_not_optimize(copy.n_faces());
+    }
+    state.set_items_processed(state.iterations() * mesh->n_vertices());
+    delete mesh;
+}
+EASY3D_BENCHMARK(property_container_copy)->arg(1000000);
+
+
+namespace details {
+    // removes a randomly chosen half of the faces (and the elements they leave unused) of a mesh with the given number
+    // of extra properties (spread over the vertices, halfedges, edges, and faces)
+    void collect_garbage(benchmark::State &state, int num_properties) {
+        SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+        for (int i = 0; i < num_properties; ++i) {
+            const std::string name = std::to_string(i);
+            switch (i % 4) {
+                case 0: mesh->add_vertex_property<float>("v:value" + name, static_cast<float>(i)); break;
+                case 1: mesh->add_halfedge_property<vec2>("h:value" + name, vec2(static_cast<float>(i))); break;
+                case 2: mesh->add_edge_property<float>("e:value" + name, static_cast<float>(i)); break;
+                default: mesh->add_face_property<vec3>("f:value" + name, vec3(static_cast<float>(i))); break;
+            }
+        }
+        std::vector<SurfaceMesh::Face> faces;
+        for (auto f : mesh->faces())
+            faces.push_back(f);
+        std::shuffle(faces.begin(), faces.end(), std::mt19937(42));
+        for (std::size_t i = 0; i < faces.size() / 2; ++i)
+            if (!mesh->is_deleted(faces[i]))
+                mesh->delete_face(faces[i]);
+
+        while (state.keep_running()) {
+            state.pause_timing();
+            SurfaceMesh *copy = new SurfaceMesh(*mesh);
+            state.resume_timing();
+            copy->collect_garbage();
+            state.pause_timing();
+            delete copy;
+            state.resume_timing();
+        }
+        state.set_items_processed(state.iterations() * mesh->faces_size());
+        state.set_label(std::to_string(num_properties) + " extra properties");
+        delete mesh;
+    }
+}
+
+
+// garbage collection with a few extra properties
+void surface_mesh_collect_garbage(benchmark::State &state) {
+    details::collect_garbage(state, 8);
+}
+EASY3D_BENCHMARK(surface_mesh_collect_garbage)->arg(10000)->arg(1000000);
+
+
+// garbage collection with many extra properties, where moving the elements of each array at once pays off (compared
+// to swapping the elements one by one through all the arrays)
+void surface_mesh_collect_garbage_many_properties(benchmark::State &state) {
+    details::collect_garbage(state, 64);
+}
+EASY3D_BENCHMARK(surface_mesh_collect_garbage_many_properties)->arg(100000);
+
+
+namespace details {
+    // a skewed distribution with an outlier
+    std::vector<float> skewed_values(std::size_t num) {
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+        std::vector<float> values(num);
+        for (auto &v : values)
+            v = uniform(rng) * uniform(rng) * 100.0f;
+        values[num / 2] = 1e6f;
+        return values;
+    }
+}
+
+
+// the quantiles of a scalar field by sorting its values (the exact reference of scalar_statistics)
+void scalar_field_sort(benchmark::State &state) {
+    const std::vector<float> values = details::skewed_values(state.arg());
+    while (state.keep_running()) {
+        std::vector<float> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        benchmark::do_not_optimize(sorted.data());
+    }
+    state.set_items_processed(state.iterations() * values.size());
+}
+EASY3D_BENCHMARK(scalar_field_sort)->arg(3000000);
+
+
+// the statistics (i.e., the quantile sketch) of a scalar field, which are used for clamping the scalar fields
+void scalar_statistics(benchmark::State &state) {
+    const std::vector<float> values = details::skewed_values(state.arg());
+    while (state.keep_running()) {
+        const ScalarStatistics stats(values);
+        benchmark::do_not_optimize(stats.count());
+    }
+    state.set_items_processed(state.iterations() * values.size());
+}
+EASY3D_BENCHMARK(scalar_statistics)->arg(3000000);
+
+
+namespace details {
+    void tracing_zones(benchmark::State &state) {
+        const long long n = state.arg();
+        while (state.keep_running()) {
+            for (long long i = 0; i < n; ++i) {
+                tracing::Zone zone("tracing_zone", "benchmark");
+                benchmark::do_not_optimize(i);
+            }
+        }
+        state.set_items_processed(state.iterations() * n);
+    }
+}
+
+
+// the cost of a tracing zone when tracing is not running
+void tracing_zone_idle(benchmark::State &state) {
+    tracing::stop();
+    details::tracing_zones(state);
+}
+EASY3D_BENCHMARK(tracing_zone_idle)->arg(1000);
+
+
+// the cost of a tracing zone when tracing is running
+void tracing_zone_running(benchmark::State &state) {
+    tracing::start();
+    details::tracing_zones(state);
+    tracing::stop();
+    tracing::clear();
+}
+EASY3D_BENCHMARK(tracing_zone_running)->arg(1000);
+
+
+// the vectorized kernels for bulk operations on points (see vec3_kernels.h) with each instruction set supported by the
+// build and the CPU (e.g., "vec3_transform/AVX2"), and the plain loops they replace (e.g., "vec3_transform/loop")
+namespace details {
+    typedef std::function<void(std::vector<vec3> &)> BulkOperation;
+
+    void bulk_operation(benchmark::State &state, const BulkOperation &operation) {
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<float> uniform(-500.0f, 500.0f);
+        std::vector<vec3> points(static_cast<std::size_t>(state.arg()));
+        for (auto &p : points)
+            p = vec3(uniform(rng), uniform(rng), uniform(rng));
+
+        while (state.keep_running())
+            operation(points);
+        benchmark::do_not_optimize(points.front());
+        state.set_items_processed(state.iterations() * points.size());
+        state.set_bytes_processed(state.iterations() * points.size() * sizeof(vec3));
+    }
+
+    // registers the plain loop and the kernel with each instruction set
+    bool register_bulk_operation(const std::string &name, const BulkOperation &loop, const BulkOperation &kernel) {
+        benchmark::register_benchmark(name + "/loop", [loop](benchmark::State &state) {
+            bulk_operation(state, loop);
+        })->arg(1000000);
+
+        for (int i = kernels::SCALAR; i <= kernels::AVX2; ++i) {
+            const auto isa = static_cast<kernels::InstructionSet>(i);
+            const std::string isa_name = kernels::instruction_set_name(isa);
+            benchmark::register_benchmark(name + "/" + isa_name, [isa, kernel](benchmark::State &state) {
+                const kernels::InstructionSet default_isa = kernels::instruction_set();
+                if (!kernels::set_instruction_set(isa)) {
+                    state.skip("not supported by the build or the CPU");
+                    return;
+                }
+                bulk_operation(state, kernel);
+                kernels::set_instruction_set(default_isa);
+            })->arg(1000000);
+        }
+        return true;
+    }
+
+    // a rigid transformation (so the points stay bounded when it is applied repeatedly), and a large offset, e.g.,
+    // of geographic coordinates
+    const mat4 rigid = mat4::translation(1, 2, 3) * mat4::rotation(vec3(1, 1, 0), 0.5f);
+    const dvec3 offset(-12345678.25, 2345678.5, -345678.75);
+}
+
+
+static const bool vec3_bounding_box = details::register_bulk_operation(
+        "vec3_bounding_box",
+        [](std::vector<vec3> &points) {
+            Box3 box;
+            for (const auto &p : points)
+                box.grow(p);
+            benchmark::do_not_optimize(box);
+        },
+        [](std::vector<vec3> &points) { benchmark::do_not_optimize(kernels::bounding_box(points)); });
+
+
+static const bool vec3_translate = details::register_bulk_operation(
+        "vec3_translate",
+        [](std::vector<vec3> &points) {
+            for (auto &p : points) {
+                p.x = static_cast<float>(p.x + details::offset.x);
+                p.y = static_cast<float>(p.y + details::offset.y);
+                p.z = static_cast<float>(p.z + details::offset.z);
+            }
+        },
+        [](std::vector<vec3> &points) { kernels::translate(points, details::offset); });
+
+
+static const bool vec3_transform = details::register_bulk_operation(
+        "vec3_transform",
+        [](std::vector<vec3> &points) {
+            for (auto &p : points)
+                p = details::rigid * p;
+        },
+        [](std::vector<vec3> &points) { kernels::transform(points, details::rigid); });
+
+
+static const bool vec3_normalize = details::register_bulk_operation(
+        "vec3_normalize",
+        [](std::vector<vec3> &points) {
+            for (auto &p : points)
+                p.normalize();
+        },
+        [](std::vector<vec3> &points) { kernels::normalize(points); });
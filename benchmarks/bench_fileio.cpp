@@ -0,0 +1,144 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+// Benchmarks of the loaders and savers of all the file formats that can be both written and read, using synthetic
+// models. The files are written into Options::data_directory and deleted afterwards. The trilist and geojson formats
+// can only be read, so they are not covered.
+
+#include "benchmark.h"
+#include "synthetic_data.h"
+
+#include <cstdio>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/fileio/point_cloud_io.h>
+#include <easy3d/fileio/surface_mesh_io.h>
+#include <easy3d/fileio/graph_io.h>
+#include <easy3d/fileio/poly_mesh_io.h>
+
+
+using namespace easy3d;
+
+
+namespace details {
+
+    template<typename Model>
+    Model *create(std::size_t size, const std::string &ext);
+
+    // LAS/LAZ files can not store normals
+    template<>
+    PointCloud *create<PointCloud>(std::size_t size, const std::string &ext) {
+        return benchmark::torus_cloud(size, ext != "las");
+    }
+
+    template<>
+    SurfaceMesh *create<SurfaceMesh>(std::size_t size, const std::string &) { return benchmark::torus_mesh(size); }
+
+    template<>
+    Graph *create<Graph>(std::size_t size, const std::string &) { return benchmark::grid_graph(size); }
+
+    template<>
+    PolyMesh *create<PolyMesh>(std::size_t size, const std::string &ext) {
+        // MESH files can only store tetrahedra
+        return ext == "mesh" ? benchmark::tetrahedral_grid(size) : benchmark::hexahedral_grid(size);
+    }
+
+
+    template<typename IO, typename Model>
+    void save(benchmark::State &state, const std::string &ext) {
+        Model *model = create<Model>(state.arg(), ext);
+        const std::string file = benchmark::temporary_file("save", ext);
+        bool success = true;
+        while (state.keep_running())
+            success = IO::save(file, model) && success;
+        if (!success)
+            state.skip("failed saving the model");
+        state.set_bytes_processed(state.iterations() * benchmark::file_size(file));
+        std::remove(file.c_str());
+        delete model;
+    }
+
+
+    template<typename IO, typename Model>
+    void load(benchmark::State &state, const std::string &ext) {
+        const std::string file = benchmark::temporary_file("load", ext);
+        Model *model = create<Model>(state.arg(), ext);
+        const bool saved = IO::save(file, model);
+        delete model;
+        if (!saved) {
+            state.skip("failed saving the model");
+            return;
+        }
+
+        bool success = true;
+        while (state.keep_running()) {
+            model = IO::load(file);
+            state.pause_timing();
+            success = (model != nullptr) && success;
+            delete model;
+            state.resume_timing();
+        }
+        if (!success)
+            state.skip("failed loading the model");
+        state.set_bytes_processed(state.iterations() * benchmark::file_size(file));
+        std::remove(file.c_str());
+    }
+}
+
+
+#define EASY3D_FILEIO_BENCHMARKS(IO, Model, ext, size)                                                  \
+    void save_##Model##_##ext(benchmark::State &state) { details::save<IO, Model>(state, #ext); }      \
+    EASY3D_BENCHMARK(save_##Model##_##ext)->arg(size);                                                  \
+    void load_##Model##_##ext(benchmark::State &state) { details::load<IO, Model>(state, #ext); }      \
+    EASY3D_BENCHMARK(load_##Model##_##ext)->arg(size)
+
+
+EASY3D_FILEIO_BENCHMARKS(PointCloudIO, PointCloud, ply, 1000000);
+EASY3D_FILEIO_BENCHMARKS(PointCloudIO, PointCloud, bin, 1000000);
+EASY3D_FILEIO_BENCHMARKS(PointCloudIO, PointCloud, xyz, 1000000);
+EASY3D_FILEIO_BENCHMARKS(PointCloudIO, PointCloud, bxyz, 1000000);
+EASY3D_FILEIO_BENCHMARKS(PointCloudIO, PointCloud, las, 1000000);
+EASY3D_FILEIO_BENCHMARKS(PointCloudIO, PointCloud, vg, 1000000);
+EASY3D_FILEIO_BENCHMARKS(PointCloudIO, PointCloud, bvg, 1000000);
+EASY3D_FILEIO_BENCHMARKS(PointCloudIO, PointCloud, snap, 1000000);
+
+EASY3D_FILEIO_BENCHMARKS(SurfaceMeshIO, SurfaceMesh, ply, 1000000);
+EASY3D_FILEIO_BENCHMARKS(SurfaceMeshIO, SurfaceMesh, sm, 1000000);
+EASY3D_FILEIO_BENCHMARKS(SurfaceMeshIO, SurfaceMesh, obj, 1000000);
+EASY3D_FILEIO_BENCHMARKS(SurfaceMeshIO, SurfaceMesh, off, 1000000);
+EASY3D_FILEIO_BENCHMARKS(SurfaceMeshIO, SurfaceMesh, stl, 1000000);
+EASY3D_FILEIO_BENCHMARKS(SurfaceMeshIO, SurfaceMesh, snap, 1000000);
+
+EASY3D_FILEIO_BENCHMARKS(GraphIO, Graph, ply, 1000000);
+EASY3D_FILEIO_BENCHMARKS(GraphIO, Graph, snap, 1000000);
+
+EASY3D_FILEIO_BENCHMARKS(PolyMeshIO, PolyMesh, plm, 100000);
+EASY3D_FILEIO_BENCHMARKS(PolyMeshIO, PolyMesh, pm, 100000);
+EASY3D_FILEIO_BENCHMARKS(PolyMeshIO, PolyMesh, mesh, 100000);
+EASY3D_FILEIO_BENCHMARKS(PolyMeshIO, PolyMesh, snap, 100000);
@@ -0,0 +1,122 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+// Benchmarks of the kd-tree backends: construction, K nearest neighbors, and fixed-radius queries.
+
+#include "benchmark.h"
+#include "synthetic_data.h"
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/kdtree/kdtree_search_ann.h>
+#include <easy3d/kdtree/kdtree_search_eth.h>
+#include <easy3d/kdtree/kdtree_search_flann.h>
+#include <easy3d/kdtree/kdtree_search_nanoflann.h>
+
+
+using namespace easy3d;
+
+
+namespace details {
+
+    template<typename KdTree>
+    KdTree *build(PointCloud *cloud) {
+        KdTree *tree = new KdTree;
+        tree->begin();
+        tree->add_point_cloud(cloud);
+        tree->end();
+        return tree;
+    }
+
+    template<typename KdTree>
+    void kdtree_build(benchmark::State &state) {
+        PointCloud *cloud = benchmark::torus_cloud(state.arg(), false);
+        while (state.keep_running()) {
+            KdTree *tree = build<KdTree>(cloud);
+            state.pause_timing();
+            delete tree;
+            state.resume_timing();
+        }
+        state.set_items_processed(state.iterations() * cloud->n_vertices());
+        delete cloud;
+    }
+
+    // the points of the cloud are used as the queries
+    template<typename KdTree>
+    void kdtree_knn(benchmark::State &state) {
+        PointCloud *cloud = benchmark::torus_cloud(state.arg(), false);
+        KdTree *tree = build<KdTree>(cloud);
+        const auto &points = cloud->points();
+        std::vector<int> neighbors;
+        while (state.keep_running()) {
+            for (const auto &p : points) {
+                tree->find_closest_k_points(p, 16, neighbors);
+                benchmark::do_not_optimize(neighbors.data());
+            }
+        }
+        state.set_items_processed(state.iterations() * points.size());
+        delete tree;
+        delete cloud;
+    }
+
+    // the radius is chosen such that each query returns about 16 points (for the default sizes)
+    template<typename KdTree>
+    void kdtree_radius(benchmark::State &state) {
+        PointCloud *cloud = benchmark::torus_cloud(state.arg(), false);
+        KdTree *tree = build<KdTree>(cloud);
+        const auto &points = cloud->points();
+        // the area of the torus is 4 * pi^2 * R * r
+        const float density = static_cast<float>(points.size() / (4.0 * M_PI * M_PI * 1.0 * 0.4));
+        const float squared_radius = static_cast<float>(16.0 / (M_PI * density));
+        std::vector<int> neighbors;
+        std::size_t num_neighbors = 0;
+        while (state.keep_running()) {
+            for (const auto &p : points) {
+                tree->find_points_in_range(p, squared_radius, neighbors);
+                num_neighbors += neighbors.size();
+            }
+        }
+        state.set_items_processed(state.iterations() * points.size());
+        if (state.iterations() > 0)
+            state.counters["neighbors"] = static_cast<double>(num_neighbors) / (state.iterations() * points.size());
+        delete tree;
+        delete cloud;
+    }
+}
+
+
+#define EASY3D_KDTREE_BENCHMARKS(KdTree)                                                               \
+    void build_##KdTree(benchmark::State &state) { details::kdtree_build<KdTree>(state); }             \
+    EASY3D_BENCHMARK(build_##KdTree)->arg(100000)->arg(1000000);                                       \
+    void knn_##KdTree(benchmark::State &state) { details::kdtree_knn<KdTree>(state); }                 \
+    EASY3D_BENCHMARK(knn_##KdTree)->arg(100000)->arg(1000000);                                         \
+    void radius_##KdTree(benchmark::State &state) { details::kdtree_radius<KdTree>(state); }           \
+    EASY3D_BENCHMARK(radius_##KdTree)->arg(100000)->arg(1000000)
+
+
+EASY3D_KDTREE_BENCHMARKS(KdTreeSearch_ANN);
+EASY3D_KDTREE_BENCHMARKS(KdTreeSearch_ETH);
+EASY3D_KDTREE_BENCHMARKS(KdTreeSearch_FLANN);
+EASY3D_KDTREE_BENCHMARKS(KdTreeSearch_NanoFLANN);
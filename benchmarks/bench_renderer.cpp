@@ -0,0 +1,173 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+// Benchmarks of buffers::update(), i.e., preparing the rendering buffers of the drawables from the models (and
+// uploading them). An OpenGL context is created by OffScreen, so no window (or display) is required. The benchmarks
+// are skipped if no context can be created.
+
+#include "benchmark.h"
+#include "synthetic_data.h"
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/renderer/buffers.h>
+#include <easy3d/renderer/drawable_points.h>
+#include <easy3d/renderer/drawable_lines.h>
+#include <easy3d/renderer/drawable_triangles.h>
+#include <easy3d/algo/reordering.h>
+#include <easy3d/viewer/offscreen.h>
+
+
+using namespace easy3d;
+
+
+namespace details {
+
+    // the drawables must be destroyed before the context (i.e., before the OffScreen)
+    template<typename Model, typename Drawable>
+    void update(benchmark::State &state, Model *model, Drawable *drawable, std::size_t num_elements) {
+        while (state.keep_running())
+            buffers::update(model, drawable);
+        state.set_items_processed(state.iterations() * num_elements);
+    }
+
+}
+
+
+void buffers_point_cloud_points(benchmark::State &state) {
+    OffScreen os(64, 64, 0);
+    if (!os.is_valid()) {
+        state.skip("no OpenGL context");
+        return;
+    }
+    PointCloud *cloud = benchmark::torus_cloud(state.arg(), true);
+    {
+        PointsDrawable drawable("vertices", cloud);
+        details::update(state, cloud, &drawable, cloud->n_vertices());
+    }
+    delete cloud;
+}
+EASY3D_BENCHMARK(buffers_point_cloud_points)->arg(1000000);
+
+
+void buffers_surface_mesh_triangles(benchmark::State &state) {
+    OffScreen os(64, 64, 0);
+    if (!os.is_valid()) {
+        state.skip("no OpenGL context");
+        return;
+    }
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    {
+        TrianglesDrawable drawable("faces", mesh);
+        details::update(state, mesh, &drawable, mesh->n_faces());
+    }
+    delete mesh;
+}
+EASY3D_BENCHMARK(buffers_surface_mesh_triangles)->arg(1000000);
+
+
+void buffers_surface_mesh_edges(benchmark::State &state) {
+    OffScreen os(64, 64, 0);
+    if (!os.is_valid()) {
+        state.skip("no OpenGL context");
+        return;
+    }
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    {
+        LinesDrawable drawable("edges", mesh);
+        details::update(state, mesh, &drawable, mesh->n_edges());
+    }
+    delete mesh;
+}
+EASY3D_BENCHMARK(buffers_surface_mesh_edges)->arg(1000000);
+
+
+// a scalar field on the vertices. The field changes in each iteration (and the cached statistics are discarded as
+// Renderer::update() does), so its statistics are computed each time.
+void buffers_surface_mesh_scalar_field(benchmark::State &state) {
+    OffScreen os(64, 64, 0);
+    if (!os.is_valid()) {
+        state.skip("no OpenGL context");
+        return;
+    }
+    SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+    auto height = mesh->add_vertex_property<float>("v:height");
+    for (auto v : mesh->vertices())
+        height[v] = mesh->position(v).z;
+    {
+        TrianglesDrawable drawable("faces", mesh);
+        drawable.set_scalar_coloring(State::VERTEX, "v:height");
+        while (state.keep_running()) {
+            state.pause_timing();
+            height[SurfaceMesh::Vertex(0)] += 0.001f;
+            buffers::invalidate_statistics(mesh);
+            state.resume_timing();
+            buffers::update(mesh, &drawable);
+        }
+        state.set_items_processed(state.iterations() * mesh->n_faces());
+    }
+    delete mesh;
+}
+EASY3D_BENCHMARK(buffers_surface_mesh_scalar_field)->arg(1000000);
+
+
+namespace details {
+
+    // renders (and reads back a tiny image of) a large mesh, so the time is dominated by the vertex processing
+    void draw(benchmark::State &state, bool optimized) {
+        OffScreen os(64, 64, 0);
+        if (!os.is_valid()) {
+            state.skip("no OpenGL context");
+            return;
+        }
+        SurfaceMesh *mesh = benchmark::torus_mesh(state.arg());
+        benchmark::shuffle(mesh);
+        if (optimized)
+            Reordering::optimize_vertex_cache(mesh);
+        const std::size_t num_faces = mesh->n_faces();
+        os.add_model(mesh);     // owned by the OffScreen
+        std::vector<unsigned char> rgba;
+        os.render(rgba);        // creates the buffers and fits the camera
+        while (state.keep_running())
+            os.render(rgba, false);
+        state.set_items_processed(state.iterations() * num_faces);
+    }
+
+}
+
+
+// draws a mesh with the elements in random order
+void draw_surface_mesh_shuffled(benchmark::State &state) {
+    details::draw(state, false);
+}
+EASY3D_BENCHMARK(draw_surface_mesh_shuffled)->arg(1000000);
+
+
+// draws a mesh with the faces and vertices ordered for the vertex cache
+void draw_surface_mesh_optimized(benchmark::State &state) {
+    details::draw(state, true);
+}
+EASY3D_BENCHMARK(draw_surface_mesh_optimized)->arg(1000000);
@@ -0,0 +1,436 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include "benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#include <easy3d/core/version.h>
+#include <easy3d/util/file_system.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace easy3d {
+
+    namespace benchmark {
+
+        State::State(long long arg, std::size_t max_iterations)
+                : arg_(arg), max_iterations_(max_iterations), num_iterations_(0), running_(false), skipped_(false),
+                  cpu_start_(0), real_time_(0.0), cpu_time_(0.0), items_processed_(0), bytes_processed_(0) {
+        }
+
+
+        bool State::keep_running() {
+            if (skipped_)
+                return false;
+            if (num_iterations_ == 0 && !running_)
+                resume_timing();
+            if (num_iterations_ < max_iterations_) {
+                ++num_iterations_;
+                return true;
+            }
+            pause_timing();
+            return false;
+        }
+
+
+        void State::pause_timing() {
+            if (!running_)
+                return;
+            real_time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start_).count();
+            cpu_time_ += static_cast<double>(std::clock() - cpu_start_) / CLOCKS_PER_SEC;
+            running_ = false;
+        }
+
+
+        void State::resume_timing() {
+            if (running_)
+                return;
+            real_start_ = std::chrono::steady_clock::now();
+            cpu_start_ = std::clock();
+            running_ = true;
+        }
+
+
+        void State::skip(const std::string &reason) {
+            skipped_ = true;
+            error_ = reason;
+        }
+
+
+        namespace details {
+
+            std::vector<Benchmark *> &registry() {
+                static std::vector<Benchmark *> benchmarks;
+                return benchmarks;
+            }
+
+            Options &current_options() {
+                static Options options;
+                return options;
+            }
+
+            struct Result {
+                std::string name;
+                std::size_t iterations;
+                double real_time;  // per iteration, in nanoseconds
+                double cpu_time;   // per iteration, in nanoseconds
+                double items_per_second;
+                double bytes_per_second;
+                std::string label;
+                std::string error;
+                std::map<std::string, double> counters;
+            };
+
+            std::string escape(const std::string &s) {
+                std::string result;
+                for (auto c : s) {
+                    if (c == '"' || c == '\\')
+                        result += '\\';
+                    if (c == '\n')
+                        result += "\\n";
+                    else
+                        result += c;
+                }
+                return result;
+            }
+
+            std::string time_string(double ns) {
+                char buf[64];
+                if (ns < 1e3)
+                    std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+                else if (ns < 1e6)
+                    std::snprintf(buf, sizeof(buf), "%.2f us", ns * 1e-3);
+                else if (ns < 1e9)
+                    std::snprintf(buf, sizeof(buf), "%.2f ms", ns * 1e-6);
+                else
+                    std::snprintf(buf, sizeof(buf), "%.3f s", ns * 1e-9);
+                return buf;
+            }
+
+            std::string rate_string(double per_second, const char *unit) {
+                char buf[64];
+                if (per_second >= 1e9)
+                    std::snprintf(buf, sizeof(buf), "%.2fG %s/s", per_second * 1e-9, unit);
+                else if (per_second >= 1e6)
+                    std::snprintf(buf, sizeof(buf), "%.2fM %s/s", per_second * 1e-6, unit);
+                else if (per_second >= 1e3)
+                    std::snprintf(buf, sizeof(buf), "%.2fk %s/s", per_second * 1e-3, unit);
+                else
+                    std::snprintf(buf, sizeof(buf), "%.2f %s/s", per_second, unit);
+                return buf;
+            }
+
+            std::string date_string() {
+                const std::time_t now = std::time(nullptr);
+                char buf[64];
+                std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+                return buf;
+            }
+
+            int num_threads() {
+#ifdef _OPENMP
+                return omp_get_max_threads();
+#else
+                return 1;
+#endif
+            }
+
+            // Reads the real time of each benchmark from a result file written by save(), which has one benchmark
+            // per line.
+            std::map<std::string, double> load_real_times(const std::string &file_name) {
+                std::map<std::string, double> times;
+                std::ifstream input(file_name.c_str());
+                if (!input.is_open()) {
+                    std::cerr << "could not open baseline file: " << file_name << std::endl;
+                    return times;
+                }
+                const std::string name_key = "\"name\": \"";
+                const std::string time_key = "\"real_time\": ";
+                std::string line;
+                while (std::getline(input, line)) {
+                    const std::size_t n = line.find(name_key);
+                    const std::size_t t = line.find(time_key);
+                    if (n == std::string::npos || t == std::string::npos)
+                        continue;
+                    const std::size_t begin = n + name_key.size();
+                    const std::size_t end = line.find('"', begin);
+                    if (end == std::string::npos)
+                        continue;
+                    times[line.substr(begin, end - begin)] = std::atof(line.c_str() + t + time_key.size());
+                }
+                return times;
+            }
+
+            bool save(const std::string &file_name, const std::vector<Result> &results, const Options &options) {
+                std::ofstream output(file_name.c_str());
+                if (!output.is_open()) {
+                    std::cerr << "could not open file for writing: " << file_name << std::endl;
+                    return false;
+                }
+                output.precision(10);
+                output << "{\n";
+                output << "  \"context\": {\n";
+                output << "    \"date\": \"" << date_string() << "\",\n";
+                output << "    \"executable\": \"" << escape(file_system::executable()) << "\",\n";
+                output << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+                output << "    \"num_threads\": " << num_threads() << ",\n";
+#ifdef NDEBUG
+                output << "    \"library_build_type\": \"release\",\n";
+#else
+                output << "    \"library_build_type\": \"debug\",\n";
+#endif
+                output << "    \"easy3d_version\": \"" << version() << "\",\n";
+                output << "    \"scale\": " << options.scale << ",\n";
+                output << "    \"min_time\": " << options.min_time << "\n";
+                output << "  },\n";
+                output << "  \"benchmarks\": [\n";
+                for (std::size_t i = 0; i < results.size(); ++i) {
+                    const Result &r = results[i];
+                    // one benchmark per line, so the files can be diffed (and parsed by load_real_times())
+                    output << "    {\"name\": \"" << escape(r.name) << "\", \"run_name\": \"" << escape(r.name) << "\"";
+                    if (!r.error.empty())
+                        output << ", \"error_occurred\": true, \"error_message\": \"" << escape(r.error) << "\"";
+                    else {
+                        output << ", \"iterations\": " << r.iterations << ", \"real_time\": " << r.real_time
+                               << ", \"cpu_time\": " << r.cpu_time << ", \"time_unit\": \"ns\"";
+                        if (r.items_per_second > 0)
+                            output << ", \"items_per_second\": " << r.items_per_second;
+                        if (r.bytes_per_second > 0)
+                            output << ", \"bytes_per_second\": " << r.bytes_per_second;
+                        for (const auto &c : r.counters)
+                            output << ", \"" << escape(c.first) << "\": " << c.second;
+                        if (!r.label.empty())
+                            output << ", \"label\": \"" << escape(r.label) << "\"";
+                    }
+                    output << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+                }
+                output << "  ]\n";
+                output << "}\n";
+                return true;
+            }
+
+        } // namespace details
+
+
+        // runs the benchmarks and collects the results
+        class Runner {
+        public:
+            explicit Runner(const Options &options) : options_(options) {}
+
+            // runs a benchmark with an argument, repeating it with more iterations until it takes min_time
+            details::Result run(const Benchmark *benchmark, const std::string &name, long long arg) const {
+                const std::size_t max_iterations = benchmark->max_iterations_ > 0 ? benchmark->max_iterations_ : 1000000000;
+                std::size_t iterations = 1;
+                while (true) {
+                    State state(arg, iterations);
+                    benchmark->function_(state);
+
+                    details::Result result;
+                    result.name = name;
+                    result.error = state.error_;
+                    if (state.skipped_)
+                        return result;
+
+                    const double real = state.real_time_;
+                    if (real >= options_.min_time || iterations >= max_iterations) {
+                        const double n = static_cast<double>(std::max<std::size_t>(state.num_iterations_, 1));
+                        result.iterations = state.num_iterations_;
+                        result.real_time = real * 1e9 / n;
+                        result.cpu_time = state.cpu_time_ * 1e9 / n;
+                        result.items_per_second = real > 0 ? static_cast<double>(state.items_processed_) / real : 0;
+                        result.bytes_per_second = real > 0 ? static_cast<double>(state.bytes_processed_) / real : 0;
+                        result.label = state.label_;
+                        result.counters = state.counters;
+                        return result;
+                    }
+
+                    // predict the number of iterations reaching min_time (with some margin)
+                    double multiplier = 10.0;
+                    if (real > 0.0 && real / options_.min_time > 0.1)
+                        multiplier = std::min(10.0, std::max(1.4 * options_.min_time / real, 1.1));
+                    iterations = std::min(max_iterations,
+                                          static_cast<std::size_t>(std::ceil(static_cast<double>(iterations) * multiplier)));
+                }
+            }
+
+        private:
+            const Options &options_;
+        };
+
+
+        Benchmark *register_benchmark(const std::string &name, const Benchmark::Function &function) {
+            Benchmark *benchmark = new Benchmark(name, function);
+            details::registry().push_back(benchmark);
+            return benchmark;
+        }
+
+
+        const Options &options() {
+            return details::current_options();
+        }
+
+
+        bool Options::parse(int argc, char **argv) {
+            for (int i = 1; i < argc; ++i) {
+                const std::string option(argv[i]);
+                const std::size_t pos = option.find('=');
+                const std::string key = option.substr(0, pos);
+                const std::string value = (pos == std::string::npos) ? "" : option.substr(pos + 1);
+                if (key == "--filter")
+                    filter = value;
+                else if (key == "--min_time")
+                    min_time = std::atof(value.c_str());
+                else if (key == "--scale")
+                    scale = std::atof(value.c_str());
+                else if (key == "--out")
+                    output_file = value;
+                else if (key == "--compare")
+                    baseline_file = value;
+                else if (key == "--data_dir")
+                    data_directory = value;
+                else if (key == "--list")
+                    list_only = true;
+                else {
+                    if (key != "--help")
+                        std::cerr << "unknown option: " << option << std::endl;
+                    return false;
+                }
+            }
+            if (min_time <= 0.0 || scale <= 0.0) {
+                std::cerr << "min_time and scale must be positive" << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+
+        std::string Options::usage(const std::string &program) {
+            return "usage: " + program + " [options]\n"
+                   "  --filter=<string>   runs only the benchmarks whose names contain <string>\n"
+                   "  --min_time=<s>      the minimum time (in seconds) of each benchmark (default: 0.5)\n"
+                   "  --scale=<factor>    scales the problem sizes (default: 1.0)\n"
+                   "  --out=<file>        saves the results into <file> (in JSON format)\n"
+                   "  --compare=<file>    compares the results with a previous result file\n"
+                   "  --data_dir=<dir>    the directory for temporary files (default: the system temp directory)\n"
+                   "  --list              lists the benchmarks without running them\n";
+        }
+
+
+        int run(const Options &opts) {
+            Options &options = details::current_options();
+            options = opts;
+            if (options.data_directory.empty()) {
+                std::string tmp = ".";
+                for (const char *var : {"TMPDIR", "TEMP", "TMP"}) {
+                    const char *value = std::getenv(var);
+                    if (value && *value) {
+                        tmp = value;
+                        break;
+                    }
+                }
+                options.data_directory = tmp + "/easy3d_benchmarks";
+            }
+            if (!file_system::is_directory(options.data_directory) &&
+                !file_system::create_directory(options.data_directory)) {
+                std::cerr << "could not create directory: " << options.data_directory << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            std::map<std::string, double> baseline;
+            if (!options.baseline_file.empty())
+                baseline = details::load_real_times(options.baseline_file);
+
+            if (!options.list_only) {
+                std::printf("%-52s %14s %14s %12s  %s\n", "Benchmark", "Time", "CPU", "Iterations", "");
+                std::printf("%s\n", std::string(110, '-').c_str());
+            }
+
+            Runner runner(options);
+            std::vector<details::Result> results;
+            for (const Benchmark *benchmark : details::registry()) {
+                std::vector<long long> args = benchmark->args();
+                const bool has_args = !args.empty();
+                if (!has_args)
+                    args.push_back(0);
+                for (auto arg : args) {
+                    if (has_args)
+                        arg = std::max(1ll, static_cast<long long>(static_cast<double>(arg) * options.scale));
+                    const std::string name = benchmark->name() + (has_args ? "/" + std::to_string(arg) : "");
+                    if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+                        continue;
+                    if (options.list_only) {
+                        std::printf("%s\n", name.c_str());
+                        continue;
+                    }
+
+                    const details::Result r = runner.run(benchmark, name, arg);
+                    results.push_back(r);
+                    if (!r.error.empty()) {
+                        std::printf("%-52s SKIPPED: %s\n", r.name.c_str(), r.error.c_str());
+                        continue;
+                    }
+
+                    std::string info;
+                    if (r.items_per_second > 0)
+                        info += details::rate_string(r.items_per_second, "items") + " ";
+                    if (r.bytes_per_second > 0)
+                        info += details::rate_string(r.bytes_per_second, "B") + " ";
+                    const auto pos = baseline.find(r.name);
+                    if (pos != baseline.end() && pos->second > 0) {
+                        char buf[64];
+                        std::snprintf(buf, sizeof(buf), "[%+.1f%% vs. baseline] ",
+                                      (r.real_time - pos->second) / pos->second * 100.0);
+                        info += buf;
+                    }
+                    info += r.label;
+                    std::printf("%-52s %14s %14s %12zu  %s\n", r.name.c_str(), details::time_string(r.real_time).c_str(),
+                                details::time_string(r.cpu_time).c_str(), r.iterations, info.c_str());
+                    std::fflush(stdout);
+                }
+            }
+
+            if (!options.output_file.empty() && !options.list_only) {
+                if (!details::save(options.output_file, results, options))
+                    return EXIT_FAILURE;
+                std::printf("results saved to '%s'\n", options.output_file.c_str());
+            }
+            return EXIT_SUCCESS;
+        }
+
+    } // namespace benchmark
+
+} // namespace easy3d
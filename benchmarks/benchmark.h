@@ -0,0 +1,202 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_BENCHMARKS_BENCHMARK_H
+#define EASY3D_BENCHMARKS_BENCHMARK_H
+
+
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <ctime>
+#include <functional>
+
+
+namespace easy3d {
+
+    /**
+     * \brief A minimal, headless benchmark harness in the style of Google Benchmark.
+     * \namespace easy3d::benchmark
+     * \details A benchmark is a function taking a State, which runs the code to be measured in a loop:
+     *      \code
+     *          void bench_traversal(benchmark::State& state) {
+     *              SurfaceMesh* mesh = benchmark::torus_mesh(state.arg());   // setup, not measured
+     *              while (state.keep_running()) {
+     *                  for (auto v : mesh->vertices())
+     *                      benchmark::do_not_optimize(mesh->valence(v));
+     *              }
+     *              state.set_items_processed(state.iterations() * mesh->n_vertices());
+     *              delete mesh;
+     *          }
+     *          EASY3D_BENCHMARK(bench_traversal)->arg(100000)->arg(1000000);
+     *      \endcode
+     *      The loop is repeated with an increasing number of iterations until it takes at least the minimum time (see
+     *      Options::min_time), and the time per iteration of the last repetition is reported. The results are printed
+     *      and can be saved in the JSON format of Google Benchmark (so its tools, e.g., compare.py, also work), with
+     *      one benchmark per line, which makes the files easy to diff between commits.
+     */
+    namespace benchmark {
+
+        /// \brief The state of a running benchmark.
+        class State {
+        public:
+            State(long long arg, std::size_t max_iterations);
+
+            /// Returns true as long as the timed loop should continue. The timer starts at the first call.
+            bool keep_running();
+
+            /// Stops the timer, e.g., to prepare the input of the next iteration.
+            void pause_timing();
+            /// Restarts the timer after pause_timing().
+            void resume_timing();
+
+            /// The argument of the benchmark (usually the problem size, see Benchmark::arg()).
+            long long arg() const { return arg_; }
+            /// The number of iterations of the timed loop.
+            std::size_t iterations() const { return max_iterations_; }
+
+            /// Sets the number of items (e.g., vertices or queries) processed in all iterations.
+            void set_items_processed(std::size_t n) { items_processed_ = n; }
+            /// Sets the number of bytes (e.g., of a file) processed in all iterations.
+            void set_bytes_processed(std::size_t n) { bytes_processed_ = n; }
+            /// Sets a label, which is reported with the results.
+            void set_label(const std::string &label) { label_ = label; }
+
+            /// Marks the benchmark as skipped, e.g., if the required resources are not available. The timed loop
+            /// will not run (i.e., keep_running() returns false).
+            void skip(const std::string &reason);
+
+            /// User-defined counters, which are reported with the results.
+            std::map<std::string, double> counters;
+
+        private:
+            long long arg_;
+            std::size_t max_iterations_;
+            std::size_t num_iterations_;
+            bool running_;
+            bool skipped_;
+            std::chrono::steady_clock::time_point real_start_;
+            std::clock_t cpu_start_;
+            double real_time_;  // in seconds
+            double cpu_time_;   // in seconds
+            std::size_t items_processed_;
+            std::size_t bytes_processed_;
+            std::string label_;
+            std::string error_;
+
+            friend class Runner;
+        };
+
+
+        /// \brief A registered benchmark.
+        class Benchmark {
+        public:
+            typedef std::function<void(State &)> Function;
+
+            Benchmark(const std::string &name, const Function &function)
+                    : name_(name), function_(function), max_iterations_(0) {}
+
+            /// Adds a run with the argument \p a (usually the problem size, which is scaled by Options::scale).
+            Benchmark *arg(long long a) {
+                args_.push_back(a);
+                return this;
+            }
+
+            /// Limits the number of iterations, e.g., to 1 for expensive algorithms.
+            Benchmark *max_iterations(std::size_t n) {
+                max_iterations_ = n;
+                return this;
+            }
+
+            const std::string &name() const { return name_; }
+            const std::vector<long long> &args() const { return args_; }
+
+        private:
+            std::string name_;
+            Function function_;
+            std::vector<long long> args_;
+            std::size_t max_iterations_;
+
+            friend class Runner;
+        };
+
+
+        /// Registers a benchmark. Use EASY3D_BENCHMARK instead.
+        Benchmark *register_benchmark(const std::string &name, const Benchmark::Function &function);
+
+
+        /// \brief The options of a run, usually given on the command line (see parse()).
+        struct Options {
+            Options() : min_time(0.5), scale(1.0), list_only(false) {}
+            std::string filter;         ///< Runs only the benchmarks whose names contain this string.
+            double min_time;            ///< The minimum time (in seconds) of the timed loop of each benchmark.
+            double scale;               ///< The factor applied to the arguments (i.e., the problem sizes).
+            std::string output_file;    ///< The file to save the results (in JSON format).
+            std::string baseline_file;  ///< A previous result file (in JSON format) to compare the results with.
+            std::string data_directory; ///< The directory for temporary files (e.g., of the I/O benchmarks).
+            bool list_only;             ///< Lists the benchmarks without running them.
+
+            /// Parses the command line options. Returns false on errors (or if the usage has been requested).
+            bool parse(int argc, char **argv);
+
+            /// Returns the usage of the command line options.
+            static std::string usage(const std::string &program);
+        };
+
+
+        /// Runs all the registered benchmarks selected by the options. Returns 0 on success.
+        int run(const Options &options);
+
+
+        /// Returns the options of the current run, e.g., to get the directory for temporary files.
+        const Options &options();
+
+
+        /// Prevents the compiler from optimizing away the computation of \p value.
+        template<typename T>
+        inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            static volatile char sink;
+            sink = *reinterpret_cast<const volatile char *>(&value);
+#endif
+        }
+
+    } // namespace benchmark
+
+} // namespace easy3d
+
+
+/// Registers the benchmark function \p func. Runs with arguments can be added, e.g.,
+/// EASY3D_BENCHMARK(bench_build)->arg(1000)->arg(100000);
+#define EASY3D_BENCHMARK(func)                                                                              \
+    static ::easy3d::benchmark::Benchmark *easy3d_benchmark_##func =                                        \
+            ::easy3d::benchmark::register_benchmark(#func, func)
+
+
+#endif  // EASY3D_BENCHMARKS_BENCHMARK_H
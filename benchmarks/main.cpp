@@ -0,0 +1,50 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include "benchmark.h"
+
+#include <iostream>
+
+#include <easy3d/util/logging.h>
+
+
+// Usage examples:
+//  - run all the benchmarks and save the results:
+//      ./benchmarks --out=results.json
+//  - run the kd-tree benchmarks with smaller problem sizes, and compare them with a previous run:
+//      ./benchmarks --filter=KdTree --scale=0.1 --compare=results.json
+
+int main(int argc, char *argv[]) {
+    easy3d::logging::initialize(false, false, true);
+
+    easy3d::benchmark::Options options;
+    if (!options.parse(argc, argv)) {
+        std::cout << easy3d::benchmark::Options::usage(argv[0]) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return easy3d::benchmark::run(options);
+}
@@ -0,0 +1,233 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include "synthetic_data.h"
+#include "benchmark.h"
+
+#include <cmath>
+#include <random>
+#include <fstream>
+#include <algorithm>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+
+
+namespace easy3d {
+
+    namespace benchmark {
+
+        namespace details {
+            const float major_radius = 1.0f;
+            const float minor_radius = 0.4f;
+
+            // the point and the normal of a torus at the angles u and v
+            inline void torus(float u, float v, vec3 &p, vec3 &n) {
+                const float cu = std::cos(u), su = std::sin(u);
+                const float cv = std::cos(v), sv = std::sin(v);
+                n = vec3(cu * cv, su * cv, sv);
+                p = vec3(major_radius * cu, major_radius * su, 0.0f) + minor_radius * n;
+            }
+        }
+
+
+        SurfaceMesh *torus_mesh(std::size_t num_vertices) {
+            // the grid is twice as long along the major circle
+            const int m = std::max(3, static_cast<int>(std::sqrt(static_cast<double>(num_vertices) / 2.0)));
+            const int n = 2 * m;
+            const float two_pi = static_cast<float>(2.0 * M_PI);
+
+            SurfaceMesh *mesh = new SurfaceMesh;
+            mesh->reserve(n * m, 3 * n * m, 2 * n * m);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < m; ++j) {
+                    vec3 p, normal;
+                    details::torus(two_pi * i / n, two_pi * j / m, p, normal);
+                    mesh->add_vertex(p);
+                }
+            }
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < m; ++j) {
+                    const SurfaceMesh::Vertex v00(i * m + j);
+                    const SurfaceMesh::Vertex v10(((i + 1) % n) * m + j);
+                    const SurfaceMesh::Vertex v01(i * m + (j + 1) % m);
+                    const SurfaceMesh::Vertex v11(((i + 1) % n) * m + (j + 1) % m);
+                    mesh->add_triangle(v00, v10, v11);
+                    mesh->add_triangle(v00, v11, v01);
+                }
+            }
+            return mesh;
+        }
+
+
+        PointCloud *torus_cloud(std::size_t num_points, bool normals) {
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<float> angle(0.0f, static_cast<float>(2.0 * M_PI));
+
+            PointCloud *cloud = new PointCloud;
+            cloud->resize(static_cast<unsigned int>(num_points));
+            auto points = cloud->get_vertex_property<vec3>("v:point");
+            PointCloud::VertexProperty<vec3> nors;
+            if (normals)
+                nors = cloud->add_vertex_property<vec3>("v:normal");
+            for (auto v : cloud->vertices()) {
+                vec3 p, n;
+                details::torus(angle(rng), angle(rng), p, n);
+                points[v] = p;
+                if (normals)
+                    nors[v] = n;
+            }
+            return cloud;
+        }
+
+
+        Graph *grid_graph(std::size_t num_vertices) {
+            const int n = std::max(2, static_cast<int>(std::cbrt(static_cast<double>(num_vertices))));
+            Graph *graph = new Graph;
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    for (int k = 0; k < n; ++k)
+                        graph->add_vertex(vec3(static_cast<float>(i), static_cast<float>(j), static_cast<float>(k)));
+                }
+            }
+            auto index = [n](int i, int j, int k) -> Graph::Vertex { return Graph::Vertex((i * n + j) * n + k); };
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    for (int k = 0; k < n; ++k) {
+                        if (i + 1 < n) graph->add_edge(index(i, j, k), index(i + 1, j, k));
+                        if (j + 1 < n) graph->add_edge(index(i, j, k), index(i, j + 1, k));
+                        if (k + 1 < n) graph->add_edge(index(i, j, k), index(i, j, k + 1));
+                    }
+                }
+            }
+            return graph;
+        }
+
+
+        PolyMesh *hexahedral_grid(std::size_t num_cells) {
+            const int n = std::max(1, static_cast<int>(std::cbrt(static_cast<double>(num_cells))));
+            PolyMesh *mesh = new PolyMesh;
+            for (int i = 0; i <= n; ++i) {
+                for (int j = 0; j <= n; ++j) {
+                    for (int k = 0; k <= n; ++k)
+                        mesh->add_vertex(vec3(static_cast<float>(i), static_cast<float>(j), static_cast<float>(k)));
+                }
+            }
+            auto index = [n](int i, int j, int k) -> PolyMesh::Vertex {
+                return PolyMesh::Vertex((i * (n + 1) + j) * (n + 1) + k);
+            };
+            // the vertex order of add_hexa(): the back face (0, 1, 2, 3) at z = k and the front face (4, 5, 6, 7) at z = k + 1
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    for (int k = 0; k < n; ++k) {
+                        mesh->add_hexa(index(i, j, k), index(i + 1, j, k),
+                                       index(i + 1, j + 1, k), index(i, j + 1, k),
+                                       index(i, j, k + 1), index(i + 1, j, k + 1),
+                                       index(i + 1, j + 1, k + 1), index(i, j + 1, k + 1));
+                    }
+                }
+            }
+            return mesh;
+        }
+
+
+        PolyMesh *tetrahedral_grid(std::size_t num_cells) {
+            const int n = std::max(1, static_cast<int>(std::cbrt(static_cast<double>(num_cells) / 6.0)));
+            PolyMesh *mesh = new PolyMesh;
+            for (int i = 0; i <= n; ++i) {
+                for (int j = 0; j <= n; ++j) {
+                    for (int k = 0; k <= n; ++k)
+                        mesh->add_vertex(vec3(static_cast<float>(i), static_cast<float>(j), static_cast<float>(k)));
+                }
+            }
+            auto index = [n](const int c[3]) -> PolyMesh::Vertex {
+                return PolyMesh::Vertex((c[0] * (n + 1) + c[1]) * (n + 1) + c[2]);
+            };
+            // the Kuhn subdivision: each tetrahedron walks from the min to the max corner of the cube along the axes
+            // in the order of a permutation. The odd permutations are flipped to be positively oriented.
+            const int permutations[6][3] = {{0, 1, 2}, {1, 2, 0}, {2, 0, 1}, {0, 2, 1}, {2, 1, 0}, {1, 0, 2}};
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    for (int k = 0; k < n; ++k) {
+                        for (int p = 0; p < 6; ++p) {
+                            int c[3] = {i, j, k};
+                            PolyMesh::Vertex v[4];
+                            v[0] = index(c);
+                            for (int s = 0; s < 3; ++s) {
+                                ++c[permutations[p][s]];
+                                v[s + 1] = index(c);
+                            }
+                            if (p < 3)
+                                mesh->add_tetra(v[0], v[1], v[2], v[3]);
+                            else
+                                mesh->add_tetra(v[0], v[2], v[1], v[3]);
+                        }
+                    }
+                }
+            }
+            return mesh;
+        }
+
+
+        void shuffle(SurfaceMesh *mesh) {
+            std::mt19937 rng(42);
+            std::vector<SurfaceMesh::Vertex> vertices;
+            for (auto v : mesh->vertices())
+                vertices.push_back(v);
+            std::shuffle(vertices.begin(), vertices.end(), rng);
+            mesh->permute_vertices(vertices);
+
+            std::vector<SurfaceMesh::Edge> edges;
+            for (auto e : mesh->edges())
+                edges.push_back(e);
+            std::shuffle(edges.begin(), edges.end(), rng);
+            mesh->permute_edges(edges);
+
+            std::vector<SurfaceMesh::Face> faces;
+            for (auto f : mesh->faces())
+                faces.push_back(f);
+            std::shuffle(faces.begin(), faces.end(), rng);
+            mesh->permute_faces(faces);
+        }
+
+
+        std::string temporary_file(const std::string &name, const std::string &ext) {
+            return options().data_directory + "/" + name + "." + ext;
+        }
+
+
+        std::size_t file_size(const std::string &file_name) {
+            std::ifstream input(file_name.c_str(), std::ios::binary | std::ios::ate);
+            if (!input.is_open())
+                return 0;
+            return static_cast<std::size_t>(input.tellg());
+        }
+
+    } // namespace benchmark
+
+} // namespace easy3d
@@ -0,0 +1,81 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_BENCHMARKS_SYNTHETIC_DATA_H
+#define EASY3D_BENCHMARKS_SYNTHETIC_DATA_H
+
+
+#include <string>
+#include <cstddef>
+
+
+namespace easy3d {
+
+    class PointCloud;
+    class SurfaceMesh;
+    class Graph;
+    class PolyMesh;
+
+    namespace benchmark {
+
+        /// \name Synthetic models for benchmarking. The models are deterministic, so the results of different runs
+        /// (and commits) are comparable. The caller takes the ownership of the returned models.
+        //@{
+
+        /// A closed triangle mesh of a torus (i.e., a regular grid wrapped around twice) with about \p num_vertices
+        /// vertices. All vertices have valence 6.
+        SurfaceMesh *torus_mesh(std::size_t num_vertices);
+
+        /// A point cloud sampled (randomly) on a torus, with normals ("v:normal") if \p normals is true.
+        PointCloud *torus_cloud(std::size_t num_points, bool normals = true);
+
+        /// A graph of a 3D grid with about \p num_vertices vertices, each connected to its (up to 6) neighbors.
+        Graph *grid_graph(std::size_t num_vertices);
+
+        /// A polyhedral mesh of a 3D grid of about \p num_cells hexahedra.
+        PolyMesh *hexahedral_grid(std::size_t num_cells);
+
+        /// A polyhedral mesh of a 3D grid of about \p num_cells tetrahedra (i.e., each cube is split into 6 tetrahedra).
+        PolyMesh *tetrahedral_grid(std::size_t num_cells);
+
+        //@}
+
+        /// Shuffles the vertices, edges, and faces of a mesh (deterministically), as if it came from a scanner, so
+        /// neighboring elements are scattered in memory.
+        void shuffle(SurfaceMesh *mesh);
+
+        /// Returns the full path of a temporary file (in Options::data_directory) with the extension \p ext.
+        std::string temporary_file(const std::string &name, const std::string &ext);
+
+        /// Returns the size of a file in bytes.
+        std::size_t file_size(const std::string &file_name);
+
+    } // namespace benchmark
+
+} // namespace easy3d
+
+
+#endif  // EASY3D_BENCHMARKS_SYNTHETIC_DATA_H
@@ -15,6 +15,9 @@
 #include <fstream>
 #include <string>
 
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/kdtree/kdtree_search_nanoflann.h>
+
 
 namespace easy3d {
 
@@ -30,6 +33,17 @@ namespace easy3d {
             }
             return result;
         }
+
+        inline double orient_2d(const float *a, const float *b, const float *c) {
+            return (double(b[0]) - a[0]) * (double(c[1]) - a[1]) - (double(b[1]) - a[1]) * (double(c[0]) - a[0]);
+        }
+
+        inline double orient_3d(const float *a, const float *b, const float *c, const float *d) {
+            const double ax = double(a[0]) - d[0], ay = double(a[1]) - d[1], az = double(a[2]) - d[2];
+            const double bx = double(b[0]) - d[0], by = double(b[1]) - d[1], bz = double(b[2]) - d[2];
+            const double cx = double(c[0]) - d[0], cy = double(c[1]) - d[1], cz = double(c[2]) - d[2];
+            return ax * (by * cz - bz * cy) - ay * (bx * cz - bz * cx) + az * (bx * cy - by * cx);
+        }
     }
     // \endcond
 
@@ -45,16 +59,22 @@ namespace easy3d {
         cell_to_v_ = nullptr;
         cell_to_cell_ = nullptr;
         is_locked_ = false;
+        kdtree_points_ = nullptr;
+        kdtree_ = nullptr;
+        kdtree_built_.reset(new std::once_flag);
     }
 
 
     Delaunay::~Delaunay() {
+        delete kdtree_;
+        delete kdtree_points_;
     }
 
 
     void Delaunay::set_vertices(unsigned int nb_vertices, const float *vertices) {
         nb_vertices_ = nb_vertices;
         vertices_ = vertices;
+        clear_kdtree();
         if (nb_vertices_ < dimension() + 1) {
             LOG(WARNING) << "only " << nb_vertices << " vertices? not enough for Delaunay triangulation";
         }
@@ -72,13 +92,46 @@ namespace easy3d {
                 update_neighbors();
             }
         }
+        clear_kdtree();
+    }
+
+
+    void Delaunay::clear_kdtree() {
+        delete kdtree_;
+        delete kdtree_points_;
+        kdtree_ = nullptr;
+        kdtree_points_ = nullptr;
+        kdtree_built_.reset(new std::once_flag);
+    }
+
+
+    const KdTreeSearch *Delaunay::kdtree() const {
+        std::call_once(*kdtree_built_, [this]() {
+            if (nb_vertices() == 0 || dimension() > 3)
+                return;
+
+            kdtree_points_ = new PointCloud;
+            kdtree_points_->resize(nb_vertices());
+            auto &points = kdtree_points_->points();
+            for (unsigned int i = 0; i < nb_vertices(); ++i) {
+                const float *p = vertex_ptr(i);
+                points[i] = vec3(p[0], p[1], dimension() == 3 ? p[2] : 0.0f);
+            }
+            kdtree_ = new KdTreeSearch_NanoFLANN;
+            kdtree_->begin();
+            kdtree_->add_point_cloud(kdtree_points_);
+            kdtree_->end();
+        });
+        return kdtree_;
     }
 
 
     unsigned int Delaunay::nearest_vertex(const float *p) const {
-        // Inefficient implementation (but at least it works).
-        std::cerr << "TODO: replace with line walk (or maybe we could use kd-tree here)" << std::endl;
         assert(nb_vertices() > 0);
+        if (const KdTreeSearch *tree = kdtree())
+            return tree->find_closest_point(vec3(p[0], p[1], dimension() == 3 ? p[2] : 0.0f));
+
+        // higher dimensions: linear search
         unsigned int result = 0;
         float d = details::squared_distance(dimension(), vertex_ptr(0), p);
         for (unsigned int i = 1; i < nb_vertices(); i++) {
@@ -91,6 +144,144 @@ namespace easy3d {
         return result;
     }
 
+
+    unsigned int Delaunay::nearest_vertex(const float *p, unsigned int hint) const {
+        assert(hint < nb_vertices());
+        if (v_to_cell_.empty() || v_to_cell_[hint] < 0)
+            return nearest_vertex(p);
+
+        // greedy walk on the Delaunay graph: if a vertex is not the nearest one, one of its neighbors is closer
+        unsigned int cur = hint;
+        float d = details::squared_distance(dimension(), vertex_ptr(cur), p);
+        while (true) {
+            unsigned int best = cur;
+            const int first = v_to_cell_[cur];
+            int t = first;
+            do {
+                for (unsigned int lv = 0; lv < cell_size(); lv++) {
+                    const unsigned int w = cell_vertex(t, lv);
+                    const float dw = details::squared_distance(dimension(), vertex_ptr(w), p);
+                    if (dw < d) {
+                        d = dw;
+                        best = w;
+                    }
+                }
+                t = next_around_vertex(t, index(t, cur));
+            } while (t != first);
+
+            if (best == cur || v_to_cell_[best] < 0)
+                return best;
+            cur = best;
+        }
+    }
+
+
+    void Delaunay::nearest_vertices(const float *points, unsigned int n, std::vector<unsigned int> &result) const {
+        result.resize(n);
+        const int num = static_cast<int>(n);
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i)
+            result[i] = nearest_vertex(points + dimension() * i);
+    }
+
+
+    bool Delaunay::is_beyond_facet(unsigned int c, unsigned int lf, const float *p) const {
+        // the vertices of the facet are the ones other than lf
+        const float *opposite = vertex_ptr(cell_vertex(c, lf));
+        const float *f[3];
+        for (unsigned int lv = 0, k = 0; lv < cell_size(); lv++) {
+            if (lv != lf)
+                f[k++] = vertex_ptr(cell_vertex(c, lv));
+        }
+        if (dimension() == 2)
+            return details::orient_2d(f[0], f[1], p) * details::orient_2d(f[0], f[1], opposite) < 0.0;
+        else
+            return details::orient_3d(f[0], f[1], f[2], p) * details::orient_3d(f[0], f[1], f[2], opposite) < 0.0;
+    }
+
+
+    int Delaunay::locate(const float *p, int hint) const {
+        if (nb_cells() == 0 || cell_to_cell_ == nullptr)
+            return -1;
+        if (dimension() > 3) {
+            LOG(ERROR) << "point location is implemented only for 2D and 3D";
+            return -1;
+        }
+
+        int cur = hint;
+        if (cur < 0 || cur >= static_cast<int>(nb_cells())) {
+            cur = v_to_cell_[nearest_vertex(p)];
+            if (cur < 0)    // a duplicated vertex
+                cur = 0;
+        }
+
+        // remembering stochastic walk (Devillers et al. Walking in a triangulation. 2002): visit the facets in a
+        // random order, and never test the facet through which the current cell was entered
+        unsigned int seed = static_cast<unsigned int>(cur) * 2654435761u + 1u;
+        int prev = -1;
+        for (unsigned int step = 0; step <= nb_cells(); ++step) {
+            seed = seed * 1664525u + 1013904223u;
+            const unsigned int start = (seed >> 16) % cell_size();
+            int next = cur;
+            for (unsigned int i = 0; i < cell_size(); ++i) {
+                const unsigned int lf = (start + i) % cell_size();
+                const int neighbor = cell_adjacent(cur, lf);
+                if (neighbor == prev && prev >= 0)
+                    continue;
+                if (is_beyond_facet(cur, lf, p)) {
+                    next = neighbor;
+                    break;
+                }
+            }
+            if (next == cur)
+                return cur;     // p is inside (or on the boundary of) the current cell
+            if (next < 0)
+                return -1;      // p is outside the convex hull
+            prev = cur;
+            cur = next;
+        }
+
+        LOG(WARNING) << "point location did not terminate (degenerate triangulation?)";
+        return -1;
+    }
+
+
+    void Delaunay::locate(const float *points, unsigned int n, std::vector<int> &result) const {
+        result.resize(n);
+        const int num = static_cast<int>(n);
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i)
+            result[i] = locate(points + dimension() * i);
+    }
+
+
+    void Delaunay::get_vertex_cells(std::vector<unsigned int> &ptr, std::vector<unsigned int> &cells) const {
+        const unsigned int num = nb_vertices();
+        ptr.assign(num + 1, 0);
+        if (cell_to_v_ == nullptr) {
+            cells.clear();
+            return;
+        }
+
+        // a counting sort of the (cell, vertex) incidences (the cells are read sequentially, which is much faster
+        // than turning around the vertices)
+        for (unsigned int c = 0; c < nb_cells(); c++) {
+            for (unsigned int lv = 0; lv < cell_size(); lv++)
+                ++ptr[cell_vertex(c, lv) + 1];
+        }
+
+        for (unsigned int v = 0; v < num; ++v)
+            ptr[v + 1] += ptr[v];
+
+        cells.resize(ptr[num]);
+        std::vector<unsigned int> pos(ptr.begin(), ptr.end() - 1);
+        for (unsigned int c = 0; c < nb_cells(); c++) {
+            for (unsigned int lv = 0; lv < cell_size(); lv++)
+                cells[pos[cell_vertex(c, lv)]++] = c;
+        }
+    }
+
+
     void Delaunay::get_neighbors(unsigned int v, std::vector<unsigned int> &neighbors) const {
         assert(v < nb_vertices());
         if (neighbors_.size() != 0) {
@@ -114,7 +305,9 @@ namespace easy3d {
          * f may be anything that has an operator()(unsigned int i)
          */
 
-        for (unsigned int i = 0; i < nb_vertices(); ++i) {
+        const int num = static_cast<int>(nb_vertices());
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
             get_neighbors_internal(i, neighbors_[i]);
         }
 
@@ -12,6 +12,8 @@
 #define EASY3D_ALGO_DELAUNAY_H
 
 #include <cassert>
+#include <memory>
+#include <mutex>
 
 #include <easy3d/core/types.h>
 #include <easy3d/util/logging.h>
@@ -19,6 +21,9 @@
 
 namespace easy3d {
 
+    class PointCloud;
+    class KdTreeSearch;
+
     /// \brief Base class for Delaunay triangulation.
     /// \class Delaunay easy3d/algo/delaunay.h
     /// \see Delaunay2D, Delaunay3D.
@@ -60,8 +65,43 @@ namespace easy3d {
 
         const int *cell_to_cell() const { return cell_to_cell_; }
 
+        /**
+         * \brief Returns the index of the vertex nearest to point \p p.
+         * \details The query is answered by a kd-tree in O(log n) time. The kd-tree is built on the first query (after
+         *      the vertices or the triangulation change), so a triangulation that is never queried does not pay for it.
+         */
         virtual unsigned int nearest_vertex(const float *p) const;
 
+        /**
+         * \brief Returns the index of the vertex nearest to point \p p, starting the search from vertex \p hint.
+         * \details The search greedily walks along the Delaunay edges towards \p p, which is guaranteed to end at the
+         *      nearest vertex. This is faster than the kd-tree if \p hint is close to \p p, e.g., the result of the
+         *      previous query for spatially coherent queries.
+         */
+        unsigned int nearest_vertex(const float *p, unsigned int hint) const;
+
+        /**
+         * \brief Returns the index of the nearest vertex of each point.
+         * \param points The coordinates of the \p n query points (each having dimension() coordinates).
+         * \details The queries are answered in parallel using the kd-tree.
+         */
+        void nearest_vertices(const float *points, unsigned int n, std::vector<unsigned int> &result) const;
+
+        /**
+         * \brief Returns the index of the cell containing point \p p, or -1 if \p p is outside the convex hull.
+         * \details The cell is located by a remembering stochastic walk along the cell adjacencies, starting from
+         *      cell \p hint. If no hint is given (i.e., \p hint is negative), the walk starts from a cell incident to
+         *      the vertex nearest to \p p (found by the kd-tree), so it takes only a few steps.
+         */
+        int locate(const float *p, int hint = -1) const;
+
+        /**
+         * \brief Returns the index of the cell containing each point (or -1 if it is outside the convex hull).
+         * \param points The coordinates of the \p n query points (each having dimension() coordinates).
+         * \details The queries are answered in parallel, each walk starting from a cell incident to the nearest vertex.
+         */
+        void locate(const float *points, unsigned int n, std::vector<int> &result) const;
+
         /// \brief Returns the index of the \p lv_th vertex in the \p c_th cell.
         int cell_vertex(unsigned int c, unsigned int lv) const {
             assert(c < nb_cells());
@@ -107,6 +147,14 @@ namespace easy3d {
             return cicl_[cell_size() * c + lv];
         }
 
+        /**
+         * \brief Computes the cells incident to each vertex, in compressed row storage (CSR) format.
+         * \details The cells incident to vertex v are cells[ptr[v]], ..., cells[ptr[v + 1] - 1], in increasing
+         *      order. Compared to turning around the vertices using next_around_vertex(), the cells of a vertex are
+         *      stored contiguously, which is cache-friendly and allows processing the vertices in parallel.
+         */
+        void get_vertex_cells(std::vector<unsigned int> &ptr, std::vector<unsigned int> &cells) const;
+
         /**
          * \brief Retrieves the one-ring neighbors of vertex v.
          */
@@ -135,6 +183,16 @@ namespace easy3d {
 
         void update_neighbors();
 
+        // discards the kd-tree (it is rebuilt on the next query)
+        void clear_kdtree();
+
+        // returns the kd-tree of the vertices (building it on the first call), or nullptr if dimension() > 3.
+        // Thread-safe, so the first parallel queries don't race to build it.
+        const KdTreeSearch *kdtree() const;
+
+        // returns true if p is strictly on the other side of facet lf of cell c than the vertex opposite to it
+        bool is_beyond_facet(unsigned int c, unsigned int lf, const float *p) const;
+
         void set_next_around_vertex(
                 unsigned int c1, unsigned int lv, unsigned int c2
         ) {
@@ -158,6 +216,11 @@ namespace easy3d {
         std::vector<int> cicl_;
         std::vector <std::vector<unsigned int>> neighbors_;
         bool is_locked_;
+
+        // for nearest vertex queries (built lazily by kdtree())
+        mutable PointCloud *kdtree_points_;
+        mutable KdTreeSearch *kdtree_;
+        std::unique_ptr<std::once_flag> kdtree_built_;
     };
 
 }   // namespace easy3d
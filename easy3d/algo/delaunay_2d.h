@@ -46,6 +46,35 @@ namespace easy3d {
             return nearest_vertex(p.data());
         }
 
+        /// \brief Returns the vertex nearest to \p p, walking along the Delaunay edges from vertex \p hint.
+        unsigned int nearest_vertex(const vec2 &p, unsigned int hint) const {
+            return Delaunay::nearest_vertex(p.data(), hint);
+        }
+
+        /// \brief Returns the index of the nearest vertex of each point (computed in parallel).
+        void nearest_vertices(const std::vector<vec2> &points, std::vector<unsigned int> &result) const {
+            if (points.empty())
+                result.clear();
+            else
+                Delaunay::nearest_vertices(points[0].data(), (unsigned int) points.size(), result);
+        }
+
+        using Delaunay::locate;
+
+        /// \brief Returns the index of the triangle containing \p p (or -1 if \p p is outside the convex hull), walking
+        /// from the triangle \p hint.
+        int locate(const vec2 &p, int hint = -1) const {
+            return Delaunay::locate(p.data(), hint);
+        }
+
+        /// \brief Returns the index of the triangle containing each point (computed in parallel).
+        void locate(const std::vector<vec2> &points, std::vector<int> &result) const {
+            if (points.empty())
+                result.clear();
+            else
+                Delaunay::locate(points[0].data(), (unsigned int) points.size(), result);
+        }
+
         const vec2 &vertex(unsigned int i) const {
             return *(const vec2 *) vertex_ptr(i);
         }
@@ -48,8 +48,9 @@ namespace easy3d {
             tetgenbehavior tetgen_args_;
             // Q: quiet
             // n: output tet neighbors
+            // J: no jettison of duplicated vertices (otherwise the vertex indices no longer match the input)
             // V: verbose
-            tetgen_args_.parse_commandline((char *) ("Qn"));
+            tetgen_args_.parse_commandline((char *) ("QnJ"));
             ::tetrahedralize(&tetgen_args_, tetgen_in_, tetgen_out_);
         } catch (const std::exception& e) {
             LOG(ERROR) << "encountered a problem: " << e.what();
@@ -107,6 +108,17 @@ namespace easy3d {
             return false;
         }
 
+        inline double orient(const dvec3 &a, const dvec3 &b, const dvec3 &c, const dvec3 &d) {
+            return dot(b - a, cross(c - a, d - a));
+        }
+
+        inline dvec3 triangle_circumcenter(const dvec3 &a, const dvec3 &b, const dvec3 &c) {
+            const dvec3 ab = b - a;
+            const dvec3 ac = c - a;
+            const dvec3 n = cross(ab, ac);
+            return a + (cross(n, ab) * length2(ac) + cross(ac, n) * length2(ab)) / (2.0 * length2(n));
+        }
+
         inline unsigned int other(unsigned int i1, unsigned int i2, unsigned int i3) {
             for (unsigned int i = 0; i < 4; i++) {
                 if (i != i1 && i != i2 && i != i3) {
@@ -129,12 +141,29 @@ namespace easy3d {
             assert(!RoS_mode);
         }
         assert(v < nb_vertices());
+
+        // the tetrahedra incident to v
+        std::vector<unsigned int> tets;
+        unsigned int t = vertex_cell(v);
+        do {
+            tets.push_back(t);
+            t = next_around_vertex(t, index(t, v));
+        } while (t != vertex_cell(v));
+
+        get_voronoi_cell(v, tets.data(), (unsigned int) tets.size(), cell, geometry, nullptr);
+    }
+
+
+    void Delaunay3::get_voronoi_cell(
+            unsigned int v, const unsigned int *tets, unsigned int nb_tets, VoronoiCell3d &cell, bool geometry,
+            const std::vector<vec3> *circumcenters
+    ) const {
         cell.clear();
         std::vector<unsigned int> visited_neigh;
 
         // For each t incident to v
-        unsigned int t = vertex_cell(v);
-        do {
+        for (unsigned int i = 0; i < nb_tets; ++i) {
+            const unsigned int t = tets[i];
             unsigned int lvit = index(t, v);
 
             // For each edge (t,neigh) incident to v
@@ -142,17 +171,119 @@ namespace easy3d {
                 unsigned int neigh = tet_vertex(t, lv);
                 if (lv != lvit && !details::contains(visited_neigh, neigh)) {
                     visited_neigh.push_back(neigh);
-                    get_voronoi_facet(cell, t, lvit, lv, geometry);
+                    get_voronoi_facet(cell, t, lvit, lv, geometry, circumcenters);
                 }
             }
-            t = next_around_vertex(t, lvit);
-        } while (t != vertex_cell(v));
+        }
+    }
+
+
+    void Delaunay3::get_circumcenters(std::vector<vec3> &circumcenters) const {
+        const int num = static_cast<int>(nb_tets());
+        circumcenters.resize(num);
+#pragma omp parallel for
+        for (int t = 0; t < num; ++t)
+            circumcenters[t] = tet_circumcenter(t);
+    }
+
+
+    void Delaunay3::get_voronoi_cells(std::vector<VoronoiCell3d> &cells, bool geometry) const {
+        std::vector<unsigned int> ptr, tets;
+        get_vertex_cells(ptr, tets);
+
+        std::vector<vec3> circumcenters;
+        if (geometry)
+            get_circumcenters(circumcenters);
+
+        const int num = static_cast<int>(nb_vertices());
+        cells.clear();
+        cells.resize(num);
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (int v = 0; v < num; ++v) {
+            if (ptr[v + 1] > ptr[v]) {
+                get_voronoi_cell(v, tets.data() + ptr[v], ptr[v + 1] - ptr[v], cells[v], geometry,
+                                 geometry ? &circumcenters : nullptr);
+            }
+        }
+    }
+
+
+    void Delaunay3::get_voronoi_cell_volumes(std::vector<float> &volumes, std::vector<vec3> *centroids) const {
+        std::vector<unsigned int> ptr, tets;
+        get_vertex_cells(ptr, tets);
+
+        std::vector<vec3> circumcenters;
+        get_circumcenters(circumcenters);
+
+        const int num = static_cast<int>(nb_vertices());
+        volumes.assign(num, -1.0f);
+        if (centroids)
+            centroids->resize(num);
+
+        // The Voronoi facet dual to edge (v, w) is the union of the triangles (m, f, c) for each tetrahedron t
+        // incident to (v, w) and each of the two faces (v, w, x) of t containing (v, w), where m is the midpoint of
+        // (v, w), f the circumcenter of (v, w, x), and c the circumcenter of t. So the cell of v is the union of the
+        // tetrahedra (v, m, f, c), which are signed by the orientation of (v, w, x, y), y being the fourth vertex of
+        // t, to handle the circumcenters outside their simplices. This requires no turning around the edges.
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (int v = 0; v < num; ++v) {
+            const dvec3 p(vertex(v));
+            if (centroids)
+                (*centroids)[v] = vertex(v);
+
+            double volume = 0.0;
+            dvec3 centroid(0, 0, 0);
+            bool bounded = (ptr[v + 1] > ptr[v]);
+
+            for (unsigned int i = ptr[v]; bounded && i < ptr[v + 1]; ++i) {
+                const unsigned int t = tets[i];
+                const unsigned int lv = index(t, v);
+
+                // v is on the convex hull if one of its incident facets is on the convex hull
+                for (unsigned int lf = 0; lf < 4; ++lf) {
+                    if (lf != lv && tet_adjacent(t, lf) < 0)
+                        bounded = false;
+                }
+                if (!bounded)
+                    break;
+
+                dvec3 q[4];
+                for (unsigned int k = 0; k < 4; ++k)
+                    q[k] = dvec3(vertex(tet_vertex(t, k)));
+                const dvec3 c(circumcenters[t]);
+
+                dvec3 m[4];
+                for (unsigned int k = 0; k < 4; ++k)
+                    m[k] = (p + q[k]) * 0.5;
+
+                // each face (v, a, b) contributes to the facets dual to (v, a) and (v, b), with opposite signs
+                for (unsigned int ly = 0; ly < 4; ++ly) {
+                    if (ly == lv)
+                        continue;
+                    const unsigned int la = (ly + 1) % 4 == lv ? (ly + 2) % 4 : (ly + 1) % 4;
+                    const unsigned int lb = 6 - lv - ly - la;
+                    const dvec3 f = details::triangle_circumcenter(p, q[la], q[lb]);
+                    const double sign = details::orient(p, q[la], q[lb], q[ly]) > 0.0 ? 1.0 : -1.0;
+                    const double vol_a = sign * details::orient(p, m[la], f, c) / 6.0;
+                    const double vol_b = -sign * details::orient(p, m[lb], f, c) / 6.0;
+                    volume += vol_a + vol_b;
+                    centroid += vol_a * (p + m[la] + f + c) * 0.25 + vol_b * (p + m[lb] + f + c) * 0.25;
+                }
+            }
+
+            if (bounded) {
+                volumes[v] = static_cast<float>(volume);
+                if (centroids && volume > 0.0)
+                    (*centroids)[v] = vec3(centroid / volume);
+            }
+        }
     }
 
 
     void Delaunay3::get_voronoi_facet(
             VoronoiCell3d &cell, unsigned int t,
-            unsigned int lv1, unsigned int lv2, bool geometry
+            unsigned int lv1, unsigned int lv2, bool geometry,
+            const std::vector<vec3> *circumcenters
     ) const {
         unsigned int v1 = tet_vertex(t, lv1);
         unsigned int v2 = tet_vertex(t, lv2);
@@ -197,7 +328,8 @@ namespace easy3d {
             unsigned int lv3 = details::other(lv1, lv2, f);
 
             if (geometry) {
-                cell.add_to_facet(tet_vertex(cur, lv3), tet_circumcenter(cur), false);
+                cell.add_to_facet(tet_vertex(cur, lv3),
+                                  circumcenters ? (*circumcenters)[cur] : tet_circumcenter(cur), false);
             } else {
                 cell.add_to_facet(tet_vertex(cur, lv3), false);
             }
@@ -64,6 +64,35 @@ namespace easy3d {
             return nearest_vertex(p.data());
         }
 
+        /// \brief Returns the vertex nearest to \p p, walking along the Delaunay edges from vertex \p hint.
+        unsigned int nearest_vertex(const vec3 &p, unsigned int hint) const {
+            return Delaunay::nearest_vertex(p.data(), hint);
+        }
+
+        /// \brief Returns the index of the nearest vertex of each point (computed in parallel).
+        void nearest_vertices(const std::vector<vec3> &points, std::vector<unsigned int> &result) const {
+            if (points.empty())
+                result.clear();
+            else
+                Delaunay::nearest_vertices(points[0].data(), (unsigned int) points.size(), result);
+        }
+
+        using Delaunay::locate;
+
+        /// \brief Returns the index of the tet containing \p p (or -1 if \p p is outside the convex hull), walking
+        /// from the tet \p hint.
+        int locate(const vec3 &p, int hint = -1) const {
+            return Delaunay::locate(p.data(), hint);
+        }
+
+        /// \brief Returns the index of the tet containing each point (computed in parallel).
+        void locate(const std::vector<vec3> &points, std::vector<int> &result) const {
+            if (points.empty())
+                result.clear();
+            else
+                Delaunay::locate(points[0].data(), (unsigned int) points.size(), result);
+        }
+
         const vec3 &vertex(unsigned int i) const {
             return *(const vec3 *) vertex_ptr(i);
         }
@@ -119,12 +148,39 @@ namespace easy3d {
                 unsigned int v, VoronoiCell3d &cell, bool geometry = true
         ) const;
 
+        /**
+         * \brief Computes the Voronoi cells of all vertices.
+         * \details The cells are computed in parallel, sharing the vertex-tetrahedron incidences (see
+         *      get_vertex_cells()) and the circumcenters of the tetrahedra, which are computed only once.
+         */
+        void get_voronoi_cells(std::vector<VoronoiCell3d> &cells, bool geometry = true) const;
+
+        /**
+         * \brief Computes the volume (and optionally the centroid) of the Voronoi cell of each vertex, without
+         *      constructing the cells.
+         * \details The computation is done in parallel. The cells of the vertices on the convex hull are unbounded,
+         *      and their volumes are -1 (and their centroids are the vertices themselves). So are the cells of the
+         *      geometrically duplicated vertices.
+         */
+        void get_voronoi_cell_volumes(std::vector<float> &volumes, std::vector<vec3> *centroids = nullptr) const;
+
     protected:
+        // computes the Voronoi cell of vertex v given its incident tetrahedra (and optionally the precomputed
+        // circumcenters of all tetrahedra)
+        void get_voronoi_cell(
+                unsigned int v, const unsigned int *tets, unsigned int nb_tets, VoronoiCell3d &cell, bool geometry,
+                const std::vector<vec3> *circumcenters
+        ) const;
+
         void get_voronoi_facet(
                 VoronoiCell3d &cell, unsigned int t,
-                unsigned int lv1, unsigned int lv2, bool geometry
+                unsigned int lv1, unsigned int lv2, bool geometry,
+                const std::vector<vec3> *circumcenters = nullptr
         ) const;
 
+        // computes the circumcenters of all tetrahedra (in parallel)
+        void get_circumcenters(std::vector<vec3> &circumcenters) const;
+
         static unsigned int other_in_face(
                 unsigned int f, unsigned int lv1, unsigned int lv2
         ) {
@@ -30,6 +30,7 @@
 #include <easy3d/kdtree/kdtree_search_nanoflann.h>
 
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/tracing.h>
 
 
 #ifdef HAS_BOOST
@@ -50,7 +51,8 @@
 namespace easy3d {
 
     bool PointCloudNormals::estimate(PointCloud *cloud, unsigned int k /* = 16 */,
-                                     bool compute_curvature /* = false */) const {
+                                     bool compute_curvature /* = false */, const CancellationToken &token) const {
+        EASY3D_TRACE_ZONE_CATEGORY("PointCloudNormals::estimate", "algo");
         if (!cloud) {
             LOG(ERROR) << "empty input point cloud";
             return false;
@@ -77,8 +79,12 @@ namespace easy3d {
         w.restart();
         LOG(INFO) << "estimating normals...";
 
+        ProgressLogger progress(num, false, false, token);
 #pragma omp parallel for
         for (int i = 0; i < num; ++i) {
+            if (progress.is_canceled())
+                continue;
+
             const vec3 &p = points[i];
             std::vector<int> neighbors;
             kdtree.find_closest_k_points(p, k, neighbors);
@@ -99,6 +105,12 @@ namespace easy3d {
             if (compute_curvature)
                 (*curvatures)[i] = float(
                         pca.eigen_value(2) / (pca.eigen_value(0) + pca.eigen_value(1) + pca.eigen_value(2)));
+            progress.next();
+        }
+
+        if (progress.is_canceled()) {
+            LOG(WARNING) << "estimating normals cancelled";
+            return false;
         }
 
         LOG(INFO) << "done. " << w.time_string();
@@ -373,6 +385,7 @@ namespace easy3d {
 
 
     bool PointCloudNormals::reorient(PointCloud *cloud, unsigned int k) const {
+        EASY3D_TRACE_ZONE_CATEGORY("PointCloudNormals::reorient", "algo");
         if (!cloud) {
             LOG(ERROR) << "empty input point cloud";
             return false;
@@ -29,6 +29,8 @@
 
 #include <string>
 
+#include <easy3d/util/progress.h>
+
 
 namespace easy3d {
 
@@ -43,7 +45,10 @@ namespace easy3d {
         /// \param cloud The input point cloud.
         /// @param k: the number of neighboring points to construct the covariance matrix.
         /// @param compute_curvature: also computes the curvature?
-        bool estimate(PointCloud *cloud, unsigned int k = 16, bool compute_curvature = false) const;
+        /// @param token: a token to cancel the estimation (e.g., from another thread), in which case the normals
+        ///     are only partially computed and \c false is returned.
+        bool estimate(PointCloud *cloud, unsigned int k = 16, bool compute_curvature = false,
+                      const CancellationToken &token = CancellationToken()) const;
 
         /// \brief Reorients the point cloud normals.
         /// This method implements the normal reorientation method described in
@@ -32,6 +32,7 @@
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/tracing.h>
 
 #include <3rd_party/poisson/MyTime.h>
 #include <3rd_party/poisson/MemoryUsage.h>
@@ -195,7 +196,9 @@ namespace easy3d {
     }
     // \endcond
 
-    SurfaceMesh *PoissonReconstruction::apply(const PointCloud *cloud, const std::string &density_attr_name) {
+    SurfaceMesh *PoissonReconstruction::apply(const PointCloud *cloud, const std::string &density_attr_name,
+                                              const CancellationToken &token) {
+        EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction::apply", "algo");
         if (!cloud) {
             LOG(ERROR) << "nullptr point cloud";
             return nullptr;
@@ -244,8 +247,21 @@ namespace easy3d {
         REAL targetValue = (REAL) 0.5;
         XForm4x4<REAL> xForm, iXForm;
 
+        // releases the intermediate data if the reconstruction has been cancelled
+        auto cancelled = [&]() -> bool {
+            if (!token.is_canceled())
+                return false;
+            delete samples, samples = nullptr;
+            delete sampleData, sampleData = nullptr;
+            delete density, density = nullptr;
+            delete normalInfo, normalInfo = nullptr;
+            LOG(WARNING) << "Poisson surface reconstruction cancelled";
+            return true;
+        };
+
         { // Load the samples (and color data)
             LOG(INFO) << "loading data into tree... ";
+            EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: load samples", "algo");
             t.restart();
             profiler.start();
             const float *pts = cloud->points()[0];
@@ -288,6 +304,8 @@ namespace easy3d {
             LOG(INFO) << "input points/samples: " << pointCount << "/" << samples->size() <<
                       ". memory usage: " << float(MemoryInfo::Usage()) / (1 << 20) << " MB. " << t.time_string();
         }
+        if (cancelled())
+            return nullptr;
 
         //////////////////////////////////////////////////////////////////////////
 
@@ -301,6 +319,7 @@ namespace easy3d {
 
             // Get the kernel density estimator [If discarding, compute anew. Otherwise, compute once.]
             {
+                EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: density estimation", "algo");
                 t.restart();
                 profiler.start();
                 density = tree.setDensityEstimator<WEIGHT_DEGREE>(*samples, kernelDepth, samples_per_node_);
@@ -311,6 +330,7 @@ namespace easy3d {
             // Transform the Hermite samples into a vector field [If discarding, compute anew. Otherwise, compute once.]
             {
                 LOG(INFO) << "setting normal field... ";
+                EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: normal field", "algo");
                 t.restart();
                 profiler.start();
                 normalInfo = new SparseNodeData<Point3D<REAL>, NORMAL_DEGREE>();
@@ -321,11 +341,14 @@ namespace easy3d {
                 LOG(INFO) << "memory usage: " << float(MemoryInfo::Usage()) / (1 << 20) << " MB. "
                           << t.time_string();
             }
+            if (cancelled())
+                return nullptr;
 
             // Trim the tree and prepare for multi-grid
             {
                 LOG(INFO) << "trimming tree and preparing for multi-grid... ";
 
+                EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: multigrid preparation", "algo");
                 t.restart();
                 profiler.start();
                 std::vector<int> indexMap;
@@ -348,6 +371,7 @@ namespace easy3d {
 
             // Add the FEM constraints
             {
+                EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: FEM constraints", "algo");
                 t.restart();
                 profiler.start();
                 constraints = tree.initDenseNodeData<DEGREE>();
@@ -361,9 +385,12 @@ namespace easy3d {
             // Free up the normal info [If we don't need it for subsequent iterations.]
             delete normalInfo;
             normalInfo = nullptr;
+            if (cancelled())
+                return nullptr;
 
             // Add the interpolation constraints
             if (pointWeight_ > 0) {
+                EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: point constraints", "algo");
                 t.restart();
                 profiler.start();
                 int AdaptiveExponent = 1;
@@ -383,6 +410,7 @@ namespace easy3d {
             {
                 LOG(INFO) << "solving the linear system... ";
 
+                EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: solve", "algo");
                 t.restart();
                 profiler.start();
                 typename Octree<REAL>::SolverInfo solverInfo;
@@ -403,11 +431,14 @@ namespace easy3d {
                           << t.time_string();
             }
         }
+        if (cancelled())
+            return nullptr;
 
         // 	CoredFileMeshData< PlyVertex< Real > > mesh;		// no depth recorded, so can not trim
         // 	CoredFileMeshData< PlyColorVertex< Real > > mesh;	// no depth, but has color
         CoredFileMeshData<PlyColorAndValueVertex<REAL> > mesh;
         {
+            EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: iso-value", "algo");
             t.restart();
             profiler.start();
             double valueSum = 0, weightSum = 0;
@@ -434,6 +465,7 @@ namespace easy3d {
         {
             LOG(INFO) << "extracting mesh... ";
 
+            EASY3D_TRACE_ZONE_CATEGORY("PoissonReconstruction: extract mesh", "algo");
             t.restart();
             profiler.start();
             SparseNodeData<ProjectiveData<Point3D<REAL>, REAL>, DATA_DEGREE> *colorData = nullptr;
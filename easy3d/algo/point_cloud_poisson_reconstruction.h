@@ -30,6 +30,7 @@
 
 #include <string>
 
+#include <easy3d/util/progress.h>
 
 namespace easy3d {
 
@@ -62,7 +63,11 @@ namespace easy3d {
         void set_sampers_per_node(float s) { samples_per_node_ = s; }
 
         /// \brief reconstruction
-        SurfaceMesh *apply(const PointCloud *cloud, const std::string &density_attr_name = "v:density");
+        /// \param token A token to cancel the reconstruction (e.g., from another thread), in which case \c nullptr
+        ///     is returned. It is checked between the stages of the reconstruction (e.g., before and after solving
+        ///     the linear system), not within them.
+        SurfaceMesh *apply(const PointCloud *cloud, const std::string &density_attr_name = "v:density",
+                           const CancellationToken &token = CancellationToken());
 
         /// \brief Trim the reconstructed surface model based on the density attribute.
         static SurfaceMesh *trim(
@@ -0,0 +1,429 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#include <easy3d/algo/reordering.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/util/logging.h>
+#include <easy3d/util/tracing.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+
+namespace easy3d {
+
+    namespace details {
+
+        // the number of bits of the grid coordinates along each axis (3 * 21 = 63 bits of a curve index)
+        const int curve_bits = 21;
+
+        // spreads the lower 21 bits of x, such that there are two zero bits between each two of them
+        inline uint64_t spread_bits(uint64_t x) {
+            x &= 0x1fffff;
+            x = (x | x << 32) & 0x1f00000000ffffull;
+            x = (x | x << 16) & 0x1f0000ff0000ffull;
+            x = (x | x << 8) & 0x100f00f00f00f00full;
+            x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+            x = (x | x << 2) & 0x1249249249249249ull;
+            return x;
+        }
+
+        // the Morton index of a grid cell
+        inline uint64_t morton_index(const uint32_t x[3]) {
+            return (spread_bits(x[0]) << 2) | (spread_bits(x[1]) << 1) | spread_bits(x[2]);
+        }
+
+        // the Hilbert index of a grid cell, computed by transposing the coordinates (see John Skilling, "Programming
+        // the Hilbert curve", AIP Conference Proceedings 707, 2004), and then interleaving them like a Morton index.
+        inline uint64_t hilbert_index(const uint32_t c[3]) {
+            uint32_t x[3] = {c[0], c[1], c[2]};
+            const uint32_t m = 1u << (curve_bits - 1);
+            // inverse undo
+            for (uint32_t q = m; q > 1; q >>= 1) {
+                const uint32_t p = q - 1;
+                for (int i = 0; i < 3; ++i) {
+                    if (x[i] & q)
+                        x[0] ^= p;
+                    else {
+                        const uint32_t t = (x[0] ^ x[i]) & p;
+                        x[0] ^= t;
+                        x[i] ^= t;
+                    }
+                }
+            }
+            // Gray encode
+            for (int i = 1; i < 3; ++i)
+                x[i] ^= x[i - 1];
+            uint32_t t = 0;
+            for (uint32_t q = m; q > 1; q >>= 1) {
+                if (x[2] & q)
+                    t ^= q - 1;
+            }
+            for (int i = 0; i < 3; ++i)
+                x[i] ^= t;
+            return morton_index(x);
+        }
+
+
+        // a stable counting sort of the elements by their keys in [0, num_keys)
+        std::vector<int> order_by_keys(const std::vector<int> &keys, std::size_t num_keys) {
+            std::vector<int> start(num_keys + 1, 0);
+            for (auto k : keys)
+                ++start[k + 1];
+            for (std::size_t i = 0; i < num_keys; ++i)
+                start[i + 1] += start[i];
+            std::vector<int> order(keys.size());
+            for (std::size_t i = 0; i < keys.size(); ++i)
+                order[start[keys[i]]++] = static_cast<int>(i);
+            return order;
+        }
+
+
+        template <typename Handle>
+        std::vector<Handle> to_handles(const std::vector<int> &indices) {
+            std::vector<Handle> handles(indices.size());
+            for (std::size_t i = 0; i < indices.size(); ++i)
+                handles[i] = Handle(indices[i]);
+            return handles;
+        }
+
+
+        // the edges in the order of their first use by the faces (the remaining ones are kept at the end)
+        std::vector<SurfaceMesh::Edge> edges_in_face_order(const SurfaceMesh *mesh) {
+            std::vector<SurfaceMesh::Edge> order;
+            order.reserve(mesh->n_edges());
+            std::vector<bool> used(mesh->n_edges(), false);
+            for (auto f : mesh->faces()) {
+                for (auto h : mesh->halfedges(f)) {
+                    const auto e = mesh->edge(h);
+                    if (!used[e.idx()]) {
+                        used[e.idx()] = true;
+                        order.push_back(e);
+                    }
+                }
+            }
+            for (auto e : mesh->edges()) {
+                if (!used[e.idx()])
+                    order.push_back(e);
+            }
+            return order;
+        }
+
+
+        // The vertex score of Forsyth's "linear-speed vertex cache optimisation" (2006). The vertices of the last face
+        // get a fixed score, so the next face does not depend on their order. The score of the other cached vertices
+        // decreases with their age, and vertices with few remaining faces are boosted to avoid leaving lonely faces.
+        // The scores are looked up in tables, which are updated when the size of the last face changes.
+        class VertexScore {
+        public:
+            explicit VertexScore(unsigned int cache_size) : cache_size_(cache_size), last_face_size_(-1) {
+                valence_score_.resize(64);
+                for (std::size_t i = 1; i < valence_score_.size(); ++i)
+                    valence_score_[i] = valence_boost(static_cast<int>(i));
+                set_last_face_size(3);
+            }
+
+            void set_last_face_size(int size) {
+                if (size == last_face_size_)
+                    return;
+                last_face_size_ = size;
+                cache_score_.resize(cache_size_);
+                const int range = std::max(1, static_cast<int>(cache_size_) - size);
+                for (int i = 0; i < static_cast<int>(cache_size_); ++i) {
+                    if (i < size)
+                        cache_score_[i] = 0.75f;
+                    else
+                        cache_score_[i] = std::pow(1.0f - static_cast<float>(i - size) / range, 1.5f);
+                }
+            }
+
+            float operator()(int cache_position, int remaining_faces) const {
+                if (remaining_faces == 0)
+                    return -1.0f;
+                const float score = cache_position >= 0 ? cache_score_[cache_position] : 0.0f;
+                if (remaining_faces < static_cast<int>(valence_score_.size()))
+                    return score + valence_score_[remaining_faces];
+                return score + valence_boost(remaining_faces);
+            }
+
+        private:
+            static float valence_boost(int remaining_faces) {
+                return 2.0f / std::sqrt(static_cast<float>(remaining_faces));
+            }
+
+        private:
+            unsigned int cache_size_;
+            int last_face_size_;
+            std::vector<float> cache_score_;
+            std::vector<float> valence_score_;
+        };
+
+
+        // returns the faces in the order optimized for a LRU vertex cache of the given size
+        std::vector<SurfaceMesh::Face> vertex_cache_order(const SurfaceMesh *mesh, unsigned int cache_size) {
+            const int num_vertices = static_cast<int>(mesh->n_vertices());
+            const int num_faces = static_cast<int>(mesh->n_faces());
+
+            // the vertices of each face, and the (remaining) faces of each vertex
+            std::vector<int> face_start(num_faces + 1, 0), face_vertices;
+            face_vertices.reserve(mesh->n_halfedges());
+            std::vector<int> vertex_start(num_vertices + 1, 0);
+            for (auto f : mesh->faces()) {
+                for (auto v : mesh->vertices(f)) {
+                    face_vertices.push_back(v.idx());
+                    ++vertex_start[v.idx() + 1];
+                }
+                face_start[f.idx() + 1] = static_cast<int>(face_vertices.size());
+            }
+            for (int v = 0; v < num_vertices; ++v)
+                vertex_start[v + 1] += vertex_start[v];
+            std::vector<int> vertex_faces(face_vertices.size());
+            std::vector<int> remaining(num_vertices, 0);    // the active faces are the first ones of each vertex
+            for (int f = 0; f < num_faces; ++f) {
+                for (int i = face_start[f]; i < face_start[f + 1]; ++i) {
+                    const int v = face_vertices[i];
+                    vertex_faces[vertex_start[v] + remaining[v]++] = f;
+                }
+            }
+
+            VertexScore vertex_score(cache_size);
+            std::vector<int> cache_position(num_vertices, -1);
+            std::vector<float> vscore(num_vertices);
+            std::vector<float> fscore(num_faces, 0.0f);
+            for (int v = 0; v < num_vertices; ++v)
+                vscore[v] = vertex_score(-1, remaining[v]);
+            int best = -1;
+            for (int f = 0; f < num_faces; ++f) {
+                for (int i = face_start[f]; i < face_start[f + 1]; ++i)
+                    fscore[f] += vscore[face_vertices[i]];
+                if (best < 0 || fscore[f] > fscore[best])
+                    best = f;
+            }
+
+            std::vector<SurfaceMesh::Face> order;
+            order.reserve(num_faces);
+            std::vector<bool> emitted(num_faces, false);
+            std::vector<int> cache, new_cache;
+            std::vector<int> in_face(num_vertices, -1);
+            int next_unemitted = 0;
+            while (static_cast<int>(order.size()) < num_faces) {
+                if (best < 0) { // no cached vertex has remaining faces, so continue from the next face in the input
+                    while (emitted[next_unemitted])
+                        ++next_unemitted;
+                    best = next_unemitted;
+                }
+                const int f = best;
+                emitted[f] = true;
+                order.push_back(SurfaceMesh::Face(f));
+
+                // remove the face from its vertices, and put its vertices at the front of the cache
+                new_cache.clear();
+                for (int i = face_start[f]; i < face_start[f + 1]; ++i) {
+                    const int v = face_vertices[i];
+                    int *faces = vertex_faces.data() + vertex_start[v];
+                    std::swap(*std::find(faces, faces + remaining[v], f), faces[remaining[v] - 1]);
+                    --remaining[v];
+                    in_face[v] = f;
+                    new_cache.push_back(v);
+                }
+                for (auto v : cache) {
+                    if (in_face[v] != f)
+                        new_cache.push_back(v);
+                }
+
+                // update the scores of the vertices in the (old and new) cache and of their remaining faces
+                vertex_score.set_last_face_size(face_start[f + 1] - face_start[f]);
+                for (std::size_t i = 0; i < new_cache.size(); ++i) {
+                    const int v = new_cache[i];
+                    cache_position[v] = i < cache_size ? static_cast<int>(i) : -1;  // the rest is evicted
+                    const float score = vertex_score(cache_position[v], remaining[v]);
+                    const float delta = score - vscore[v];
+                    vscore[v] = score;
+                    for (int j = vertex_start[v]; j < vertex_start[v] + remaining[v]; ++j)
+                        fscore[vertex_faces[j]] += delta;
+                }
+                if (new_cache.size() > cache_size)
+                    new_cache.resize(cache_size);
+                cache.swap(new_cache);
+
+                // the next face is the best one using the cached vertices
+                best = -1;
+                for (auto v : cache) {
+                    for (int j = vertex_start[v]; j < vertex_start[v] + remaining[v]; ++j) {
+                        const int g = vertex_faces[j];
+                        if (best < 0 || fscore[g] > fscore[best])
+                            best = g;
+                    }
+                }
+            }
+            return order;
+        }
+
+    }
+
+
+    std::vector<int> Reordering::spatial_order(const std::vector<vec3> &points, Curve curve) {
+        Box3 box;
+        for (const auto &p : points)
+            box.grow(p);
+        // the same scale for all axes, so the curve is not distorted
+        const double max_cell = static_cast<double>((1u << details::curve_bits) - 1);
+        const double scale = (points.empty() || box.max_range() <= 0.0f) ? 0.0 : max_cell / box.max_range();
+
+        std::vector<std::pair<uint64_t, int> > keys(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            const vec3 d = points[i] - box.min_point();
+            uint32_t cell[3];
+            for (int j = 0; j < 3; ++j)
+                cell[j] = static_cast<uint32_t>(std::min(max_cell, std::max(0.0, d[j] * scale)));
+            const uint64_t key = (curve == HILBERT) ? details::hilbert_index(cell) : details::morton_index(cell);
+            keys[i] = std::make_pair(key, static_cast<int>(i));
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<int> order(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            order[i] = keys[i].second;
+        return order;
+    }
+
+
+    bool Reordering::apply(PointCloud *cloud, Curve curve) {
+        if (!cloud) {
+            LOG(ERROR) << "empty input point cloud";
+            return false;
+        }
+        EASY3D_TRACE_ZONE_CATEGORY("Reordering::apply(PointCloud)", "algo");
+        if (cloud->has_garbage())
+            cloud->collect_garbage();
+
+        const std::vector<int> order = spatial_order(cloud->points(), curve);
+        return cloud->permute_vertices(details::to_handles<PointCloud::Vertex>(order));
+    }
+
+
+    bool Reordering::apply(SurfaceMesh *mesh, Curve curve) {
+        if (!mesh) {
+            LOG(ERROR) << "empty input surface mesh";
+            return false;
+        }
+        EASY3D_TRACE_ZONE_CATEGORY("Reordering::apply(SurfaceMesh)", "algo");
+        if (mesh->has_garbage())
+            mesh->collect_garbage();
+
+        const std::vector<int> order = spatial_order(mesh->points(), curve);
+        if (!mesh->permute_vertices(details::to_handles<SurfaceMesh::Vertex>(order)))
+            return false;
+
+        // the faces and edges in the order of their first vertices
+        std::vector<int> keys(mesh->n_faces());
+        for (auto f : mesh->faces()) {
+            int key = std::numeric_limits<int>::max();
+            for (auto v : mesh->vertices(f))
+                key = std::min(key, v.idx());
+            keys[f.idx()] = key;
+        }
+        if (!mesh->permute_faces(details::to_handles<SurfaceMesh::Face>(details::order_by_keys(keys, mesh->n_vertices()))))
+            return false;
+
+        keys.resize(mesh->n_edges());
+        for (auto e : mesh->edges())
+            keys[e.idx()] = std::min(mesh->vertex(e, 0).idx(), mesh->vertex(e, 1).idx());
+        return mesh->permute_edges(details::to_handles<SurfaceMesh::Edge>(details::order_by_keys(keys, mesh->n_vertices())));
+    }
+
+
+    bool Reordering::optimize_vertex_cache(SurfaceMesh *mesh, unsigned int cache_size) {
+        if (!mesh) {
+            LOG(ERROR) << "empty input surface mesh";
+            return false;
+        }
+        if (cache_size < 4) {
+            LOG(WARNING) << "cache size too small (" << cache_size << "), using 4 instead";
+            cache_size = 4;
+        }
+        EASY3D_TRACE_ZONE_CATEGORY("Reordering::optimize_vertex_cache", "algo");
+        if (mesh->has_garbage())
+            mesh->collect_garbage();
+
+        if (!mesh->permute_faces(details::vertex_cache_order(mesh, cache_size)))
+            return false;
+
+        // the vertices in the order of their first use by the faces (the isolated ones are kept at the end)
+        std::vector<SurfaceMesh::Vertex> order;
+        order.reserve(mesh->n_vertices());
+        std::vector<bool> used(mesh->n_vertices(), false);
+        for (auto f : mesh->faces()) {
+            for (auto v : mesh->vertices(f)) {
+                if (!used[v.idx()]) {
+                    used[v.idx()] = true;
+                    order.push_back(v);
+                }
+            }
+        }
+        for (auto v : mesh->vertices()) {
+            if (!used[v.idx()])
+                order.push_back(v);
+        }
+        if (!mesh->permute_vertices(order))
+            return false;
+
+        return mesh->permute_edges(details::edges_in_face_order(mesh));
+    }
+
+
+    float Reordering::average_cache_miss_ratio(const SurfaceMesh *mesh, unsigned int cache_size) {
+        if (!mesh || mesh->n_faces() == 0)
+            return 0.0f;
+
+        // a vertex is in the FIFO cache if less than cache_size vertices have been loaded after it
+        std::vector<long long> loaded(mesh->vertices_size(), -1);
+        long long misses = 0;
+        auto fetch = [&](SurfaceMesh::Vertex v) {
+            if (loaded[v.idx()] < 0 || misses - loaded[v.idx()] > static_cast<long long>(cache_size))
+                loaded[v.idx()] = misses++;
+        };
+
+        std::size_t num_triangles = 0;
+        for (auto f : mesh->faces()) {
+            // a polygon is rendered as a fan of triangles
+            const auto h0 = mesh->halfedge(f);
+            const auto v0 = mesh->target(h0);
+            for (auto h = mesh->next(h0); mesh->next(h) != h0; h = mesh->next(h)) {
+                fetch(v0);
+                fetch(mesh->target(h));
+                fetch(mesh->target(mesh->next(h)));
+                ++num_triangles;
+            }
+        }
+        return num_triangles > 0 ? static_cast<float>(misses) / static_cast<float>(num_triangles) : 0.0f;
+    }
+
+}
@@ -0,0 +1,102 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+
+#ifndef EASY3D_ALGO_REORDERING_H
+#define EASY3D_ALGO_REORDERING_H
+
+
+#include <vector>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    class PointCloud;
+    class SurfaceMesh;
+
+    /**
+     * \brief Reorders the elements of 3D models to improve the memory locality.
+     * \class Reordering easy3d/algo/reordering.h
+     * \details Models from scanners, file loaders, or after editing often store their elements in an order that is
+     *      unrelated to their spatial layout, so the neighbors of an element are scattered in memory. This makes
+     *      algorithms visiting the neighborhoods (e.g., kNN queries, curvature, smoothing, remeshing) and the
+     *      rendering (i.e., the vertex caches of the GPU) suffer from cache misses. Reordering only changes the
+     *      indices of the elements: all properties are permuted consistently, but handles and indices obtained
+     *      before the reordering become meaningless, so the drawables of a model should be updated afterwards.
+     *      Example:
+     *      \code
+     *          Reordering::apply(mesh);                   // for processing
+     *          Reordering::optimize_vertex_cache(mesh);   // or for rendering (triangle meshes)
+     *          mesh->renderer()->update();
+     *      \endcode
+     */
+    class Reordering {
+    public:
+        /// The space-filling curves for ordering points.
+        enum Curve {
+            MORTON,     ///< The Z-order curve, which is cheap to compute.
+            HILBERT     ///< The Hilbert curve, which preserves the locality better (no jumps between neighbors).
+        };
+
+        /**
+         * \brief Computes the order of a set of points along a space-filling curve.
+         * \details The bounding box of the points is quantized into a grid of 2^21 cells along each axis.
+         * \return The indices of the points in the order along the curve.
+         */
+        static std::vector<int> spatial_order(const std::vector<vec3> &points, Curve curve = HILBERT);
+
+        /// Reorders the vertices of a point cloud along a space-filling curve.
+        static bool apply(PointCloud *cloud, Curve curve = HILBERT);
+
+        /**
+         * \brief Reorders the vertices of a surface mesh along a space-filling curve, and the edges and faces in the
+         *      order of their (first) vertices, so elements close to each other in space are also close in memory.
+         */
+        static bool apply(SurfaceMesh *mesh, Curve curve = HILBERT);
+
+        /**
+         * \brief Reorders the faces of a surface mesh to maximize the hits of the post-transform vertex cache of the
+         *      GPU (using Forsyth's "linear-speed vertex cache optimisation"), and then the vertices and edges in the
+         *      order they are first used by the faces, so that the vertex fetches are (nearly) sequential.
+         * \param mesh The mesh (polygonal faces are handled as the fans of triangles they are rendered with).
+         * \param cache_size The size of the modeled LRU vertex cache.
+         */
+        static bool optimize_vertex_cache(SurfaceMesh *mesh, unsigned int cache_size = 32);
+
+        /**
+         * \brief Computes the average cache miss ratio (ACMR), i.e., the number of vertex transforms per triangle of
+         *      rendering the faces in their current order with a FIFO vertex cache of the given size.
+         * \details The optimal value is about 0.5 for large triangle meshes, and the worst is 3.
+         */
+        static float average_cache_miss_ratio(const SurfaceMesh *mesh, unsigned int cache_size = 32);
+    };
+
+}
+
+
+#endif  // EASY3D_ALGO_REORDERING_H
@@ -0,0 +1,259 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/algo/sparse_solver.h>
+
+#include <cstring>
+
+#include <Eigen/Sparse>
+#include <Eigen/IterativeLinearSolvers>
+
+#include <easy3d/util/logging.h>
+#include <easy3d/util/stop_watch.h>
+#include <easy3d/util/tracing.h>
+
+
+namespace easy3d {
+
+    // \cond
+    struct SparseSolver::Impl {
+        typedef Eigen::SparseMatrix<double> Matrix;
+        typedef Eigen::SparseMatrix<double, Eigen::RowMajor> RowMatrix;
+        typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Dense;
+
+        Impl() : analyzed(false), factorized(false) {}
+
+        // the last factorized matrix
+        Matrix A;
+        // the row-major copy used by the multi-threaded conjugate gradient
+        RowMatrix A_row;
+        bool analyzed;
+        bool factorized;
+
+        Eigen::SimplicialLDLT<Matrix> ldlt;
+        Eigen::SimplicialLLT<Matrix> llt;
+        // Eigen parallelizes the matrix-vector products of a row-major matrix with Lower|Upper using OpenMP
+        Eigen::ConjugateGradient<RowMatrix, Eigen::Lower | Eigen::Upper> cg;
+        Eigen::ConjugateGradient<Matrix, Eigen::Lower | Eigen::Upper, Eigen::IncompleteCholesky<double> > cg_ichol;
+
+        static bool same_pattern(const Matrix &a, const Matrix &b) {
+            if (a.rows() != b.rows() || a.cols() != b.cols() || a.nonZeros() != b.nonZeros())
+                return false;
+            return std::memcmp(a.outerIndexPtr(), b.outerIndexPtr(), sizeof(Matrix::StorageIndex) * (a.outerSize() + 1)) == 0 &&
+                   std::memcmp(a.innerIndexPtr(), b.innerIndexPtr(), sizeof(Matrix::StorageIndex) * a.nonZeros()) == 0;
+        }
+
+        static bool same_values(const Matrix &a, const Matrix &b) {
+            return std::memcmp(a.valuePtr(), b.valuePtr(), sizeof(double) * a.nonZeros()) == 0;
+        }
+    };
+    // \endcond
+
+
+    SparseSolver::SparseSolver(Method method) : impl_(new Impl), method_(method) {
+        set_tolerance(1e-8);
+        set_max_iterations(1000);
+    }
+
+
+    SparseSolver::~SparseSolver() {
+        delete impl_;
+    }
+
+
+    void SparseSolver::set_method(Method method) {
+        if (method != method_) {
+            method_ = method;
+            clear();
+        }
+    }
+
+
+    void SparseSolver::set_tolerance(double tolerance) {
+        impl_->cg.setTolerance(tolerance);
+        impl_->cg_ichol.setTolerance(tolerance);
+    }
+
+
+    void SparseSolver::set_max_iterations(int num) {
+        impl_->cg.setMaxIterations(num);
+        impl_->cg_ichol.setMaxIterations(num);
+    }
+
+
+    void SparseSolver::clear() {
+        impl_->A = Impl::Matrix();
+        impl_->A_row = Impl::RowMatrix();
+        impl_->analyzed = false;
+        impl_->factorized = false;
+    }
+
+
+    bool SparseSolver::factorize(int n, const std::vector<Triplet> &triplets) {
+        EASY3D_TRACE_ZONE_CATEGORY("SparseSolver::factorize", "algo");
+        StopWatch w;
+        std::vector<Eigen::Triplet<double> > entries;
+        entries.reserve(triplets.size());
+        for (const auto &t : triplets)
+            entries.emplace_back(t.row, t.col, t.value);
+        Impl::Matrix A(n, n);
+        A.setFromTriplets(entries.begin(), entries.end());
+        A.makeCompressed();
+        timing_.assembly += w.elapsed_seconds(6);
+
+        const bool analyze = !(impl_->analyzed && Impl::same_pattern(A, impl_->A));
+        if (!analyze && impl_->factorized && Impl::same_values(A, impl_->A))
+            return true;    // nothing changed, reuse the factorization
+
+        impl_->A.swap(A);
+        impl_->factorized = false;
+
+        w.restart();
+        bool success = false;
+        switch (method_) {
+            case SIMPLICIAL_LDLT:
+                if (analyze)
+                    impl_->ldlt.analyzePattern(impl_->A);
+                timing_.analysis += w.elapsed_seconds(6);
+                w.restart();
+                impl_->ldlt.factorize(impl_->A);
+                success = (impl_->ldlt.info() == Eigen::Success);
+                break;
+            case SIMPLICIAL_LLT:
+                if (analyze)
+                    impl_->llt.analyzePattern(impl_->A);
+                timing_.analysis += w.elapsed_seconds(6);
+                w.restart();
+                impl_->llt.factorize(impl_->A);
+                success = (impl_->llt.info() == Eigen::Success);
+                break;
+            case CONJUGATE_GRADIENT:
+                impl_->A_row = impl_->A;
+                if (analyze)
+                    impl_->cg.analyzePattern(impl_->A_row);
+                timing_.analysis += w.elapsed_seconds(6);
+                w.restart();
+                impl_->cg.factorize(impl_->A_row);
+                success = (impl_->cg.info() == Eigen::Success);
+                break;
+            case CONJUGATE_GRADIENT_ICHOL:
+                if (analyze)
+                    impl_->cg_ichol.analyzePattern(impl_->A);
+                timing_.analysis += w.elapsed_seconds(6);
+                w.restart();
+                impl_->cg_ichol.factorize(impl_->A);
+                success = (impl_->cg_ichol.info() == Eigen::Success);
+                break;
+        }
+        timing_.factorization += w.elapsed_seconds(6);
+        if (analyze)
+            ++timing_.num_analysis;
+        ++timing_.num_factorization;
+
+        impl_->analyzed = true;
+        impl_->factorized = success;
+        if (!success)
+            LOG(ERROR) << "failed to factorize the matrix";
+        return success;
+    }
+
+
+    bool SparseSolver::solve(const double *b, double *x, std::size_t n, int dim, bool use_guess) {
+        EASY3D_TRACE_ZONE_CATEGORY("SparseSolver::solve", "algo");
+        if (!impl_->factorized) {
+            LOG(ERROR) << "the matrix has not been (successfully) factorized";
+            return false;
+        }
+        if (n != static_cast<std::size_t>(impl_->A.rows())) {
+            LOG(ERROR) << "the size of the right-hand side (" << n << ") does not match the matrix ("
+                       << impl_->A.rows() << ")";
+            return false;
+        }
+
+        StopWatch w;
+        Eigen::Map<const Impl::Dense> B(b, n, dim);
+        Eigen::Map<Impl::Dense> X(x, n, dim);
+        bool success = false;
+        switch (method_) {
+            case SIMPLICIAL_LDLT:
+                X = impl_->ldlt.solve(B);
+                success = (impl_->ldlt.info() == Eigen::Success);
+                break;
+            case SIMPLICIAL_LLT:
+                X = impl_->llt.solve(B);
+                success = (impl_->llt.info() == Eigen::Success);
+                break;
+            case CONJUGATE_GRADIENT:
+                if (use_guess)
+                    X = impl_->cg.solveWithGuess(B, Impl::Dense(X));
+                else
+                    X = impl_->cg.solve(B);
+                success = (impl_->cg.info() == Eigen::Success);
+                break;
+            case CONJUGATE_GRADIENT_ICHOL:
+                if (use_guess)
+                    X = impl_->cg_ichol.solveWithGuess(B, Impl::Dense(X));
+                else
+                    X = impl_->cg_ichol.solve(B);
+                success = (impl_->cg_ichol.info() == Eigen::Success);
+                break;
+        }
+        timing_.solving += w.elapsed_seconds(6);
+        ++timing_.num_solving;
+
+        if (!success)
+            LOG(ERROR) << "failed to solve the linear system";
+        return success;
+    }
+
+
+    bool SparseSolver::solve(const std::vector<double> &b, std::vector<double> &x) {
+        const bool use_guess = (x.size() == b.size());
+        x.resize(b.size());
+        if (b.empty())
+            return solve(nullptr, nullptr, 0, 1, false);
+        return solve(b.data(), x.data(), b.size(), 1, use_guess);
+    }
+
+
+    bool SparseSolver::solve(const std::vector<dvec2> &b, std::vector<dvec2> &x) {
+        const bool use_guess = (x.size() == b.size());
+        x.resize(b.size());
+        if (b.empty())
+            return solve(nullptr, nullptr, 0, 2, false);
+        return solve(b[0].data(), x[0].data(), b.size(), 2, use_guess);
+    }
+
+
+    bool SparseSolver::solve(const std::vector<dvec3> &b, std::vector<dvec3> &x) {
+        const bool use_guess = (x.size() == b.size());
+        x.resize(b.size());
+        if (b.empty())
+            return solve(nullptr, nullptr, 0, 3, false);
+        return solve(b[0].data(), x[0].data(), b.size(), 3, use_guess);
+    }
+
+}
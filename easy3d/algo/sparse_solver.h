@@ -0,0 +1,147 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_ALGO_SPARSE_SOLVER_H
+#define EASY3D_ALGO_SPARSE_SOLVER_H
+
+
+#include <vector>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    /**
+     * \brief A solver for sparse symmetric linear systems that caches its factorizations.
+     * \class SparseSolver easy3d/algo/sparse_solver.h
+     * \details The matrix is given in triplet format. The symbolic analysis is reused as long as the sparsity pattern
+     *      of the matrix does not change (i.e., the mesh topology is unchanged), and the numeric factorization is
+     *      reused as long as also the values do not change, so that repeatedly solving a system in which only the
+     *      right-hand side changes costs only back-substitutions. The time spent in each phase is recorded.
+     *      It is used by SurfaceMeshSmoothing, SurfaceMeshFairing, and SurfaceMeshParameterization.
+     *
+     * Example usage:
+     *      \code
+     *          SparseSolver solver(SparseSolver::CONJUGATE_GRADIENT);
+     *          solver.factorize(n, triplets);  // std::vector<SparseSolver::Triplet>
+     *          solver.solve(b, x);             // std::vector<dvec3>
+     *          LOG(INFO) << "factorization took " << solver.timing().factorization << " seconds";
+     *      \endcode
+     */
+    class SparseSolver {
+    public:
+        /// \brief The available solvers.
+        enum Method {
+            SIMPLICIAL_LDLT,            ///< direct sparse LDLT Cholesky factorization (default)
+            SIMPLICIAL_LLT,             ///< direct sparse LLT Cholesky factorization (matrix must be positive definite)
+            CONJUGATE_GRADIENT,         ///< conjugate gradient with a diagonal preconditioner (multi-threaded)
+            CONJUGATE_GRADIENT_ICHOL    ///< conjugate gradient with an incomplete Cholesky preconditioner
+        };
+
+        /// \brief A nonzero entry (row, column, value) of the matrix.
+        struct Triplet {
+            Triplet(int r, int c, double v) : row(r), col(c), value(v) {}
+            int row;
+            int col;
+            double value;
+        };
+
+        /// \brief The accumulated time (in seconds) and number of calls of each phase.
+        struct Timing {
+            Timing() : assembly(0), analysis(0), factorization(0), solving(0),
+                       num_analysis(0), num_factorization(0), num_solving(0) {}
+            double assembly;        ///< building the matrix from the triplets
+            double analysis;        ///< symbolic analysis (skipped if the sparsity pattern is unchanged)
+            double factorization;   ///< numeric factorization (skipped if the matrix is unchanged)
+            double solving;         ///< back-substitution or iterations
+            unsigned int num_analysis;
+            unsigned int num_factorization;
+            unsigned int num_solving;
+        };
+
+    public:
+        explicit SparseSolver(Method method = SIMPLICIAL_LDLT);
+        ~SparseSolver();
+
+        /// \brief Changes the solver. This discards the cached factorizations.
+        void set_method(Method method);
+        /// \brief Returns the solver in use.
+        Method method() const { return method_; }
+
+        /// \brief Sets the tolerance for the iterative solvers (default: 1e-8).
+        void set_tolerance(double tolerance);
+        /// \brief Sets the maximum number of iterations for the iterative solvers (default: 1000).
+        void set_max_iterations(int num);
+
+        /**
+         * \brief Sets the n by n matrix of the system and factorizes it.
+         * \details Duplicated triplets are summed up. The previous symbolic analysis and numeric factorization are
+         *      reused if the new matrix has the same sparsity pattern and values, respectively.
+         * \return \c true on success.
+         */
+        bool factorize(int n, const std::vector<Triplet> &triplets);
+
+        /**
+         * \brief Solves the system for right-hand side \p b, using the last factorized matrix.
+         * \param x Returns the solution. For the iterative solvers, \p x is used as the initial guess if it has the
+         *      same size as \p b.
+         * \return \c true on success.
+         */
+        bool solve(const std::vector<double> &b, std::vector<double> &x);
+        /// \brief Solves the system for two right-hand sides (e.g., texture coordinates).
+        bool solve(const std::vector<dvec2> &b, std::vector<dvec2> &x);
+        /// \brief Solves the system for three right-hand sides (e.g., vertex positions).
+        bool solve(const std::vector<dvec3> &b, std::vector<dvec3> &x);
+
+        /// \brief Discards the cached matrix and factorizations.
+        void clear();
+
+        /// \brief Returns the accumulated timing of the phases.
+        const Timing &timing() const { return timing_; }
+        /// \brief Resets the timing.
+        void reset_timing() { timing_ = Timing(); }
+
+    private:
+        // solves for dim right-hand sides stored row by row (i.e., as an array of n vectors of dim doubles)
+        bool solve(const double *b, double *x, std::size_t n, int dim, bool use_guess);
+
+        // copying is not allowed
+        SparseSolver(const SparseSolver &);
+        SparseSolver &operator=(const SparseSolver &);
+
+    private:
+        struct Impl;
+        Impl *impl_;
+
+        Method method_;
+        Timing timing_;
+    };
+
+} // namespace easy3d
+
+
+#endif  // EASY3D_ALGO_SPARSE_SOLVER_H
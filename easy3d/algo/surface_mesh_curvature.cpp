@@ -12,6 +12,7 @@
 #include <easy3d/algo/surface_mesh_curvature.h>
 #include <easy3d/algo/surface_mesh_geometry.h>
 #include <easy3d/core/eigen_solver.h>
+#include <easy3d/util/tracing.h>
 
 
 namespace easy3d {
@@ -29,39 +30,36 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshCurvature::analyze(unsigned int post_smoothing_steps) {
-        float kmin, kmax, mean, gauss;
-        float area, sum_angles;
-        float weight, sum_weights;
-        vec3 p0, p1, p2, laplace;
-
-        // cotan weight per edge
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshCurvature::analyze", "algo");
+        // cotan weight per edge and Voronoi area per vertex, each computed only once
         auto cotan = mesh_->add_edge_property<double>("curv:cotan");
-        for (auto e : mesh_->edges())
-            cotan[e] = geom::cotan_weight(mesh_, e);
+        auto area = mesh_->add_vertex_property<double>("curv:area");
+        geom::cotan_weights(mesh_, cotan);
+        geom::voronoi_areas(mesh_, area);
+
+        const int num = static_cast<int>(mesh_->vertices_size());
 
-        // Voronoi area per vertex
         // Laplace per vertex
         // angle sum per vertex
         // -> mean, Gauss -> min, max curvature
-        for (auto v : mesh_->vertices()) {
-            kmin = kmax = 0.0;
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
+            const SurfaceMesh::Vertex v(i);
+            float kmin = 0.0, kmax = 0.0;
 
-            if (!mesh_->is_isolated(v) && !mesh_->is_border(v)) {
-                laplace = vec3(0.0);
-                sum_weights = 0.0;
-                sum_angles = 0.0;
-                p0 = mesh_->position(v);
-
-                // Voronoi area
-                area = geom::voronoi_area(mesh_, v);
+            if (!mesh_->is_deleted(v) && !mesh_->is_isolated(v) && !mesh_->is_border(v)) {
+                vec3 laplace(0.0);
+                float sum_weights = 0.0;
+                float sum_angles = 0.0;
+                const vec3 &p0 = mesh_->position(v);
 
                 // Laplace & angle sum
                 for (auto vh : mesh_->halfedges(v)) {
-                    p1 = mesh_->position(mesh_->target(vh));
-                    p2 = mesh_->position(
+                    vec3 p1 = mesh_->position(mesh_->target(vh));
+                    vec3 p2 = mesh_->position(
                             mesh_->target(mesh_->prev_around_source(vh)));
 
-                    weight = cotan[mesh_->edge(vh)];
+                    const float weight = cotan[mesh_->edge(vh)];
                     sum_weights += weight;
                     laplace += weight * p1;
 
@@ -71,11 +69,11 @@ namespace easy3d {
                     p2.normalize();
                     sum_angles += acos(geom::clamp_cos(dot(p1, p2)));
                 }
-                laplace -= sum_weights * mesh_->position(v);
-                laplace /= float(2.0) * area;
+                laplace -= sum_weights * p0;
+                laplace /= float(2.0) * area[v];
 
-                mean = float(0.5) * norm(laplace);
-                gauss = (2.0 * M_PI - sum_angles) / area;
+                const float mean = float(0.5) * norm(laplace);
+                const float gauss = (2.0 * M_PI - sum_angles) / area[v];
 
                 const float s = sqrt(std::max(float(0.0), mean * mean - gauss));
                 kmin = mean - s;
@@ -87,17 +85,19 @@ namespace easy3d {
         }
 
         // boundary vertices: interpolate from interior neighbors
-        for (auto v : mesh_->vertices()) {
-            if (mesh_->is_border(v)) {
-                kmin = kmax = sum_weights = 0.0;
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
+            const SurfaceMesh::Vertex v(i);
+            if (!mesh_->is_deleted(v) && mesh_->is_border(v)) {
+                float kmin = 0.0, kmax = 0.0, sum_weights = 0.0;
 
                 for (auto vh : mesh_->halfedges(v)) {
-                    v = mesh_->target(vh);
-                    if (!mesh_->is_border(v)) {
-                        weight = cotan[mesh_->edge(vh)];
+                    const auto tv = mesh_->target(vh);
+                    if (!mesh_->is_border(tv)) {
+                        const float weight = cotan[mesh_->edge(vh)];
                         sum_weights += weight;
-                        kmin += weight * min_curvature_[v];
-                        kmax += weight * max_curvature_[v];
+                        kmin += weight * min_curvature_[tv];
+                        kmax += weight * max_curvature_[tv];
                     }
                 }
 
@@ -111,54 +111,53 @@ namespace easy3d {
             }
         }
 
+        // smooth curvature values (reusing the cotan weights)
+        smooth_curvatures(post_smoothing_steps, cotan);
+
         // clean-up properties
         mesh_->remove_edge_property(cotan);
-
-        // smooth curvature values
-        smooth_curvatures(post_smoothing_steps);
+        mesh_->remove_vertex_property(area);
     }
 
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshCurvature::analyze_tensor(unsigned int post_smoothing_steps,
                                               bool two_ring_neighborhood) {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshCurvature::analyze_tensor", "algo");
         auto area = mesh_->add_vertex_property<double>("curv:area", 0.0);
         auto normal = mesh_->add_face_property<dvec3>("curv:normal");
         auto evec = mesh_->add_edge_property<dvec3>("curv:evec", dvec3(0, 0, 0));
         auto angle = mesh_->add_edge_property<double>("curv:angle", 0.0);
 
-        dvec3 p0, p1, n0, n1, ev;
-        double l, A, beta, a1, a2, a3;
-        dmat3 tensor;
-
-        double eval1, eval2, eval3, kmin, kmax;
-        dvec3 evec1, evec2, evec3;
-
-        std::vector<SurfaceMesh::Vertex> neighborhood;
-        neighborhood.reserve(15);
-
         // precompute Voronoi area per vertex
-        for (auto v : mesh_->vertices()) {
-            area[v] = geom::voronoi_area(mesh_, v);
-        }
+        geom::voronoi_areas(mesh_, area);
 
         // precompute face normals
-        for (auto f : mesh_->faces()) {
-            normal[f] = (dvec3) mesh_->compute_face_normal(f);
+        const int num_faces = static_cast<int>(mesh_->faces_size());
+#pragma omp parallel for
+        for (int i = 0; i < num_faces; ++i) {
+            const SurfaceMesh::Face f(i);
+            if (!mesh_->is_deleted(f))
+                normal[f] = (dvec3) mesh_->compute_face_normal(f);
         }
 
         // precompute dihedralAngle*edge_length*edge per edge
-        for (auto e : mesh_->edges()) {
+        const int num_edges = static_cast<int>(mesh_->edges_size());
+#pragma omp parallel for
+        for (int i = 0; i < num_edges; ++i) {
+            const SurfaceMesh::Edge e(i);
+            if (mesh_->is_deleted(e))
+                continue;
             auto h0 = mesh_->halfedge(e, 0);
             auto h1 = mesh_->halfedge(e, 1);
             auto f0 = mesh_->face(h0);
             auto f1 = mesh_->face(h1);
             if (f0.is_valid() && f1.is_valid()) {
-                n0 = normal[f0];
-                n1 = normal[f1];
-                ev = (dvec3) mesh_->position(mesh_->target(h0));
+                const dvec3 &n0 = normal[f0];
+                const dvec3 &n1 = normal[f1];
+                dvec3 ev = (dvec3) mesh_->position(mesh_->target(h0));
                 ev -= (dvec3) mesh_->position(mesh_->target(h1));
-                l = norm(ev);
+                double l = norm(ev);
                 if (l != 0) {   // avoid overflow in case of 0-length edges
                     ev /= l;
                     l *= 0.5; // only consider half of the edge (matching Voronoi area)
@@ -169,97 +168,102 @@ namespace easy3d {
         }
 
         // compute curvature tensor for each vertex
-        for (auto v : mesh_->vertices()) {
-            kmin = 0.0;
-            kmax = 0.0;
-
-            if (!mesh_->is_isolated(v)) {
-                // one-ring or two-ring neighborhood?
-                neighborhood.clear();
-                neighborhood.push_back(v);
-                if (two_ring_neighborhood) {
-                    for (auto vv : mesh_->vertices(v))
-                        neighborhood.push_back(vv);
-                }
-
-                A = 0.0;
-                tensor = dmat3(0.0);
-
-                // compute tensor over vertex neighborhood stored in vertices
-                for (auto nit : neighborhood) {
-                    // accumulate tensor from dihedral angles around vertices
-                    for (auto hv : mesh_->halfedges(nit)) {
-                        auto ee = mesh_->edge(hv);
-                        ev = evec[ee];
-                        beta = angle[ee];
-                        for (int i = 0; i < 3; ++i)
-                            for (int j = 0; j < 3; ++j)
-                                tensor(i, j) += beta * ev[i] * ev[j];
-                    }
+        const int num = static_cast<int>(mesh_->vertices_size());
+#pragma omp parallel
+        {
+            // per-thread workspace
+            std::vector<SurfaceMesh::Vertex> neighborhood;
+            neighborhood.reserve(15);
+            EigenSolver<double> solver(3);
+            double m[3][3];
+            double *matrix[3] = {m[0], m[1], m[2]};
+
+#pragma omp for
+            for (int idx = 0; idx < num; ++idx) {
+                const SurfaceMesh::Vertex v(idx);
+                if (mesh_->is_deleted(v))
+                    continue;
 
-                    // accumulate area
-                    A += area[nit];
-                }
+                double kmin = 0.0;
+                double kmax = 0.0;
 
-                // normalize tensor by accumulated
-                if (A != 0)     // avoid overflow in case of 0-area
-                    tensor /= A;
+                if (!mesh_->is_isolated(v)) {
+                    // one-ring or two-ring neighborhood?
+                    neighborhood.clear();
+                    neighborhood.push_back(v);
+                    if (two_ring_neighborhood) {
+                        for (auto vv : mesh_->vertices(v))
+                            neighborhood.push_back(vv);
+                    }
 
-                // Liangliang: eigen solver requires FT** as input matrix :-(
-                double **matrix = new double *[3];
-                for (int i = 0; i < 3; ++i) {
-                    matrix[i] = new double[3];
-                    for (int j = 0; j < 3; ++j)
-                        matrix[i][j] = tensor(i, j);
-                }
-                // Eigen-decomposition
-                EigenSolver<double> solver(3);
-                solver.solve(matrix, EigenSolver<double>::DECREASING);
-                eval1 = solver.eigen_value(0);
-                eval2 = solver.eigen_value(1);
-                eval3 = solver.eigen_value(2);
-                for (int i = 0; i < 3; ++i) {
-                    evec1[i] = solver.eigen_vector(i, 0);
-                    evec2[i] = solver.eigen_vector(i, 1);
-                    evec3[i] = solver.eigen_vector(i, 2);
-                }
-                for (int i = 0; i < 3; ++i)
-                    delete[] matrix[i];
-                delete[] matrix;
-
-                // curvature values:
-                //   normal vector -> eval with smallest absolute value
-                //   evals are sorted in decreasing order
-                a1 = fabs(eval1);
-                a2 = fabs(eval2);
-                a3 = fabs(eval3);
-                if (a1 < a2) {
-                    if (a1 < a3) {
-                        // e1 is normal
-                        kmax = eval2;
-                        kmin = eval3;
-                    } else {
-                        // e3 is normal
-                        kmax = eval1;
-                        kmin = eval2;
+                    double A = 0.0;
+                    dmat3 tensor(0.0);
+
+                    // compute tensor over vertex neighborhood stored in vertices
+                    for (auto nit : neighborhood) {
+                        // accumulate tensor from dihedral angles around vertices
+                        for (auto hv : mesh_->halfedges(nit)) {
+                            auto ee = mesh_->edge(hv);
+                            const dvec3 &ev = evec[ee];
+                            const double beta = angle[ee];
+                            for (int i = 0; i < 3; ++i)
+                                for (int j = 0; j < 3; ++j)
+                                    tensor(i, j) += beta * ev[i] * ev[j];
+                        }
+
+                        // accumulate area
+                        A += area[nit];
                     }
-                } else {
-                    if (a2 < a3) {
-                        // e2 is normal
-                        kmax = eval1;
-                        kmin = eval3;
+
+                    // normalize tensor by accumulated
+                    if (A != 0)     // avoid overflow in case of 0-area
+                        tensor /= A;
+
+                    // Liangliang: eigen solver requires FT** as input matrix :-(
+                    for (int i = 0; i < 3; ++i)
+                        for (int j = 0; j < 3; ++j)
+                            matrix[i][j] = tensor(i, j);
+
+                    // Eigen-decomposition
+                    solver.solve(matrix, EigenSolver<double>::DECREASING);
+                    const double eval1 = solver.eigen_value(0);
+                    const double eval2 = solver.eigen_value(1);
+                    const double eval3 = solver.eigen_value(2);
+
+                    // curvature values:
+                    //   normal vector -> eval with smallest absolute value
+                    //   evals are sorted in decreasing order
+                    const double a1 = fabs(eval1);
+                    const double a2 = fabs(eval2);
+                    const double a3 = fabs(eval3);
+                    if (a1 < a2) {
+                        if (a1 < a3) {
+                            // e1 is normal
+                            kmax = eval2;
+                            kmin = eval3;
+                        } else {
+                            // e3 is normal
+                            kmax = eval1;
+                            kmin = eval2;
+                        }
                     } else {
-                        // e3 is normal
-                        kmax = eval1;
-                        kmin = eval2;
+                        if (a2 < a3) {
+                            // e2 is normal
+                            kmax = eval1;
+                            kmin = eval3;
+                        } else {
+                            // e3 is normal
+                            kmax = eval1;
+                            kmin = eval2;
+                        }
                     }
                 }
-            }
 
-            assert(kmin <= kmax);
+                assert(kmin <= kmax);
 
-            min_curvature_[v] = kmin;
-            max_curvature_[v] = kmax;
+                min_curvature_[v] = kmin;
+                max_curvature_[v] = kmax;
+            }
         }
 
         // clean-up properties
@@ -275,25 +279,42 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshCurvature::smooth_curvatures(unsigned int iterations) {
-        float kmin, kmax;
-        float weight, sum_weights;
+        if (iterations == 0)
+            return;
 
-        // properties
-        auto vfeature = mesh_->get_vertex_property<bool>("v:feature");
+        // cotan weight per edge
         auto cotan = mesh_->add_edge_property<double>("curv:cotan");
+        geom::cotan_weights(mesh_, cotan);
 
-        // cotan weight per edge
-        for (auto e : mesh_->edges()) {
-            cotan[e] = geom::cotan_weight(mesh_, e);
-        }
+        smooth_curvatures(iterations, cotan);
+
+        // remove property
+        mesh_->remove_edge_property(cotan);
+    }
+
+    //-----------------------------------------------------------------------------
+
+    void SurfaceMeshCurvature::smooth_curvatures(unsigned int iterations,
+                                                 const SurfaceMesh::EdgeProperty<double> &cotan) {
+        // properties
+        auto vfeature = mesh_->get_vertex_property<bool>("v:feature");
 
-        for (unsigned int i = 0; i < iterations; ++i) {
-            for (auto v : mesh_->vertices()) {
+        // Jacobi iterations (the new values are computed from the values of the previous iteration), such that the
+        // vertices can be processed in parallel
+        const int num = static_cast<int>(mesh_->vertices_size());
+        std::vector<float> old_min, old_max;
+        for (unsigned int iter = 0; iter < iterations; ++iter) {
+            old_min = min_curvature_.vector();
+            old_max = max_curvature_.vector();
+
+#pragma omp parallel for
+            for (int i = 0; i < num; ++i) {
+                const SurfaceMesh::Vertex v(i);
                 // don't smooth feature vertices
-                if (vfeature && vfeature[v])
+                if (mesh_->is_deleted(v) || (vfeature && vfeature[v]))
                     continue;
 
-                kmin = kmax = sum_weights = 0.0;
+                float kmin = 0.0, kmax = 0.0, sum_weights = 0.0;
 
                 for (auto vh : mesh_->halfedges(v)) {
                     auto tv = mesh_->target(vh);
@@ -302,10 +323,10 @@ namespace easy3d {
                     if (vfeature && vfeature[tv])
                         continue;
 
-                    weight = std::max(0.0, geom::cotan_weight(mesh_, mesh_->edge(vh)));
+                    const float weight = std::max(0.0, cotan[mesh_->edge(vh)]);
                     sum_weights += weight;
-                    kmin += weight * min_curvature_[tv];
-                    kmax += weight * max_curvature_[tv];
+                    kmin += weight * old_min[tv.idx()];
+                    kmax += weight * old_max[tv.idx()];
                 }
 
                 if (sum_weights) {
@@ -314,16 +335,18 @@ namespace easy3d {
                 }
             }
         }
-
-        // remove property
-        mesh_->remove_edge_property(cotan);
     }
 
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshCurvature::compute_mean_curvature() {
         auto curvatures = mesh_->vertex_property<float>("v:curv-mean");
-        for (auto v : mesh_->vertices()) {
+        const int num = static_cast<int>(mesh_->vertices_size());
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
+            const SurfaceMesh::Vertex v(i);
+            if (mesh_->is_deleted(v))
+                continue;
 //            curvatures[v] = fabs(mean_curvature(v));
             curvatures[v] = mean_curvature(v);
         }
@@ -333,16 +356,28 @@ namespace easy3d {
 
     void SurfaceMeshCurvature::compute_gauss_curvature() {
         auto curvatures = mesh_->vertex_property<float>("v:curv-gauss");
-        for (auto v : mesh_->vertices())
+        const int num = static_cast<int>(mesh_->vertices_size());
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
+            const SurfaceMesh::Vertex v(i);
+            if (mesh_->is_deleted(v))
+                continue;
             curvatures[v] = gauss_curvature(v);
+        }
     }
 
     //-----------------------------------------------------------------------------
 
     void SurfaceMeshCurvature::compute_max_abs_curvature() {
         auto curvatures = mesh_->vertex_property<float>("v:curv-max_abs");
-        for (auto v : mesh_->vertices())
+        const int num = static_cast<int>(mesh_->vertices_size());
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
+            const SurfaceMesh::Vertex v(i);
+            if (mesh_->is_deleted(v))
+                continue;
             curvatures[v] = max_abs_curvature(v);
+        }
     }
 
-} // namespace easy3d
\ No newline at end of file
+} // namespace easy3d
@@ -88,6 +88,8 @@ namespace easy3d {
     private:
         //! smooth curvature values
         void smooth_curvatures(unsigned int iterations);
+        //! smooth curvature values using precomputed cotan weights
+        void smooth_curvatures(unsigned int iterations, const SurfaceMesh::EdgeProperty<double> &cotan);
 
     private:
         SurfaceMesh *mesh_;
@@ -0,0 +1,304 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/algo/surface_mesh_distance.h>
+
+#include <fstream>
+#include <limits>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/algo/triangle_mesh_kdtree.h>
+#include <easy3d/algo/surface_mesh_sampler.h>
+#include <easy3d/algo/surface_mesh_triangulation.h>
+#include <easy3d/util/line_stream.h>
+#include <easy3d/util/logging.h>
+#include <easy3d/util/stop_watch.h>
+
+
+namespace easy3d {
+
+
+    SurfaceMeshDistance::SurfaceMeshDistance(const SurfaceMesh *reference)
+            : reference_(reference), triangulated_(nullptr), tree_(nullptr) {
+        if (!reference->is_triangle_mesh()) {
+            LOG(WARNING) << "reference is not a triangle mesh (creating a temporary triangle mesh by triangulating it)";
+            triangulated_ = new SurfaceMesh(*reference);
+            SurfaceMeshTriangulation triangulator(triangulated_);
+            triangulator.triangulate(SurfaceMeshTriangulation::MIN_AREA);
+        }
+        const SurfaceMesh *mesh = triangulated_ ? triangulated_ : reference_;
+
+        StopWatch w;
+        LOG(INFO) << "building kd-tree for the reference mesh...";
+        tree_ = new TriangleMeshKdTree(mesh);
+        LOG(INFO) << "done. " << w.time_string();
+
+        // face normals and angle-weighted vertex normals (i.e., the pseudo-normals of faces and vertices), indexed
+        // by the elements, so deleted elements (i.e., garbage) also have a slot
+        face_normals_.resize(mesh->faces_size(), vec3(0, 0, 0));
+        vertex_normals_.resize(mesh->vertices_size(), vec3(0, 0, 0));
+        for (auto f : mesh->faces()) {
+            SurfaceMesh::Vertex v[3];
+            int i = 0;
+            for (auto vf : mesh->vertices(f))
+                v[i++] = vf;
+            const vec3 &p0 = mesh->position(v[0]);
+            const vec3 &p1 = mesh->position(v[1]);
+            const vec3 &p2 = mesh->position(v[2]);
+            const vec3 n = geom::triangle_normal(p0, p1, p2);
+            face_normals_[f.idx()] = n;
+            vertex_normals_[v[0].idx()] += n * static_cast<float>(geom::angle(p1 - p0, p2 - p0));
+            vertex_normals_[v[1].idx()] += n * static_cast<float>(geom::angle(p2 - p1, p0 - p1));
+            vertex_normals_[v[2].idx()] += n * static_cast<float>(geom::angle(p0 - p2, p1 - p2));
+        }
+
+        begin();
+    }
+
+
+    SurfaceMeshDistance::~SurfaceMeshDistance() {
+        delete tree_;
+        delete triangulated_;
+    }
+
+
+    vec3 SurfaceMeshDistance::pseudo_normal(SurfaceMesh::Face f, const vec3 &q) const {
+        const SurfaceMesh *mesh = triangulated_ ? triangulated_ : reference_;
+
+        SurfaceMesh::Halfedge h[3];
+        int i = 0;
+        for (auto hf : mesh->halfedges(f))
+            h[i++] = hf;
+
+        // h[i] points to the i-th corner, and the edge opposite to it is h[i+2] (from corner i+1 to corner i+2)
+        const vec3 b = geom::barycentric_coordinates(q,
+                                                     mesh->position(mesh->target(h[0])),
+                                                     mesh->position(mesh->target(h[1])),
+                                                     mesh->position(mesh->target(h[2])));
+        const float eps = 1e-4f;
+        int num_zeros = 0, zero = -1, nonzero = -1;
+        for (int k = 0; k < 3; ++k) {
+            if (b[k] < eps) {
+                ++num_zeros;
+                zero = k;
+            } else
+                nonzero = k;
+        }
+
+        if (num_zeros >= 2 && nonzero >= 0)  // closest to a vertex
+            return vertex_normals_[mesh->target(h[nonzero]).idx()];
+        else if (num_zeros == 1) {          // closest to an edge
+            const SurfaceMesh::Halfedge opp = mesh->opposite(h[(zero + 2) % 3]);
+            vec3 n = face_normals_[f.idx()];
+            if (!mesh->is_border(opp))
+                n += face_normals_[mesh->face(opp).idx()];
+            return n;
+        } else                              // inside the face
+            return face_normals_[f.idx()];
+    }
+
+
+    void SurfaceMeshDistance::distances(const std::vector<vec3> &points, std::vector<float> &distances,
+                                        bool signed_distance) const {
+        std::vector<SurfaceMesh::Face> faces;
+        std::vector<vec3> nearest;
+        tree_->nearest(points, distances, faces, nearest);
+
+        if (signed_distance) {
+            const int num = static_cast<int>(points.size());
+#pragma omp parallel for
+            for (int i = 0; i < num; ++i) {
+                if (faces[i].is_valid() && dot(points[i] - nearest[i], pseudo_normal(faces[i], nearest[i])) < 0.0f)
+                    distances[i] = -distances[i];
+            }
+        }
+    }
+
+
+    void SurfaceMeshDistance::begin() {
+        count_ = 0;
+        sum_ = 0.0;
+        sum2_ = 0.0;
+        min_ = std::numeric_limits<float>::max();
+        max_ = 0.0f;
+    }
+
+
+    void SurfaceMeshDistance::add(const std::vector<vec3> &points, bool signed_distance,
+                                  std::vector<float> *distances) {
+        std::vector<float> dist;
+        std::vector<float> &d = distances ? *distances : dist;
+        this->distances(points, d, signed_distance);
+
+        for (auto v : d) {
+            const float a = std::abs(v);
+            sum_ += a;
+            sum2_ += double(a) * a;
+            min_ = std::min(min_, a);
+            max_ = std::max(max_, a);
+        }
+        count_ += d.size();
+    }
+
+
+    SurfaceMeshDistance::Statistics SurfaceMeshDistance::end() const {
+        Statistics stats;
+        if (count_ > 0) {
+            stats.count = count_;
+            stats.min = min_;
+            stats.max = max_;
+            stats.mean = static_cast<float>(sum_ / count_);
+            stats.rms = static_cast<float>(std::sqrt(sum2_ / count_));
+        }
+        return stats;
+    }
+
+
+    SurfaceMeshDistance::Statistics
+    SurfaceMeshDistance::compute(PointCloud *cloud, bool signed_distance, const std::string &name) {
+        StopWatch w;
+        auto prop = cloud->vertex_property<float>(name);
+        if (!prop) {
+            LOG(ERROR) << "could not store the distances (a property named '" << name << "' exists with another type)";
+            return Statistics();
+        }
+        LOG(INFO) << "computing distances for " << cloud->n_vertices() << " points...";
+        begin();
+        add(cloud->points(), signed_distance, &prop.vector());
+        LOG(INFO) << "done. " << w.time_string();
+        return end();
+    }
+
+
+    SurfaceMeshDistance::Statistics
+    SurfaceMeshDistance::compute(SurfaceMesh *mesh, bool signed_distance, const std::string &name) {
+        StopWatch w;
+        auto prop = mesh->vertex_property<float>(name);
+        if (!prop) {
+            LOG(ERROR) << "could not store the distances (a property named '" << name << "' exists with another type)";
+            return Statistics();
+        }
+        LOG(INFO) << "computing distances for " << mesh->n_vertices() << " vertices...";
+        begin();
+        add(mesh->points(), signed_distance, &prop.vector());
+        LOG(INFO) << "done. " << w.time_string();
+        return end();
+    }
+
+
+    SurfaceMeshDistance::Statistics SurfaceMeshDistance::compute_sampled(const SurfaceMesh *mesh, int num_samples) {
+        SurfaceMeshSampler sampler;
+        PointCloud *cloud = sampler.apply(mesh, num_samples);
+        if (!cloud)
+            return Statistics();
+
+        StopWatch w;
+        LOG(INFO) << "computing distances for " << cloud->n_vertices() << " samples...";
+        begin();
+        add(cloud->points());
+        delete cloud;
+        LOG(INFO) << "done. " << w.time_string();
+        return end();
+    }
+
+
+    SurfaceMeshDistance::Statistics
+    SurfaceMeshDistance::compute(const std::string &xyz_file, bool signed_distance, const std::string &output_file,
+                                 std::size_t chunk_size) {
+        std::ifstream input(xyz_file.c_str());
+        if (input.fail()) {
+            LOG(ERROR) << "could not open file: " << xyz_file;
+            return Statistics();
+        }
+
+        std::ofstream output;
+        if (!output_file.empty()) {
+            output.open(output_file.c_str());
+            if (output.fail()) {
+                LOG(ERROR) << "could not open file: " << output_file;
+                return Statistics();
+            }
+            output.precision(16);
+        }
+
+        StopWatch w;
+        LOG(INFO) << "computing distances for points in file: " << xyz_file;
+
+        std::vector<vec3> points;
+        std::vector<float> dist;
+        points.reserve(chunk_size);
+        auto flush = [&]() {
+            add(points, signed_distance, &dist);
+            if (output.is_open()) {
+                for (std::size_t i = 0; i < points.size(); ++i)
+                    output << points[i] << " " << dist[i] << std::endl;
+            }
+            points.clear();
+        };
+
+        begin();
+        io::LineInputStream in(input);
+        vec3 p;
+        while (!input.eof()) {
+            in.get_line();
+            if (in.current_line().empty() || in.current_line()[0] == '#')
+                continue;
+            in >> p;
+            if (in.fail())
+                continue;
+            points.push_back(p);
+            if (points.size() >= chunk_size)
+                flush();
+        }
+        if (!points.empty())
+            flush();
+
+        LOG(INFO) << "done. " << count_ << " points processed. " << w.time_string();
+        return end();
+    }
+
+
+    SurfaceMeshDistance::Statistics
+    SurfaceMeshDistance::hausdorff(const SurfaceMesh *mesh_a, const SurfaceMesh *mesh_b, int num_samples) {
+        const Statistics ab = SurfaceMeshDistance(mesh_b).compute_sampled(mesh_a, num_samples);
+        const Statistics ba = SurfaceMeshDistance(mesh_a).compute_sampled(mesh_b, num_samples);
+
+        if (ab.count == 0)
+            return ba;
+        else if (ba.count == 0)
+            return ab;
+
+        Statistics stats;
+        stats.count = ab.count + ba.count;
+        stats.min = std::min(ab.min, ba.min);
+        stats.max = std::max(ab.max, ba.max);
+        stats.mean = static_cast<float>((double(ab.mean) * ab.count + double(ba.mean) * ba.count) / stats.count);
+        stats.rms = static_cast<float>(std::sqrt(
+                (double(ab.rms) * ab.rms * ab.count + double(ba.rms) * ba.rms * ba.count) / stats.count));
+        return stats;
+    }
+
+}
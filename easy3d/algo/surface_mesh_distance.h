@@ -0,0 +1,151 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_ALGO_SURFACE_MESH_DISTANCE_H
+#define EASY3D_ALGO_SURFACE_MESH_DISTANCE_H
+
+
+#include <string>
+#include <vector>
+
+#include <easy3d/core/surface_mesh.h>
+
+
+namespace easy3d {
+
+    class PointCloud;
+    class TriangleMeshKdTree;
+
+    /**
+     * \brief Computes the distances from point sets (point clouds, mesh vertices, or samples of a surface mesh) to a
+     *      reference surface mesh.
+     * \class SurfaceMeshDistance easy3d/algo/surface_mesh_distance.h
+     * \details The closest points are found using a TriangleMeshKdTree and the queries are answered in parallel.
+     *      Signed distances are positive on the side the face normals point to, and are determined using the
+     *      angle-weighted pseudo-normals of the closest feature (face, edge, or vertex), see "Signed distance
+     *      computation using the angle weighted pseudonormal", Baerentzen and Aanaes, TVCG 2005.
+     *      Point sets that do not fit into memory can be processed in chunks using begin(), add(), and end().
+     *
+     * Example usage:
+     *      \code
+     *          SurfaceMeshDistance dist(reference);
+     *          const auto stats = dist.compute(cloud, true);   // stored in "v:distance" for rendering
+     *          std::cout << "Hausdorff: " << stats.max << ", mean: " << stats.mean << ", RMS: " << stats.rms;
+     *      \endcode
+     */
+    class SurfaceMeshDistance {
+    public:
+        /// \brief Statistics of the (absolute) distances of a point set.
+        struct Statistics {
+            Statistics() : count(0), min(0.0f), max(0.0f), mean(0.0f), rms(0.0f) {}
+            std::size_t count;  ///< number of points
+            float min;          ///< minimum distance
+            float max;          ///< maximum distance, i.e., the one-sided Hausdorff distance
+            float mean;         ///< mean distance
+            float rms;          ///< root mean square distance
+        };
+
+    public:
+        /// \brief Constructor. Non-triangular reference meshes are triangulated internally.
+        explicit SurfaceMeshDistance(const SurfaceMesh *reference);
+        ~SurfaceMeshDistance();
+
+        /**
+         * \brief Computes the distances from the points of a point cloud to the reference mesh.
+         * \param signed_distance \c true to compute signed distances.
+         * \param name The name of the vertex property (of type float) storing the distances.
+         * \return The statistics of the distances. If the property cannot be created (e.g., a property with the same
+         *      name but another type exists), nothing is computed and the returned statistics have a count of 0.
+         */
+        Statistics compute(PointCloud *cloud, bool signed_distance = false, const std::string &name = "v:distance");
+
+        /**
+         * \brief Computes the distances from the vertices of a surface mesh to the reference mesh.
+         * \param signed_distance \c true to compute signed distances.
+         * \param name The name of the vertex property (of type float) storing the distances.
+         * \return The statistics of the distances. If the property cannot be created (e.g., a property with the same
+         *      name but another type exists), nothing is computed and the returned statistics have a count of 0.
+         */
+        Statistics compute(SurfaceMesh *mesh, bool signed_distance = false, const std::string &name = "v:distance");
+
+        /**
+         * \brief Computes the distances from \p num_samples points sampled on a surface mesh to the reference mesh.
+         * \details The samples are generated by SurfaceMeshSampler and are not stored.
+         */
+        Statistics compute_sampled(const SurfaceMesh *mesh, int num_samples);
+
+        /**
+         * \brief Streams the points of an ASCII XYZ file (each line starting with the coordinates of a point) in
+         *      chunks, such that the file can be larger than the available memory.
+         * \param output_file If not empty, each point followed by its distance is written to this file.
+         * \param chunk_size The number of points processed at a time.
+         */
+        Statistics compute(const std::string &xyz_file, bool signed_distance = false,
+                           const std::string &output_file = "", std::size_t chunk_size = 1000000);
+
+        /**
+         * \brief Computes the symmetric Hausdorff, mean, and RMS distances between two surface meshes, using \p
+         *      num_samples samples on each mesh.
+         */
+        static Statistics hausdorff(const SurfaceMesh *mesh_a, const SurfaceMesh *mesh_b, int num_samples);
+
+        /// \brief Computes the distances of a set of points to the reference mesh (in parallel if possible).
+        void distances(const std::vector<vec3> &points, std::vector<float> &distances, bool signed_distance) const;
+
+        /// \name Streaming interface
+        //@{
+        /// \brief Resets the accumulated statistics.
+        void begin();
+        /// \brief Computes the distances of a chunk of points and accumulates their statistics.
+        /// \param distances If not null, returns the distances of the chunk.
+        void add(const std::vector<vec3> &points, bool signed_distance = false, std::vector<float> *distances = nullptr);
+        /// \brief Returns the statistics of all points added since the last call to begin().
+        Statistics end() const;
+        //@}
+
+    private:
+        // the normal (not normalized) used to determine the sign for a point p closest to q on face f
+        vec3 pseudo_normal(SurfaceMesh::Face f, const vec3 &q) const;
+
+    private:
+        const SurfaceMesh *reference_;
+        SurfaceMesh *triangulated_;     // a triangulated copy of the reference mesh if it has non-triangle faces
+        TriangleMeshKdTree *tree_;
+
+        std::vector<vec3> face_normals_;
+        std::vector<vec3> vertex_normals_;  // angle-weighted
+
+        // accumulated statistics
+        std::size_t count_;
+        double sum_;
+        double sum2_;
+        float min_;
+        float max_;
+    };
+
+} // namespace easy3d
+
+#endif  // EASY3D_ALGO_SURFACE_MESH_DISTANCE_H
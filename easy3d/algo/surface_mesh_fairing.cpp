@@ -11,9 +11,6 @@
 
 #include <easy3d/algo/surface_mesh_fairing.h>
 
-#include <Eigen/Dense>
-#include <Eigen/Sparse>
-
 #include <easy3d/algo/surface_mesh_geometry.h>
 #include <easy3d/util/logging.h>
 
@@ -21,8 +18,7 @@
 namespace easy3d {
 
     // \cond
-    using SparseMatrix = Eigen::SparseMatrix<double>;
-    using Triplet = Eigen::Triplet<double>;
+    using Triplet = SparseSolver::Triplet;
     // \endcond
 
     //=============================================================================
@@ -30,7 +26,9 @@ namespace easy3d {
     SurfaceMeshFairing::SurfaceMeshFairing(SurfaceMesh *mesh) : mesh_(mesh) {
         // get & add properties
         points_ = mesh_->get_vertex_property<vec3>("v:point");
-        vselected_ = mesh_->get_vertex_property<bool>("v:selected");
+        auto vselected = mesh_->get_vertex_property<bool>("v:selected");
+        if (vselected)
+            selected_.assign(vselected.vector());
         vlocked_ = mesh_->add_vertex_property<bool>("fairing:locked");
         vweight_ = mesh_->add_vertex_property<double>("fairing:vweight");
         eweight_ = mesh_->add_edge_property<double>("fairing:eweight");
@@ -49,6 +47,17 @@ namespace easy3d {
 
     //-----------------------------------------------------------------------------
 
+    void SurfaceMeshFairing::set_selection(const SelectionSet &selected) {
+        if (selected.size() != mesh_->vertices_size()) {
+            LOG(WARNING) << "the size of the selection (" << selected.size() << ") does not match the number of "
+                         << "vertices (" << mesh_->vertices_size() << "). Selection ignored";
+            return;
+        }
+        selected_ = selected;
+    }
+
+    //-----------------------------------------------------------------------------
+
     void SurfaceMeshFairing::fair(unsigned int k) {
         // compute cotan weights
         for (auto v : mesh_->vertices()) {
@@ -58,16 +67,10 @@ namespace easy3d {
             eweight_[e] = std::max(0.0, geom::cotan_weight(mesh_, e));
         }
 
-        // check whether some vertices are selected
-        bool no_selection = true;
-        if (vselected_) {
-            for (auto v : mesh_->vertices()) {
-                if (vselected_[v]) {
-                    no_selection = false;
-                    break;
-                }
-            }
-        }
+        // check whether some vertices are selected (vertices added after the selection are not selected)
+        const bool no_selection = selected_.none();
+        if (!no_selection)
+            selected_.resize(mesh_->vertices_size());
 
         // lock k locked boundary rings
         for (auto v : mesh_->vertices()) {
@@ -93,7 +96,7 @@ namespace easy3d {
 
         // lock un-selected and isolated vertices
         for (auto v : mesh_->vertices()) {
-            if (!no_selection && !vselected_[v]) {
+            if (!no_selection && !selected_.test(v.idx())) {
                 vlocked_[v] = true;
             }
 
@@ -120,8 +123,7 @@ namespace easy3d {
 
         // construct matrix & rhs
         const unsigned int n = vertices.size();
-        SparseMatrix A(n, n);
-        Eigen::MatrixXd B(n, 3);
+        std::vector<dvec3> B(n), X(n);
         dvec3 b;
 
         std::map<SurfaceMesh::Vertex, double> row;
@@ -143,22 +145,17 @@ namespace easy3d {
                 }
             }
 
-            B.row(i) = (Eigen::Vector3d) b;
+            B[i] = b;
+            X[i] = static_cast<dvec3>(points_[vertices[i]]);   // initial guess for the iterative solvers
         }
 
-        A.setFromTriplets(triplets.begin(), triplets.end());
-
         // solve A*X = B
-        Eigen::SimplicialLDLT<SparseMatrix> solver(A);
-        Eigen::MatrixXd X = solver.solve(B);
-
-        if (solver.info() != Eigen::Success) {
+        if (!solver_.factorize(n, triplets) || !solver_.solve(B, X)) {
             LOG(ERROR) << "SurfaceMeshFairing failed to solve the linear system";
         } else {
-            for (unsigned int i = 0; i < n; ++i) {
-                const auto &tmp = X.row(i);
-                points_[vertices[i]] = vec3(tmp(0), tmp(1), tmp(2));
-            }
+            for (unsigned int i = 0; i < n; ++i)
+                points_[vertices[i]] = vec3(X[i]);
+            mesh_->invalidate_bounding_box();
         }
     }
 
@@ -13,6 +13,8 @@
 #define EASY3D_ALGO_SURFACE_MESH_FAIRING_H
 
 #include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/selection_set.h>
+#include <easy3d/algo/sparse_solver.h>
 #include <map>
 
 namespace easy3d {
@@ -40,6 +42,18 @@ namespace easy3d {
         //! compute surface by solving k-harmonic equation
         void fair(unsigned int k = 2);
 
+        //! \brief Restricts fairing to the selected vertices. The other vertices are kept fixed.
+        //! \details The selection is indexed by SurfaceMesh::Vertex::idx() and its size must be equal to
+        //!     SurfaceMesh::vertices_size(). If no selection is given, the vertices marked in the bool property
+        //!     "v:selected" (if it exists when the fairing is constructed) are used. An empty selection means all
+        //!     vertices can be moved.
+        void set_selection(const SelectionSet &selected);
+
+        //! \brief The solver of the linear system.
+        //! \details Use it to choose the solver type or to query the time spent in each phase. Its factorizations
+        //!     are kept across calls of fair() and reused whenever possible.
+        SparseSolver& solver() { return solver_; }
+
     private:
         void setup_matrix_row(const SurfaceMesh::Vertex v, SurfaceMesh::VertexProperty<double> vweight,
                               SurfaceMesh::EdgeProperty<double> eweight,
@@ -51,11 +65,14 @@ namespace easy3d {
 
         // property handles
         SurfaceMesh::VertexProperty <vec3> points_;
-        SurfaceMesh::VertexProperty<bool> vselected_;
         SurfaceMesh::VertexProperty<bool> vlocked_;
         SurfaceMesh::VertexProperty<double> vweight_;
         SurfaceMesh::EdgeProperty<double> eweight_;
         SurfaceMesh::VertexProperty<int> idx_;
+
+        SelectionSet selected_;
+
+        SparseSolver solver_;
     };
 
 
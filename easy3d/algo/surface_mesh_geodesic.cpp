@@ -10,12 +10,13 @@
  ********************************************************************/
 
 #include <easy3d/algo/surface_mesh_geodesic.h>
+#include <easy3d/algo/surface_mesh_geometry.h>
 
 
 namespace easy3d {
 
     SurfaceMeshGeodesic::SurfaceMeshGeodesic(SurfaceMesh *mesh, bool use_virtual_edges)
-            : mesh_(mesh), use_virtual_edges_(use_virtual_edges) {
+            : mesh_(mesh), use_virtual_edges_(use_virtual_edges), heat_time_factor_(0.0f) {
         distance_ = mesh_->vertex_property<float>("v:geodesic:distance");
         processed_ = mesh_->add_vertex_property<bool>("v:geodesic:processed");
 
@@ -387,6 +388,182 @@ namespace easy3d {
 
     //-----------------------------------------------------------------------------
 
+    bool SurfaceMeshGeodesic::factorize_heat(float time_factor) {
+        if (!mesh_->is_triangle_mesh()) {
+            LOG(ERROR) << "the heat method requires a triangle mesh";
+            return false;
+        }
+        if (mesh_->n_edges() == 0) {
+            LOG(ERROR) << "the heat method requires a mesh with edges";
+            return false;
+        }
+        if (time_factor <= 0.0f) {
+            LOG(ERROR) << "the time factor of the heat method must be positive (" << time_factor << " given)";
+            return false;
+        }
+
+        const int nv = static_cast<int>(mesh_->vertices_size());
+        const int nh = static_cast<int>(mesh_->halfedges_size());
+
+        // cotangent of the angle opposite to each (non-border) halfedge
+        heat_cotan_.assign(nh, 0.0);
+#pragma omp parallel for
+        for (int i = 0; i < nh; ++i) {
+            const SurfaceMesh::Halfedge h(i);
+            if (mesh_->is_deleted(h) || mesh_->is_border(h))
+                continue;
+            const dvec3 p0 = (dvec3) mesh_->position(mesh_->source(h));
+            const dvec3 p1 = (dvec3) mesh_->position(mesh_->target(h));
+            const dvec3 p2 = (dvec3) mesh_->position(mesh_->target(mesh_->next(h)));
+            const dvec3 d0 = p0 - p2;
+            const dvec3 d1 = p1 - p2;
+            const double area = norm(cross(d0, d1));
+            if (area > std::numeric_limits<double>::min())
+                heat_cotan_[i] = geom::clamp_cot(dot(d0, d1) / area);
+        }
+
+        // mean edge length
+        double h = 0.0;
+        for (auto e : mesh_->edges())
+            h += mesh_->edge_length(e);
+        h /= mesh_->n_edges();
+        const double t = time_factor * h * h;
+
+        // cotan Laplacian (positive semi-definite) and lumped mass matrix
+        std::vector<double> area;
+        area.resize(nv);
+#pragma omp parallel for
+        for (int i = 0; i < nv; ++i) {
+            const SurfaceMesh::Vertex v(i);
+            area[i] = mesh_->is_deleted(v) ? 0.0 : geom::voronoi_area(mesh_, v);
+        }
+
+        // the systems are built for the valid vertices only, numbered compactly (deleted vertices have no row)
+        const int rows = static_cast<int>(mesh_->n_vertices());
+        heat_index_.assign(nv, -1);
+        int count = 0;
+        for (auto v : mesh_->vertices())
+            heat_index_[v.idx()] = count++;
+
+        std::vector<SparseSolver::Triplet> heat, poisson;
+        for (auto v : mesh_->vertices()) {
+            const int i = heat_index_[v.idx()];
+            // isolated vertices get an identity row
+            const double m = area[v.idx()] > std::numeric_limits<double>::min() ? area[v.idx()] : 1.0;
+            double diag = 0.0;
+            for (auto hv : mesh_->halfedges(v)) {
+                const double w = 0.5 * (heat_cotan_[hv.idx()] + heat_cotan_[mesh_->opposite(hv).idx()]);
+                const int j = heat_index_[mesh_->target(hv).idx()];
+                heat.emplace_back(i, j, -t * w);
+                poisson.emplace_back(i, j, -w);
+                diag += w;
+            }
+            heat.emplace_back(i, i, m + t * diag);
+            // a tiny mass term makes the Poisson system non-singular
+            poisson.emplace_back(i, i, diag + 1e-8 * m);
+        }
+
+        if (!heat_solver_.factorize(rows, heat) || !poisson_solver_.factorize(rows, poisson)) {
+            LOG(ERROR) << "failed to factorize the systems of the heat method";
+            heat_time_factor_ = 0.0f;
+            return false;
+        }
+
+        heat_time_factor_ = time_factor;
+        return true;
+    }
+
+    //-----------------------------------------------------------------------------
+
+    bool SurfaceMeshGeodesic::compute_heat(const std::vector<SurfaceMesh::Vertex> &seed, float time_factor) {
+        if (seed.empty()) {
+            LOG(ERROR) << "no seed vertices given";
+            return false;
+        }
+        // not factorized yet (heat_time_factor_ is 0), or with another time factor
+        if ((heat_time_factor_ <= 0.0f || time_factor != heat_time_factor_) && !factorize_heat(time_factor))
+            return false;
+
+        const int rows = static_cast<int>(mesh_->n_vertices());
+        const int nv = static_cast<int>(mesh_->vertices_size());
+        const int nf = static_cast<int>(mesh_->faces_size());
+        for (auto v : seed) {
+            if (!mesh_->is_valid(v) || mesh_->is_deleted(v)) {
+                LOG(ERROR) << "invalid or deleted seed vertex: " << v;
+                return false;
+            }
+        }
+
+        // step 1: heat flow from the seed vertices (the unknowns are numbered by heat_index_)
+        std::vector<double> delta(rows, 0.0), u;
+        for (auto v : seed)
+            delta[heat_index_[v.idx()]] = 1.0;
+        if (!heat_solver_.solve(delta, u))
+            return false;
+
+        // step 2: normalized negative gradient of the heat per face
+        std::vector<dvec3> X(nf, dvec3(0, 0, 0));
+#pragma omp parallel for
+        for (int i = 0; i < nf; ++i) {
+            const SurfaceMesh::Face f(i);
+            if (mesh_->is_deleted(f))
+                continue;
+            SurfaceMesh::Vertex v[3];
+            int k = 0;
+            for (auto vf : mesh_->vertices(f))
+                v[k++] = vf;
+            const dvec3 p0 = (dvec3) mesh_->position(v[0]);
+            const dvec3 p1 = (dvec3) mesh_->position(v[1]);
+            const dvec3 p2 = (dvec3) mesh_->position(v[2]);
+            const dvec3 n = cross(p1 - p0, p2 - p0);
+            const double area2 = norm(n);
+            if (area2 <= std::numeric_limits<double>::min())
+                continue;
+            const dvec3 grad = (cross(n, p2 - p1) * u[heat_index_[v[0].idx()]] +
+                                cross(n, p0 - p2) * u[heat_index_[v[1].idx()]] +
+                                cross(n, p1 - p0) * u[heat_index_[v[2].idx()]]) / (area2 * area2);
+            const double len = norm(grad);
+            if (len > std::numeric_limits<double>::min())
+                X[i] = -grad / len;
+        }
+
+        // step 3: integrated divergence of the gradient field per vertex
+        std::vector<double> div(rows, 0.0), phi;
+#pragma omp parallel for
+        for (int i = 0; i < nv; ++i) {
+            const SurfaceMesh::Vertex v(i);
+            if (mesh_->is_deleted(v))
+                continue;
+            const dvec3 p = (dvec3) mesh_->position(v);
+            double sum = 0.0;
+            for (auto h : mesh_->halfedges(v)) {
+                if (mesh_->is_border(h))
+                    continue;
+                const dvec3 &x = X[mesh_->face(h).idx()];
+                const SurfaceMesh::Halfedge prev = mesh_->prev(h);
+                const dvec3 e1 = (dvec3) mesh_->position(mesh_->target(h)) - p;
+                const dvec3 e2 = (dvec3) mesh_->position(mesh_->source(prev)) - p;
+                sum += heat_cotan_[h.idx()] * dot(e1, x) + heat_cotan_[prev.idx()] * dot(e2, x);
+            }
+            div[heat_index_[i]] = -0.5 * sum;
+        }
+
+        // step 4: recover the distances by solving the Poisson equation
+        if (!poisson_solver_.solve(div, phi))
+            return false;
+
+        // shift the distances such that they are zero at the seed vertices
+        double shift = std::numeric_limits<double>::max();
+        for (auto v : seed)
+            shift = std::min(shift, phi[heat_index_[v.idx()]]);
+        for (auto v : mesh_->vertices())
+            distance_[v] = static_cast<float>(std::max(0.0, phi[heat_index_[v.idx()]] - shift));
+
+        return true;
+    }
+
+    //-----------------------------------------------------------------------------
+
     void SurfaceMeshGeodesic::distance_to_texture_coordinates() {
         // find maximum distance
         float maxdist(0);
@@ -13,6 +13,7 @@
 #define EASY3D_ALGO_SURFACE_MESH_GEODESIC_H
 
 #include <easy3d/core/surface_mesh.h>
+#include <easy3d/algo/sparse_solver.h>
 #include <vector>
 #include <set>
 #include <float.h>
@@ -27,6 +28,11 @@ namespace easy3d {
      * heap structure. See the following paper for more details:
      *  - Kimmel and Sethian. Computing geodesic paths on manifolds. Proceedings of the National Academy of Sciences,
      *    95(15):8431–8435, 1998.
+     *
+     * Alternatively, compute_heat() computes the geodesic distances using the heat method, which is suitable for
+     * many queries on the same mesh. See the following paper for more details:
+     *  - Crane, Weischedel, and Wardetzky. Geodesics in heat: a new approach to computing distance based on heat flow.
+     *    ACM Transactions on Graphics, 32(5):152:1–152:11, 2013.
      */
     class SurfaceMeshGeodesic {
     public:
@@ -53,6 +59,17 @@ namespace easy3d {
                              unsigned int maxnum = INT_MAX,
                              std::vector<SurfaceMesh::Vertex> *neighbors = nullptr);
 
+        //! \brief Compute geodesic distances from specified seed points using the heat method.
+        //! \details The results are stored in the same vertex property "v:geodesic:distance" as compute(). The heat
+        //! and Poisson systems are factorized in the first call only (and when \p time_factor changes), so each
+        //! subsequent query is just two back-substitutions. The mesh must not be modified between queries.
+        //! \param[in] seed The vector of seed vertices.
+        //! \param[in] time_factor The time step of the heat flow is \p time_factor * h^2, where h is the mean edge
+        //! length. Larger values give smoother distances. It must be positive.
+        //! \return \c true on success.
+        //! \pre The mesh must be a triangle mesh.
+        bool compute_heat(const std::vector<SurfaceMesh::Vertex> &seed, float time_factor = 1.0f);
+
         //! \brief Access the computed geodesic distance.
         //! \param[in] v The vertex for which to return the geodesic distance.
         //! \return The geodesic distance of vertex \p v.
@@ -110,6 +127,9 @@ namespace easy3d {
         float distance(SurfaceMesh::Vertex v0, SurfaceMesh::Vertex v1, SurfaceMesh::Vertex v2, float r0 = FLT_MAX,
                        float r1 = FLT_MAX);
 
+        // factorizes the heat and Poisson systems of the heat method
+        bool factorize_heat(float time_factor);
+
     private: // private data
         SurfaceMesh *mesh_;
 
@@ -120,6 +140,13 @@ namespace easy3d {
 
         SurfaceMesh::VertexProperty<float> distance_;
         SurfaceMesh::VertexProperty<bool> processed_;
+
+        // the heat method
+        SparseSolver heat_solver_;
+        SparseSolver poisson_solver_;
+        float heat_time_factor_;
+        std::vector<double> heat_cotan_;    // cotangent of the angle opposite to each halfedge
+        std::vector<int> heat_index_;       // the row of each vertex in the systems (-1 for deleted vertices)
     };
 
 } // namespace easy3d
@@ -306,6 +306,46 @@ namespace easy3d {
 
         //-----------------------------------------------------------------------------
 
+        namespace internal {
+
+            // the values are indexed by the edge indices
+            void cotan_weights(const SurfaceMesh *mesh, std::vector<double> &cotan) {
+                const int num = static_cast<int>(mesh->edges_size());
+                cotan.resize(num);
+#pragma omp parallel for
+                for (int i = 0; i < num; ++i) {
+                    const SurfaceMesh::Edge e(i);
+                    cotan[i] = mesh->is_deleted(e) ? 0.0 : cotan_weight(mesh, e);
+                }
+            }
+
+            // the values are indexed by the vertex indices
+            void voronoi_areas(const SurfaceMesh *mesh, std::vector<double> &area) {
+                const int num = static_cast<int>(mesh->vertices_size());
+                area.resize(num);
+#pragma omp parallel for
+                for (int i = 0; i < num; ++i) {
+                    const SurfaceMesh::Vertex v(i);
+                    area[i] = mesh->is_deleted(v) ? 0.0 : voronoi_area(mesh, v);
+                }
+            }
+
+        }
+
+        //-----------------------------------------------------------------------------
+
+        void cotan_weights(const SurfaceMesh *mesh, SurfaceMesh::EdgeProperty<double> cotan) {
+            internal::cotan_weights(mesh, cotan.vector());
+        }
+
+        //-----------------------------------------------------------------------------
+
+        void voronoi_areas(const SurfaceMesh *mesh, SurfaceMesh::VertexProperty<double> area) {
+            internal::voronoi_areas(mesh, area.vector());
+        }
+
+        //-----------------------------------------------------------------------------
+
         VertexCurvature vertex_curvature(const SurfaceMesh *mesh, SurfaceMesh::Vertex v) {
             VertexCurvature c;
 
@@ -330,6 +370,44 @@ namespace easy3d {
             return c;
         }
 
+
+        //-----------------------------------------------------------------------------
+
+        void vertex_curvatures(const SurfaceMesh *mesh, std::vector<VertexCurvature> &curvatures) {
+            std::vector<double> cotan, area;
+            internal::cotan_weights(mesh, cotan);
+            internal::voronoi_areas(mesh, area);
+
+            const int num = static_cast<int>(mesh->vertices_size());
+            curvatures.assign(num, VertexCurvature());
+#pragma omp parallel for
+            for (int i = 0; i < num; ++i) {
+                const SurfaceMesh::Vertex v(i);
+                if (mesh->is_deleted(v) || mesh->is_isolated(v) || area[i] <= std::numeric_limits<float>::min())
+                    continue;
+
+                // Laplace with the precomputed cotan weights (the same as laplace())
+                const vec3 &p0 = mesh->position(v);
+                vec3 laplace(0.0, 0.0, 0.0);
+                float sum_weights(0.0);
+                for (auto h : mesh->halfedges(v)) {
+                    const float weight = cotan[mesh->edge(h).idx()];
+                    sum_weights += weight;
+                    laplace += weight * mesh->position(mesh->target(h));
+                }
+                laplace -= sum_weights * p0;
+                laplace /= float(2.0) * area[i];
+
+                VertexCurvature &c = curvatures[i];
+                c.mean = float(0.5) * norm(laplace);
+                c.gauss = (2.0 * M_PI - angle_sum(mesh, v)) / area[i];
+
+                const float s = sqrt(std::max(float(0.0), c.mean * c.mean - c.gauss));
+                c.min = c.mean - s;
+                c.max = c.mean + s;
+            }
+        }
+
     }
 
 } // namespace easy3d
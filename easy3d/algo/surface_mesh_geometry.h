@@ -59,6 +59,12 @@ namespace easy3d {
         /** \brief compute the sum of angles around vertex v (used for Gaussian curvature)    */
         float angle_sum(const SurfaceMesh *mesh, SurfaceMesh::Vertex v);
 
+        /** \brief compute the cotangent weights of all edges (in parallel)    */
+        void cotan_weights(const SurfaceMesh *mesh, SurfaceMesh::EdgeProperty<double> cotan);
+
+        /** \brief compute the (mixed) Voronoi areas of all vertices (in parallel)    */
+        void voronoi_areas(const SurfaceMesh *mesh, SurfaceMesh::VertexProperty<double> area);
+
         /** \brief discrete curvature information for a vertex. used for vertex_curvature()    */
         struct VertexCurvature {
             VertexCurvature() : mean(0.0), gauss(0.0), max(0.0), min(0.0) {}
@@ -73,6 +79,15 @@ namespace easy3d {
         /** \attention This will not give reliable values for boundary vertices.    */
         VertexCurvature vertex_curvature(const SurfaceMesh *mesh, SurfaceMesh::Vertex v);
 
+        /**
+         * \brief compute min, max, mean, and Gaussian curvature for all vertices (in parallel).
+         * \details The cotangent weight of each edge and the Voronoi area of each vertex are computed only once, so
+         *      this is much faster than calling vertex_curvature() for each vertex.
+         * \param curvatures Returns the curvatures, indexed by the vertex indices.
+         * \attention This will not give reliable values for boundary vertices.
+         */
+        void vertex_curvatures(const SurfaceMesh *mesh, std::vector<VertexCurvature> &curvatures);
+
     }
 
 } // namespace easy3d
@@ -444,16 +444,16 @@ namespace easy3d {
             return;
 
         // convert non-locked into selection
-        auto vsel = mesh_->vertex_property<bool>("v:selected");
-        for (auto v : mesh_->vertices())
-            vsel[v] = !vlocked_[v];
+        SelectionSet selected(mesh_->vertices_size());
+        for (auto v : mesh_->vertices()) {
+            if (!vlocked_[v])
+                selected.set(v.idx());
+        }
 
         // fair new vertices
         SurfaceMeshFairing fairing(mesh_);
+        fairing.set_selection(selected);
         fairing.minimize_curvature();
-
-        // clean up
-        mesh_->remove_vertex_property(vsel);
     }
 
 }
\ No newline at end of file
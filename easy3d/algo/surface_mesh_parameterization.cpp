@@ -12,8 +12,6 @@
 #include <easy3d/algo/surface_mesh_parameterization.h>
 
 #include <cmath>
-#include <Eigen/Dense>
-#include <Eigen/Sparse>
 
 #include <easy3d/algo/surface_mesh_geometry.h>
 #include <easy3d/util/logging.h>
@@ -121,10 +119,8 @@ namespace easy3d {
 
         // setup matrix A and rhs B
         const unsigned int n = free_vertices.size();
-        Eigen::SparseMatrix<double> A(n, n);
-        Eigen::MatrixXd B(n, 2);
-        std::vector<Eigen::Triplet<double>>
-                triplets;
+        std::vector<dvec2> B(n), X;
+        std::vector<SparseSolver::Triplet> triplets;
         dvec2 b;
         double w, ww;
         SurfaceMesh::Vertex v, vv;
@@ -150,23 +146,16 @@ namespace easy3d {
                 }
             }
             triplets.emplace_back(i, i, ww);
-            B.row(i) = (Eigen::Vector2d) b;
+            B[i] = b;
         }
 
-        // build sparse matrix from triplets
-        A.setFromTriplets(triplets.begin(), triplets.end());
-
         // solve A*X = B
-        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(A);
-        Eigen::MatrixXd X = solver.solve(B);
-        if (solver.info() != Eigen::Success) {
+        if (!solver_.factorize(n, triplets) || !solver_.solve(B, X)) {
             LOG(ERROR) << "failed solving the linear system.";
         } else {
             // copy solution
-            for (i = 0; i < n; ++i) {
-                const auto &tmp = X.row(i);
-                tex[free_vertices[i]] = vec2(tmp(0), tmp(1));
-            }
+            for (i = 0; i < n; ++i)
+                tex[free_vertices[i]] = vec2(X[i]);
         }
 
         // clean-up
@@ -307,10 +296,8 @@ namespace easy3d {
         double si, sj0, sj1, sign;
         int row(0), c0, c1;
 
-        Eigen::SparseMatrix<double> A(2 * n, 2 * n);
-        Eigen::VectorXd b = Eigen::VectorXd::Zero(2 * n);
-        std::vector<Eigen::Triplet<double>>
-                triplets;
+        std::vector<double> b(2 * n, 0.0), x;
+        std::vector<SparseSolver::Triplet> triplets;
 
         for (unsigned int i = 0; i < nv2; ++i) {
             vi = SurfaceMesh::Vertex(i % nv);
@@ -366,13 +353,8 @@ namespace easy3d {
             }
         }
 
-        // build sparse matrix from triplets
-        A.setFromTriplets(triplets.begin(), triplets.end());
-
         // solve A*X = B
-        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(A);
-        Eigen::VectorXd x = solver.solve(b);
-        if (solver.info() != Eigen::Success) {
+        if (!solver_.factorize(2 * n, triplets) || !solver_.solve(b, x)) {
             LOG(ERROR) << "failed solving the linear system";
         } else {
             // copy solution
@@ -14,6 +14,7 @@
 
 
 #include <easy3d/core/surface_mesh.h>
+#include <easy3d/algo/sparse_solver.h>
 
 
 namespace easy3d {
@@ -36,6 +37,11 @@ namespace easy3d {
         //! \brief Compute parameterization based on least squares conformal mapping.
         void lscm();
 
+        //! \brief The solver of the linear systems.
+        //! \details Use it to choose the solver type or to query the time spent in each phase. Its factorizations
+        //!     are kept and reused whenever possible.
+        SparseSolver& solver() { return solver_; }
+
     private:
         //! setup boundary constraints: map surface boundary to unit circle
         bool setup_boundary_constraints();
@@ -46,6 +52,8 @@ namespace easy3d {
     private:
         //! the mesh
         SurfaceMesh *mesh_;
+
+        SparseSolver solver_;
     };
 
 } // namespace easy3d
@@ -18,6 +18,8 @@
 #include <easy3d/algo/surface_mesh_curvature.h>
 #include <easy3d/algo/surface_mesh_geometry.h>
 #include <easy3d/util/progress.h>
+#include <easy3d/util/logging.h>
+#include <easy3d/util/tracing.h>
 
 namespace easy3d {
 
@@ -34,16 +36,27 @@ namespace easy3d {
 
     SurfaceMeshRemeshing::~SurfaceMeshRemeshing() = default;
 
+    void SurfaceMeshRemeshing::set_selection(const SelectionSet &selected) {
+        if (selected.size() != mesh_->vertices_size()) {
+            LOG(WARNING) << "the size of the selection (" << selected.size() << ") does not match the number of "
+                         << "vertices (" << mesh_->vertices_size() << "). Selection ignored";
+            return;
+        }
+        selected_ = selected;
+    }
+
     void SurfaceMeshRemeshing::uniform_remeshing(float edge_length,
                                                  unsigned int iterations,
-                                                 bool use_projection) {
+                                                 bool use_projection,
+                                                 const CancellationToken &token) {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::uniform_remeshing", "algo");
         uniform_ = true;
         use_projection_ = use_projection;
         target_edge_length_ = edge_length;
 
         preprocessing();
 
-        ProgressLogger progress(iterations, false, false);
+        ProgressLogger progress(iterations, false, false, token);
         for (unsigned int i = 0; i < iterations; ++i) {
             if (progress.is_canceled()) {
                 LOG(WARNING) << "remeshing surface mesh cancelled";
@@ -71,7 +84,9 @@ namespace easy3d {
                                                   float max_edge_length,
                                                   float approx_error,
                                                   unsigned int iterations,
-                                                  bool use_projection) {
+                                                  bool use_projection,
+                                                  const CancellationToken &token) {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::adaptive_remeshing", "algo");
         uniform_ = false;
         min_edge_length_ = min_edge_length;
         max_edge_length_ = max_edge_length;
@@ -80,7 +95,7 @@ namespace easy3d {
 
         preprocessing();
 
-        ProgressLogger progress(iterations, false, false);
+        ProgressLogger progress(iterations, false, false, token);
         for (unsigned int i = 0; i < iterations; ++i) {
             if (progress.is_canceled()) {
                 LOG(WARNING) << "remeshing surface mesh cancelled";
@@ -104,6 +119,7 @@ namespace easy3d {
     }
 
     void SurfaceMeshRemeshing::preprocessing() {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::preprocessing", "algo");
         // properties
         vfeature_ = mesh_->vertex_property<bool>("v:feature", false);
         efeature_ = mesh_->edge_property<bool>("e:feature", false);
@@ -112,26 +128,22 @@ namespace easy3d {
         vsizing_ = mesh_->add_vertex_property<float>("v:sizing:SurfaceMeshRemeshing");
 
         // lock unselected vertices if some vertices are selected
-        auto vselected = mesh_->get_vertex_property<bool>("v:selected");
-        if (vselected) {
-            bool has_selection = false;
+        SelectionSet selected = selected_;
+        if (selected.size() == 0) {
+            auto vselected = mesh_->get_vertex_property<bool>("v:selected");
+            if (vselected)
+                selected.assign(vselected.vector());
+        }
+        selected.resize(mesh_->vertices_size());
+        if (selected.any()) {
             for (auto v : mesh_->vertices()) {
-                if (vselected[v]) {
-                    has_selection = true;
-                    break;
-                }
+                vlocked_[v] = !selected.test(v.idx());
             }
 
-            if (has_selection) {
-                for (auto v : mesh_->vertices()) {
-                    vlocked_[v] = !vselected[v];
-                }
-
-                // lock an edge if one of its vertices is locked
-                for (auto e : mesh_->edges()) {
-                    elocked_[e] = (vlocked_[mesh_->vertex(e, 0)] ||
-                                   vlocked_[mesh_->vertex(e, 1)]);
-                }
+            // lock an edge if one of its vertices is locked
+            for (auto e : mesh_->edges()) {
+                elocked_[e] = (vlocked_[mesh_->vertex(e, 0)] ||
+                               vlocked_[mesh_->vertex(e, 1)]);
             }
         }
 
@@ -246,6 +258,7 @@ namespace easy3d {
     }
 
     void SurfaceMeshRemeshing::postprocessing() {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::postprocessing", "algo");
         // delete kd-tree and reference mesh
         if (use_projection_) {
             delete kd_tree_;
@@ -256,6 +269,8 @@ namespace easy3d {
         mesh_->remove_vertex_property(vlocked_);
         mesh_->remove_edge_property(elocked_);
         mesh_->remove_vertex_property(vsizing_);
+
+        mesh_->invalidate_bounding_box();
     }
 
     void SurfaceMeshRemeshing::project_to_reference(SurfaceMesh::Vertex v) {
@@ -310,6 +325,7 @@ namespace easy3d {
     }
 
     void SurfaceMeshRemeshing::split_long_edges() {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::split_long_edges", "algo");
         SurfaceMesh::Vertex vnew, v0, v1;
         SurfaceMesh::Edge enew, e0, e1;
         SurfaceMesh::Face f0, f1, f2, f3;
@@ -353,6 +369,7 @@ namespace easy3d {
     }
 
     void SurfaceMeshRemeshing::collapse_short_edges() {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::collapse_short_edges", "algo");
         SurfaceMesh::Vertex v0, v1;
         SurfaceMesh::Halfedge h0, h1, h01, h10;
         bool ok, b0, b1, l0, l1, f0, f1;
@@ -475,6 +492,7 @@ namespace easy3d {
     }
 
     void SurfaceMeshRemeshing::flip_edges() {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::flip_edges", "algo");
         SurfaceMesh::Vertex v0, v1, v2, v3;
         SurfaceMesh::Halfedge h;
         int val0, val1, val2, val3;
@@ -559,6 +577,7 @@ namespace easy3d {
     }
 
     void SurfaceMeshRemeshing::tangential_smoothing(unsigned int iterations) {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::tangential_smoothing", "algo");
         SurfaceMesh::Vertex v1, v2, v3, vv;
         SurfaceMesh::Edge e;
         float w, ww;
@@ -660,6 +679,7 @@ namespace easy3d {
     }
 
     void SurfaceMeshRemeshing::remove_caps() {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshRemeshing::remove_caps", "algo");
         SurfaceMesh::Halfedge h;
         SurfaceMesh::Vertex v, vb, vd;
         SurfaceMesh::Face fb, fd;
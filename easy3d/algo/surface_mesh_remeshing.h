@@ -13,6 +13,8 @@
 #define EASY3D_ALGO_SURFACE_MESH_REMESHING_H
 
 #include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/selection_set.h>
+#include <easy3d/util/progress.h>
 
 namespace easy3d {
 
@@ -38,8 +40,11 @@ namespace easy3d {
         //! \param edge_length the target edge length.
         //! \param iterations the number of iterations
         //! \param use_projection use back-projection to the input surface
+        //! \param token a token to cancel the remeshing (e.g., from another thread), which is checked before each
+        //!     iteration. A cancelled remeshing leaves the mesh partially remeshed.
         void uniform_remeshing(float edge_length, unsigned int iterations = 10,
-                               bool use_projection = true);
+                               bool use_projection = true,
+                               const CancellationToken &token = CancellationToken());
 
         //! \brief Perform adaptive remeshing.
         //! \param min_edge_length the minimum edge length.
@@ -47,9 +52,17 @@ namespace easy3d {
         //! \param approx_error the maximum approximation error
         //! \param iterations the number of iterations
         //! \param use_projection use back-projection to the input surface
+        //! \param token a token to cancel the remeshing (see uniform_remeshing()).
         void adaptive_remeshing(float min_edge_length, float max_edge_length,
                                 float approx_error, unsigned int iterations = 10,
-                                bool use_projection = true);
+                                bool use_projection = true,
+                                const CancellationToken &token = CancellationToken());
+
+        //! \brief Restricts remeshing to the selected vertices. The other vertices (and their edges) are locked.
+        //! \details The selection is indexed by SurfaceMesh::Vertex::idx() and its size must be equal to
+        //!     SurfaceMesh::vertices_size(). If no selection is given, the vertices marked in the bool property
+        //!     "v:selected" (if it exists) are used. An empty selection means the whole mesh is remeshed.
+        void set_selection(const SelectionSet &selected);
 
     private:
         void preprocessing();
@@ -93,6 +106,8 @@ namespace easy3d {
         SurfaceMesh::EdgeProperty<bool> elocked_;
         SurfaceMesh::VertexProperty<float> vsizing_;
 
+        SelectionSet selected_;
+
         SurfaceMesh::VertexProperty <vec3> refpoints_;
         SurfaceMesh::VertexProperty <vec3> refnormals_;
         SurfaceMesh::VertexProperty<float> refsizing_;
@@ -35,8 +35,9 @@
 namespace easy3d {
 
 
-    PointCloud *SurfaceMeshSampler::apply(const SurfaceMesh *input_mesh, int expected_num /* = 1000000 */) {
-        auto func = [](const SurfaceMesh *mesh, int num) -> PointCloud * {
+    PointCloud *SurfaceMeshSampler::apply(const SurfaceMesh *input_mesh, int expected_num /* = 1000000 */,
+                                          const CancellationToken &token) {
+        auto func = [&token](const SurfaceMesh *mesh, int num) -> PointCloud * {
             PointCloud *cloud = new PointCloud;
             const std::string &name = file_system::name_less_extension(mesh->name()) + "_sampled.ply";
             cloud->set_name(name);
@@ -105,7 +106,7 @@ namespace easy3d {
             std::size_t triangle_num = triangles.size();
             std::size_t num_generated = 0;
             std::size_t triangles_done = 0;
-            ProgressLogger progress(triangle_num, false, false);
+            ProgressLogger progress(triangle_num, false, false, token);
             for (std::size_t idx = 0; idx < triangle_num; ++idx) {
                 if (progress.is_canceled()) {
                     LOG(WARNING) << "sampling surface mesh cancelled";
@@ -27,6 +27,7 @@
 #ifndef EASY3D_ALGO_MESH_SAMPLER_H
 #define EASY3D_ALGO_MESH_SAMPLER_H
 
+#include <easy3d/util/progress.h>
 
 namespace easy3d {
 
@@ -38,7 +39,10 @@ namespace easy3d {
     class SurfaceMeshSampler {
     public:
         /// @param num The expected point number, must be greater than the number of vertices of the surface mesh.
-        PointCloud *apply(const SurfaceMesh *mesh, int num = 1000000);
+        /// @param token A token to cancel the sampling (e.g., from another thread), in which case \c nullptr is
+        ///     returned.
+        PointCloud *apply(const SurfaceMesh *mesh, int num = 1000000,
+                          const CancellationToken &token = CancellationToken());
     };
 
 } // namespace easy3d
@@ -10,6 +10,8 @@
  ********************************************************************/
 
 #include <easy3d/algo/surface_mesh_simplification.h>
+#include <easy3d/util/tracing.h>
+#include <easy3d/util/logging.h>
 
 #include <cfloat>
 #include <iterator> // for back_inserter on Windows
@@ -40,10 +42,22 @@ namespace easy3d {
 
     //-----------------------------------------------------------------------------
 
+    void SurfaceMeshSimplification::set_selection(const SelectionSet &selected) {
+        if (selected.size() != mesh_->vertices_size()) {
+            LOG(WARNING) << "the size of the selection (" << selected.size() << ") does not match the number of "
+                         << "vertices (" << mesh_->vertices_size() << "). Selection ignored";
+            return;
+        }
+        selected_ = selected;
+    }
+
+    //-----------------------------------------------------------------------------
+
     void SurfaceMeshSimplification::initialize(float aspect_ratio, float edge_length,
                                                unsigned int max_valence,
                                                float normal_deviation,
                                                float hausdorff_error) {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshSimplification::initialize", "algo");
         if (!mesh_->is_triangle_mesh())
             return;
 
@@ -68,16 +82,12 @@ namespace easy3d {
         vquadric_ = mesh_->add_vertex_property<Quadric>("v:quadric");
 
         // vertex selection
-        has_selection_ = false;
-        vselected_ = mesh_->get_vertex_property<bool>("v:selected");
-        if (vselected_) {
-            for (auto v : mesh_->vertices()) {
-                if (vselected_[v]) {
-                    has_selection_ = true;
-                    break;
-                }
-            }
+        if (selected_.size() == 0) {
+            auto vselected = mesh_->get_vertex_property<bool>("v:selected");
+            if (vselected)
+                selected_.assign(vselected.vector());
         }
+        has_selection_ = selected_.any();
 
         // feature vertices/edges
         has_features_ = false;
@@ -122,7 +132,8 @@ namespace easy3d {
 
     //-----------------------------------------------------------------------------
 
-    void SurfaceMeshSimplification::simplify(unsigned int n_vertices) {
+    void SurfaceMeshSimplification::simplify(unsigned int n_vertices, const CancellationToken &token) {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshSimplification::simplify", "algo");
         if (!mesh_->is_triangle_mesh()) {
             std::cerr << "Not a triangle mesh!" << std::endl;
             return;
@@ -154,6 +165,11 @@ namespace easy3d {
         }
 
         while (nv > n_vertices && !queue_->empty()) {
+            if (token.is_canceled()) {
+                LOG(WARNING) << "simplification cancelled";
+                break;
+            }
+
             // get 1st element
             v = queue_->front();
             queue_->pop_front();
@@ -241,7 +257,7 @@ namespace easy3d {
     bool SurfaceMeshSimplification::is_collapse_legal(const CollapseData &cd) {
         // test selected vertices
         if (has_selection_) {
-            if (!vselected_[cd.v0])
+            if (!selected_.test(cd.v0.idx()))
                 return false;
         }
 
@@ -14,6 +14,8 @@
 
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/core/heap.h>
+#include <easy3d/core/selection_set.h>
+#include <easy3d/util/progress.h>
 
 #include <set>
 #include <vector>
@@ -177,7 +179,16 @@ namespace easy3d {
                         float hausdorff_error = 0.0);
 
         //! Simplify mesh to \p n vertices.
-        void simplify(unsigned int n_vertices);
+        //! A \p token can be given to cancel the simplification (e.g., from another thread), in which case the
+        //! mesh is left with the collapses performed so far.
+        void simplify(unsigned int n_vertices, const CancellationToken &token = CancellationToken());
+
+        //! \brief Restricts simplification to the selected vertices, i.e., only they can be removed. Call it before
+        //!     initialize().
+        //! \details The selection is indexed by SurfaceMesh::Vertex::idx() and its size must be equal to
+        //!     SurfaceMesh::vertices_size(). If no selection is given, the vertices marked in the bool property
+        //!     "v:selected" (if it exists) are used. An empty selection means all vertices can be removed.
+        void set_selection(const SelectionSet &selected);
 
     private:
         //! Store data for an halfedge collapse
@@ -267,7 +278,7 @@ namespace easy3d {
 
         SurfaceMesh::VertexProperty<vec3> vpoint_;
         SurfaceMesh::FaceProperty<vec3> fnormal_;
-        SurfaceMesh::VertexProperty<bool> vselected_;
+        SelectionSet selected_;
         SurfaceMesh::VertexProperty<bool> vfeature_;
         SurfaceMesh::EdgeProperty<bool> efeature_;
 
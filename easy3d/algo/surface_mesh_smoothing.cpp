@@ -11,17 +11,14 @@
 
 #include <easy3d/algo/surface_mesh_smoothing.h>
 
-#include <Eigen/Dense>
-#include <Eigen/Sparse>
-
 #include <easy3d/algo/surface_mesh_geometry.h>
+#include <easy3d/util/logging.h>
 
 
 namespace easy3d {
 
     // \cond
-    using SparseMatrix = Eigen::SparseMatrix<double>;
-    using Triplet = Eigen::Triplet<double>;
+    using Triplet = SparseSolver::Triplet;
     // \endcond
 
     //-----------------------------------------------------------------------------
@@ -123,6 +120,7 @@ namespace easy3d {
 
         // clean-up custom properties
         mesh_->remove_vertex_property(laplace);
+        mesh_->invalidate_bounding_box();
     }
 
     //-----------------------------------------------------------------------------
@@ -169,8 +167,7 @@ namespace easy3d {
         const unsigned int n = free_vertices.size();
 
         // A*X = B
-        SparseMatrix A(n, n);
-        Eigen::MatrixXd B(n, 3);
+        std::vector<dvec3> B(n), X(n);
 
         // nonzero elements of A as triplets: (row, column, value)
         std::vector<Triplet> triplets;
@@ -201,28 +198,24 @@ namespace easy3d {
                 else {
                     triplets.emplace_back(i, idx[vv], -timestep * eweight[e]);
                 }
-
-                B.row(i) = (Eigen::Vector3d) b;
             }
+            B[i] = b;
+
+            // the current positions are the initial guess for the iterative solvers
+            X[i] = static_cast<dvec3>(points[v]);
 
             // center vertex -> matrix
             triplets.emplace_back(i, i, 1.0 / vweight[v] + timestep * ww);
         }
 
-        // build sparse matrix from triplets
-        A.setFromTriplets(triplets.begin(), triplets.end());
-
-        // solve A*X = B
-        Eigen::SimplicialLDLT<SparseMatrix> solver(A);
-        Eigen::MatrixXd X = solver.solve(B);
-        if (solver.info() != Eigen::Success) {
-            std::cerr << "SurfaceMeshSmoothing: Could not solve linear system\n";
+        // solve A*X = B. The factorization is reused if the matrix did not change since the last call (e.g., uniform
+        // Laplacian with the same timestep), and the symbolic analysis is reused if the mesh topology did not change.
+        if (!solver_.factorize(n, triplets) || !solver_.solve(B, X)) {
+            LOG(ERROR) << "SurfaceMeshSmoothing: Could not solve linear system";
         } else {
             // copy solution
-            for (unsigned int i = 0; i < n; ++i) {
-                const auto &tmp = X.row(i);
-                points[free_vertices[i]] = vec3(tmp(0), tmp(1), tmp(2));
-            }
+            for (unsigned int i = 0; i < n; ++i)
+                points[free_vertices[i]] = vec3(X[i]);
         }
 
         if (rescale) {
@@ -241,6 +234,7 @@ namespace easy3d {
 
         // clean-up
         mesh_->remove_vertex_property(idx);
+        mesh_->invalidate_bounding_box();
     }
 
 } // namespace easy3d
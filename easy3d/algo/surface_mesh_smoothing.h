@@ -13,6 +13,7 @@
 #define EASY3D_ALGO_SURFACE_MESH_SMOOTHING_H
 
 #include <easy3d/core/surface_mesh.h>
+#include <easy3d/algo/sparse_solver.h>
 
 namespace easy3d {
 
@@ -43,6 +44,11 @@ namespace easy3d {
                                 bool use_uniform_laplace = false,
                                 bool rescale = true);
 
+        //! \brief The solver used by implicit smoothing.
+        //! \details Use it to choose the solver type or to query the time spent in each phase. Its factorizations
+        //!     are kept across calls of implicit_smoothing() and reused whenever possible.
+        SparseSolver& solver() { return solver_; }
+
         //! \brief Initialize edge and vertex weights.
         void initialize(bool use_uniform_laplace = false) {
             compute_edge_weights(use_uniform_laplace);
@@ -64,6 +70,8 @@ namespace easy3d {
         // recompute if numbers change (i.e. mesh has changed)
         unsigned int how_many_edge_weights_;
         unsigned int how_many_vertex_weights_;
+
+        SparseSolver solver_;
     };
 
 } // namespace easy3d
@@ -12,55 +12,194 @@
 #include <easy3d/algo/triangle_mesh_kdtree.h>
 
 #include <limits>
+#include <cfloat>
+#include <algorithm>
 
 #include <easy3d/algo/surface_mesh_geometry.h>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define EASY3D_KDTREE_USE_SSE
+#include <xmmintrin.h>
+#endif
+
 
 namespace easy3d {
 
+    namespace details {
+
+        // the maximum depth of the tree, which bounds the size of the traversal stack
+        const unsigned int kdtree_max_depth = 64;
+
+        // Computes the squared distances from point (px, py, pz) to the four triangles of a block.
+        // The closest point is the projection onto the supporting plane if it falls inside the triangle, or the
+        // closest point on one of the three edges otherwise. All branches are evaluated and the result is selected,
+        // which maps the four triangles onto the four SIMD lanes. block_distances() uses the SSE version if it is
+        // available, and the scalar version otherwise (both give the same results).
+        template<typename Block>
+        inline void block_distances_scalar(const Block &b, float px, float py, float pz, float *d2) {
+            for (int l = 0; l < 4; ++l) {
+                const float d[3] = {px - b.v0[0][l], py - b.v0[1][l], pz - b.v0[2][l]};
+                const float d1[3] = {d[0] - b.e0[0][l], d[1] - b.e0[1][l], d[2] - b.e0[2][l]};
+
+                auto segment_dist2 = [&](const float *o, const float (*e)[4], float inv) -> float {
+                    float t = (o[0] * e[0][l] + o[1] * e[1][l] + o[2] * e[2][l]) * inv;
+                    t = std::min(std::max(t, 0.0f), 1.0f);
+                    const float q[3] = {o[0] - t * e[0][l], o[1] - t * e[1][l], o[2] - t * e[2][l]};
+                    return q[0] * q[0] + q[1] * q[1] + q[2] * q[2];
+                };
+                auto side = [&](const float *a, const float *c) -> float {  // dot(cross(a, c), n)
+                    return (a[1] * c[2] - a[2] * c[1]) * b.n[0][l] +
+                           (a[2] * c[0] - a[0] * c[2]) * b.n[1][l] +
+                           (a[0] * c[1] - a[1] * c[0]) * b.n[2][l];
+                };
+
+                const float e0[3] = {b.e0[0][l], b.e0[1][l], b.e0[2][l]};
+                const float e1[3] = {b.e1[0][l], b.e1[1][l], b.e1[2][l]};
+                const float e2[3] = {b.e2[0][l], b.e2[1][l], b.e2[2][l]};
+                const bool inside = side(e0, d) >= 0.0f && side(e2, d1) >= 0.0f && side(d, e1) >= 0.0f &&
+                                    b.inv_n[l] > 0.0f;
+                if (inside) {
+                    const float h = d[0] * b.n[0][l] + d[1] * b.n[1][l] + d[2] * b.n[2][l];
+                    d2[l] = h * h * b.inv_n[l];
+                } else {
+                    d2[l] = std::min(std::min(segment_dist2(d, b.e0, b.inv_e0[l]), segment_dist2(d, b.e1, b.inv_e1[l])),
+                                     segment_dist2(d1, b.e2, b.inv_e2[l]));
+                }
+            }
+        }
+
+#ifdef EASY3D_KDTREE_USE_SSE
+        template<typename Block>
+        inline void block_distances_sse(const Block &b, float px, float py, float pz, float *d2) {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            // d = p - v0
+            const __m128 dx = _mm_sub_ps(_mm_set1_ps(px), _mm_loadu_ps(b.v0[0]));
+            const __m128 dy = _mm_sub_ps(_mm_set1_ps(py), _mm_loadu_ps(b.v0[1]));
+            const __m128 dz = _mm_sub_ps(_mm_set1_ps(pz), _mm_loadu_ps(b.v0[2]));
+
+            const __m128 e0x = _mm_loadu_ps(b.e0[0]), e0y = _mm_loadu_ps(b.e0[1]), e0z = _mm_loadu_ps(b.e0[2]);
+            const __m128 e1x = _mm_loadu_ps(b.e1[0]), e1y = _mm_loadu_ps(b.e1[1]), e1z = _mm_loadu_ps(b.e1[2]);
+            const __m128 e2x = _mm_loadu_ps(b.e2[0]), e2y = _mm_loadu_ps(b.e2[1]), e2z = _mm_loadu_ps(b.e2[2]);
+            const __m128 nx = _mm_loadu_ps(b.n[0]), ny = _mm_loadu_ps(b.n[1]), nz = _mm_loadu_ps(b.n[2]);
+
+#define EASY3D_DOT(ax, ay, az, bx, by, bz) \
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz))
+
+            // squared distance to the segment starting at (ox, oy, oz) with direction (ex, ey, ez)
+#define EASY3D_SEGMENT_DIST2(ox, oy, oz, ex, ey, ez, inv) \
+            [&]() { \
+                const __m128 t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(EASY3D_DOT(ox, oy, oz, ex, ey, ez), inv), zero), one); \
+                const __m128 qx = _mm_sub_ps(ox, _mm_mul_ps(t, ex)); \
+                const __m128 qy = _mm_sub_ps(oy, _mm_mul_ps(t, ey)); \
+                const __m128 qz = _mm_sub_ps(oz, _mm_mul_ps(t, ez)); \
+                return EASY3D_DOT(qx, qy, qz, qx, qy, qz); \
+            }()
+
+            const __m128 inv_e0 = _mm_loadu_ps(b.inv_e0);
+            const __m128 inv_e1 = _mm_loadu_ps(b.inv_e1);
+            const __m128 inv_e2 = _mm_loadu_ps(b.inv_e2);
+            const __m128 inv_n = _mm_loadu_ps(b.inv_n);
+
+            // d1 = p - v1
+            const __m128 d1x = _mm_sub_ps(dx, e0x), d1y = _mm_sub_ps(dy, e0y), d1z = _mm_sub_ps(dz, e0z);
+
+            __m128 edge = EASY3D_SEGMENT_DIST2(dx, dy, dz, e0x, e0y, e0z, inv_e0);
+            edge = _mm_min_ps(edge, EASY3D_SEGMENT_DIST2(dx, dy, dz, e1x, e1y, e1z, inv_e1));
+            edge = _mm_min_ps(edge, EASY3D_SEGMENT_DIST2(d1x, d1y, d1z, e2x, e2y, e2z, inv_e2));
+
+            // inside tests against the three edges: dot(cross(edge, p - edge_start), n) >= 0
+            const __m128 s0 = EASY3D_DOT(
+                    _mm_sub_ps(_mm_mul_ps(e0y, dz), _mm_mul_ps(e0z, dy)),
+                    _mm_sub_ps(_mm_mul_ps(e0z, dx), _mm_mul_ps(e0x, dz)),
+                    _mm_sub_ps(_mm_mul_ps(e0x, dy), _mm_mul_ps(e0y, dx)),
+                    nx, ny, nz);
+            const __m128 s1 = EASY3D_DOT(
+                    _mm_sub_ps(_mm_mul_ps(e2y, d1z), _mm_mul_ps(e2z, d1y)),
+                    _mm_sub_ps(_mm_mul_ps(e2z, d1x), _mm_mul_ps(e2x, d1z)),
+                    _mm_sub_ps(_mm_mul_ps(e2x, d1y), _mm_mul_ps(e2y, d1x)),
+                    nx, ny, nz);
+            const __m128 s2 = EASY3D_DOT(
+                    _mm_sub_ps(_mm_mul_ps(dy, e1z), _mm_mul_ps(dz, e1y)),
+                    _mm_sub_ps(_mm_mul_ps(dz, e1x), _mm_mul_ps(dx, e1z)),
+                    _mm_sub_ps(_mm_mul_ps(dx, e1y), _mm_mul_ps(dy, e1x)),
+                    nx, ny, nz);
+            const __m128 inside = _mm_and_ps(
+                    _mm_and_ps(_mm_cmpge_ps(s0, zero), _mm_cmpge_ps(s1, zero)),
+                    _mm_and_ps(_mm_cmpge_ps(s2, zero), _mm_cmpgt_ps(inv_n, zero))
+            );
+
+            const __m128 h = EASY3D_DOT(dx, dy, dz, nx, ny, nz);
+            const __m128 plane = _mm_mul_ps(_mm_mul_ps(h, h), inv_n);
+
+            _mm_storeu_ps(d2, _mm_or_ps(_mm_and_ps(inside, plane), _mm_andnot_ps(inside, edge)));
+
+#undef EASY3D_SEGMENT_DIST2
+#undef EASY3D_DOT
+        }
+#endif
+
+        template<typename Block>
+        inline void block_distances(const Block &b, float px, float py, float pz, float *d2) {
+#ifdef EASY3D_KDTREE_USE_SSE
+            block_distances_sse(b, px, py, pz, d2);
+#else
+            block_distances_scalar(b, px, py, pz, d2);
+#endif
+        }
+
+    }
+
+
     TriangleMeshKdTree::TriangleMeshKdTree(const SurfaceMesh *mesh, unsigned int max_faces,
                                            unsigned int max_depth) {
-        // init
-        root_ = new Node();
-        root_->faces = new Triangles();
         SurfaceMesh::VertexProperty<vec3> points = mesh->get_vertex_property<vec3>("v:point");
 
         // collect triangles
-        Triangle tri;
-        root_->faces->reserve(mesh->n_faces());
+        std::vector<vec3> corners;
+        std::vector<SurfaceMesh::Face> faces;
+        corners.reserve(mesh->n_faces() * 3);
+        faces.reserve(mesh->n_faces());
         for (SurfaceMesh::FaceIterator fit = mesh->faces_begin();
              fit != mesh->faces_end(); ++fit) {
             SurfaceMesh::VertexAroundFaceCirculator vfit = mesh->vertices(*fit);
-            tri.x[0] = points[*vfit];
+            corners.push_back(points[*vfit]);
             ++vfit;
-            tri.x[1] = points[*vfit];
+            corners.push_back(points[*vfit]);
             ++vfit;
-            tri.x[2] = points[*vfit];
-            tri.f = *fit;
-            root_->faces->push_back(tri);
+            corners.push_back(points[*vfit]);
+            faces.push_back(*fit);
         }
 
+        std::vector<unsigned int> triangles(faces.size());
+        for (std::size_t i = 0; i < triangles.size(); ++i)
+            triangles[i] = static_cast<unsigned int>(i);
+
         // call recursive helper
-        build_recurse(root_, max_faces, max_depth);
+        build_recurse(corners, faces, triangles, max_faces, std::min(max_depth, details::kdtree_max_depth));
+
+        nodes_.shrink_to_fit();
     }
 
     //-----------------------------------------------------------------------------
 
-    unsigned int TriangleMeshKdTree::build_recurse(Node *node, unsigned int max_faces,
-                                                   unsigned int depth) {
+    void TriangleMeshKdTree::build_recurse(const std::vector<vec3> &corners,
+                                           const std::vector<SurfaceMesh::Face> &faces,
+                                           std::vector<unsigned int> &triangles,
+                                           unsigned int max_faces,
+                                           unsigned int depth) {
         // should we stop at this level ?
-        if ((depth == 0) || (node->faces->size() <= max_faces))
-            return depth;
-
-        std::vector<Triangle>::const_iterator fit, fend = node->faces->end();
-        unsigned int i;
+        if ((depth == 0) || (triangles.size() <= max_faces)) {
+            make_leaf(corners, faces, triangles);
+            return;
+        }
 
         // compute bounding box
         Box3 bbox;
-        for (fit = node->faces->begin(); fit != fend; ++fit) {
-            for (i = 0; i < 3; ++i) {
-                bbox.grow(fit->x[i]);
-            }
+        for (auto t : triangles) {
+            for (unsigned int i = 0; i < 3; ++i)
+                bbox.grow(corners[t * 3 + i]);
         }
 
         // split longest side of bounding box
@@ -72,86 +211,89 @@ namespace easy3d {
         if (bb[2] > length)
             length = bb[(axis = 2)];
 
-#if 1
         // split in the middle
         float split = bbox.center()[axis];
-#else
-        // find split position as median
-        std::vector<float> v;
-        v.reserve(node->faces->size() * 3);
-        for (fit = node->faces->begin(); fit != fend; ++fit)
-            for (i = 0; i < 3; ++i)
-                v.push_back(fit->x[i][axis]]);
-        std::sort(v.begin(), v.end());
-        split = v[v.size() / 2];
-#endif
-
-        // create children
-        auto *left = new Node();
-        left->faces = new Triangles();
-        left->faces->reserve(node->faces->size() / 2);
-        auto *right = new Node();
-        right->faces = new Triangles;
-        right->faces->reserve(node->faces->size() / 2);
 
         // partition for left and right child
-        for (fit = node->faces->begin(); fit != fend; ++fit) {
+        std::vector<unsigned int> left, right;
+        left.reserve(triangles.size() / 2);
+        right.reserve(triangles.size() / 2);
+        for (auto t : triangles) {
             bool l = false, r = false;
-
-            const Triangle &t = *fit;
-            if (t.x[0][axis] <= split)
-                l = true;
-            else
-                r = true;
-            if (t.x[1][axis] <= split)
-                l = true;
-            else
-                r = true;
-            if (t.x[2][axis] <= split)
-                l = true;
-            else
-                r = true;
-
-            if (l) {
-                left->faces->push_back(t);
+            for (unsigned int i = 0; i < 3; ++i) {
+                if (corners[t * 3 + i][axis] <= split)
+                    l = true;
+                else
+                    r = true;
             }
 
-            if (r) {
-                right->faces->push_back(t);
-            }
+            if (l)
+                left.push_back(t);
+            if (r)
+                right.push_back(t);
         }
 
         // stop here?
-        if (left->faces->size() == node->faces->size() ||
-            right->faces->size() == node->faces->size()) {
-            // compact my memory
-            node->faces->shrink_to_fit();
-
-            // delete new nodes
-            delete left;
-            delete right;
-
-            // return tree depth
-            return depth;
+        if (left.size() == triangles.size() || right.size() == triangles.size()) {
+            make_leaf(corners, faces, triangles);
+            return;
         }
 
-            // or recurse further?
-        else {
-            // free my memory
-            delete node->faces;
-            node->faces = nullptr;
-
-            // store internal data
-            node->axis = axis;
-            node->split = split;
-            node->left_child = left;
-            node->right_child = right;
+        // or recurse further? free my memory first
+        std::vector<unsigned int>().swap(triangles);
+
+        const std::size_t index = nodes_.size();
+        Node node;
+        node.split = split;
+        node.axis = axis;
+        node.first = 0;
+        node.count = 0;
+        nodes_.push_back(node);
+
+        // the left child immediately follows its parent
+        build_recurse(corners, faces, left, max_faces, depth - 1);
+        nodes_[index].first = static_cast<unsigned int>(nodes_.size());
+        build_recurse(corners, faces, right, max_faces, depth - 1);
+    }
 
-            // recurse to childen
-            int depthLeft = build_recurse(node->left_child, max_faces, depth - 1);
-            int depthRight = build_recurse(node->right_child, max_faces, depth - 1);
+    //-----------------------------------------------------------------------------
 
-            return std::min(depthLeft, depthRight);
+    void TriangleMeshKdTree::make_leaf(const std::vector<vec3> &corners,
+                                       const std::vector<SurfaceMesh::Face> &faces,
+                                       const std::vector<unsigned int> &triangles) {
+        Node node;
+        node.split = 0.0f;
+        node.axis = 3;
+        node.first = static_cast<unsigned int>(blocks_.size());
+        node.count = static_cast<unsigned int>(triangles.size());
+        nodes_.push_back(node);
+
+        const std::size_t num_blocks = (triangles.size() + 3) / 4;
+        for (std::size_t b = 0; b < num_blocks; ++b) {
+            Block block;
+            for (std::size_t l = 0; l < 4; ++l) {
+                // unused lanes replicate the last triangle
+                const unsigned int t = triangles[std::min(b * 4 + l, triangles.size() - 1)];
+                const vec3 &v0 = corners[t * 3];
+                const vec3 e0 = corners[t * 3 + 1] - v0;
+                const vec3 e1 = corners[t * 3 + 2] - v0;
+                const vec3 e2 = corners[t * 3 + 2] - corners[t * 3 + 1];
+                const vec3 n = cross(e0, e1);
+                for (unsigned int i = 0; i < 3; ++i) {
+                    block.v0[i][l] = v0[i];
+                    block.e0[i][l] = e0[i];
+                    block.e1[i][l] = e1[i];
+                    block.e2[i][l] = e2[i];
+                    block.n[i][l] = n[i];
+                }
+                const float le0 = length2(e0), le1 = length2(e1), le2 = length2(e2), ln = length2(n);
+                block.inv_e0[l] = le0 > FLT_MIN ? 1.0f / le0 : 0.0f;
+                block.inv_e1[l] = le1 > FLT_MIN ? 1.0f / le1 : 0.0f;
+                block.inv_e2[l] = le2 > FLT_MIN ? 1.0f / le2 : 0.0f;
+                block.inv_n[l] = ln > FLT_MIN ? 1.0f / ln : 0.0f;
+                block_faces_.push_back(faces[t]);
+            }
+            blocks_.push_back(block);
         }
     }
 
@@ -161,44 +303,92 @@ namespace easy3d {
         NearestNeighbor data;
         data.dist = std::numeric_limits<float>::max();
         data.tests = 0;
-        nearest_recurse(root_, p, data);
-        return data;
-    }
-
-    //-----------------------------------------------------------------------------
+        if (nodes_.empty())
+            return data;
+
+        // the squared distance to the closest triangle found so far, and its block/lane
+        float best = std::numeric_limits<float>::max();
+        std::size_t best_block = 0, best_lane = 0;
+        bool found = false;
+
+        // each entry holds a node to visit and the squared distance from p to its splitting plane
+        struct Entry {
+            unsigned int node;
+            float dist2;
+        } stack[details::kdtree_max_depth + 1];
+        int top = 0;
+        stack[top].node = 0;
+        stack[top].dist2 = 0.0f;
+        ++top;
+
+        float d2[4];
+        while (top > 0) {
+            --top;
+            if (stack[top].dist2 >= best)
+                continue;
+
+            // descend to the leaf on the side of p, remembering the far children
+            unsigned int index = stack[top].node;
+            while (nodes_[index].axis != 3) {
+                const Node &node = nodes_[index];
+                const float dist = p[node.axis] - node.split;
+                const unsigned int near_child = (dist <= 0.0f) ? index + 1 : node.first;
+                const unsigned int far_child = (dist <= 0.0f) ? node.first : index + 1;
+                if (dist * dist < best) {
+                    stack[top].node = far_child;
+                    stack[top].dist2 = dist * dist;
+                    ++top;
+                }
+                index = near_child;
+            }
 
-    void TriangleMeshKdTree::nearest_recurse(Node *node, const vec3 &point,
-                                             NearestNeighbor &data) const {
-        // terminal node?
-        if (!node->left_child) {
-            float d;
-            vec3 n;
-
-            auto fit = node->faces->begin(), fend = node->faces->end();
-            for (; fit != fend; ++fit) {
-                d = geom::dist_point_triangle(point, fit->x[0], fit->x[1], fit->x[2], n);
-                ++data.tests;
-                if (d < data.dist) {
-                    data.dist = d;
-                    data.face = fit->f;
-                    data.nearest = n;
+            // terminal node
+            const Node &leaf = nodes_[index];
+            const std::size_t end = leaf.first + (leaf.count + 3) / 4;
+            for (std::size_t b = leaf.first; b < end; ++b) {
+                details::block_distances(blocks_[b], p.x, p.y, p.z, d2);
+                const std::size_t lanes = std::min<std::size_t>(4, leaf.count - (b - leaf.first) * 4);
+                for (std::size_t l = 0; l < lanes; ++l) {
+                    if (d2[l] < best) {
+                        best = d2[l];
+                        best_block = b;
+                        best_lane = l;
+                        found = true;
+                    }
                 }
+                data.tests += static_cast<int>(lanes);
             }
         }
 
-        // non-terminal node
-        else {
-            float dist = point[node->axis] - node->split;
-
-            if (dist <= 0.0) {
-                nearest_recurse(node->left_child, point, data);
-                if (fabs(dist) < data.dist)
-                    nearest_recurse(node->right_child, point, data);
-            } else {
-                nearest_recurse(node->right_child, point, data);
-                if (fabs(dist) < data.dist)
-                    nearest_recurse(node->left_child, point, data);
-            }
+        if (found) {
+            const Block &b = blocks_[best_block];
+            const std::size_t l = best_lane;
+            const vec3 v0(b.v0[0][l], b.v0[1][l], b.v0[2][l]);
+            const vec3 v1 = v0 + vec3(b.e0[0][l], b.e0[1][l], b.e0[2][l]);
+            const vec3 v2 = v0 + vec3(b.e1[0][l], b.e1[1][l], b.e1[2][l]);
+            data.dist = geom::dist_point_triangle(p, v0, v1, v2, data.nearest);
+            data.face = block_faces_[best_block * 4 + l];
+        }
+        return data;
+    }
+
+    //-----------------------------------------------------------------------------
+
+    void TriangleMeshKdTree::nearest(const std::vector<vec3> &points,
+                                     std::vector<float> &distances,
+                                     std::vector<SurfaceMesh::Face> &faces,
+                                     std::vector<vec3> &nearest_points) const {
+        const int num = static_cast<int>(points.size());
+        distances.resize(num);
+        faces.resize(num);
+        nearest_points.resize(num);
+
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
+            const NearestNeighbor nn = nearest(points[i]);
+            distances[i] = nn.dist;
+            faces[i] = nn.face;
+            nearest_points[i] = nn.nearest;
         }
     }
 
@@ -21,12 +21,16 @@ namespace easy3d {
 
     //! \brief A k-d tree for triangular surface meshes.
     /// \class TriangleMeshKdTree easy3d/algo/triangle_mesh_kdtree.h
+    /// \details The tree is stored as a flat array of nodes in depth-first order (the left child of an inner node
+    ///     immediately follows its parent). The triangles of each leaf are packed in blocks of four in a
+    ///     structure-of-arrays layout, such that the point-triangle distances of a block can be evaluated together
+    ///     using SIMD instructions (SSE on x86, a scalar fallback elsewhere).
     class TriangleMeshKdTree {
     public:
         //! \brief construct with mesh
         TriangleMeshKdTree(const SurfaceMesh *mesh, unsigned int max_faces = 10, unsigned int max_depth = 30);
 
-        ~TriangleMeshKdTree() { delete root_; }
+        ~TriangleMeshKdTree() {}
 
         //! \brief nearest neighbor information
         struct NearestNeighbor {
@@ -39,53 +43,59 @@ namespace easy3d {
         //! \brief Return handle of the nearest neighbor
         NearestNeighbor nearest(const vec3 &p) const;
 
-    private:
-        // triangle stores corners and face handle
-        struct Triangle {
-            Triangle() {}
-
-            Triangle(const vec3 &x0, const vec3 &x1, const vec3 &x2, SurfaceMesh::Face ff) {
-                x[0] = x0;
-                x[1] = x1;
-                x[2] = x2;
-                f = ff;
-            }
-
-            vec3 x[3];
-            SurfaceMesh::Face f;
-        };
+        /**
+         * \brief Query the nearest neighbors of a set of points (in parallel if OpenMP is available).
+         * \param points The query points.
+         * \param distances Returns the distance from each query point to its nearest triangle.
+         * \param faces Returns the nearest face of each query point.
+         * \param nearest_points Returns the closest point on the mesh for each query point.
+         */
+        void nearest(const std::vector<vec3> &points,
+                     std::vector<float> &distances,
+                     std::vector<SurfaceMesh::Face> &faces,
+                     std::vector<vec3> &nearest_points
+        ) const;
 
-        // vector of Triangle
-        typedef std::vector<Triangle> Triangles;
-
-        // Node of the tree: contains parent, children and splitting plane
+    private:
+        // A node of the tree. An inner node stores the splitting plane and the index of its right child (its left
+        // child is the next node). A leaf stores the range of its triangle blocks.
         struct Node {
-            Node() : faces(nullptr), left_child(nullptr), right_child(nullptr) {};
-
-            ~Node() {
-                delete faces;
-                delete left_child;
-                delete right_child;
-            }
-
-            unsigned char axis;
             float split;
-            Triangles *faces;
-            Node *left_child;
-            Node *right_child;
+            unsigned int axis;      // 0, 1, 2 for inner nodes, and 3 for leaves
+            unsigned int first;     // inner node: index of the right child; leaf: index of the first block
+            unsigned int count;     // leaf: number of triangles (the number of blocks is (count + 3) / 4)
+        };
+
+        // Four triangles in structure-of-arrays layout, with precomputed quantities for the distance kernel.
+        // Unused lanes replicate the last triangle of the leaf.
+        struct Block {
+            float v0[3][4];         // the first corner
+            float e0[3][4];         // v1 - v0
+            float e1[3][4];         // v2 - v0
+            float e2[3][4];         // v2 - v1
+            float n[3][4];          // cross(e0, e1), not normalized
+            float inv_e0[4];        // 1 / |e0|^2 (0 for a degenerate edge)
+            float inv_e1[4];        // 1 / |e1|^2 (0 for a degenerate edge)
+            float inv_e2[4];        // 1 / |e2|^2 (0 for a degenerate edge)
+            float inv_n[4];         // 1 / |n|^2 (0 for a degenerate triangle)
         };
 
-        // Recursive part of build()
-        unsigned int build_recurse(Node *node, unsigned int max_handles, unsigned int depth);
+        // Recursive part of the constructor. The triangles are given by their indices into corners (three corners
+        // per triangle) and faces.
+        void build_recurse(const std::vector<vec3> &corners, const std::vector<SurfaceMesh::Face> &faces,
+                           std::vector<unsigned int> &triangles, unsigned int max_faces, unsigned int depth);
 
-        // Recursive part of nearest()
-        void nearest_recurse(Node *node, const vec3 &point, NearestNeighbor &data) const;
+        // Append a leaf holding the given triangles
+        void make_leaf(const std::vector<vec3> &corners, const std::vector<SurfaceMesh::Face> &faces,
+                       const std::vector<unsigned int> &triangles);
 
     private:
-        Node *root_;
+        std::vector<Node> nodes_;
+        std::vector<Block> blocks_;
+        std::vector<SurfaceMesh::Face> block_faces_;  // four per block
     };
 
 } // namespace easy3d
 
 
-#endif  // EASY3D_ALGO_TRIANGLE_MESH_KDTREE_H
\ No newline at end of file
+#endif  // EASY3D_ALGO_TRIANGLE_MESH_KDTREE_H
@@ -58,7 +58,9 @@ namespace easy3d {
         }
 
         /** Construct a box from its diagonal corners. */
-        GenericBox(const Point &pmin, const Point &pmax) {
+        GenericBox(const Point &pmin, const Point &pmax)
+                : min_(std::numeric_limits<FT>::max())
+                , max_(-std::numeric_limits<FT>::max()) {
             // the user might provide wrong order
             // min_ = pmin;
             // max_ = pmax;
@@ -225,10 +227,15 @@ namespace easy3d {
 
         /** Add a box to this box. This will compute its new extent. */
         inline void grow(const thisclass &b) {
-            if (b.is_valid()) {
-                grow(b.min_point());
-                grow(b.max_point());
-            }
+            if (!b.is_valid())
+                return;
+            if (is_valid()) {
+                for (int i = 0; i < DIM; ++i) {
+                    min_[i] = std::min(min_[i], b.min_[i]);
+                    max_[i] = std::max(max_[i], b.max_[i]);
+                }
+            } else
+                *this = b;
         }
 
         /** Return the bounding box of 'this' and another box \c b. */
@@ -241,10 +248,7 @@ namespace easy3d {
 
         /** Modify this box by adding another box \c b. */
         inline thisclass &operator+=(const thisclass &b) {
-            if (b.is_valid()) {
-                grow(b.min_point());
-                grow(b.max_point());
-            }
+            grow(b);
             return *this;
         }
 
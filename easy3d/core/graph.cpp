@@ -178,32 +178,32 @@ namespace easy3d {
         {
             output << "model properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (mprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
 		props = vertex_properties();
 		if (!props.empty())
 		{
-			std::cout << "vertex properties:\n";
+			output << "vertex properties:\n";
 			for (unsigned int i = 0; i < props.size(); ++i)
-                output << "\t" << props[i] << std::endl;
+                output << "\t" << props[i] << (vprops_.is_deferred(props[i]) ? " (not loaded)" : "") << std::endl;
 		}
 
 
         props = edge_properties();
 		if (!props.empty())
 		{
-			std::cout << "edge properties:\n";
+			output << "edge properties:\n";
 			for (unsigned int i = 0; i < props.size(); ++i)
-                output << "\t" << props[i] << std::endl;
+                output << "\t" << props[i] << (eprops_.is_deferred(props[i]) ? " (not loaded)" : "") << std::endl;
 		}
 
 		props = model_properties();
 		if (!props.empty())
 		{
-			std::cout << "model properties:\n";
+			output << "model properties:\n";
 			for (unsigned int i = 0; i < props.size(); ++i)
-                output << "\t" << props[i] << std::endl;
+                output << "\t" << props[i] << (mprops_.is_deferred(props[i]) ? " (not loaded)" : "") << std::endl;
 		}
     }
 
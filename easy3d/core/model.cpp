@@ -25,6 +25,7 @@
  ********************************************************************/
 
 #include <easy3d/core/model.h>
+#include <easy3d/core/vec3_kernels.h>
 
 
 namespace easy3d {
@@ -45,9 +46,7 @@ namespace easy3d {
     const Box3& Model::bounding_box(bool recompute) const {
         if (!bbox_known_ || recompute) {
             Box3& box = const_cast<Model*>(this)->bbox_;
-            box.clear();
-            for (const auto& p : points())
-                box.grow(p);
+            box = kernels::bounding_box(points());
 
             if (box.is_valid())
                 const_cast<Model*>(this)->bbox_known_ = true;
@@ -57,4 +56,9 @@ namespace easy3d {
         return bbox_;
     }
 
+
+    void Model::invalidate_bounding_box() {
+        bbox_known_ = false;
+    }
+
 }
@@ -0,0 +1,304 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/core/model_diff.h>
+
+#include <algorithm>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+
+    namespace details {
+
+        // the property containers of a model, in the same order for all models of the same type
+        std::vector<const PropertyContainer *> containers(const Model *model) {
+            if (auto mesh = dynamic_cast<const SurfaceMesh *>(model)) {
+                return {&mesh->vertex_property_container(), &mesh->halfedge_property_container(),
+                        &mesh->edge_property_container(), &mesh->face_property_container(),
+                        &mesh->model_property_container()};
+            } else if (auto cloud = dynamic_cast<const PointCloud *>(model)) {
+                return {&cloud->vertex_property_container(), &cloud->model_property_container()};
+            } else if (auto graph = dynamic_cast<const Graph *>(model)) {
+                return {&graph->vertex_property_container(), &graph->edge_property_container(),
+                        &graph->model_property_container()};
+            } else if (auto mesh = dynamic_cast<const PolyMesh *>(model)) {
+                return {&mesh->vertex_property_container(), &mesh->edge_property_container(),
+                        &mesh->halfface_property_container(), &mesh->face_property_container(),
+                        &mesh->cell_property_container(), &mesh->model_property_container()};
+            }
+            return {};
+        }
+
+        std::vector<PropertyContainer *> containers(Model *model) {
+            std::vector<PropertyContainer *> result;
+            for (auto c : containers(static_cast<const Model *>(model)))
+                result.push_back(const_cast<PropertyContainer *>(c));
+            return result;
+        }
+
+        bool has_garbage(const Model *model) {
+            if (auto mesh = dynamic_cast<const SurfaceMesh *>(model))
+                return mesh->has_garbage();
+            else if (auto cloud = dynamic_cast<const PointCloud *>(model))
+                return cloud->has_garbage();
+            else if (auto graph = dynamic_cast<const Graph *>(model))
+                return graph->has_garbage();
+            return false;   // a PolyMesh has no deleted elements
+        }
+
+        template<typename MODEL>
+        Model *copy_as(const Model *model) {
+            auto m = dynamic_cast<const MODEL *>(model);
+            return m ? new MODEL(*m) : nullptr;
+        }
+
+        Model *copy(const Model *model) {
+            Model *result = copy_as<SurfaceMesh>(model);
+            if (!result) result = copy_as<PointCloud>(model);
+            if (!result) result = copy_as<Graph>(model);
+            if (!result) result = copy_as<PolyMesh>(model);
+            return result;
+        }
+
+        template<typename MODEL>
+        Model *create_as(const Model *model) {
+            return dynamic_cast<const MODEL *>(model) ? new MODEL : nullptr;
+        }
+
+        // an empty model of the same type
+        Model *create(const Model *model) {
+            Model *result = create_as<SurfaceMesh>(model);
+            if (!result) result = create_as<PointCloud>(model);
+            if (!result) result = create_as<Graph>(model);
+            if (!result) result = create_as<PolyMesh>(model);
+            return result;
+        }
+
+        template<typename MODEL>
+        bool assign_as(Model *model, const Model *state) {
+            auto m = dynamic_cast<MODEL *>(model);
+            auto s = dynamic_cast<const MODEL *>(state);
+            if (!m || !s)
+                return false;
+            *m = *s;    // the model also acquires the handles of its properties again
+            return true;
+        }
+
+        bool assign(Model *model, const Model *state) {
+            return assign_as<SurfaceMesh>(model, state) || assign_as<PointCloud>(model, state) ||
+                   assign_as<Graph>(model, state) || assign_as<PolyMesh>(model, state);
+        }
+
+        // the position of the array named 'name' in 'arrays', or arrays.size() if it does not exist
+        std::size_t find(const std::vector<BasePropertyArray *> &arrays, const std::string &name) {
+            for (std::size_t i = 0; i < arrays.size(); ++i) {
+                if (arrays[i]->name() == name)
+                    return i;
+            }
+            return arrays.size();
+        }
+    }
+
+
+    ModelDiff::ModelDiff() : state_(nullptr) {
+    }
+
+
+    ModelDiff::~ModelDiff() {
+        clear();
+    }
+
+
+    void ModelDiff::clear() {
+        delete state_;
+        state_ = nullptr;
+        for (auto &diff : containers_) {
+            for (auto array : diff.arrays)
+                delete array;
+        }
+        containers_.clear();
+    }
+
+
+    std::size_t ModelDiff::num_arrays() const {
+        std::size_t num = 0;
+        if (state_) {
+            for (auto container : details::containers(state_))
+                num += container->n_properties();
+        }
+        for (const auto &diff : containers_)
+            num += diff.arrays.size();
+        return num;
+    }
+
+
+    bool ModelDiff::record(Model *before, const Model *model) {
+        clear();
+        if (!before || !model || typeid(*before) != typeid(*model) || details::containers(model).empty()) {
+            LOG(ERROR) << "the two states are not of the same (supported) model type";
+            delete before;
+            return false;
+        }
+
+        if (details::has_garbage(before) || details::has_garbage(model)) {
+            state_ = before;
+            return true;
+        }
+
+        const auto old_containers = details::containers(before);
+        const auto new_containers = details::containers(model);
+        for (std::size_t i = 0; i < old_containers.size(); ++i) {
+            PropertyContainer *old_container = old_containers[i];
+            const PropertyContainer *new_container = new_containers[i];
+            old_container->load_deferred();
+            new_container->load_deferred();
+            const std::vector<BasePropertyArray *> &old_arrays = old_container->arrays();
+            const std::vector<BasePropertyArray *> &new_arrays = new_container->arrays();
+
+            ContainerDiff diff;
+            diff.size = old_container->size();
+            std::vector<BasePropertyArray *> unchanged;
+            for (auto array : old_arrays) {
+                const std::size_t j = details::find(new_arrays, array->name());
+                if (j < new_arrays.size() && array->is_equal(*new_arrays[j]))
+                    unchanged.push_back(array);
+                else
+                    diff.arrays.push_back(array);
+            }
+            for (auto array : new_arrays) {
+                if (details::find(old_arrays, array->name()) == old_arrays.size())
+                    diff.removed.push_back(array->name());
+            }
+            containers_.push_back(diff);
+
+            // the changed arrays are moved to the diff, and the unchanged ones are deleted with 'before'
+            old_container->arrays() = unchanged;
+        }
+        delete before;
+        return true;
+    }
+
+
+    bool ModelDiff::apply(Model *model) {
+        if (state_) {
+            Model *current = details::copy(model);
+            if (!current || typeid(*current) != typeid(*state_)) {
+                LOG(ERROR) << "the diff does not match the model: " << model->name();
+                delete current;
+                return false;
+            }
+            details::assign(model, state_);
+            delete state_;
+            state_ = current;
+            model->invalidate_bounding_box();
+            return true;
+        }
+
+        const auto model_containers = details::containers(model);
+        if (containers_.empty() || model_containers.size() != containers_.size() || details::has_garbage(model)) {
+            LOG(ERROR) << "the diff does not match the model: " << model->name();
+            return false;
+        }
+
+        // if only the data of existing arrays differ, the data are exchanged with the model
+        bool exchange = true;
+        for (std::size_t i = 0; i < containers_.size() && exchange; ++i) {
+            const std::vector<BasePropertyArray *> &arrays = model_containers[i]->arrays();
+            exchange = containers_[i].removed.empty();
+            for (auto array : containers_[i].arrays) {
+                const std::size_t j = details::find(arrays, array->name());
+                exchange = exchange && j < arrays.size() && arrays[j]->type() == array->type();
+            }
+        }
+
+        if (exchange) {
+            for (std::size_t i = 0; i < containers_.size(); ++i) {
+                PropertyContainer *container = model_containers[i];
+                ContainerDiff &diff = containers_[i];
+                const std::vector<BasePropertyArray *> &arrays = container->arrays();
+                for (auto array : diff.arrays)
+                    arrays[details::find(arrays, array->name())]->exchange(*array);
+                const std::size_t size = container->size();
+                container->resize(diff.size);
+                container->invalidate_computed();
+                diff.size = size;
+            }
+            model->invalidate_bounding_box();
+            return true;
+        }
+
+        // otherwise, the arrays are moved to a new state, which is assigned to the model (so the model acquires the
+        // handles of its properties again)
+        Model *state = details::create(model);
+        const auto state_containers = details::containers(state);
+        for (std::size_t i = 0; i < containers_.size(); ++i) {
+            PropertyContainer *container = model_containers[i];
+            ContainerDiff &diff = containers_[i];
+            ContainerDiff inverse;
+            inverse.size = container->size();
+
+            std::vector<BasePropertyArray *> arrays;    // the arrays of the recorded state
+            std::vector<bool> used(diff.arrays.size(), false);
+            for (auto array : container->arrays()) {
+                const std::size_t j = details::find(diff.arrays, array->name());
+                if (j < diff.arrays.size()) {
+                    arrays.push_back(diff.arrays[j]);
+                    used[j] = true;
+                    inverse.arrays.push_back(array);
+                } else if (std::find(diff.removed.begin(), diff.removed.end(), array->name()) != diff.removed.end())
+                    inverse.arrays.push_back(array);
+                else
+                    arrays.push_back(array);
+            }
+            for (std::size_t j = 0; j < diff.arrays.size(); ++j) {
+                if (!used[j]) {
+                    arrays.push_back(diff.arrays[j]);
+                    inverse.removed.push_back(diff.arrays[j]->name());
+                }
+            }
+            container->arrays().clear();
+
+            PropertyContainer *state_container = state_containers[i];
+            for (auto array : state_container->arrays())
+                delete array;
+            state_container->arrays() = arrays;
+            state_container->resize(diff.size);
+            diff = inverse;
+        }
+        details::assign(model, state);
+        delete state;
+        model->invalidate_bounding_box();
+        return true;
+    }
+
+}
@@ -0,0 +1,110 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_CORE_MODEL_DIFF_H
+#define EASY3D_CORE_MODEL_DIFF_H
+
+
+#include <vector>
+#include <string>
+
+
+namespace easy3d {
+
+    class Model;
+    class BasePropertyArray;
+
+    /**
+     * \brief The difference between two states of a model, e.g., for undoing and redoing a modification.
+     * \class ModelDiff easy3d/core/model_diff.h
+     * \details A diff is recorded from a copy of a model taken before a modification and the model after the
+     *      modification. It keeps only the property arrays whose data have changed (e.g., only the points when the
+     *      model is smoothed), so it usually costs much less memory than a copy of the model. Applying the diff
+     *      restores the recorded state, and the diff then holds the state it replaced, i.e., applying it again
+     *      redoes the modification. Applying a diff that changes only the data of the arrays exchanges the data
+     *      with the model, so it doesn't copy anything.
+     *
+     *      Example usage:
+     *      \code
+     *          SurfaceMesh* before = new SurfaceMesh(*mesh);
+     *          SurfaceMeshSmoothing(mesh).explicit_smoothing();
+     *          ModelDiff diff;
+     *          diff.record(before, mesh);  // takes the ownership of 'before'
+     *          diff.apply(mesh);           // undo
+     *          diff.apply(mesh);           // redo
+     *      \endcode
+     *
+     * \note A diff must be applied to the state it was recorded against, i.e., to the model right after the
+     *      modification (for undoing) or right after the diff was applied (for redoing). The data of arrays of types
+     *      that are not trivially copyable (e.g., std::string) cannot be compared, so they are always kept. The
+     *      numbers of deleted elements are not stored in properties, so states with deleted elements (i.e., garbage)
+     *      are kept as complete copies of the model.
+     */
+    class ModelDiff {
+    public:
+        ModelDiff();
+        ~ModelDiff();
+
+        /// \brief Records the difference between \p before, a copy of \p model taken before it was modified, and the
+        ///     current state of \p model.
+        /// \details The diff takes the ownership of \p before, whose unchanged property arrays are released.
+        /// \return false if \p before and \p model are not of the same type (\p before is deleted in this case).
+        bool record(Model *before, const Model *model);
+
+        /// \brief Restores the recorded state of \p model, and records the state it replaces.
+        /// \return false if the diff does not match \p model (which is not modified in this case).
+        bool apply(Model *model);
+
+        /// \brief Discards the recorded difference.
+        void clear();
+
+        /// \brief Returns the number of property arrays kept by the diff (i.e., the arrays that have changed).
+        std::size_t num_arrays() const;
+
+        /// \brief Returns whether the diff keeps a complete copy of the model (i.e., if a state had garbage).
+        bool is_complete() const { return state_ != nullptr; }
+
+    private:
+        // copying is not allowed
+        ModelDiff(const ModelDiff &);
+        ModelDiff &operator=(const ModelDiff &);
+
+    private:
+        // the difference of a property container
+        struct ContainerDiff {
+            std::size_t size;                           // the number of elements
+            std::vector<BasePropertyArray *> arrays;    // the arrays that are different or don't exist (owned)
+            std::vector<std::string> removed;           // the names of the arrays that don't exist in the state
+        };
+
+        Model *state_;  // the complete state (only if a state has garbage)
+        std::vector<ContainerDiff> containers_;
+    };
+
+} // namespace easy3d
+
+
+#endif  // EASY3D_CORE_MODEL_DIFF_H
@@ -143,23 +143,23 @@ namespace easy3d {
         {
             output << "model properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (mprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
         props = vertex_properties();
 		if (!props.empty())
 		{
-			std::cout << "vertex properties:\n";
+			output << "vertex properties:\n";
 			for (unsigned int i = 0; i < props.size(); ++i)
-                output << "\t" << props[i] << std::endl;
+                output << "\t" << props[i] << (vprops_.is_deferred(props[i]) ? " (not loaded)" : "") << std::endl;
 		}
 
 		props = model_properties();
 		if (!props.empty())
 		{
-			std::cout << "model properties:\n";
+			output << "model properties:\n";
 			for (unsigned int i = 0; i < props.size(); ++i)
-                output << "\t" << props[i] << std::endl;
+                output << "\t" << props[i] << (mprops_.is_deferred(props[i]) ? " (not loaded)" : "") << std::endl;
 		}
     }
 
@@ -233,4 +233,33 @@ namespace easy3d {
         garbage_ = false;
     }
 
+
+    bool PointCloud::permute_vertices(const std::vector<Vertex>& order)
+    {
+        if (garbage_) {
+            LOG(ERROR) << "the point cloud has garbage (call collect_garbage() first)";
+            return false;
+        }
+        if (order.size() != n_vertices()) {
+            LOG(ERROR) << "the size of the order (" << order.size() << ") does not match the number of vertices ("
+                       << n_vertices() << ")";
+            return false;
+        }
+
+        std::vector<std::size_t> indices(order.size());
+        std::vector<bool> used(order.size(), false);
+        for (std::size_t i=0; i<order.size(); ++i) {
+            const int idx = order[i].idx();
+            if (idx < 0 || idx >= static_cast<int>(order.size()) || used[idx]) {
+                LOG(ERROR) << "the order is not a permutation of the vertices";
+                return false;
+            }
+            used[idx] = true;
+            indices[i] = static_cast<std::size_t>(idx);
+        }
+
+        vprops_.permute(indices);
+        return true;
+    }
+
 } // namespace easy3d
@@ -277,6 +277,14 @@ namespace easy3d {
         /// @brief remove deleted vertices
         void collect_garbage();
 
+        /**
+         * @brief Reorders the vertices (and all their properties), such that the new i-th vertex is the old vertex
+         *      \p order[i], e.g., to improve the memory locality (see Reordering).
+         * @param order A permutation of all the vertices. The cloud must not have garbage.
+         * @return \c true on success (false if \p order is not a valid permutation).
+         */
+        bool permute_vertices(const std::vector<Vertex>& order);
+
         /// @brief deletes the vertex \c v from the cloud
         void delete_vertex(Vertex v);
 
@@ -407,6 +415,15 @@ namespace easy3d {
         /// @brief prints the names of all properties to an output stream (e.g., std::cout)
         void property_stats(std::ostream &output) const;
 
+        /// returns the container of all vertex properties
+        PropertyContainer& vertex_property_container() { return vprops_; }
+        /// returns the container of all vertex properties
+        const PropertyContainer& vertex_property_container() const { return vprops_; }
+        /// returns the container of all model properties
+        PropertyContainer& model_property_container() { return mprops_; }
+        /// returns the container of all model properties
+        const PropertyContainer& model_property_container() const { return mprops_; }
+
         //@}
 
 
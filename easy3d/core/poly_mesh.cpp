@@ -357,7 +357,7 @@ namespace easy3d {
         {
             output << "model properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (mprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
         props = vertex_properties();
@@ -365,7 +365,7 @@ namespace easy3d {
         {
             output << "vertex properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (vprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
         props = edge_properties();
@@ -373,7 +373,7 @@ namespace easy3d {
         {
             output<< "edge properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (eprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
         props = halfface_properties();
@@ -381,7 +381,7 @@ namespace easy3d {
         {
             output << "halfface properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (hprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
         props = face_properties();
@@ -389,7 +389,7 @@ namespace easy3d {
         {
             output << "face properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (fprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
         props = cell_properties();
@@ -397,7 +397,7 @@ namespace easy3d {
         {
             output << "cell properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (cprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
         props = model_properties();
@@ -405,7 +405,7 @@ namespace easy3d {
         {
             output << "model properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (mprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
     }
 
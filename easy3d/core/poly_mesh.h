@@ -1105,6 +1105,31 @@ namespace easy3d {
         /// prints the names of all properties to an output stream (e.g., std::cout).
         void property_stats(std::ostream &output) const;
 
+        /// returns the container of all vertex properties
+        PropertyContainer& vertex_property_container() { return vprops_; }
+        /// returns the container of all vertex properties
+        const PropertyContainer& vertex_property_container() const { return vprops_; }
+        /// returns the container of all edge properties
+        PropertyContainer& edge_property_container() { return eprops_; }
+        /// returns the container of all edge properties
+        const PropertyContainer& edge_property_container() const { return eprops_; }
+        /// returns the container of all halfface properties
+        PropertyContainer& halfface_property_container() { return hprops_; }
+        /// returns the container of all halfface properties
+        const PropertyContainer& halfface_property_container() const { return hprops_; }
+        /// returns the container of all face properties
+        PropertyContainer& face_property_container() { return fprops_; }
+        /// returns the container of all face properties
+        const PropertyContainer& face_property_container() const { return fprops_; }
+        /// returns the container of all cell properties
+        PropertyContainer& cell_property_container() { return cprops_; }
+        /// returns the container of all cell properties
+        const PropertyContainer& cell_property_container() const { return cprops_; }
+        /// returns the container of all model properties
+        PropertyContainer& model_property_container() { return mprops_; }
+        /// returns the container of all model properties
+        const PropertyContainer& model_property_container() const { return mprops_; }
+
         //@}
 
 
@@ -30,6 +30,13 @@
 #include <iostream>
 #include <algorithm>
 #include <typeinfo>
+#include <functional>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstring>
+#include <type_traits>
 #include <cassert>
 
 
@@ -71,6 +78,13 @@ namespace easy3d {
         /// Let copy 'from' -> 'to'.
         virtual void copy(size_t from, size_t to) = 0;
 
+        /// Let copy 'from[i]' -> 'to[i]' for all i, e.g., to fill the holes of the removed elements. The two sets of
+        /// elements must be disjoint.
+        virtual void copy(const std::vector<size_t>& from, const std::vector<size_t>& to) = 0;
+
+        /// Reorder the elements, such that the new i-th element is the old element order[i].
+        virtual void permute(const std::vector<size_t>& order) = 0;
+
         /// Return a deep copy of self.
         virtual BasePropertyArray* clone () const = 0;
 
@@ -80,6 +94,14 @@ namespace easy3d {
         /// Return the type_info of the property
         virtual const std::type_info& type() const = 0;
 
+        /// Return whether the data of \p other (of the same type) are identical to the data of self. The data are
+        /// compared byte by byte, which is only possible for trivially copyable types (e.g., numbers, vectors, and
+        /// element handles). Other types (e.g., std::string) are always reported as different.
+        virtual bool is_equal(const BasePropertyArray& other) const = 0;
+
+        /// Exchange the data with another array of the same type (the names are not exchanged).
+        virtual bool exchange(BasePropertyArray& other) = 0;
+
         /// Return the name of the property
         const std::string& name() const { return name_; }
 
@@ -97,7 +119,6 @@ namespace easy3d {
     };
 
 
-
     //== CLASS DEFINITION =========================================================
 
     /// \brief Implementation of a generic property array.
@@ -176,6 +197,24 @@ namespace easy3d {
             data_[to]=data_[from];
         }
 
+        virtual void copy(const std::vector<size_t>& from, const std::vector<size_t>& to)
+        {
+            assert(from.size() == to.size());
+            for (size_t i=0; i<from.size(); ++i)
+                data_[to[i]]=data_[from[i]];
+        }
+
+        virtual void permute(const std::vector<size_t>& order)
+        {
+            // gathering into a new array reads randomly but writes sequentially, which is much faster than
+            // following the cycles of the permutation by swapping (random reads and writes)
+            vector_type data;
+            data.reserve(data_.size());
+            for (size_t i=0; i<order.size(); ++i)
+                data.push_back(data_[order[i]]);
+            data_.swap(data);
+        }
+
         virtual BasePropertyArray* clone() const
         {
             PropertyArray<T>* p = new PropertyArray<T>(name_, value_);
@@ -191,6 +230,22 @@ namespace easy3d {
 
         virtual const std::type_info& type() const { return typeid(T); }
 
+        virtual bool is_equal(const BasePropertyArray& other) const
+        {
+            const PropertyArray<T>* pa = dynamic_cast<const PropertyArray*>(&other);
+            return pa != nullptr && is_equal(data_, pa->data_, std::is_trivially_copyable<T>());
+        }
+
+        virtual bool exchange(BasePropertyArray& other)
+        {
+            PropertyArray<T>* pa = dynamic_cast<PropertyArray*>(&other);
+            if (pa == nullptr)
+                return false;
+            data_.swap(pa->data_);
+            std::swap(value_, pa->value_);
+            return true;
+        }
+
 
     public:
 
@@ -207,6 +262,12 @@ namespace easy3d {
             return data_;
         }
 
+        /// Get const reference to the underlying vector
+        const std::vector<T>& vector() const
+        {
+            return data_;
+        }
+
 
         /// Access the i'th element. No range check is performed!
         reference operator[](size_t _idx)
@@ -223,6 +284,24 @@ namespace easy3d {
         }
 
 
+    private:
+        // the data of two arrays are compared byte by byte if the type is trivially copyable
+        template <class V>
+        static bool is_equal(const V& a, const V& b, std::true_type)
+        {
+            return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+        }
+        template <class V>
+        static bool is_equal(const V&, const V&, std::false_type)
+        {
+            return false;
+        }
+        // std::vector<bool> is packed, so it has no data()
+        static bool is_equal(const std::vector<bool>& a, const std::vector<bool>& b, std::true_type)
+        {
+            return a == b;
+        }
+
     private:
         vector_type data_;
         value_type  value_;
@@ -317,6 +396,7 @@ namespace easy3d {
         }
 
         /// Set the name of the property
+        /// \note Prefer PropertyContainer::rename(), which also keeps the name index of the container up to date.
         void set_name(const std::string& n) {
             assert(parray_ != nullptr);
             parray_->set_name(n);
@@ -328,25 +408,249 @@ namespace easy3d {
 
 
 
+    //== CLASS DEFINITION =========================================================
+
+    /// \brief Base class for a computed property.
+    /// \class BaseComputedProperty easy3d/core/properties.h
+    /// \details A computed (i.e., virtual) property has no array. Its value for an element is computed on demand
+    ///     by a function over the element index, e.g., the height (z-coordinate) of a vertex.
+    class BaseComputedProperty
+    {
+    public:
+        /// Default constructor
+        explicit BaseComputedProperty(const std::string& name) : name_(name), size_(0) {}
+
+        /// Destructor.
+        virtual ~BaseComputedProperty() {}
+
+        /// Changes the number of elements. It also invalidates the cached values.
+        virtual void resize(size_t n) = 0;
+
+        /// Discards the cached values (if any), e.g., after the data the values are computed from have changed.
+        /// It should not be called concurrently with accessing the values.
+        virtual void invalidate() = 0;
+
+        /// Return the type_info of the property
+        virtual const std::type_info& type() const = 0;
+
+        /// Return the name of the property
+        const std::string& name() const { return name_; }
+
+        /// Set the name of the property
+        void set_name(const std::string& n) { name_ = n; }
+
+        /// Returns the number of elements
+        size_t size() const { return size_; }
+
+    protected:
+        std::string name_;
+        size_t size_;
+    };
+
+
+
+    //== CLASS DEFINITION =========================================================
+
+    /// \brief Implementation of a computed property.
+    /// \class ComputedPropertyArray easy3d/core/properties.h
+    /// \details If the block size is not zero, the computed values are cached in blocks of that many elements, which
+    ///     pays off if the function is expensive and the values are accessed repeatedly. A block is computed (once)
+    ///     on the first access to any of its elements, so the cache never holds more than the accessed blocks.
+    ///     Accessing the values is thread-safe if the function is.
+    template <class T>
+    class ComputedPropertyArray : public BaseComputedProperty
+    {
+    public:
+        typedef std::function<T(size_t)> Function;
+
+        ComputedPropertyArray(const std::string& name, const Function& function, size_t block_size)
+                : BaseComputedProperty(name), function_(function), block_size_(block_size), num_blocks_(0),
+                  num_cached_(0) {}
+
+        ~ComputedPropertyArray() { invalidate(); }
+
+        virtual void resize(size_t n)
+        {
+            invalidate();
+            size_ = n;
+            const size_t num_blocks = (block_size_ == 0) ? 0 : (n + block_size_ - 1) / block_size_;
+            if (num_blocks != num_blocks_) {
+                blocks_.reset(num_blocks > 0 ? new std::atomic<std::vector<T>*>[num_blocks] : nullptr);
+                for (size_t i = 0; i < num_blocks; ++i)
+                    blocks_[i].store(nullptr, std::memory_order_relaxed);
+                num_blocks_ = num_blocks;
+            }
+        }
+
+        virtual void invalidate()
+        {
+            if (num_cached_.load() == 0)
+                return;
+            for (size_t i = 0; i < num_blocks_; ++i)
+                delete blocks_[i].exchange(nullptr);
+            num_cached_ = 0;
+        }
+
+        virtual const std::type_info& type() const { return typeid(T); }
+
+        /// Returns the value of element \p idx.
+        T value(size_t idx) const
+        {
+            if (block_size_ == 0)
+                return function_(idx);
+
+            const size_t b = idx / block_size_;
+            assert(b < num_blocks_);
+            std::vector<T>* block = blocks_[b].load(std::memory_order_acquire);
+            if (!block) {
+                std::vector<T>* values = new std::vector<T>;
+                const size_t begin = b * block_size_;
+                const size_t end = std::min(begin + block_size_, size_);
+                values->reserve(end - begin);
+                for (size_t i = begin; i < end; ++i)
+                    values->push_back(function_(i));
+                if (blocks_[b].compare_exchange_strong(block, values, std::memory_order_acq_rel)) {
+                    block = values;
+                    ++num_cached_;
+                }
+                else
+                    delete values;  // another thread was faster, and 'block' is its result
+            }
+            return (*block)[idx - b * block_size_];
+        }
+
+        /// Returns the function computing the values.
+        const Function& function() const { return function_; }
+
+        /// Returns the block size of the cache (0 if the values are not cached).
+        size_t block_size() const { return block_size_; }
+
+    private:
+        Function function_;
+        size_t block_size_;
+        std::unique_ptr<std::atomic<std::vector<T>*>[]> blocks_;
+        size_t num_blocks_;
+        mutable std::atomic<size_t> num_cached_;
+    };
+
+
+
+    //== CLASS DEFINITION =========================================================
+
+    /// \brief A handle to a computed property.
+    /// \class ComputedProperty easy3d/core/properties.h
+    /// \details Values are returned by value, and they can be accessed by the element index or by the element
+    ///     handle (e.g., a vertex), in the same way as a regular property, e.g.,
+    ///     \code
+    ///         auto height = mesh->vertex_property_container().add_computed<float>("v:height",
+    ///             [mesh](std::size_t i) { return mesh->position(SurfaceMesh::Vertex(i)).z; });
+    ///         for (auto v : mesh->vertices())
+    ///             std::cout << height[v] << std::endl;
+    ///     \endcode
+    template <class T>
+    class ComputedProperty
+    {
+    public:
+        typedef typename ComputedPropertyArray<T>::Function Function;
+
+        friend class PropertyContainer;
+
+    public:
+        ComputedProperty(ComputedPropertyArray<T> *p = nullptr) : parray_(p) {}
+
+        void reset()
+        {
+            parray_ = nullptr;
+        }
+
+        operator bool() const
+        {
+            return parray_ != nullptr;
+        }
+
+        T operator[](size_t i) const
+        {
+            assert(parray_ != nullptr);
+            assert(i < parray_->size());
+            return parray_->value(i);
+        }
+
+        /// Access by an element handle, i.e., anything that has idx().
+        template <class Handle>
+        auto operator[](Handle h) const -> decltype(static_cast<void>(h.idx()), T())
+        {
+            return (*this)[static_cast<size_t>(h.idx())];
+        }
+
+        /// Returns the number of elements.
+        size_t size() const
+        {
+            assert(parray_ != nullptr);
+            return parray_->size();
+        }
+
+        /// Discards the cached values. See BaseComputedProperty::invalidate().
+        void invalidate()
+        {
+            assert(parray_ != nullptr);
+            parray_->invalidate();
+        }
+
+        const ComputedPropertyArray<T>& array() const
+        {
+            assert(parray_ != nullptr);
+            return *parray_;
+        }
+
+        /// Return the name of the property
+        const std::string& name() const {
+            assert(parray_ != nullptr);
+            return parray_->name();
+        }
+
+    private:
+        ComputedPropertyArray<T>* parray_;
+    };
+
+
+
     //== CLASS DEFINITION =========================================================
 
 
     /// \brief Implementation of generic property container.
     /// \class PropertyContainer easy3d/core/properties.h
+    /// \details Besides the property arrays in memory, a container can hold deferred properties, i.e., properties
+    ///     whose data are only loaded (e.g., from a file) when they are first accessed by get(). A deferred property
+    ///     is listed by properties() and get_type(), but not by arrays(). All deferred properties are loaded before
+    ///     the elements are modified (e.g., resize(), push_back(), or swap()), except that resizing to zero discards
+    ///     them. Loading on first access is not thread-safe, so access the properties before entering a parallel
+    ///     region.
+    ///     Properties are looked up by name through a hash index, which is rebuilt on the first lookup after the
+    ///     set of properties has changed. Each such change also gives the container a new stamp(), which allows
+    ///     clients to cache the result of a lookup (see CachedProperty).
+    ///     A container can also hold computed properties (see ComputedProperty), whose values are computed on demand
+    ///     instead of being stored. They share the name space of the other properties, but they are only listed by
+    ///     computed_properties(), so they are ignored by clients iterating the arrays (e.g., the file writers).
+    ///     Their functions usually capture the model owning the container, so they are not copied with the container.
     class PropertyContainer
     {
     public:
+        /// A function that creates and fills the array of a deferred property, given the name of the property and
+        /// the number of elements. It returns nullptr on failure.
+        typedef std::function<BasePropertyArray*(const std::string&, std::size_t)> Loader;
+
 
         // default constructor
-        PropertyContainer() : size_(0) {}
+        PropertyContainer() : size_(0), stamp_(next_stamp()), index_stamp_(0) {}
 
         // destructor (deletes all property arrays)
         virtual ~PropertyContainer() { clear(); }
 
         // copy constructor: performs deep copy of property arrays
-        PropertyContainer(const PropertyContainer& _rhs) { operator=(_rhs); }
+        PropertyContainer(const PropertyContainer& _rhs) : size_(0), stamp_(0), index_stamp_(0) { operator=(_rhs); }
 
-        // assignment: performs deep copy of property arrays
+        // assignment: performs deep copy of property arrays. The computed properties are not copied, because their
+        // functions refer to the source (e.g., the model owning the source container).
         PropertyContainer& operator=(const PropertyContainer& _rhs)
         {
             if (this != &_rhs)
@@ -356,12 +660,16 @@ namespace easy3d {
                 size_ = _rhs.size();
                 for (size_t i=0; i<parrays_.size(); ++i)
                     parrays_[i] = _rhs.parrays_[i]->clone();
+                deferred_ = _rhs.deferred_;
+                changed();
             }
             return *this;
         }
 
         void transfer(const PropertyContainer& _rhs)
         {
+            load_deferred();
+            _rhs.load_deferred();
             for(std::size_t i=0; i<parrays_.size(); ++i){
                 for (std::size_t j=0; j<_rhs.parrays_.size(); ++j){
                     if(parrays_[i]->is_same (*(_rhs.parrays_[j]))){
@@ -375,21 +683,16 @@ namespace easy3d {
         // Copy properties that don't already exist from another container
         void copy_properties (const PropertyContainer& _rhs)
         {
+            _rhs.load_deferred();
             for (std::size_t i = 0; i < _rhs.parrays_.size(); ++ i)
             {
-                bool property_already_exists = false;
-                for (std::size_t j = 0; j < parrays_.size(); ++ j)
-                    if (_rhs.parrays_[i]->is_same (*(parrays_[j])))
-                    {
-                        property_already_exists = true;
-                        break;
-                    }
-
-                if (property_already_exists)
-                    continue;
+                const std::size_t j = index_of(_rhs.parrays_[i]->name());
+                if (j < parrays_.size() && _rhs.parrays_[i]->is_same (*(parrays_[j])))
+                    continue;   // property already exists
 
-                parrays_.push_back (_rhs.parrays_[i]->empty_clone());
-                parrays_.back()->resize(size_);
+                BasePropertyArray* p = _rhs.parrays_[i]->empty_clone();
+                p->resize(size_);
+                append(p);
             }
         }
 
@@ -397,6 +700,8 @@ namespace easy3d {
         // WARNING: properties must be the same in the two containers
         bool transfer(const PropertyContainer& _rhs, std::size_t from, std::size_t to)
         {
+            load_deferred();
+            _rhs.load_deferred();
             bool out = true;
             for(std::size_t i=0; i<parrays_.size(); ++i)
                 if (!(parrays_[i]->transfer(* _rhs.parrays_[i], from, to)))
@@ -407,37 +712,74 @@ namespace easy3d {
         // returns the current size of the property arrays
         size_t size() const { return size_; }
 
-        // returns the number of property arrays
+        // returns the number of property arrays (in memory, i.e., excluding the deferred properties)
         size_t n_properties() const { return parrays_.size(); }
 
-        // returns a vector of all property names
+        // returns the number of deferred properties (i.e., not loaded yet)
+        size_t n_deferred_properties() const { return deferred_.size(); }
+
+        // returns the stamp of the container, which changes whenever a property is added, removed, renamed, or
+        // loaded. Stamps are unique among all containers, so a stamp identifies both the container and its set of
+        // properties.
+        std::size_t stamp() const { return stamp_; }
+
+        // returns a vector of all property names (including the deferred properties)
         std::vector<std::string> properties() const
         {
             std::vector<std::string> names;
             for (size_t i=0; i<parrays_.size(); ++i)
                 names.push_back(parrays_[i]->name());
+            for (size_t i=0; i<deferred_.size(); ++i)
+                names.push_back(deferred_[i].name);
             return names;
         }
 
+        // returns whether property \c name is deferred (i.e., exists but has not been loaded yet)
+        bool is_deferred(const std::string& name) const
+        {
+            for (size_t i=0; i<deferred_.size(); ++i)
+                if (deferred_[i].name == name)
+                    return true;
+            return false;
+        }
+
+        // adds a deferred property of the given type, whose data will be created by \c loader on first access.
+        bool add_deferred(const std::string& name, const std::type_info& type, const Loader& loader)
+        {
+            if (get_type(name) != typeid(void) || computed_index_of(name) < cparrays_.size())
+            {
+                LOG(ERROR) << "A property with name \""
+                           << name << "\" already exists. Deferred property not added.";
+                return false;
+            }
+            deferred_.push_back(Deferred(name, type, loader));
+            changed();
+            return true;
+        }
+
+        // loads all deferred properties
+        void load_deferred() const
+        {
+            while (!deferred_.empty())
+                load(deferred_.front().name);
+        }
+
 
         // add a property with name \c name and default value \c t
         template <class T> Property<T> add(const std::string& name, const T t=T())
         {
             // if a property with this name already exists, return an invalid property
-            for (size_t i=0; i<parrays_.size(); ++i)
+            if (index_of(name) < parrays_.size() || is_deferred(name) || computed_index_of(name) < cparrays_.size())
             {
-                if (parrays_[i]->name() == name)
-                {
-                    LOG(ERROR) << "A property with name \""
-                              << name << "\" already exists. Returning invalid property.";
-                    return Property<T>();
-                }
+                LOG(ERROR) << "A property with name \""
+                          << name << "\" already exists. Returning invalid property.";
+                return Property<T>();
             }
 
             // otherwise add the property
             PropertyArray<T>* p = new PropertyArray<T>(name, t);
             p->resize(size_);
-            parrays_.push_back(p);
+            append(p);
             return Property<T>(p);
         }
 
@@ -445,9 +787,12 @@ namespace easy3d {
         // get a property by its name. returns invalid property if it does not exist.
         template <class T> Property<T> get(const std::string& name) const
         {
-            for (size_t i=0; i<parrays_.size(); ++i)
-                if (parrays_[i]->name() == name)
-                    return Property<T>(dynamic_cast<PropertyArray<T>*>(parrays_[i]));
+            const std::size_t idx = index_of(name);
+            if (idx < parrays_.size())
+                return Property<T>(dynamic_cast<PropertyArray<T>*>(parrays_[idx]));
+            for (size_t i=0; i<deferred_.size(); ++i)
+                if (deferred_[i].name == name && *deferred_[i].type == typeid(T))
+                    return Property<T>(dynamic_cast<PropertyArray<T>*>(load(name)));
             return Property<T>();
         }
 
@@ -461,12 +806,91 @@ namespace easy3d {
         }
 
 
+        // add a computed property with name \c name, whose value of the i-th element is \c function(i). If
+        // \c block_size is not zero, the values are cached in blocks of \c block_size elements when first accessed.
+        template <class T> ComputedProperty<T> add_computed(
+                const std::string& name, const typename ComputedProperty<T>::Function& function, size_t block_size = 0)
+        {
+            if (index_of(name) < parrays_.size() || is_deferred(name) || computed_index_of(name) < cparrays_.size())
+            {
+                LOG(ERROR) << "A property with name \""
+                           << name << "\" already exists. Returning invalid computed property.";
+                return ComputedProperty<T>();
+            }
+
+            ComputedPropertyArray<T>* p = new ComputedPropertyArray<T>(name, function, block_size);
+            p->resize(size_);
+            cparrays_.push_back(p);
+            return ComputedProperty<T>(p);
+        }
+
+
+        // get a computed property by its name. returns invalid property if it does not exist.
+        template <class T> ComputedProperty<T> get_computed(const std::string& name) const
+        {
+            const std::size_t idx = computed_index_of(name);
+            if (idx < cparrays_.size())
+                return ComputedProperty<T>(dynamic_cast<ComputedPropertyArray<T>*>(cparrays_[idx]));
+            return ComputedProperty<T>();
+        }
+
+
+        // returns a vector of the names of all computed properties
+        std::vector<std::string> computed_properties() const
+        {
+            std::vector<std::string> names;
+            for (size_t i=0; i<cparrays_.size(); ++i)
+                names.push_back(cparrays_[i]->name());
+            return names;
+        }
+
+        // returns the number of computed properties
+        size_t n_computed_properties() const { return cparrays_.size(); }
+
+        // get the type of a computed property by its name. returns typeid(void) if it does not exist.
+        const std::type_info& get_computed_type(const std::string& name) const
+        {
+            const std::size_t idx = computed_index_of(name);
+            if (idx < cparrays_.size())
+                return cparrays_[idx]->type();
+            return typeid(void);
+        }
+
+        // discards the cached values of all computed properties, e.g., after the data they are computed from
+        // have changed.
+        void invalidate_computed() const
+        {
+            for (size_t i=0; i<cparrays_.size(); ++i)
+                cparrays_[i]->invalidate();
+        }
+
+        // delete a computed property. Returns true on success.
+        template <class T> bool remove(ComputedProperty<T>& h)
+        {
+            std::vector<BaseComputedProperty*>::iterator it=cparrays_.begin(), end=cparrays_.end();
+            for (; it!=end; ++it)
+            {
+                if (*it == h.parray_)
+                {
+                    delete *it;
+                    cparrays_.erase(it);
+                    h.reset();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+
         // get the type of property by its name. returns typeid(void) if it does not exist.
         const std::type_info& get_type(const std::string& name) const
         {
-            for (size_t i=0; i<parrays_.size(); ++i)
-                if (parrays_[i]->name() == name)
-                    return parrays_[i]->type();
+            const std::size_t idx = index_of(name);
+            if (idx < parrays_.size())
+                return parrays_[idx]->type();
+            for (size_t i=0; i<deferred_.size(); ++i)
+                if (deferred_[i].name == name)
+                    return *deferred_[i].type;
             return typeid(void);
         }
 
@@ -482,6 +906,7 @@ namespace easy3d {
                     delete *it;
                     parrays_.erase(it);
                     h.reset();
+                    changed();
                     return true;
                 }
             }
@@ -491,16 +916,30 @@ namespace easy3d {
         // delete a property by name. Returns true on success.
         bool remove(const std::string& name)
         {
-            std::vector<BasePropertyArray*>::iterator it=parrays_.begin(), end=parrays_.end();
-            for (; it!=end; ++it)
+            const std::size_t idx = index_of(name);
+            if (idx < parrays_.size())
+            {
+                delete parrays_[idx];
+                parrays_.erase(parrays_.begin() + idx);
+                changed();
+                return true;
+            }
+            for (std::size_t i=0; i<deferred_.size(); ++i)
             {
-                if ((*it)->name() == name)
+                if (deferred_[i].name == name)
                 {
-                    delete *it;
-                    parrays_.erase(it);
+                    deferred_.erase(deferred_.begin() + i);
+                    changed();
                     return true;
                 }
             }
+            const std::size_t cidx = computed_index_of(name);
+            if (cidx < cparrays_.size())
+            {
+                delete cparrays_[cidx];
+                cparrays_.erase(cparrays_.begin() + cidx);
+                return true;
+            }
             return false;
         }
 
@@ -509,15 +948,28 @@ namespace easy3d {
         {
             assert(!old_name.empty());
             assert(!new_name.empty());
-            std::vector<BasePropertyArray*>::iterator it=parrays_.begin(), end=parrays_.end();
-            for (; it!=end; ++it)
+            const std::size_t idx = index_of(old_name);
+            if (idx < parrays_.size())
             {
-                if ((*it)->name() == old_name)
+                parrays_[idx]->set_name(new_name);
+                changed();
+                return true;
+            }
+            for (std::size_t i=0; i<deferred_.size(); ++i)
+            {
+                if (deferred_[i].name == old_name)
                 {
-                    (*it)->set_name(new_name);
+                    deferred_[i].name = new_name;
+                    changed();
                     return true;
                 }
             }
+            const std::size_t cidx = computed_index_of(old_name);
+            if (cidx < cparrays_.size())
+            {
+                cparrays_[cidx]->set_name(new_name);
+                return true;
+            }
             return false;
         }
 
@@ -528,7 +980,12 @@ namespace easy3d {
             for (size_t i=0; i<parrays_.size(); ++i)
                 delete parrays_[i];
             parrays_.clear();
+            deferred_.clear();
+            for (size_t i=0; i<cparrays_.size(); ++i)
+                delete cparrays_[i];
+            cparrays_.clear();
             size_ = 0;
+            changed();
         }
 
 
@@ -542,19 +999,34 @@ namespace easy3d {
         // resize all arrays to size n
         void resize(size_t n)
         {
+            if (n == 0)     // the data of the deferred properties would be dropped anyway
+                deferred_.clear();
+            else
+                load_deferred();
             for (size_t i=0; i<parrays_.size(); ++i)
                 parrays_[i]->resize(n);
+            for (size_t i=0; i<cparrays_.size(); ++i)
+                cparrays_[i]->resize(n);
             size_ = n;
         }
 
-        // resize the vector of properties to n, deleting all other properties
+        // resize the vector of properties to n, deleting all other properties (including the deferred and the
+        // computed ones)
         void resize_property_array(size_t n)
         {
+            for (std::size_t i=0; i<cparrays_.size(); ++i)
+                delete cparrays_[i];
+            cparrays_.clear();
+            if (!deferred_.empty()) {
+                deferred_.clear();
+                changed();
+            }
             if (parrays_.size()<=n)
                 return;
             for (std::size_t i=n; i<parrays_.size(); ++i)
                 delete parrays_[i];
             parrays_.resize(n);
+            changed();
         }
 
         // free unused space in all arrays
@@ -567,45 +1039,223 @@ namespace easy3d {
         // add a new element to each vector
         void push_back()
         {
+            load_deferred();
             for (size_t i=0; i<parrays_.size(); ++i)
                 parrays_[i]->push_back();
             ++size_;
+            for (size_t i=0; i<cparrays_.size(); ++i)
+                cparrays_[i]->resize(size_);
         }
 
         // reset element to its default property values
         void reset(size_t idx)
         {
+            load_deferred();
             for (std::size_t i=0; i<parrays_.size(); ++i)
                 parrays_[i]->reset(idx);
+            invalidate_computed();
         }
 
         // swap elements i0 and i1 in all arrays
         void swap(size_t i0, size_t i1) const
         {
+            load_deferred();
             for (size_t i=0; i<parrays_.size(); ++i)
                 parrays_[i]->swap(i0, i1);
+            invalidate_computed();
         }
 
         // swap content with other Property_container
         void swap (PropertyContainer& other)
         {
             this->parrays_.swap (other.parrays_);
+            this->deferred_.swap (other.deferred_);
+            this->cparrays_.swap (other.cparrays_);
             std::swap(this->size_, other.size_);
+            this->changed();
+            other.changed();
         }
 
         // copy 'from' -> 'to' in all arrays
         void copy(size_t from, size_t to) const
         {
+            load_deferred();
             for (size_t i=0; i<parrays_.size(); ++i)
                 parrays_[i]->copy(from, to);
+            invalidate_computed();
+        }
+
+        // reorder the elements in all arrays, such that the new i-th element is the old element order[i]. The
+        // order must be a permutation of [0, size()).
+        void permute(const std::vector<size_t>& order) const
+        {
+            assert(order.size() == size_);
+            load_deferred();
+            for (size_t i=0; i<parrays_.size(); ++i)
+                parrays_[i]->permute(order);
+            invalidate_computed();
         }
 
         const std::vector<BasePropertyArray*>& arrays() const { return parrays_; }
-        std::vector<BasePropertyArray*>& arrays() { return parrays_; }
+        // the caller may add, remove, or rename arrays, so the container is considered changed
+        std::vector<BasePropertyArray*>& arrays() { changed(); return parrays_; }
 
     private:
-        std::vector<BasePropertyArray*>  parrays_;
+        // loads deferred property 'name' and moves it into the property arrays. returns nullptr on failure.
+        BasePropertyArray* load(const std::string& name) const
+        {
+            for (std::size_t i=0; i<deferred_.size(); ++i)
+            {
+                if (deferred_[i].name == name)
+                {
+                    const Deferred d = deferred_[i];
+                    deferred_.erase(deferred_.begin() + i);
+                    BasePropertyArray* p = d.loader(name, size_);
+                    if (p && p->type() != *d.type) {
+                        delete p;
+                        p = nullptr;
+                    }
+                    if (!p) {
+                        LOG(ERROR) << "failed loading deferred property \"" << name << "\"";
+                        return nullptr;
+                    }
+                    append(p);
+                    return p;
+                }
+            }
+            return nullptr;
+        }
+
+        // returns the position of the array named 'name' in parrays_, or parrays_.size() if it does not exist.
+        // Containers with a few properties (the common case) are searched linearly, which is faster than hashing
+        // the name and avoids rebuilding the index each time a property is added, removed, or renamed.
+        std::size_t index_of(const std::string& name) const
+        {
+            if (parrays_.size() < index_threshold) {
+                for (std::size_t i=0; i<parrays_.size(); ++i)
+                    if (parrays_[i]->name() == name)
+                        return i;
+                return parrays_.size();
+            }
+            if (index_stamp_.load(std::memory_order_acquire) != stamp_)
+                update_index();
+            std::unordered_map<std::string, std::size_t>::const_iterator pos = index_.find(name);
+            if (pos == index_.end())
+                return parrays_.size();
+            if (parrays_[pos->second]->name() == name)
+                return pos->second;
+            // the array has been renamed behind our back (e.g., by Property::set_name())
+            for (std::size_t i=0; i<parrays_.size(); ++i)
+                if (parrays_[i]->name() == name)
+                    return i;
+            return parrays_.size();
+        }
+
+        // returns the position of the computed property named 'name' in cparrays_, or cparrays_.size() if it does
+        // not exist. There are usually only a few computed properties, so they are not indexed.
+        std::size_t computed_index_of(const std::string& name) const
+        {
+            for (std::size_t i=0; i<cparrays_.size(); ++i)
+                if (cparrays_[i]->name() == name)
+                    return i;
+            return cparrays_.size();
+        }
+
+        // rebuilds the name index. Concurrent lookups are safe, as the index is only read when it is up to date.
+        void update_index() const
+        {
+            std::lock_guard<std::mutex> lock(index_mutex_);
+            if (index_stamp_.load(std::memory_order_relaxed) == stamp_)
+                return;
+            index_.clear();
+            index_.reserve(parrays_.size());
+            for (std::size_t i=0; i<parrays_.size(); ++i)
+                index_.insert(std::make_pair(parrays_[i]->name(), i)); // keeps the first one for duplicated names
+            index_stamp_.store(stamp_, std::memory_order_release);
+        }
+
+        // adds an array to the end of parrays_, and updates the index if it is up to date
+        void append(BasePropertyArray* p) const
+        {
+            const bool indexed = (index_stamp_.load(std::memory_order_acquire) == stamp_);
+            parrays_.push_back(p);
+            changed();
+            if (indexed) {
+                index_.insert(std::make_pair(p->name(), parrays_.size() - 1));
+                index_stamp_.store(stamp_, std::memory_order_release);
+            }
+        }
+
+        // gives the container a new stamp, which also invalidates the name index
+        void changed() const { stamp_ = next_stamp(); }
+
+        static std::size_t next_stamp()
+        {
+            static std::atomic<std::size_t> counter(0);
+            return ++counter;
+        }
+
+        struct Deferred {
+            Deferred(const std::string& n, const std::type_info& t, const Loader& l) : name(n), type(&t), loader(l) {}
+            std::string name;
+            const std::type_info* type;
+            Loader loader;
+        };
+
+    private:
+        // mutable, because deferred properties are loaded on first access by the const accessors
+        mutable std::vector<BasePropertyArray*>  parrays_;
+        mutable std::vector<Deferred>  deferred_;
+        std::vector<BaseComputedProperty*>  cparrays_;
         size_t  size_;
+
+        mutable std::size_t stamp_;
+        // the name index is used only for containers with at least this number of arrays
+        static const std::size_t index_threshold = 32;
+        // name -> position in parrays_, valid only if index_stamp_ equals stamp_
+        mutable std::unordered_map<std::string, std::size_t> index_;
+        mutable std::atomic<std::size_t> index_stamp_;
+        mutable std::mutex index_mutex_;
+    };
+
+
+    /// \brief A property handle that caches the result of looking up a property by its name.
+    /// \class CachedProperty easy3d/core/properties.h
+    /// \details The lookup is repeated only if the set of properties of the container has changed since the last
+    ///     call (i.e., if the stamp of the container differs), so it is cheap to call get() in code that runs
+    ///     repeatedly, e.g., when updating the rendering buffers. Example:
+    ///     \code
+    ///         CachedProperty<vec3> normals("v:normal");
+    ///         ...
+    ///         auto prop = normals.get(mesh->vertex_property_container());
+    ///         if (prop) { ... }
+    ///     \endcode
+    template <class T>
+    class CachedProperty
+    {
+    public:
+        explicit CachedProperty(const std::string& name) : name_(name), stamp_(0) {}
+
+        /// Returns the property in \p container, which is invalid if the property does not exist.
+        Property<T> get(const PropertyContainer& container)
+        {
+            if (container.stamp() != stamp_) {
+                property_ = container.get<T>(name_);
+                stamp_ = container.stamp(); // after get(), which may have loaded a deferred property
+            }
+            return property_;
+        }
+
+        /// Returns the name of the property.
+        const std::string& name() const { return name_; }
+
+        /// Forgets the cached property, so the next call to get() will look it up again.
+        void reset() { stamp_ = 0; property_.reset(); }
+
+    private:
+        std::string name_;
+        Property<T> property_;
+        std::size_t stamp_;
     };
 
 } // namespace easy3d
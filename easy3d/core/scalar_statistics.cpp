@@ -0,0 +1,320 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/core/scalar_statistics.h>
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace easy3d {
+
+
+    namespace details {
+
+        // The values are split into chunks of at least this many elements, which are processed in parallel.
+        const std::size_t min_chunk_size = 1 << 16;
+
+        inline std::size_t max_threads() {
+#ifdef _OPENMP
+            return static_cast<std::size_t>(omp_get_max_threads());
+#else
+            return 1;
+#endif
+        }
+
+        // Maps a float to an unsigned integer key with the same order.
+        inline std::uint32_t key(float v) {
+            std::uint32_t b;
+            std::memcpy(&b, &v, sizeof(b));
+            return (b & 0x80000000u) ? ~b : (b | 0x80000000u);
+        }
+
+        // A quantile table: each of the points represents (count / points.size()) values.
+        struct Summary {
+            std::size_t count = 0;
+            std::vector<float> points;
+        };
+
+
+        // Places the values of the given ranks [rank_begin, rank_end) at their sorted positions within
+        // [begin, end), i.e., a multi-selection by recursive nth_element() calls.
+        void select(float *values, std::size_t begin, std::size_t end,
+                    const std::size_t *ranks, std::size_t rank_begin, std::size_t rank_end) {
+            if (rank_begin >= rank_end || begin >= end)
+                return;
+            const std::size_t mid = rank_begin + (rank_end - rank_begin) / 2;
+            const std::size_t r = ranks[mid];
+            std::nth_element(values + begin, values + r, values + end);
+            select(values, begin, r, ranks, rank_begin, mid);
+            select(values, r + 1, end, ranks, mid + 1, rank_end);
+        }
+
+
+        // Merges the quantile tables of several sets of values into the quantile table of their union: the points
+        // of the tables are treated as weighted samples, which are sorted and then sampled at the target ranks.
+        Summary merge(const std::vector<const Summary *> &summaries, std::size_t resolution) {
+            Summary result;
+            std::vector<std::pair<float, double> > samples;   // value, weight
+            for (auto s : summaries) {
+                if (s->count == 0 || s->points.empty())
+                    continue;
+                result.count += s->count;
+                const double weight = static_cast<double>(s->count) / static_cast<double>(s->points.size());
+                for (auto v : s->points)
+                    samples.emplace_back(v, weight);
+            }
+            if (result.count == 0)
+                return result;
+
+            std::sort(samples.begin(), samples.end(),
+                      [](const std::pair<float, double> &a, const std::pair<float, double> &b) -> bool {
+                          return a.first < b.first;
+                      });
+
+            const std::size_t num = std::min(result.count, resolution + 1);
+            result.points.resize(num);
+            if (num == 1) {
+                result.points[0] = samples.front().first;
+                return result;
+            }
+
+            // sample i covers the ranks [cumulative, cumulative + weight)
+            std::size_t i = 0;
+            double cumulative = 0.0;
+            for (std::size_t j = 0; j < num; ++j) {
+                const double target = static_cast<double>(j) * static_cast<double>(result.count - 1) / (num - 1);
+                while (i + 1 < samples.size() && cumulative + samples[i].second <= target) {
+                    cumulative += samples[i].second;
+                    ++i;
+                }
+                result.points[j] = samples[i].first;
+            }
+            // the extremes are exact
+            result.points.front() = samples.front().first;
+            result.points.back() = samples.back().first;
+            return result;
+        }
+
+    }
+
+
+    const std::size_t ScalarStatistics::default_resolution;
+
+
+    ScalarStatistics::ScalarStatistics(std::size_t resolution)
+            : resolution_(std::max(resolution, std::size_t(1))), count_(0)
+    {
+    }
+
+
+    template<typename VALUES>
+    void ScalarStatistics::compute(std::size_t n, const VALUES &values) {
+        // The values at the target ranks are found by one level of radix selection: a histogram of the 16 most
+        // significant bits of the (order-preserving) keys of the values tells the bin and the rank within the bin
+        // of each target rank. Then only the values in these bins are gathered, and the targets are selected by
+        // nth_element() within their bins, which are much smaller than the field.
+        const std::size_t num_bins = std::size_t(1) << 16;
+        const std::size_t num_chunks = std::max(std::size_t(1), std::min(n / details::min_chunk_size, details::max_threads()));
+        const std::size_t chunk_size = (n + num_chunks - 1) / num_chunks;
+
+        // per chunk histograms (which later become the write positions of the chunks in each bin)
+        std::vector<std::vector<std::size_t> > histograms(num_chunks, std::vector<std::size_t>(num_bins, 0));
+#pragma omp parallel for
+        for (int c = 0; c < static_cast<int>(num_chunks); ++c) {
+            std::vector<std::size_t> &histogram = histograms[c];
+            const std::size_t end = std::min((c + 1) * chunk_size, n);
+            for (std::size_t i = c * chunk_size; i < end; ++i) {
+                const float v = static_cast<float>(values[i]);
+                if (std::isfinite(v))
+                    ++histogram[details::key(v) >> 16];
+            }
+        }
+
+        std::vector<std::size_t> bin_begin(num_bins + 1, 0);    // the rank of the first value in each bin
+        for (std::size_t b = 0; b < num_bins; ++b) {
+            bin_begin[b + 1] = bin_begin[b];
+            for (std::size_t c = 0; c < num_chunks; ++c)
+                bin_begin[b + 1] += histograms[c][b];
+        }
+        count_ = bin_begin[num_bins];
+        sketch_.clear();
+        if (count_ == 0)
+            return;
+
+        // the target ranks and their bins
+        const std::size_t num_ranks = std::min(count_, resolution_ + 1);
+        std::vector<std::size_t> ranks(num_ranks), rank_bins(num_ranks);
+        for (std::size_t j = 0; j < num_ranks; ++j) {
+            ranks[j] = num_ranks == 1 ? 0 : static_cast<std::size_t>(
+                    (static_cast<std::uint64_t>(j) * (count_ - 1)) / (num_ranks - 1));
+            rank_bins[j] = std::upper_bound(bin_begin.begin(), bin_begin.end(), ranks[j]) - bin_begin.begin() - 1;
+        }
+
+        // the layout of the gathered values: only the bins containing target ranks
+        std::vector<std::size_t> targets;                          // the bins containing target ranks
+        std::vector<std::size_t> gathered_begin(num_bins, n);     // n for bins without target ranks
+        std::size_t num_gathered = 0;
+        for (std::size_t j = 0; j < num_ranks; ++j) {
+            const std::size_t b = rank_bins[j];
+            if (gathered_begin[b] != n)
+                continue;
+            targets.push_back(b);
+            gathered_begin[b] = num_gathered;
+            num_gathered += bin_begin[b + 1] - bin_begin[b];
+        }
+        for (std::size_t b = 0; b < num_bins; ++b) {
+            if (gathered_begin[b] == n)
+                continue;
+            std::size_t pos = gathered_begin[b];
+            for (std::size_t c = 0; c < num_chunks; ++c) {
+                const std::size_t num = histograms[c][b];
+                histograms[c][b] = pos;
+                pos += num;
+            }
+        }
+
+        std::vector<float> gathered(num_gathered);
+#pragma omp parallel for
+        for (int c = 0; c < static_cast<int>(num_chunks); ++c) {
+            std::vector<std::size_t> &positions = histograms[c];
+            const std::size_t end = std::min((c + 1) * chunk_size, n);
+            for (std::size_t i = c * chunk_size; i < end; ++i) {
+                const float v = static_cast<float>(values[i]);
+                if (!std::isfinite(v))
+                    continue;
+                const std::size_t b = details::key(v) >> 16;
+                if (gathered_begin[b] != n)
+                    gathered[positions[b]++] = v;
+            }
+        }
+
+        // select the target ranks within their bins (the ranks of a bin are consecutive in 'ranks')
+        std::vector<std::size_t> local_ranks(num_ranks);
+        std::vector<std::size_t> first_rank(targets.size() + 1, 0);
+        for (std::size_t j = 0, t = 0; j < num_ranks; ++j) {
+            if (j > 0 && rank_bins[j] != rank_bins[j - 1])
+                first_rank[++t] = j;
+            local_ranks[j] = ranks[j] - bin_begin[rank_bins[j]];
+        }
+        first_rank[targets.size()] = num_ranks;
+
+#pragma omp parallel for schedule(dynamic)
+        for (int t = 0; t < static_cast<int>(targets.size()); ++t) {
+            const std::size_t b = targets[t];
+            details::select(gathered.data() + gathered_begin[b], 0, bin_begin[b + 1] - bin_begin[b],
+                            local_ranks.data(), first_rank[t], first_rank[t + 1]);
+        }
+
+        sketch_.resize(num_ranks);
+        for (std::size_t j = 0; j < num_ranks; ++j)
+            sketch_[j] = gathered[gathered_begin[rank_bins[j]] + local_ranks[j]];
+    }
+
+
+#define EASY3D_SCALAR_STATISTICS_INSTANTIATE(FT)                                                    \
+    ScalarStatistics::ScalarStatistics(const std::vector<FT> &values, std::size_t resolution)       \
+            : resolution_(std::max(resolution, std::size_t(1))), count_(0)                          \
+    {                                                                                               \
+        compute(values.size(), values);                                                             \
+    }
+
+    EASY3D_SCALAR_STATISTICS_INSTANTIATE(float)
+    EASY3D_SCALAR_STATISTICS_INSTANTIATE(double)
+    EASY3D_SCALAR_STATISTICS_INSTANTIATE(int)
+    EASY3D_SCALAR_STATISTICS_INSTANTIATE(unsigned int)
+    EASY3D_SCALAR_STATISTICS_INSTANTIATE(char)
+    EASY3D_SCALAR_STATISTICS_INSTANTIATE(unsigned char)
+    EASY3D_SCALAR_STATISTICS_INSTANTIATE(bool)
+
+#undef EASY3D_SCALAR_STATISTICS_INSTANTIATE
+
+
+    namespace details {
+        // provides values[i] by calling a function
+        struct FunctionValues {
+            explicit FunctionValues(const std::function<float(std::size_t)> &f) : function(f) {}
+            float operator[](std::size_t i) const { return function(i); }
+            const std::function<float(std::size_t)> &function;
+        };
+    }
+
+
+    ScalarStatistics::ScalarStatistics(std::size_t n, const std::function<float(std::size_t)> &value,
+                                       std::size_t resolution)
+            : resolution_(std::max(resolution, std::size_t(1))), count_(0)
+    {
+        compute(n, details::FunctionValues(value));
+    }
+
+
+    float ScalarStatistics::quantile(float q) const {
+        if (empty())
+            return 0.0f;
+        q = std::min(std::max(q, 0.0f), 1.0f);
+        const std::size_t index = static_cast<std::size_t>(q * static_cast<float>(sketch_.size() - 1) + 0.5f);
+        return sketch_[std::min(index, sketch_.size() - 1)];
+    }
+
+
+    std::vector<std::size_t> ScalarStatistics::histogram(std::size_t num_bins) const {
+        std::vector<double> bins(num_bins, 0.0);
+        if (num_bins == 0 || empty())
+            return std::vector<std::size_t>(num_bins, 0);
+
+        const float range = max() - min();
+        const double weight = static_cast<double>(count_) / static_cast<double>(sketch_.size());
+        for (auto v : sketch_) {
+            std::size_t b = 0;
+            if (range > 0.0f)
+                b = std::min(static_cast<std::size_t>((v - min()) / range * num_bins), num_bins - 1);
+            bins[b] += weight;
+        }
+
+        std::vector<std::size_t> result(num_bins);
+        for (std::size_t i = 0; i < num_bins; ++i)
+            result[i] = static_cast<std::size_t>(bins[i] + 0.5);
+        return result;
+    }
+
+
+    void ScalarStatistics::merge(const ScalarStatistics &other) {
+        details::Summary a, b;
+        a.count = count_;
+        a.points = sketch_;
+        b.count = other.count_;
+        b.points = other.sketch_;
+        resolution_ = std::max(resolution_, other.resolution_);
+        details::Summary result = details::merge({&a, &b}, resolution_);
+        count_ = result.count;
+        sketch_.swap(result.points);
+    }
+
+}
@@ -0,0 +1,132 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_CORE_SCALAR_STATISTICS_H
+#define EASY3D_CORE_SCALAR_STATISTICS_H
+
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Statistics of a scalar field (e.g., a vertex property of type float): the value range, a quantile
+     *      sketch, and histograms.
+     * \class ScalarStatistics easy3d/core/scalar_statistics.h
+     * \details The quantile sketch is a table of at most (resolution + 1) values sorted in increasing order, where
+     *      the i-th value is the (i / resolution)-quantile of the field. For fields with at most (resolution + 1)
+     *      values, the table holds all the values. The quantiles are exact: they are found by one level of radix
+     *      selection, i.e., a histogram pass over the values (in parallel) locates the bins holding the target ranks,
+     *      and the targets are selected by nth_element() among the (few) values in these bins, which is much faster
+     *      than sorting the values. Sketches are mergeable, so the statistics of several fields can be combined (see
+     *      merge()), in which case the rank error of a quantile is below 1/resolution.
+     *      Once computed, a quantile query is a lookup in the table.
+     *
+     *      Example usage:
+     *      \code
+     *          ScalarStatistics stats(mesh->get_vertex_property<float>("v:curvature").vector());
+     *          const float lower = stats.quantile(0.05f);    // the value below which 5% of the values are
+     *          const float upper = stats.quantile(0.95f);
+     *      \endcode
+     *
+     * \note Non-finite values (i.e., NaN and infinity) are ignored.
+     */
+    class ScalarStatistics {
+    public:
+        /// The default resolution of the quantile sketch.
+        static const std::size_t default_resolution = 1024;
+
+    public:
+        /// Constructs empty statistics.
+        explicit ScalarStatistics(std::size_t resolution = default_resolution);
+
+        /// \name Computes the statistics of the values of a scalar field.
+        //@{
+        explicit ScalarStatistics(const std::vector<float> &values, std::size_t resolution = default_resolution);
+        explicit ScalarStatistics(const std::vector<double> &values, std::size_t resolution = default_resolution);
+        explicit ScalarStatistics(const std::vector<int> &values, std::size_t resolution = default_resolution);
+        explicit ScalarStatistics(const std::vector<unsigned int> &values, std::size_t resolution = default_resolution);
+        explicit ScalarStatistics(const std::vector<char> &values, std::size_t resolution = default_resolution);
+        explicit ScalarStatistics(const std::vector<unsigned char> &values, std::size_t resolution = default_resolution);
+        explicit ScalarStatistics(const std::vector<bool> &values, std::size_t resolution = default_resolution);
+        //@}
+
+        /**
+         * \brief Computes the statistics of \p n values given by a function, e.g., the values of a computed property.
+         * \details The values are never stored: \p value is called (twice for each index, and from several threads
+         *      if OpenMP is available), so it must be thread-safe and return the same value for the same index.
+         */
+        ScalarStatistics(std::size_t n, const std::function<float(std::size_t)> &value,
+                         std::size_t resolution = default_resolution);
+
+        /// Returns the number of (finite) values.
+        std::size_t count() const { return count_; }
+        /// Returns true if there are no (finite) values.
+        bool empty() const { return count_ == 0; }
+
+        /// Returns the minimum value. The result is undefined if the statistics are empty.
+        float min() const { return sketch_.front(); }
+        /// Returns the maximum value. The result is undefined if the statistics are empty.
+        float max() const { return sketch_.back(); }
+
+        /**
+         * \brief Returns the \p q-quantile of the values, i.e., a fraction \p q of the values are smaller than or
+         *      equal to the returned value. The result is undefined if the statistics are empty.
+         * \param q The fraction in [0, 1]. Values outside the range are clamped.
+         */
+        float quantile(float q) const;
+
+        /**
+         * \brief Computes a histogram of the values (derived from the quantile sketch).
+         * \param num_bins The number of bins, which evenly divide [min(), max()].
+         * \return The (approximate) number of values in each bin.
+         */
+        std::vector<std::size_t> histogram(std::size_t num_bins) const;
+
+        /// Merges the statistics of another set of values into these ones.
+        void merge(const ScalarStatistics &other);
+
+        /// Returns the quantile sketch, i.e., the values at the evenly distributed ranks.
+        const std::vector<float> &sketch() const { return sketch_; }
+
+    private:
+        // 'values' is anything that provides values[i] for i in [0, n), e.g., a std::vector
+        template<typename VALUES>
+        void compute(std::size_t n, const VALUES &values);
+
+    private:
+        std::size_t resolution_;
+        std::size_t count_;
+        std::vector<float> sketch_;
+    };
+
+}
+
+
+#endif  // EASY3D_CORE_SCALAR_STATISTICS_H
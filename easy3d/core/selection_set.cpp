@@ -0,0 +1,250 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/core/selection_set.h>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace easy3d {
+
+
+    namespace details {
+
+        inline int popcount(std::uint32_t w) {
+#if defined(_MSC_VER)
+            return static_cast<int>(__popcnt(w));
+#else
+            return __builtin_popcount(w);
+#endif
+        }
+
+    }
+
+
+    const std::size_t SelectionSet::bits_per_word;
+
+
+    SelectionSet::SelectionSet(std::size_t n) : size_(0) {
+        resize(n);
+    }
+
+
+    SelectionSet::SelectionSet(const std::vector<bool> &flags) : size_(0) {
+        assign(flags);
+    }
+
+
+    SelectionSet::SelectionSet(const SelectionSet &other) : size_(0) {
+        *this = other;
+    }
+
+
+    SelectionSet &SelectionSet::operator=(const SelectionSet &other) {
+        if (this == &other)
+            return *this;
+        const std::size_t n = other.num_words();
+        if (n != num_words())
+            words_.reset(n > 0 ? new std::atomic<word_type>[n] : nullptr);
+        for (std::size_t i = 0; i < n; ++i)
+            words_[i].store(other.word(i), std::memory_order_relaxed);
+        size_ = other.size_;
+        return *this;
+    }
+
+
+    void SelectionSet::resize(std::size_t n) {
+        const std::size_t old_words = num_words();
+        const std::size_t new_words = num_words(n);
+        if (new_words != old_words) {
+            std::unique_ptr<std::atomic<word_type>[]> words(new_words > 0 ? new std::atomic<word_type>[new_words] : nullptr);
+            const std::size_t num = std::min(old_words, new_words);
+            for (std::size_t i = 0; i < num; ++i)
+                words[i].store(word(i), std::memory_order_relaxed);
+            for (std::size_t i = num; i < new_words; ++i)
+                words[i].store(0, std::memory_order_relaxed);
+            words_.swap(words);
+        }
+
+        // the bits beyond the size must be zero
+        const std::size_t old_size = size_;
+        size_ = n;
+        if (n < old_size && new_words > 0)
+            words_[new_words - 1].fetch_and(last_word_mask(), std::memory_order_relaxed);
+    }
+
+
+    void SelectionSet::get_words(std::vector<word_type> &words) const {
+        const std::size_t n = num_words();
+        words.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+            words[i] = word(i);
+    }
+
+
+    SelectionSet::word_type SelectionSet::last_word_mask() const {
+        const std::size_t rest = size_ % bits_per_word;
+        return rest == 0 ? ~word_type(0) : (word_type(1) << rest) - 1;
+    }
+
+
+    void SelectionSet::fill(std::size_t first, std::size_t last, bool value) {
+        last = std::min(last, size_);
+        if (first >= last)
+            return;
+
+        const std::size_t first_word = first / bits_per_word;
+        const std::size_t last_word = (last - 1) / bits_per_word;
+        const word_type first_mask = ~word_type(0) << (first % bits_per_word);
+        const word_type last_mask = ~word_type(0) >> (bits_per_word - 1 - (last - 1) % bits_per_word);
+
+        for (std::size_t i = first_word; i <= last_word; ++i) {
+            word_type m = ~word_type(0);
+            if (i == first_word) m &= first_mask;
+            if (i == last_word)  m &= last_mask;
+            if (value)
+                words_[i].fetch_or(m, std::memory_order_relaxed);
+            else
+                words_[i].fetch_and(~m, std::memory_order_relaxed);
+        }
+    }
+
+
+    void SelectionSet::set_range(std::size_t first, std::size_t last) {
+        fill(first, last, true);
+    }
+
+
+    void SelectionSet::reset_range(std::size_t first, std::size_t last) {
+        fill(first, last, false);
+    }
+
+
+    void SelectionSet::set() {
+        fill(0, size_, true);
+    }
+
+
+    void SelectionSet::reset() {
+        const std::size_t n = num_words();
+        for (std::size_t i = 0; i < n; ++i)
+            words_[i].store(0, std::memory_order_relaxed);
+    }
+
+
+    void SelectionSet::flip() {
+        const std::size_t n = num_words();
+        for (std::size_t i = 0; i < n; ++i)
+            words_[i].store(~word(i), std::memory_order_relaxed);
+        if (n > 0)
+            words_[n - 1].fetch_and(last_word_mask(), std::memory_order_relaxed);
+    }
+
+
+    SelectionSet &SelectionSet::operator|=(const SelectionSet &other) {
+        assert(size_ == other.size_);
+        const std::size_t n = std::min(num_words(), other.num_words());
+        for (std::size_t i = 0; i < n; ++i)
+            words_[i].fetch_or(other.word(i), std::memory_order_relaxed);
+        return *this;
+    }
+
+
+    SelectionSet &SelectionSet::operator&=(const SelectionSet &other) {
+        assert(size_ == other.size_);
+        const std::size_t n = std::min(num_words(), other.num_words());
+        for (std::size_t i = 0; i < n; ++i)
+            words_[i].fetch_and(other.word(i), std::memory_order_relaxed);
+        for (std::size_t i = n; i < num_words(); ++i)
+            words_[i].store(0, std::memory_order_relaxed);
+        return *this;
+    }
+
+
+    SelectionSet &SelectionSet::operator-=(const SelectionSet &other) {
+        assert(size_ == other.size_);
+        const std::size_t n = std::min(num_words(), other.num_words());
+        for (std::size_t i = 0; i < n; ++i)
+            words_[i].fetch_and(~other.word(i), std::memory_order_relaxed);
+        return *this;
+    }
+
+
+    std::size_t SelectionSet::count() const {
+        std::size_t num = 0;
+        const std::size_t n = num_words();
+        for (std::size_t i = 0; i < n; ++i)
+            num += details::popcount(word(i));
+        return num;
+    }
+
+
+    bool SelectionSet::any() const {
+        const std::size_t n = num_words();
+        for (std::size_t i = 0; i < n; ++i) {
+            if (word(i))
+                return true;
+        }
+        return false;
+    }
+
+
+    std::vector<int> SelectionSet::indices() const {
+        std::vector<int> result;
+        result.reserve(count());
+        for_each([&result](std::size_t i) { result.push_back(static_cast<int>(i)); });
+        return result;
+    }
+
+
+    void SelectionSet::assign(const std::vector<bool> &flags) {
+        resize(flags.size());
+        const std::size_t n = num_words();
+        auto it = flags.begin();
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t num = std::min(bits_per_word, size_ - i * bits_per_word);
+            word_type w = 0;
+            for (std::size_t j = 0; j < num; ++j, ++it)
+                w |= word_type(*it) << j;
+            words_[i].store(w, std::memory_order_relaxed);
+        }
+    }
+
+
+    void SelectionSet::get(std::vector<bool> &flags) const {
+        flags.resize(size_);
+        const std::size_t n = num_words();
+        auto it = flags.begin();
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t num = std::min(bits_per_word, size_ - i * bits_per_word);
+            const word_type w = word(i);
+            for (std::size_t j = 0; j < num; ++j, ++it)
+                *it = (w >> j) & 1u;
+        }
+    }
+
+}
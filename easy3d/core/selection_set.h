@@ -0,0 +1,195 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_CORE_SELECTION_SET_H
+#define EASY3D_CORE_SELECTION_SET_H
+
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace easy3d {
+
+    /**
+     * \brief A set of selected elements (e.g., vertices or faces), stored as a packed bitset.
+     * \class SelectionSet easy3d/core/selection_set.h
+     * \details Unlike a bool property (which is stored in a bit-packed std::vector<bool>), a SelectionSet can be
+     *      modified from multiple threads: setting, resetting, and flipping a single element are atomic operations
+     *      on the 32-bit word holding the element. The bits are stored in words, so range operations, counting, and
+     *      iterating over the selected elements process 32 elements at a time, and the words can be directly
+     *      uploaded to the GPU (see PointsDrawable::update_selection_buffer()).
+     *
+     *      Example usage:
+     *      \code
+     *          SelectionSet selection(cloud->n_vertices());
+     *          #pragma omp parallel for
+     *          for (int i = 0; i < num; ++i) {
+     *              if (inside(points[i]))
+     *                  selection.set(i);
+     *          }
+     *          std::cout << selection.count() << " points selected" << std::endl;
+     *          selection.for_each([&](std::size_t i) { ... });
+     *      \endcode
+     *
+     * \note Operations involving more than one element (e.g., set_range(), flip(), operator|=()) are not
+     *      atomic as a whole, and they should not run concurrently with other modifications of the same bits.
+     */
+    class SelectionSet {
+    public:
+        typedef std::uint32_t word_type;
+        static const std::size_t bits_per_word = 32;
+
+    public:
+        /// Constructs a selection set of \p n elements, none of which is selected.
+        explicit SelectionSet(std::size_t n = 0);
+        /// Constructs a selection set from the values of a bool property (e.g., "v:select").
+        explicit SelectionSet(const std::vector<bool> &flags);
+
+        SelectionSet(const SelectionSet &other);
+        SelectionSet &operator=(const SelectionSet &other);
+
+        /// Returns the number of elements.
+        std::size_t size() const { return size_; }
+        /// Changes the number of elements. Newly added elements are not selected.
+        void resize(std::size_t n);
+
+        /// Returns the number of words storing the bits.
+        std::size_t num_words() const { return num_words(size_); }
+        /// Returns the \p i-th word, e.g., for uploading the bits to the GPU.
+        word_type word(std::size_t i) const { return words_[i].load(std::memory_order_relaxed); }
+        /// Copies all the words into \p words.
+        void get_words(std::vector<word_type> &words) const;
+
+        /// \name Single elements (thread-safe)
+        //@{
+        /// Returns whether the \p i-th element is selected.
+        bool test(std::size_t i) const {
+            return (words_[i / bits_per_word].load(std::memory_order_relaxed) & mask(i)) != 0;
+        }
+        /// Selects the \p i-th element.
+        void set(std::size_t i) { words_[i / bits_per_word].fetch_or(mask(i), std::memory_order_relaxed); }
+        /// Deselects the \p i-th element.
+        void reset(std::size_t i) { words_[i / bits_per_word].fetch_and(~mask(i), std::memory_order_relaxed); }
+        /// Selects (if \p b is true) or deselects (if \p b is false) the \p i-th element.
+        void set(std::size_t i, bool b) { if (b) set(i); else reset(i); }
+        /// Flips the selection state of the \p i-th element.
+        void flip(std::size_t i) { words_[i / bits_per_word].fetch_xor(mask(i), std::memory_order_relaxed); }
+        //@}
+
+        /// \name Ranges and the whole set
+        //@{
+        /// Selects the elements in the range [\p first, \p last).
+        void set_range(std::size_t first, std::size_t last);
+        /// Deselects the elements in the range [\p first, \p last).
+        void reset_range(std::size_t first, std::size_t last);
+        /// Selects all the elements.
+        void set();
+        /// Deselects all the elements.
+        void reset();
+        /// Flips the selection state of all the elements.
+        void flip();
+
+        /// Adds the elements selected in \p other to this set. The two sets must have the same size.
+        SelectionSet &operator|=(const SelectionSet &other);
+        /// Keeps only the elements also selected in \p other. The two sets must have the same size.
+        SelectionSet &operator&=(const SelectionSet &other);
+        /// Removes the elements selected in \p other from this set. The two sets must have the same size.
+        SelectionSet &operator-=(const SelectionSet &other);
+        //@}
+
+        /// \name Queries
+        //@{
+        /// Returns the number of selected elements.
+        std::size_t count() const;
+        /// Returns whether any element is selected.
+        bool any() const;
+        /// Returns whether no element is selected.
+        bool none() const { return !any(); }
+
+        /// Calls \p func(index) for each selected element, in increasing order of the indices.
+        template<typename FT>
+        void for_each(FT func) const;
+        /// Returns the indices of the selected elements.
+        std::vector<int> indices() const;
+        //@}
+
+        /// \name Conversion from/to bool properties
+        //@{
+        /// Replaces the selection by the values of a bool property. The size is changed accordingly.
+        void assign(const std::vector<bool> &flags);
+        /// Writes the selection into a bool property, which is resized to size().
+        void get(std::vector<bool> &flags) const;
+        //@}
+
+    private:
+        static std::size_t num_words(std::size_t n) { return (n + bits_per_word - 1) / bits_per_word; }
+        static word_type mask(std::size_t i) { return word_type(1) << (i % bits_per_word); }
+        // the valid bits of the last word
+        word_type last_word_mask() const;
+        // sets the bits in [first, last) to value
+        void fill(std::size_t first, std::size_t last, bool value);
+
+        static int lowest_bit(word_type w);
+
+    private:
+        std::size_t size_;
+        std::unique_ptr<std::atomic<word_type>[]> words_;
+    };
+
+
+    inline int SelectionSet::lowest_bit(word_type w) {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward(&index, w);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(w);
+#endif
+    }
+
+
+    template<typename FT>
+    void SelectionSet::for_each(FT func) const {
+        const std::size_t n = num_words();
+        for (std::size_t i = 0; i < n; ++i) {
+            word_type w = words_[i].load(std::memory_order_relaxed);
+            while (w) {
+                func(i * bits_per_word + lowest_bit(w));
+                w &= w - 1; // clear the lowest set bit
+            }
+        }
+    }
+
+}
+
+
+#endif  // EASY3D_CORE_SELECTION_SET_H
@@ -411,7 +411,7 @@ namespace easy3d {
         {
             output << "model properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (mprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
         }
 
 		props = vertex_properties();
@@ -419,7 +419,7 @@ namespace easy3d {
 		{
             output << "vertex properties:\n";
 			for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (vprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
 		}
 
 		props = halfedge_properties();
@@ -427,7 +427,7 @@ namespace easy3d {
 		{
             output << "halfedge properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (hprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
 		}
 
 		props = edge_properties();
@@ -435,7 +435,7 @@ namespace easy3d {
 		{
             output<< "edge properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (eprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
 		}
 
 		props = face_properties();
@@ -443,7 +443,7 @@ namespace easy3d {
 		{
             output << "face properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (fprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
 		}
 
 		props = model_properties();
@@ -451,7 +451,7 @@ namespace easy3d {
 		{
             output << "model properties:\n";
             for (const auto& p : props)
-                output << "\t" << p << std::endl;
+                output << "\t" << p << (mprops_.is_deferred(p) ? " (not loaded)" : "") << std::endl;
 		}
     }
 
@@ -1055,15 +1055,18 @@ namespace easy3d {
         if (!fnormal_)
             fnormal_ = face_property<vec3>("f:normal");
 
-        FaceIterator fit, fend=faces_end();
-
+        const int num = static_cast<int>(faces_size());
         int num_degenerate = 0;
-        for (fit=faces_begin(); fit!=fend; ++fit) {
-            if (is_degenerate(*fit)) {
+#pragma omp parallel for reduction(+:num_degenerate)
+        for (int i = 0; i < num; ++i) {
+            const Face f(i);
+            if (is_deleted(f))
+                continue;
+            if (is_degenerate(f)) {
                 ++num_degenerate;
-                fnormal_[*fit] = vec3(0, 0, 1);
+                fnormal_[f] = vec3(0, 0, 1);
             } else
-                fnormal_[*fit] = compute_face_normal(*fit);
+                fnormal_[f] = compute_face_normal(f);
         }
 
         if (num_degenerate > 0)
@@ -1118,9 +1121,8 @@ namespace easy3d {
         if (!vnormal_)
             vnormal_ = vertex_property<vec3>("v:normal");
 
-        VertexIterator vit, vend=vertices_end();
-
 #if 0   // not stable for concave vertices
+        VertexIterator vit, vend=vertices_end();
         for (vit=vertices_begin(); vit!=vend; ++vit)
             vnormal_[*vit] = compute_vertex_normal(*vit);
 #else // the angle-weighted average of incident face average
@@ -1181,8 +1183,13 @@ namespace easy3d {
         // always re-compute face normals
         update_face_normals();
 
-        for (vit=vertices_begin(); vit!=vend; ++vit)
-            vnormal_[*vit] = angle_weighted_face_normals(*vit);
+        const int num = static_cast<int>(vertices_size());
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
+            const Vertex v(i);
+            if (!is_deleted(v))
+                vnormal_[v] = angle_weighted_face_normals(v);
+        }
 #endif
     }
 
@@ -2137,151 +2144,297 @@ namespace easy3d {
     //-----------------------------------------------------------------------------
 
 
-    void SurfaceMesh::collect_garbage()
-    {
-        if (!garbage_)
-            return;
+    namespace details {
+
+        // returns the positions in [begin, end) satisfying pred, in increasing order. The positions are counted and
+        // collected in parallel by blocks, with a prefix sum of the counts of the blocks.
+        template <typename Pred>
+        std::vector<int> positions(int begin, int end, Pred pred) {
+            const int num_blocks = std::max(1, std::min(256, (end - begin) / 4096));
+            const int block_size = (end - begin + num_blocks - 1) / num_blocks;
+            std::vector<int> offsets(num_blocks + 1, 0);
+#pragma omp parallel for
+            for (int b = 0; b < num_blocks; ++b) {
+                const int last = std::min(end, begin + (b + 1) * block_size);
+                int count = 0;
+                for (int i = begin + b * block_size; i < last; ++i)
+                    count += pred(i) ? 1 : 0;
+                offsets[b + 1] = count;
+            }
+            for (int b = 0; b < num_blocks; ++b)
+                offsets[b + 1] += offsets[b];
+
+            // branchless (the deleted elements are often scattered randomly), so one extra slot for the last write
+            std::vector<int> result(offsets[num_blocks] + 1);
+#pragma omp parallel for
+            for (int b = 0; b < num_blocks; ++b) {
+                const int last = std::min(end, begin + (b + 1) * block_size);
+                int k = offsets[b];
+                for (int i = begin + b * block_size; i < last; ++i) {
+                    const int next = k + (pred(i) ? 1 : 0);
+                    if (k < offsets[b + 1])
+                        result[k] = i;
+                    k = next;
+                }
+            }
+            result.pop_back();
+            return result;
+        }
 
-        int  i, i0, i1,
-        nV(vertices_size()),
-        nE(edges_size()),
-        nH(halfedges_size()),
-        nF(faces_size());
 
-        Vertex    v;
-        Halfedge  h;
-        Face      f;
+        // Computes the compaction of n elements, some of which are deleted. The kept elements in front of the new end
+        // stay in place, and the holes there are filled by the kept elements behind it, the first hole by the last
+        // element (i.e., the same result as repeatedly swapping the first deleted and the last kept element).
+        // The elements 'from' are moved to 'to', and 'new_index' receives the new index of each old element (-1 for
+        // the deleted ones). Returns the number of the kept elements.
+        template <typename Deleted>
+        int compaction(int n, int num_deleted, Deleted deleted, std::vector<std::size_t> &from,
+                       std::vector<std::size_t> &to, std::vector<int> &new_index) {
+            const int num_kept = n - num_deleted;
+            new_index.resize(n);
+            if (num_deleted == 0) {
+#pragma omp parallel for
+                for (int i = 0; i < n; ++i)
+                    new_index[i] = i;
+                return n;
+            }
 
+            const std::vector<int> holes = positions(0, num_kept, deleted);
+            const std::vector<int> tail = positions(num_kept, n, [&deleted](int i) { return !deleted(i); });
+            assert(holes.size() == tail.size());
+
+            const int num_moved = static_cast<int>(holes.size());
+            from.resize(num_moved);
+            to.resize(num_moved);
+#pragma omp parallel for
+            for (int i = 0; i < num_kept; ++i)
+                new_index[i] = deleted(i) ? -1 : i;
+#pragma omp parallel for
+            for (int i = num_kept; i < n; ++i)
+                new_index[i] = -1;
+#pragma omp parallel for
+            for (int k = 0; k < num_moved; ++k) {
+                from[k] = static_cast<std::size_t>(tail[num_moved - 1 - k]);
+                to[k] = static_cast<std::size_t>(holes[k]);
+                new_index[from[k]] = holes[k];
+            }
+            return num_kept;
+        }
 
-        // setup handle mapping
-        VertexProperty<Vertex>      vmap = add_vertex_property<Vertex>("v:garbage-collection");
-        HalfedgeProperty<Halfedge>  hmap = add_halfedge_property<Halfedge>("h:garbage-collection");
-        FaceProperty<Face>          fmap = add_face_property<Face>("f:garbage-collection");
-        for (i=0; i<nV; ++i)
-            vmap[Vertex(i)] = Vertex(i);
-        for (i=0; i<nH; ++i)
-            hmap[Halfedge(i)] = Halfedge(i);
-        for (i=0; i<nF; ++i)
-            fmap[Face(i)] = Face(i);
 
+        struct Compaction {
+            PropertyContainer *container;
+            std::vector<std::size_t> from, to;
+            int size;
+        };
 
+        // moves the kept elements of all the arrays of the containers at once (the arrays in parallel)
+        void compact(const std::vector<Compaction *> &compactions) {
+            std::vector<std::pair<BasePropertyArray *, const Compaction *> > tasks;
+            for (const auto c : compactions) {
+                const PropertyContainer &props = *c->container;
+                props.load_deferred();
+                for (auto a : props.arrays())
+                    tasks.emplace_back(a, c);
+            }
+            const int num = static_cast<int>(tasks.size());
+#pragma omp parallel for schedule(dynamic)
+            for (int i = 0; i < num; ++i) {
+                BasePropertyArray *array = tasks[i].first;
+                const Compaction *c = tasks[i].second;
+                array->copy(c->from, c->to);
+                array->resize(c->size);
+                array->shrink_to_fit();
+            }
+            // the arrays have the new size already, and the computed properties follow
+            for (const auto c : compactions) {
+                c->container->resize(c->size);
+                c->container->invalidate_computed();
+            }
+        }
 
-        // remove deleted vertices
-        if (nV > 0)
-        {
-            i0=0;  i1=nV-1;
 
-            while (1)
-            {
-                // find first deleted and last un-deleted
-                while (!vdeleted_[Vertex(i0)] && i0 < i1)  ++i0;
-                while ( vdeleted_[Vertex(i1)] && i0 < i1)  --i1;
-                if (i0 >= i1) break;
+        // converts the handles into indices, checking if they are a permutation of [0, n)
+        template <typename Handle>
+        bool permutation_indices(const std::vector<Handle>& order, std::size_t n, std::vector<std::size_t>& indices) {
+            if (order.size() != n) {
+                LOG(ERROR) << "the size of the order (" << order.size() << ") does not match the number of elements ("
+                           << n << ")";
+                return false;
+            }
+            indices.resize(n);
+            std::vector<bool> used(n, false);
+            for (std::size_t i = 0; i < n; ++i) {
+                const int idx = order[i].idx();
+                if (idx < 0 || idx >= static_cast<int>(n) || used[idx]) {
+                    LOG(ERROR) << "the order is not a permutation of the elements";
+                    return false;
+                }
+                used[idx] = true;
+                indices[i] = static_cast<std::size_t>(idx);
+            }
+            return true;
+        }
+    }
+
 
-                // swap
-                vprops_.swap(i0, i1);
-            };
+    void SurfaceMesh::collect_garbage()
+    {
+        if (!garbage_)
+            return;
 
-            // remember new size
-            nV = vdeleted_[Vertex(i0)] ? i0 : i0+1;
+        // the kept elements to move into the holes of the deleted ones, and the new index of each element
+        details::Compaction vc, hc, ec, fc;
+        std::vector<int> vmap, emap, fmap;
+        vc.container = &vprops_;
+        vc.size = details::compaction(static_cast<int>(vertices_size()), static_cast<int>(deleted_vertices_),
+                                      [this](int i) { return vdeleted_[Vertex(i)]; }, vc.from, vc.to, vmap);
+        ec.container = &eprops_;
+        ec.size = details::compaction(static_cast<int>(edges_size()), static_cast<int>(deleted_edges_),
+                                      [this](int i) { return edeleted_[Edge(i)]; }, ec.from, ec.to, emap);
+        fc.container = &fprops_;
+        fc.size = details::compaction(static_cast<int>(faces_size()), static_cast<int>(deleted_faces_),
+                                      [this](int i) { return fdeleted_[Face(i)]; }, fc.from, fc.to, fmap);
+
+        // the halfedges move with their edges
+        hc.container = &hprops_;
+        hc.size = 2 * ec.size;
+        const int nE = static_cast<int>(ec.from.size());
+        hc.from.resize(2 * nE);
+        hc.to.resize(2 * nE);
+#pragma omp parallel for
+        for (int i=0; i<nE; ++i) {
+            hc.from[2 * i] = 2 * ec.from[i];
+            hc.from[2 * i + 1] = 2 * ec.from[i] + 1;
+            hc.to[2 * i] = 2 * ec.to[i];
+            hc.to[2 * i + 1] = 2 * ec.to[i] + 1;
         }
+        auto hmap = [&emap](Halfedge h) -> Halfedge {
+            const int e = emap[h.idx() >> 1];
+            return e < 0 ? Halfedge() : Halfedge(2 * e + (h.idx() & 1));
+        };
 
+        // all the property arrays are compacted at once
+        details::compact({&vc, &hc, &ec, &fc});
+
+        // update the connectivity, which still refers to the old indices
+        const int nV = vc.size;
+        const int nH = hc.size;
+        const int nF = fc.size;
+#pragma omp parallel for
+        for (int i=0; i<nV; ++i) {
+            VertexConnectivity& conn = vconn_[Vertex(i)];
+            if (conn.halfedge_.is_valid())
+                conn.halfedge_ = hmap(conn.halfedge_);
+        }
+#pragma omp parallel for
+        for (int i=0; i<nH; ++i) {
+            HalfedgeConnectivity& conn = hconn_[Halfedge(i)];
+            conn.vertex_ = Vertex(vmap[conn.vertex_.idx()]);
+            conn.next_ = hmap(conn.next_);
+            conn.prev_ = hmap(conn.prev_);
+            if (conn.face_.is_valid())
+                conn.face_ = Face(fmap[conn.face_.idx()]);
+        }
+#pragma omp parallel for
+        for (int i=0; i<nF; ++i) {
+            FaceConnectivity& conn = fconn_[Face(i)];
+            conn.halfedge_ = hmap(conn.halfedge_);
+        }
 
-        // remove deleted edges
-        if (nE > 0)
-        {
-            i0=0;  i1=nE-1;
+        deleted_vertices_ = deleted_edges_ = deleted_faces_ = 0;
+        garbage_ = false;
 
-            while (1)
-            {
-                // find first deleted and last un-deleted
-                while (!edeleted_[Edge(i0)] && i0 < i1)  ++i0;
-                while ( edeleted_[Edge(i1)] && i0 < i1)  --i1;
-                if (i0 >= i1) break;
+#if 1
+        // [Liangliang]: It seems the outgoing halfedges of the vertices may be broken after garbage collection, e.g.,
+        // the index of a vertex's outgoing halfedge may go out of range in some cases (e.g., after deleting faces).
+        // The reason was that the mesh may have an invalid state when elements were marked deleted but still exist.
+        // This can be easily fixed by assigning a correct outgoing halfedge to each vertex.
+        adjust_outgoing_halfedges();
+#endif
+    }
 
-                // swap
-                eprops_.swap(i0, i1);
-                hprops_.swap(2*i0,   2*i1);
-                hprops_.swap(2*i0+1, 2*i1+1);
-            };
 
-            // remember new size
-            nE = edeleted_[Edge(i0)] ? i0 : i0+1;
-            nH = 2*nE;
+    bool SurfaceMesh::permute_vertices(const std::vector<Vertex>& order)
+    {
+        if (garbage_) {
+            LOG(ERROR) << "the mesh has garbage (call collect_garbage() first)";
+            return false;
         }
+        std::vector<std::size_t> indices;
+        if (!details::permutation_indices(order, n_vertices(), indices))
+            return false;
 
+        vprops_.permute(indices);
 
-        // remove deleted faces
-        if (nF > 0)
-        {
-            i0=0;  i1=nF-1;
-
-            while (1)
-            {
-                // find 1st deleted and last un-deleted
-                while (!fdeleted_[Face(i0)] && i0 < i1)  ++i0;
-                while ( fdeleted_[Face(i1)] && i0 < i1)  --i1;
-                if (i0 >= i1) break;
+        // the outgoing halfedges moved with the vertices, only the targets of the halfedges need an update
+        std::vector<int> new_index(indices.size());
+        for (std::size_t i=0; i<indices.size(); ++i)
+            new_index[indices[i]] = static_cast<int>(i);
+        for (auto h : halfedges())
+            set_target(h, Vertex(new_index[target(h).idx()]));
+        return true;
+    }
 
-                // swap
-                fprops_.swap(i0, i1);
-            };
 
-            // remember new size
-            nF = fdeleted_[Face(i0)] ? i0 : i0+1;
+    bool SurfaceMesh::permute_edges(const std::vector<Edge>& order)
+    {
+        if (garbage_) {
+            LOG(ERROR) << "the mesh has garbage (call collect_garbage() first)";
+            return false;
         }
+        std::vector<std::size_t> indices;
+        if (!details::permutation_indices(order, n_edges(), indices))
+            return false;
 
+        // the two halfedges of an edge stay together (and opposite to each other)
+        std::vector<std::size_t> hindices(2 * indices.size());
+        for (std::size_t i=0; i<indices.size(); ++i) {
+            hindices[2 * i] = 2 * indices[i];
+            hindices[2 * i + 1] = 2 * indices[i] + 1;
+        }
+        eprops_.permute(indices);
+        hprops_.permute(hindices);
 
-        // update vertex connectivity
-        for (i=0; i<nV; ++i)
-        {
-            v = Vertex(i);
+        std::vector<int> new_index(hindices.size());
+        for (std::size_t i=0; i<hindices.size(); ++i)
+            new_index[hindices[i]] = static_cast<int>(i);
+        for (auto v : vertices()) {
             if (!is_isolated(v))
-                set_out_halfedge(v, hmap[out_halfedge(v)]);
+                set_out_halfedge(v, Halfedge(new_index[out_halfedge(v).idx()]));
         }
-
-
-        // update halfedge connectivity
-        for (i=0; i<nH; ++i)
-        {
-            h = Halfedge(i);
-            set_target(h, vmap[target(h)]);
-            set_next(h, hmap[next(h)]);
-            if (!is_border(h))
-                set_face(h, fmap[face(h)]);
+        for (auto h : halfedges()) {
+            HalfedgeConnectivity& conn = hconn_[h];
+            conn.next_ = Halfedge(new_index[conn.next_.idx()]);
+            conn.prev_ = Halfedge(new_index[conn.prev_.idx()]);
         }
+        for (auto f : faces())
+            set_halfedge(f, Halfedge(new_index[halfedge(f).idx()]));
+        return true;
+    }
 
 
-        // update handles of faces
-        for (i=0; i<nF; ++i)
-        {
-            f = Face(i);
-            set_halfedge(f, hmap[halfedge(f)]);
+    bool SurfaceMesh::permute_faces(const std::vector<Face>& order)
+    {
+        if (garbage_) {
+            LOG(ERROR) << "the mesh has garbage (call collect_garbage() first)";
+            return false;
         }
+        std::vector<std::size_t> indices;
+        if (!details::permutation_indices(order, n_faces(), indices))
+            return false;
 
+        fprops_.permute(indices);
 
-        // remove handle maps
-        remove_vertex_property(vmap);
-        remove_halfedge_property(hmap);
-        remove_face_property(fmap);
-
-        // finally resize arrays
-        vprops_.resize(nV); vprops_.shrink_to_fit();
-        hprops_.resize(nH); hprops_.shrink_to_fit();
-        eprops_.resize(nE); eprops_.shrink_to_fit();
-        fprops_.resize(nF); fprops_.shrink_to_fit();
-
-        deleted_vertices_ = deleted_edges_ = deleted_faces_ = 0;
-        garbage_ = false;
-
-#if 1
-        // [Liangliang]: It seems the outgoing halfedges of the vertices may be broken after garbage collection, e.g.,
-        // the index of a vertex's outgoing halfedge may go out of range in some cases (e.g., after deleting faces).
-        // The reason was that the mesh may have an invalid state when elements were marked deleted but still exist.
-        // This can be easily fixed by assigning a correct outgoing halfedge to each vertex.
-        adjust_outgoing_halfedges();
-#endif
-
+        // the halfedges of the faces moved with the faces, only the faces of the halfedges need an update
+        std::vector<int> new_index(indices.size());
+        for (std::size_t i=0; i<indices.size(); ++i)
+            new_index[indices[i]] = static_cast<int>(i);
+        for (auto h : halfedges()) {
+            if (!is_border(h))
+                set_face(h, Face(new_index[face(h).idx()]));
+        }
+        return true;
     }
 
 
@@ -1036,6 +1036,20 @@ namespace easy3d {
         /// remove deleted vertices/edges/faces
         void collect_garbage();
 
+        /// \name Reordering
+        /// The elements (and all their properties) are reordered such that the new i-th element is the old element
+        /// \c order[i], e.g., to improve the memory locality of traversals and rendering (see Reordering).
+        /// The connectivity is updated accordingly, so the mesh stays the same except for the indices of the elements.
+        /// The mesh must not have garbage. They return \c false if \c order is not a permutation of all the elements.
+        //@{
+        /// reorders the vertices
+        bool permute_vertices(const std::vector<Vertex>& order);
+        /// reorders the edges (and their halfedges)
+        bool permute_edges(const std::vector<Edge>& order);
+        /// reorders the faces
+        bool permute_faces(const std::vector<Face>& order);
+        //@}
+
 
         /// returns whether vertex \c v is deleted
         /// \sa collect_garbage()
@@ -1542,6 +1556,27 @@ namespace easy3d {
         /// prints the names of all properties to an output stream (e.g., std::cout).
         void property_stats(std::ostream &output) const;
 
+        /// returns the container of all vertex properties
+        PropertyContainer& vertex_property_container() { return vprops_; }
+        /// returns the container of all vertex properties
+        const PropertyContainer& vertex_property_container() const { return vprops_; }
+        /// returns the container of all halfedge properties
+        PropertyContainer& halfedge_property_container() { return hprops_; }
+        /// returns the container of all halfedge properties
+        const PropertyContainer& halfedge_property_container() const { return hprops_; }
+        /// returns the container of all edge properties
+        PropertyContainer& edge_property_container() { return eprops_; }
+        /// returns the container of all edge properties
+        const PropertyContainer& edge_property_container() const { return eprops_; }
+        /// returns the container of all face properties
+        PropertyContainer& face_property_container() { return fprops_; }
+        /// returns the container of all face properties
+        const PropertyContainer& face_property_container() const { return fprops_; }
+        /// returns the container of all model properties
+        PropertyContainer& model_property_container() { return mprops_; }
+        /// returns the container of all model properties
+        const PropertyContainer& model_property_container() const { return mprops_; }
+
         //@}
 
 
@@ -0,0 +1,759 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/core/vec3_kernels.h>
+
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <algorithm>
+
+// SSE2 is part of x86-64, so it can be used unconditionally. AVX2 is enabled per function and only used if the CPU
+// supports it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EASY3D_KERNELS_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define EASY3D_KERNELS_AVX2
+#define EASY3D_KERNELS_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define EASY3D_KERNELS_AVX2
+#define EASY3D_KERNELS_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+
+namespace easy3d {
+
+    namespace kernels {
+
+        namespace details {
+
+            // A 4x4 (or 3x3) matrix stored row by row, so the kernels do not depend on the storage order of mat4.
+            struct Matrix {
+                float m[4][4];
+                bool affine;    // the last row is (0, 0, 0, 1), so the division by w can be skipped
+            };
+
+            // The kernels of an instruction set. They operate on n consecutive (x, y, z) triples.
+            struct Table {
+                void (*bounding_box)(const float *p, std::size_t n, float *pmin, float *pmax);
+                void (*translate)(float *p, std::size_t n, const float *t);
+                void (*translate_double)(float *p, std::size_t n, const double *t);
+                void (*transform4)(float *p, std::size_t n, const Matrix &m);
+                void (*transform3)(float *p, std::size_t n, const Matrix &m);
+                void (*normalize)(float *p, std::size_t n);
+                void (*dot)(const float *a, const float *b, float *result, std::size_t n);
+                void (*cross)(const float *a, const float *b, float *result, std::size_t n);
+            };
+
+
+            namespace scalar {
+
+                void bounding_box(const float *p, std::size_t n, float *pmin, float *pmax) {
+                    for (std::size_t i = 0; i < n * 3; i += 3) {
+                        for (int c = 0; c < 3; ++c) {
+                            pmin[c] = std::min(pmin[c], p[i + c]);
+                            pmax[c] = std::max(pmax[c], p[i + c]);
+                        }
+                    }
+                }
+
+                void translate(float *p, std::size_t n, const float *t) {
+                    for (std::size_t i = 0; i < n * 3; i += 3) {
+                        p[i] += t[0];
+                        p[i + 1] += t[1];
+                        p[i + 2] += t[2];
+                    }
+                }
+
+                void translate_double(float *p, std::size_t n, const double *t) {
+                    for (std::size_t i = 0; i < n * 3; i += 3) {
+                        p[i] = static_cast<float>(p[i] + t[0]);
+                        p[i + 1] = static_cast<float>(p[i + 1] + t[1]);
+                        p[i + 2] = static_cast<float>(p[i + 2] + t[2]);
+                    }
+                }
+
+                void transform4(float *p, std::size_t n, const Matrix &mat) {
+                    const float (*m)[4] = mat.m;
+                    for (std::size_t i = 0; i < n * 3; i += 3) {
+                        const float x = p[i], y = p[i + 1], z = p[i + 2];
+                        float rx = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3];
+                        float ry = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3];
+                        float rz = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3];
+                        if (!mat.affine) {
+                            const float w = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3];
+                            rx /= w;
+                            ry /= w;
+                            rz /= w;
+                        }
+                        p[i] = rx;
+                        p[i + 1] = ry;
+                        p[i + 2] = rz;
+                    }
+                }
+
+                void transform3(float *p, std::size_t n, const Matrix &mat) {
+                    const float (*m)[4] = mat.m;
+                    for (std::size_t i = 0; i < n * 3; i += 3) {
+                        const float x = p[i], y = p[i + 1], z = p[i + 2];
+                        p[i] = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+                        p[i + 1] = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+                        p[i + 2] = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+                    }
+                }
+
+                void normalize(float *p, std::size_t n) {
+                    for (std::size_t i = 0; i < n * 3; i += 3) {
+                        float s = std::sqrt(p[i] * p[i] + p[i + 1] * p[i + 1] + p[i + 2] * p[i + 2]);
+                        s = (s > std::numeric_limits<float>::min()) ? 1.0f / s : 0.0f;
+                        p[i] *= s;
+                        p[i + 1] *= s;
+                        p[i + 2] *= s;
+                    }
+                }
+
+                void dot(const float *a, const float *b, float *result, std::size_t n) {
+                    for (std::size_t i = 0; i < n; ++i)
+                        result[i] = a[3 * i] * b[3 * i] + a[3 * i + 1] * b[3 * i + 1] + a[3 * i + 2] * b[3 * i + 2];
+                }
+
+                void cross(const float *a, const float *b, float *result, std::size_t n) {
+                    for (std::size_t i = 0; i < n * 3; i += 3) {
+                        const float x = a[i + 1] * b[i + 2] - a[i + 2] * b[i + 1];
+                        const float y = a[i + 2] * b[i] - a[i] * b[i + 2];
+                        const float z = a[i] * b[i + 1] - a[i + 1] * b[i];
+                        result[i] = x;
+                        result[i + 1] = y;
+                        result[i + 2] = z;
+                    }
+                }
+
+                const Table table = {
+                        bounding_box, translate, translate_double, transform4, transform3, normalize, dot, cross
+                };
+            }
+
+
+#ifdef EASY3D_KERNELS_SSE2
+            namespace sse2 {
+
+                // Loads 4 points (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) and transposes them into x, y, and z.
+                inline void load(const float *p, __m128 &x, __m128 &y, __m128 &z) {
+                    const __m128 a = _mm_loadu_ps(p);
+                    const __m128 b = _mm_loadu_ps(p + 4);
+                    const __m128 c = _mm_loadu_ps(p + 8);
+                    const __m128 xt = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+                    x = _mm_shuffle_ps(a, xt, _MM_SHUFFLE(2, 0, 3, 0));
+                    const __m128 yt1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+                    const __m128 yt2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+                    y = _mm_shuffle_ps(yt1, yt2, _MM_SHUFFLE(2, 0, 2, 0));
+                    const __m128 zt = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+                    z = _mm_shuffle_ps(zt, c, _MM_SHUFFLE(3, 0, 2, 0));
+                }
+
+                // The inverse of load().
+                inline void store(float *p, __m128 x, __m128 y, __m128 z) {
+                    const __m128 a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)),
+                                                    _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+                                                    _MM_SHUFFLE(2, 0, 2, 0));
+                    const __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+                                                    _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+                                                    _MM_SHUFFLE(2, 0, 2, 0));
+                    const __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+                                                    _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+                                                    _MM_SHUFFLE(2, 0, 2, 0));
+                    _mm_storeu_ps(p, a);
+                    _mm_storeu_ps(p + 4, b);
+                    _mm_storeu_ps(p + 8, c);
+                }
+
+                // Computes m[row] * (x, y, z, w) with w = 1 if 'homogeneous', and w = 0 otherwise.
+                inline __m128 row(const Matrix &mat, int r, __m128 x, __m128 y, __m128 z, bool homogeneous) {
+                    const float *m = mat.m[r];
+                    __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0]), x), _mm_mul_ps(_mm_set1_ps(m[1]), y));
+                    s = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(m[2]), z));
+                    return homogeneous ? _mm_add_ps(s, _mm_set1_ps(m[3])) : s;
+                }
+
+                // The min/max reduction works on the flat array of coordinates: 12 floats (i.e., 4 points) are
+                // processed at a time, and lane k of register r holds coordinate (4 * r + k) % 3.
+                void bounding_box(const float *p, std::size_t n, float *pmin, float *pmax) {
+                    const std::size_t blocks = n / 4;
+                    if (blocks > 0) {
+                        __m128 mn[3], mx[3];
+                        for (int r = 0; r < 3; ++r) {
+                            mn[r] = _mm_set1_ps(std::numeric_limits<float>::max());
+                            mx[r] = _mm_set1_ps(-std::numeric_limits<float>::max());
+                        }
+                        for (std::size_t i = 0; i < blocks * 12; i += 12) {
+                            for (int r = 0; r < 3; ++r) {
+                                const __m128 v = _mm_loadu_ps(p + i + 4 * r);
+                                mn[r] = _mm_min_ps(mn[r], v);
+                                mx[r] = _mm_max_ps(mx[r], v);
+                            }
+                        }
+                        float fmn[12], fmx[12];
+                        for (int r = 0; r < 3; ++r) {
+                            _mm_storeu_ps(fmn + 4 * r, mn[r]);
+                            _mm_storeu_ps(fmx + 4 * r, mx[r]);
+                        }
+                        for (int k = 0; k < 12; ++k) {
+                            pmin[k % 3] = std::min(pmin[k % 3], fmn[k]);
+                            pmax[k % 3] = std::max(pmax[k % 3], fmx[k]);
+                        }
+                    }
+                    scalar::bounding_box(p + blocks * 12, n - blocks * 4, pmin, pmax);
+                }
+
+                void translate(float *p, std::size_t n, const float *t) {
+                    const std::size_t blocks = n / 4;
+                    const __m128 t0 = _mm_setr_ps(t[0], t[1], t[2], t[0]);
+                    const __m128 t1 = _mm_setr_ps(t[1], t[2], t[0], t[1]);
+                    const __m128 t2 = _mm_setr_ps(t[2], t[0], t[1], t[2]);
+                    for (std::size_t i = 0; i < blocks * 12; i += 12) {
+                        _mm_storeu_ps(p + i, _mm_add_ps(_mm_loadu_ps(p + i), t0));
+                        _mm_storeu_ps(p + i + 4, _mm_add_ps(_mm_loadu_ps(p + i + 4), t1));
+                        _mm_storeu_ps(p + i + 8, _mm_add_ps(_mm_loadu_ps(p + i + 8), t2));
+                    }
+                    scalar::translate(p + blocks * 12, n - blocks * 4, t);
+                }
+
+                // Adds t (2 doubles) to the 2 floats at p in double precision.
+                inline void add2(float *p, __m128d t) {
+                    const __m128d v = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p))));
+                    _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_castps_si128(_mm_cvtpd_ps(_mm_add_pd(v, t))));
+                }
+
+                void translate_double(float *p, std::size_t n, const double *t) {
+                    const std::size_t blocks = n / 2;
+                    const __m128d t0 = _mm_setr_pd(t[0], t[1]);
+                    const __m128d t1 = _mm_setr_pd(t[2], t[0]);
+                    const __m128d t2 = _mm_setr_pd(t[1], t[2]);
+                    for (std::size_t i = 0; i < blocks * 6; i += 6) {
+                        add2(p + i, t0);
+                        add2(p + i + 2, t1);
+                        add2(p + i + 4, t2);
+                    }
+                    scalar::translate_double(p + blocks * 6, n - blocks * 2, t);
+                }
+
+                void transform4(float *p, std::size_t n, const Matrix &m) {
+                    const std::size_t blocks = n / 4;
+                    for (std::size_t i = 0; i < blocks * 12; i += 12) {
+                        __m128 x, y, z;
+                        load(p + i, x, y, z);
+                        __m128 rx = row(m, 0, x, y, z, true);
+                        __m128 ry = row(m, 1, x, y, z, true);
+                        __m128 rz = row(m, 2, x, y, z, true);
+                        if (!m.affine) {
+                            const __m128 w = row(m, 3, x, y, z, true);
+                            rx = _mm_div_ps(rx, w);
+                            ry = _mm_div_ps(ry, w);
+                            rz = _mm_div_ps(rz, w);
+                        }
+                        store(p + i, rx, ry, rz);
+                    }
+                    scalar::transform4(p + blocks * 12, n - blocks * 4, m);
+                }
+
+                void transform3(float *p, std::size_t n, const Matrix &m) {
+                    const std::size_t blocks = n / 4;
+                    for (std::size_t i = 0; i < blocks * 12; i += 12) {
+                        __m128 x, y, z;
+                        load(p + i, x, y, z);
+                        store(p + i, row(m, 0, x, y, z, false), row(m, 1, x, y, z, false), row(m, 2, x, y, z, false));
+                    }
+                    scalar::transform3(p + blocks * 12, n - blocks * 4, m);
+                }
+
+                void normalize(float *p, std::size_t n) {
+                    const std::size_t blocks = n / 4;
+                    const __m128 one = _mm_set1_ps(1.0f);
+                    const __m128 tiny = _mm_set1_ps(std::numeric_limits<float>::min());
+                    for (std::size_t i = 0; i < blocks * 12; i += 12) {
+                        __m128 x, y, z;
+                        load(p + i, x, y, z);
+                        const __m128 s = _mm_sqrt_ps(
+                                _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+                        const __m128 inv = _mm_and_ps(_mm_cmpgt_ps(s, tiny), _mm_div_ps(one, s));
+                        store(p + i, _mm_mul_ps(x, inv), _mm_mul_ps(y, inv), _mm_mul_ps(z, inv));
+                    }
+                    scalar::normalize(p + blocks * 12, n - blocks * 4);
+                }
+
+                void dot(const float *a, const float *b, float *result, std::size_t n) {
+                    const std::size_t blocks = n / 4;
+                    for (std::size_t i = 0; i < blocks * 4; i += 4) {
+                        __m128 ax, ay, az, bx, by, bz;
+                        load(a + i * 3, ax, ay, az);
+                        load(b + i * 3, bx, by, bz);
+                        const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+                        _mm_storeu_ps(result + i, d);
+                    }
+                    scalar::dot(a + blocks * 12, b + blocks * 12, result + blocks * 4, n - blocks * 4);
+                }
+
+                void cross(const float *a, const float *b, float *result, std::size_t n) {
+                    const std::size_t blocks = n / 4;
+                    for (std::size_t i = 0; i < blocks * 12; i += 12) {
+                        __m128 ax, ay, az, bx, by, bz;
+                        load(a + i, ax, ay, az);
+                        load(b + i, bx, by, bz);
+                        store(result + i,
+                              _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by)),
+                              _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz)),
+                              _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+                    }
+                    scalar::cross(a + blocks * 12, b + blocks * 12, result + blocks * 12, n - blocks * 4);
+                }
+
+                const Table table = {
+                        bounding_box, translate, translate_double, transform4, transform3, normalize, dot, cross
+                };
+            }
+#endif  // EASY3D_KERNELS_SSE2
+
+
+#ifdef EASY3D_KERNELS_AVX2
+            namespace avx2 {
+
+                // Loads 8 points (24 floats in registers a, b, and c) and transposes them into x, y, and z. Each
+                // coordinate is gathered from the three registers by two blends, and then put in order by a
+                // permutation.
+                EASY3D_KERNELS_AVX2_TARGET
+                inline void load(const float *p, __m256 &x, __m256 &y, __m256 &z) {
+                    const __m256 a = _mm256_loadu_ps(p);
+                    const __m256 b = _mm256_loadu_ps(p + 8);
+                    const __m256 c = _mm256_loadu_ps(p + 16);
+                    const __m256 xt = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24);
+                    const __m256 yt = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x24), c, 0x49);
+                    const __m256 zt = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x49), c, 0x92);
+                    x = _mm256_permutevar8x32_ps(xt, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+                    y = _mm256_permutevar8x32_ps(yt, _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+                    z = _mm256_permutevar8x32_ps(zt, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+                }
+
+                // The inverse of load().
+                EASY3D_KERNELS_AVX2_TARGET
+                inline void store(float *p, __m256 x, __m256 y, __m256 z) {
+                    const __m256 xt = _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+                    const __m256 yt = _mm256_permutevar8x32_ps(y, _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+                    const __m256 zt = _mm256_permutevar8x32_ps(z, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+                    _mm256_storeu_ps(p, _mm256_blend_ps(_mm256_blend_ps(xt, yt, 0x92), zt, 0x24));
+                    _mm256_storeu_ps(p + 8, _mm256_blend_ps(_mm256_blend_ps(xt, yt, 0x24), zt, 0x49));
+                    _mm256_storeu_ps(p + 16, _mm256_blend_ps(_mm256_blend_ps(xt, yt, 0x49), zt, 0x92));
+                }
+
+                // Computes m[row] * (x, y, z, w) with w = 1 if 'homogeneous', and w = 0 otherwise.
+                EASY3D_KERNELS_AVX2_TARGET
+                inline __m256 row(const Matrix &mat, int r, __m256 x, __m256 y, __m256 z, bool homogeneous) {
+                    const float *m = mat.m[r];
+                    __m256 s = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m[0]), x),
+                                             _mm256_mul_ps(_mm256_set1_ps(m[1]), y));
+                    s = _mm256_add_ps(s, _mm256_mul_ps(_mm256_set1_ps(m[2]), z));
+                    return homogeneous ? _mm256_add_ps(s, _mm256_set1_ps(m[3])) : s;
+                }
+
+                // Same as the SSE2 version, but with 24 floats (i.e., 8 points) at a time.
+                EASY3D_KERNELS_AVX2_TARGET
+                void bounding_box(const float *p, std::size_t n, float *pmin, float *pmax) {
+                    const std::size_t blocks = n / 8;
+                    if (blocks > 0) {
+                        __m256 mn[3], mx[3];
+                        for (int r = 0; r < 3; ++r) {
+                            mn[r] = _mm256_set1_ps(std::numeric_limits<float>::max());
+                            mx[r] = _mm256_set1_ps(-std::numeric_limits<float>::max());
+                        }
+                        for (std::size_t i = 0; i < blocks * 24; i += 24) {
+                            for (int r = 0; r < 3; ++r) {
+                                const __m256 v = _mm256_loadu_ps(p + i + 8 * r);
+                                mn[r] = _mm256_min_ps(mn[r], v);
+                                mx[r] = _mm256_max_ps(mx[r], v);
+                            }
+                        }
+                        float fmn[24], fmx[24];
+                        for (int r = 0; r < 3; ++r) {
+                            _mm256_storeu_ps(fmn + 8 * r, mn[r]);
+                            _mm256_storeu_ps(fmx + 8 * r, mx[r]);
+                        }
+                        for (int k = 0; k < 24; ++k) {
+                            pmin[k % 3] = std::min(pmin[k % 3], fmn[k]);
+                            pmax[k % 3] = std::max(pmax[k % 3], fmx[k]);
+                        }
+                    }
+                    scalar::bounding_box(p + blocks * 24, n - blocks * 8, pmin, pmax);
+                }
+
+                EASY3D_KERNELS_AVX2_TARGET
+                void translate(float *p, std::size_t n, const float *t) {
+                    const std::size_t blocks = n / 8;
+                    const __m256 t0 = _mm256_setr_ps(t[0], t[1], t[2], t[0], t[1], t[2], t[0], t[1]);
+                    const __m256 t1 = _mm256_setr_ps(t[2], t[0], t[1], t[2], t[0], t[1], t[2], t[0]);
+                    const __m256 t2 = _mm256_setr_ps(t[1], t[2], t[0], t[1], t[2], t[0], t[1], t[2]);
+                    for (std::size_t i = 0; i < blocks * 24; i += 24) {
+                        _mm256_storeu_ps(p + i, _mm256_add_ps(_mm256_loadu_ps(p + i), t0));
+                        _mm256_storeu_ps(p + i + 8, _mm256_add_ps(_mm256_loadu_ps(p + i + 8), t1));
+                        _mm256_storeu_ps(p + i + 16, _mm256_add_ps(_mm256_loadu_ps(p + i + 16), t2));
+                    }
+                    scalar::translate(p + blocks * 24, n - blocks * 8, t);
+                }
+
+                // Adds t (4 doubles) to the 4 floats at p in double precision.
+                EASY3D_KERNELS_AVX2_TARGET
+                inline void add4(float *p, __m256d t) {
+                    const __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(p));
+                    _mm_storeu_ps(p, _mm256_cvtpd_ps(_mm256_add_pd(v, t)));
+                }
+
+                EASY3D_KERNELS_AVX2_TARGET
+                void translate_double(float *p, std::size_t n, const double *t) {
+                    const std::size_t blocks = n / 4;
+                    const __m256d t0 = _mm256_setr_pd(t[0], t[1], t[2], t[0]);
+                    const __m256d t1 = _mm256_setr_pd(t[1], t[2], t[0], t[1]);
+                    const __m256d t2 = _mm256_setr_pd(t[2], t[0], t[1], t[2]);
+                    for (std::size_t i = 0; i < blocks * 12; i += 12) {
+                        add4(p + i, t0);
+                        add4(p + i + 4, t1);
+                        add4(p + i + 8, t2);
+                    }
+                    scalar::translate_double(p + blocks * 12, n - blocks * 4, t);
+                }
+
+                EASY3D_KERNELS_AVX2_TARGET
+                void transform4(float *p, std::size_t n, const Matrix &m) {
+                    const std::size_t blocks = n / 8;
+                    for (std::size_t i = 0; i < blocks * 24; i += 24) {
+                        __m256 x, y, z;
+                        load(p + i, x, y, z);
+                        __m256 rx = row(m, 0, x, y, z, true);
+                        __m256 ry = row(m, 1, x, y, z, true);
+                        __m256 rz = row(m, 2, x, y, z, true);
+                        if (!m.affine) {
+                            const __m256 w = row(m, 3, x, y, z, true);
+                            rx = _mm256_div_ps(rx, w);
+                            ry = _mm256_div_ps(ry, w);
+                            rz = _mm256_div_ps(rz, w);
+                        }
+                        store(p + i, rx, ry, rz);
+                    }
+                    scalar::transform4(p + blocks * 24, n - blocks * 8, m);
+                }
+
+                EASY3D_KERNELS_AVX2_TARGET
+                void transform3(float *p, std::size_t n, const Matrix &m) {
+                    const std::size_t blocks = n / 8;
+                    for (std::size_t i = 0; i < blocks * 24; i += 24) {
+                        __m256 x, y, z;
+                        load(p + i, x, y, z);
+                        store(p + i, row(m, 0, x, y, z, false), row(m, 1, x, y, z, false), row(m, 2, x, y, z, false));
+                    }
+                    scalar::transform3(p + blocks * 24, n - blocks * 8, m);
+                }
+
+                EASY3D_KERNELS_AVX2_TARGET
+                void normalize(float *p, std::size_t n) {
+                    const std::size_t blocks = n / 8;
+                    const __m256 one = _mm256_set1_ps(1.0f);
+                    const __m256 tiny = _mm256_set1_ps(std::numeric_limits<float>::min());
+                    for (std::size_t i = 0; i < blocks * 24; i += 24) {
+                        __m256 x, y, z;
+                        load(p + i, x, y, z);
+                        const __m256 s = _mm256_sqrt_ps(_mm256_add_ps(
+                                _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+                        const __m256 inv = _mm256_and_ps(_mm256_cmp_ps(s, tiny, _CMP_GT_OQ), _mm256_div_ps(one, s));
+                        store(p + i, _mm256_mul_ps(x, inv), _mm256_mul_ps(y, inv), _mm256_mul_ps(z, inv));
+                    }
+                    scalar::normalize(p + blocks * 24, n - blocks * 8);
+                }
+
+                EASY3D_KERNELS_AVX2_TARGET
+                void dot(const float *a, const float *b, float *result, std::size_t n) {
+                    const std::size_t blocks = n / 8;
+                    for (std::size_t i = 0; i < blocks * 8; i += 8) {
+                        __m256 ax, ay, az, bx, by, bz;
+                        load(a + i * 3, ax, ay, az);
+                        load(b + i * 3, bx, by, bz);
+                        const __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)),
+                                                       _mm256_mul_ps(az, bz));
+                        _mm256_storeu_ps(result + i, d);
+                    }
+                    scalar::dot(a + blocks * 24, b + blocks * 24, result + blocks * 8, n - blocks * 8);
+                }
+
+                EASY3D_KERNELS_AVX2_TARGET
+                void cross(const float *a, const float *b, float *result, std::size_t n) {
+                    const std::size_t blocks = n / 8;
+                    for (std::size_t i = 0; i < blocks * 24; i += 24) {
+                        __m256 ax, ay, az, bx, by, bz;
+                        load(a + i, ax, ay, az);
+                        load(b + i, bx, by, bz);
+                        store(result + i,
+                              _mm256_sub_ps(_mm256_mul_ps(ay, bz), _mm256_mul_ps(az, by)),
+                              _mm256_sub_ps(_mm256_mul_ps(az, bx), _mm256_mul_ps(ax, bz)),
+                              _mm256_sub_ps(_mm256_mul_ps(ax, by), _mm256_mul_ps(ay, bx)));
+                    }
+                    scalar::cross(a + blocks * 24, b + blocks * 24, result + blocks * 24, n - blocks * 8);
+                }
+
+                const Table table = {
+                        bounding_box, translate, translate_double, transform4, transform3, normalize, dot, cross
+                };
+            }
+#endif  // EASY3D_KERNELS_AVX2
+
+
+            bool cpu_supports(InstructionSet isa) {
+                switch (isa) {
+                    case SCALAR:
+                        return true;
+                    case SSE2:
+#ifdef EASY3D_KERNELS_SSE2
+                        return true;
+#else
+                        return false;
+#endif
+                    case AVX2: {
+#if defined(EASY3D_KERNELS_AVX2) && defined(_MSC_VER)
+                        int info[4];
+                        __cpuid(info, 0);
+                        if (info[0] < 7)
+                            return false;
+                        __cpuid(info, 1);
+                        const bool os_saves_ymm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+                                                  ((_xgetbv(0) & 6) == 6);
+                        if (!os_saves_ymm)
+                            return false;
+                        __cpuidex(info, 7, 0);
+                        return (info[1] & (1 << 5)) != 0;
+#elif defined(EASY3D_KERNELS_AVX2)
+                        __builtin_cpu_init();
+                        return __builtin_cpu_supports("avx2");
+#else
+                        return false;
+#endif
+                    }
+                }
+                return false;
+            }
+
+            const Table* table_of(InstructionSet isa) {
+                switch (isa) {
+#ifdef EASY3D_KERNELS_AVX2
+                    case AVX2: return &avx2::table;
+#endif
+#ifdef EASY3D_KERNELS_SSE2
+                    case SSE2: return &sse2::table;
+#endif
+                    default: return &scalar::table;
+                }
+            }
+
+            InstructionSet best_instruction_set() {
+                if (cpu_supports(AVX2))
+                    return AVX2;
+                if (cpu_supports(SSE2))
+                    return SSE2;
+                return SCALAR;
+            }
+
+            // the instruction set in use, chosen on first use
+            std::atomic<int>& current() {
+                static std::atomic<int> isa(best_instruction_set());
+                return isa;
+            }
+
+            inline const Table& table() {
+                return *table_of(static_cast<InstructionSet>(current().load(std::memory_order_relaxed)));
+            }
+
+            // Large arrays are split into chunks of this many elements, which are processed in parallel. The chunks
+            // are large enough to amortize the cost of the threads, and a multiple of the block sizes.
+            const std::size_t chunk_size = 1 << 16;
+
+            // Calls func(begin, count) for each chunk of [0, n).
+            template<typename FUNC>
+            void for_each_chunk(std::size_t n, FUNC func) {
+                const std::size_t num_chunks = (n + chunk_size - 1) / chunk_size;
+                if (num_chunks <= 1) {
+                    func(std::size_t(0), n);
+                    return;
+                }
+#pragma omp parallel for
+                for (int c = 0; c < static_cast<int>(num_chunks); ++c) {
+                    const std::size_t begin = c * chunk_size;
+                    func(begin, std::min(chunk_size, n - begin));
+                }
+            }
+
+            // vec3 is a plain struct of three floats, so an array of vec3s is an array of floats
+            inline float* floats(vec3* p) { return reinterpret_cast<float*>(p); }
+            inline const float* floats(const vec3* p) { return reinterpret_cast<const float*>(p); }
+
+            Matrix to_matrix(const mat4& m) {
+                Matrix result;
+                for (int i = 0; i < 4; ++i) {
+                    for (int j = 0; j < 4; ++j)
+                        result.m[i][j] = m(i, j);
+                }
+                result.affine = (m(3, 0) == 0.0f && m(3, 1) == 0.0f && m(3, 2) == 0.0f && m(3, 3) == 1.0f);
+                return result;
+            }
+
+            Matrix to_matrix(const mat3& m) {
+                Matrix result;
+                for (int i = 0; i < 4; ++i) {
+                    for (int j = 0; j < 4; ++j)
+                        result.m[i][j] = (i < 3 && j < 3) ? m(i, j) : 0.0f;
+                }
+                result.affine = true;
+                return result;
+            }
+        }
+
+
+        InstructionSet instruction_set() {
+            return static_cast<InstructionSet>(details::current().load());
+        }
+
+
+        bool set_instruction_set(InstructionSet isa) {
+            if (!details::cpu_supports(isa))
+                return false;
+            details::current().store(isa);
+            return true;
+        }
+
+
+        const char* instruction_set_name(InstructionSet isa) {
+            switch (isa) {
+                case AVX2: return "AVX2";
+                case SSE2: return "SSE2";
+                default:   return "scalar";
+            }
+        }
+
+
+        Box3 bounding_box(const vec3* points, std::size_t n) {
+            if (n == 0)
+                return Box3();
+            // each chunk has its own min/max corners, which are merged afterwards
+            const std::size_t num_chunks = (n + details::chunk_size - 1) / details::chunk_size;
+            std::vector<vec3> pmin(num_chunks, vec3(std::numeric_limits<float>::max()));
+            std::vector<vec3> pmax(num_chunks, vec3(-std::numeric_limits<float>::max()));
+            const details::Table& table = details::table();
+            const float* p = details::floats(points);
+            details::for_each_chunk(n, [&](std::size_t begin, std::size_t count) {
+                const std::size_t c = begin / details::chunk_size;
+                table.bounding_box(p + begin * 3, count, pmin[c].data(), pmax[c].data());
+            });
+            Box3 box;
+            box.min_point() = pmin[0];
+            box.max_point() = pmax[0];
+            for (std::size_t c = 1; c < num_chunks; ++c) {
+                for (int i = 0; i < 3; ++i) {
+                    box.min_point()[i] = std::min(box.min_point()[i], pmin[c][i]);
+                    box.max_point()[i] = std::max(box.max_point()[i], pmax[c][i]);
+                }
+            }
+            return box;
+        }
+
+
+        void translate(vec3* points, std::size_t n, const vec3& t) {
+            const details::Table& table = details::table();
+            float* p = details::floats(points);
+            details::for_each_chunk(n, [&](std::size_t begin, std::size_t count) {
+                table.translate(p + begin * 3, count, t.data());
+            });
+        }
+
+
+        void translate(vec3* points, std::size_t n, const dvec3& t) {
+            const details::Table& table = details::table();
+            float* p = details::floats(points);
+            details::for_each_chunk(n, [&](std::size_t begin, std::size_t count) {
+                table.translate_double(p + begin * 3, count, t.data());
+            });
+        }
+
+
+        void transform(vec3* points, std::size_t n, const mat4& m) {
+            const details::Table& table = details::table();
+            const details::Matrix mat = details::to_matrix(m);
+            float* p = details::floats(points);
+            details::for_each_chunk(n, [&](std::size_t begin, std::size_t count) {
+                table.transform4(p + begin * 3, count, mat);
+            });
+        }
+
+
+        void transform(vec3* vectors, std::size_t n, const mat3& m) {
+            const details::Table& table = details::table();
+            const details::Matrix mat = details::to_matrix(m);
+            float* p = details::floats(vectors);
+            details::for_each_chunk(n, [&](std::size_t begin, std::size_t count) {
+                table.transform3(p + begin * 3, count, mat);
+            });
+        }
+
+
+        void normalize(vec3* vectors, std::size_t n) {
+            const details::Table& table = details::table();
+            float* p = details::floats(vectors);
+            details::for_each_chunk(n, [&](std::size_t begin, std::size_t count) {
+                table.normalize(p + begin * 3, count);
+            });
+        }
+
+
+        void dot(const vec3* a, const vec3* b, float* result, std::size_t n) {
+            const details::Table& table = details::table();
+            const float* pa = details::floats(a);
+            const float* pb = details::floats(b);
+            details::for_each_chunk(n, [&](std::size_t begin, std::size_t count) {
+                table.dot(pa + begin * 3, pb + begin * 3, result + begin, count);
+            });
+        }
+
+
+        void cross(const vec3* a, const vec3* b, vec3* result, std::size_t n) {
+            const details::Table& table = details::table();
+            const float* pa = details::floats(a);
+            const float* pb = details::floats(b);
+            float* pr = details::floats(result);
+            details::for_each_chunk(n, [&](std::size_t begin, std::size_t count) {
+                table.cross(pa + begin * 3, pb + begin * 3, pr + begin * 3, count);
+            });
+        }
+
+    } // namespace kernels
+
+} // namespace easy3d
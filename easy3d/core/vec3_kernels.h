@@ -0,0 +1,120 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_CORE_VEC3_KERNELS_H
+#define EASY3D_CORE_VEC3_KERNELS_H
+
+#include <vector>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Vectorized kernels for bulk operations on contiguous arrays of 3D points/vectors.
+     * \namespace easy3d::kernels
+     * \details The kernels load blocks of 8 (AVX2) or 4 (SSE2) vec3s, transpose them into a structure-of-arrays
+     *      layout in registers, and process the remaining elements with scalar code. The instruction set is chosen
+     *      at runtime according to the CPU, so Easy3D does not have to be compiled with AVX2 enabled. Each kernel
+     *      performs the same floating-point operations in the same order as the corresponding vec3/mat4 operators,
+     *      so the results are identical to those of a plain loop. Large arrays are split into chunks that are
+     *      processed in parallel (if OpenMP is available).
+     *
+     *      Example usage:
+     *      \code
+     *          std::vector<vec3>& points = cloud->points();
+     *          const Box3 box = kernels::bounding_box(points);
+     *          kernels::translate(points, -box.center());
+     *      \endcode
+     */
+    namespace kernels {
+
+        /// The instruction sets the kernels can use.
+        enum InstructionSet { SCALAR = 0, SSE2 = 1, AVX2 = 2 };
+
+        /// Returns the instruction set currently used by the kernels. By default, it is the best one supported by
+        /// both the build and the CPU.
+        InstructionSet instruction_set();
+
+        /// Sets the instruction set used by the kernels, e.g., to compare the performance of different
+        /// implementations. Returns false (and does nothing) if \p isa is not supported by the build or the CPU.
+        bool set_instruction_set(InstructionSet isa);
+
+        /// Returns the name of an instruction set, i.e., "scalar", "SSE2", or "AVX2".
+        const char* instruction_set_name(InstructionSet isa);
+
+        /// Computes the bounding box of \p n points. The box is invalid if \p n is 0.
+        Box3 bounding_box(const vec3* points, std::size_t n);
+
+        /// Translates \p n points by \p t, i.e., p += t.
+        void translate(vec3* points, std::size_t n, const vec3& t);
+        /// Translates \p n points by \p t in double precision, i.e., p = vec3(dvec3(p) + t). This is useful to
+        /// subtract a large offset (e.g., geographic coordinates) without losing precision.
+        void translate(vec3* points, std::size_t n, const dvec3& t);
+
+        /// Transforms \p n points by a 4x4 matrix \p m, i.e., p = m * p (the points are treated as homogeneous
+        /// coordinates with w = 1, and the results are divided by w).
+        void transform(vec3* points, std::size_t n, const mat4& m);
+        /// Transforms \p n vectors by a 3x3 matrix \p m, i.e., v = m * v (e.g., normals with the normal matrix).
+        void transform(vec3* vectors, std::size_t n, const mat3& m);
+
+        /// Normalizes \p n vectors. Vectors with zero length become zero (the same as vec3::normalize()).
+        void normalize(vec3* vectors, std::size_t n);
+
+        /// Computes the dot products result[i] = dot(a[i], b[i]) for i in [0, n).
+        void dot(const vec3* a, const vec3* b, float* result, std::size_t n);
+        /// Computes the cross products result[i] = cross(a[i], b[i]) for i in [0, n). \p result can be \p a or \p b.
+        void cross(const vec3* a, const vec3* b, vec3* result, std::size_t n);
+
+
+        // convenient overloads for std::vector
+
+        inline Box3 bounding_box(const std::vector<vec3>& points) {
+            return bounding_box(points.data(), points.size());
+        }
+        inline void translate(std::vector<vec3>& points, const vec3& t) {
+            translate(points.data(), points.size(), t);
+        }
+        inline void translate(std::vector<vec3>& points, const dvec3& t) {
+            translate(points.data(), points.size(), t);
+        }
+        inline void transform(std::vector<vec3>& points, const mat4& m) {
+            transform(points.data(), points.size(), m);
+        }
+        inline void transform(std::vector<vec3>& vectors, const mat3& m) {
+            transform(vectors.data(), vectors.size(), m);
+        }
+        inline void normalize(std::vector<vec3>& vectors) {
+            normalize(vectors.data(), vectors.size());
+        }
+
+    } // namespace kernels
+
+} // namespace easy3d
+
+
+#endif  // EASY3D_CORE_VEC3_KERNELS_H
@@ -28,9 +28,11 @@
 
 #include <clocale>
 
+#include <easy3d/fileio/snapshot.h>
 #include <easy3d/core/graph.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/tracing.h>
 #include <easy3d/util/logging.h>
 
 
@@ -39,6 +41,7 @@ namespace easy3d {
 
     Graph* GraphIO::load(const std::string& file_name)
 	{
+		EASY3D_TRACE_ZONE_CATEGORY("GraphIO::load", "io");
 		std::setlocale(LC_NUMERIC, "C");
 
         Graph* graph = new Graph;
@@ -50,12 +53,14 @@ namespace easy3d {
         const std::string& ext = file_system::extension(file_name, true);
         if (ext == "ply")
             success = io::load_ply(file_name, graph);
+        else if (ext == "snap")
+            success = io::load_snapshot(file_name, graph);
         else if (ext.empty()){
             LOG(ERROR) << "unknown file format: no extension" << ext;
             success = false;
         }
         else {
-            LOG(ERROR) << "unknown file format: " << ext << ". Only PLY format is supported for Graph" << ext;
+            LOG(ERROR) << "unknown file format: " << ext << ". Only PLY and snapshot formats are supported for Graph";
             return nullptr;
         }
 
@@ -79,6 +84,7 @@ namespace easy3d {
 
     bool GraphIO::save(const std::string& file_name, const Graph* graph)
 	{
+        EASY3D_TRACE_ZONE_CATEGORY("GraphIO::save", "io");
         if (!graph || graph->n_vertices() == 0) {
             LOG(ERROR) << "graph is null";
 			return false;
@@ -97,8 +103,10 @@ namespace easy3d {
             }
             success = io::save_ply(final_name, graph, true);
         }
+        else if (ext == "snap")
+            success = io::save_snapshot(final_name, graph);
 		else {
-            LOG(ERROR) << "unknown file format: " << ext << ". Only PLY format is supported for Graph";
+            LOG(ERROR) << "unknown file format: " << ext << ". Only PLY and snapshot formats are supported for Graph";
 			success = false;
 		}
 
@@ -35,7 +35,7 @@ namespace easy3d {
 
     class Graph;
 
-    /// \brief Implementation of file input/output operations for Graph (Currently only PLY format is supported).
+    /// \brief Implementation of file input/output operations for Graph (PLY and snapshot formats are supported).
     /// \class GraphIO easy3d/fileio/graph_io.h
     class GraphIO
 	{
@@ -43,13 +43,13 @@ namespace easy3d {
         /**
          * \brief Reads a graph from file \p file_name.
          * \return The pointer of the graph (nullptr if failed).
-         * \details File extension determines file format (currently only PLY format is supported).
+         * \details File extension determines file format (ply, or snap for a snapshot, see io::save_snapshot()).
          */
         static Graph* load(const std::string& file_name);
 
         /**
          * \brief Saves \p graph to file \p file_name.
-         * \details File extension determines file format (currently only PLY format is supported).
+         * \details File extension determines file format (ply, or snap for a snapshot, see io::save_snapshot()).
          * \return The status of the operation
          *      \arg true if succeeded
          *      \arg false if failed
@@ -28,6 +28,7 @@
 #include <easy3d/fileio/translator.h>
 #include <easy3d/fileio/ply_reader_writer.h>
 #include <easy3d/core/graph.h>
+#include <easy3d/core/vec3_kernels.h>
 
 
 namespace easy3d {
@@ -143,12 +144,13 @@ namespace easy3d {
                     graph->add_vertex(p);
             } else if (Translator::instance()->status() == Translator::TRANSLATE_USE_FIRST_POINT) {
                 // the first point
-                const vec3 &p0 = coordinates[0];
+                const vec3 p0 = coordinates[0];
                 const dvec3 origin(p0.data());
                 Translator::instance()->set_translation(origin);
 
+                kernels::translate(coordinates, -p0);
                 for (auto p: coordinates)
-                    graph->add_vertex(p - p0);
+                    graph->add_vertex(p);
 
                 auto trans = graph->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
                 trans[0] = origin;
@@ -157,8 +159,9 @@ namespace easy3d {
             } else if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET) {
                 const dvec3 &origin = Translator::instance()->translation();
 
+                kernels::translate(coordinates, -origin);
                 for (auto p: coordinates)
-                    graph->add_vertex(vec3(p.x - origin.x, p.y - origin.y, p.z + origin.z));
+                    graph->add_vertex(p);
 
                 auto trans = graph->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
                 trans[0] = origin;
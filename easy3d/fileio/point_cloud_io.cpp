@@ -29,9 +29,11 @@
 #include <clocale>
 
 #include <easy3d/fileio/point_cloud_io_vg.h>
+#include <easy3d/fileio/snapshot.h>
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/tracing.h>
 
 
 namespace easy3d {
@@ -39,6 +41,7 @@ namespace easy3d {
 
 	PointCloud* PointCloudIO::load(const std::string& file_name)
 	{
+		EASY3D_TRACE_ZONE_CATEGORY("PointCloudIO::load", "io");
 		std::setlocale(LC_NUMERIC, "C");
 
 		PointCloud* cloud = new PointCloud;
@@ -62,6 +65,8 @@ namespace easy3d {
             success = io::PointCloudIO_vg::load_vg(file_name, cloud);
         else if (ext == "bvg")
             success = io::PointCloudIO_vg::load_bvg(file_name, cloud);
+        else if (ext == "snap")
+            success = io::load_snapshot(file_name, cloud);
 
         else if (ext.empty()){
             LOG(ERROR) << "unknown file format: no extension";
@@ -90,6 +95,7 @@ namespace easy3d {
 
 
 	bool PointCloudIO::save(const std::string& file_name, const PointCloud* cloud) {
+		EASY3D_TRACE_ZONE_CATEGORY("PointCloudIO::save", "io");
 		if (!cloud) {
 			LOG(ERROR) << "Point cloud is null";
 			return false;
@@ -119,6 +125,8 @@ namespace easy3d {
             success = io::PointCloudIO_vg::save_vg(file_name, cloud);
         else if (ext == "bvg")
             success = io::PointCloudIO_vg::save_bvg(file_name, cloud);
+        else if (ext == "snap")
+            success = io::save_snapshot(final_name, cloud);
 		else {
 			LOG(ERROR) << "unknown file format: " << ext;
             success = false;
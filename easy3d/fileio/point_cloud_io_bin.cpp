@@ -30,6 +30,7 @@
 
 #include <easy3d/fileio/translator.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/core/vec3_kernels.h>
 
 
 namespace easy3d {
@@ -67,8 +68,7 @@ namespace easy3d {
                 const dvec3 origin(p0.data());
                 Translator::instance()->set_translation(origin);
 
-                for (auto& p : positions)
-                    p -= p0;
+                kernels::translate(positions, -p0);
 
                 auto trans = cloud->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
                 trans[0] = origin;
@@ -77,11 +77,7 @@ namespace easy3d {
             } else if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET) {
                 const dvec3 &origin = Translator::instance()->translation();
                 auto& points = cloud->get_vertex_property<vec3>("v:point").vector();
-                for (auto& p: points) {
-                    p.x -= origin.x;
-                    p.y -= origin.y;
-                    p.z -= origin.z;
-                }
+                kernels::translate(points, -origin);
 
                 auto trans = cloud->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
                 trans[0] = origin;
@@ -32,6 +32,7 @@
 #include <easy3d/fileio/translator.h>
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/random.h>
+#include <easy3d/core/vec3_kernels.h>
 #include <easy3d/util/logging.h>
 
 /*
@@ -407,8 +408,7 @@ namespace easy3d {
                 const dvec3 origin(p0.data());
                 Translator::instance()->set_translation(origin);
 
-                for (auto& p : positions)
-                    p -= p0;
+                kernels::translate(positions, -p0);
 
                 auto trans = cloud->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
                 trans[0] = origin;
@@ -417,11 +417,7 @@ namespace easy3d {
             } else if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET) {
                 const dvec3 &origin = Translator::instance()->translation();
                 auto& points = cloud->get_vertex_property<vec3>("v:point").vector();
-                for (auto& p: points) {
-                    p.x -= origin.x;
-                    p.y -= origin.y;
-                    p.z -= origin.z;
-                }
+                kernels::translate(points, -origin);
 
                 auto trans = cloud->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
                 trans[0] = origin;
@@ -705,6 +701,9 @@ namespace easy3d {
         void PointCloudIO_vg::collect_groups(const PointCloud* cloud, std::vector<VertexGroup>& groups) {
             auto primitve_type = cloud->get_vertex_property<int>("v:primitive_type");
             auto primitve_index = cloud->get_vertex_property<int>("v:primitive_index");
+            groups.clear();
+            if (!primitve_type || !primitve_index)  // no segmentation
+                return;
 
             // each type has a number of groups; primitive type may not be continuous, e.g., 1, 2, 5, 6
             std::unordered_map<int, std::unordered_map<int, VertexGroup> > temp_groups;    // groups[primitive type][primitive index]
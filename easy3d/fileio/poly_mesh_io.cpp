@@ -28,9 +28,11 @@
 
 #include <clocale>
 
+#include <easy3d/fileio/snapshot.h>
 #include <easy3d/core/poly_mesh.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/tracing.h>
 #include <easy3d/util/logging.h>
 
 
@@ -38,6 +40,7 @@ namespace easy3d {
 
 
     PolyMesh *PolyMeshIO::load(const std::string &file_name) {
+        EASY3D_TRACE_ZONE_CATEGORY("PolyMeshIO::load", "io");
         std::setlocale(LC_NUMERIC, "C");
 
         PolyMesh* mesh = new PolyMesh;
@@ -53,6 +56,8 @@ namespace easy3d {
             success = io::load_pm(file_name, mesh);
         else if (ext == "mesh")
             success = io::load_mesh(file_name, mesh);
+        else if (ext == "snap")
+            success = io::load_snapshot(file_name, mesh);
         else if (ext.empty()){
             LOG(ERROR) << "unknown file format: no extension" << ext;
             success = false;
@@ -83,6 +88,7 @@ namespace easy3d {
 
 
     bool PolyMeshIO::save(const std::string &file_name, const PolyMesh *mesh) {
+        EASY3D_TRACE_ZONE_CATEGORY("PolyMeshIO::save", "io");
         if (!mesh || mesh->n_vertices() == 0 || mesh->n_faces() == 0 || mesh->n_cells() == 0) {
             LOG(ERROR) << "polyhedral mesh is null";
             return false;
@@ -111,6 +117,8 @@ namespace easy3d {
             success = io::save_pm(final_name, mesh);
         else if (ext == "mesh")
             success = io::save_mesh(file_name, mesh);
+        else if (ext == "snap")
+            success = io::save_snapshot(final_name, mesh);
         else {
             LOG(ERROR) << "unknown file format: " << ext;
             success = false;
@@ -0,0 +1,958 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/fileio/snapshot.h>
+
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/util/logging.h>
+
+
+/** ----------------------------------------------------------
+ *
+ * Layout of a snapshot file (all numbers and the raw chunks are stored in the native byte order of the machine that
+ * wrote the file, so they can be read directly into the property arrays):
+ *      - header (64 bytes): magic "EASY3DSN", version, model type, number of containers, number of chunks, offset
+ *        and size of the table, and a byte order mark (0x01020304 as written by the machine). A snapshot written
+ *        on a machine with another byte order is rejected;
+ *      - chunks: the data of the property arrays, each starting at a page boundary if it is not compressed;
+ *      - table: for each property container, its kind ('v', 'h', 'e', 'f', 'c', or 'm') and its size; for each
+ *        chunk, the length of its entry, the kind of the container, the codec, the element size (0 for types with
+ *        variable length), the number of elements, the offset, the stored size, the uncompressed size, and the
+ *        type and name of the property.
+ * A reader skips the unknown trailing fields of a table entry, so new fields can be appended in later versions.
+ *
+ *----------------------------------------------------------*/
+
+
+namespace easy3d {
+
+    namespace io {
+
+        namespace details {
+
+            const char magic[8] = {'E', 'A', 'S', 'Y', '3', 'D', 'S', 'N'};
+            const uint32_t version = 1;
+            const uint64_t page_size = 4096;
+            const uint32_t byte_order_mark = 0x01020304;
+
+            enum ModelType { UNKNOWN_MODEL = 0, POINT_CLOUD = 1, SURFACE_MESH = 2, GRAPH = 3, POLY_MESH = 4 };
+            enum Codec { CODEC_NONE = 0, CODEC_SHUFFLE_LZ = 1 };
+
+            struct Header {
+                char magic[8];
+                uint32_t version;
+                uint32_t model_type;
+                uint32_t num_containers;
+                uint32_t num_chunks;
+                uint64_t table_offset;
+                uint64_t table_size;
+                uint32_t byte_order;    // 0 in the files written before it was recorded
+                uint32_t reserved32;
+                uint64_t reserved[2];
+            };
+            static_assert(sizeof(Header) == 64, "unexpected size of the snapshot header");
+
+            struct Chunk {
+                Chunk() : kind(0), codec(CODEC_NONE), element_size(0), num_elements(0), offset(0),
+                          stored_size(0), raw_size(0) {}
+                char kind;
+                uint8_t codec;
+                uint64_t element_size;
+                uint64_t num_elements;
+                uint64_t offset;
+                uint64_t stored_size;
+                uint64_t raw_size;
+                std::string type;
+                std::string name;
+            };
+
+
+            //-------------------------------------------------------------------------------------------------------
+
+            // the property containers of a model, each with a character indicating the kind of its elements
+
+            ModelType model_type(const Model *model) {
+                if (dynamic_cast<const PointCloud *>(model)) return POINT_CLOUD;
+                else if (dynamic_cast<const SurfaceMesh *>(model)) return SURFACE_MESH;
+                else if (dynamic_cast<const Graph *>(model)) return GRAPH;
+                else if (dynamic_cast<const PolyMesh *>(model)) return POLY_MESH;
+                return UNKNOWN_MODEL;
+            }
+
+            std::vector<std::pair<char, const PropertyContainer *> > containers(const Model *model) {
+                std::vector<std::pair<char, const PropertyContainer *> > result;
+                if (auto cloud = dynamic_cast<const PointCloud *>(model)) {
+                    result.emplace_back('v', &cloud->vertex_property_container());
+                    result.emplace_back('m', &cloud->model_property_container());
+                } else if (auto mesh = dynamic_cast<const SurfaceMesh *>(model)) {
+                    result.emplace_back('v', &mesh->vertex_property_container());
+                    result.emplace_back('h', &mesh->halfedge_property_container());
+                    result.emplace_back('e', &mesh->edge_property_container());
+                    result.emplace_back('f', &mesh->face_property_container());
+                    result.emplace_back('m', &mesh->model_property_container());
+                } else if (auto graph = dynamic_cast<const Graph *>(model)) {
+                    result.emplace_back('v', &graph->vertex_property_container());
+                    result.emplace_back('e', &graph->edge_property_container());
+                    result.emplace_back('m', &graph->model_property_container());
+                } else if (auto poly = dynamic_cast<const PolyMesh *>(model)) {
+                    result.emplace_back('v', &poly->vertex_property_container());
+                    result.emplace_back('e', &poly->edge_property_container());
+                    result.emplace_back('h', &poly->halfface_property_container());
+                    result.emplace_back('f', &poly->face_property_container());
+                    result.emplace_back('c', &poly->cell_property_container());
+                    result.emplace_back('m', &poly->model_property_container());
+                }
+                return result;
+            }
+
+            std::vector<std::pair<char, PropertyContainer *> > containers(Model *model) {
+                std::vector<std::pair<char, PropertyContainer *> > result;
+                if (auto cloud = dynamic_cast<PointCloud *>(model)) {
+                    result.emplace_back('v', &cloud->vertex_property_container());
+                    result.emplace_back('m', &cloud->model_property_container());
+                } else if (auto mesh = dynamic_cast<SurfaceMesh *>(model)) {
+                    result.emplace_back('v', &mesh->vertex_property_container());
+                    result.emplace_back('h', &mesh->halfedge_property_container());
+                    result.emplace_back('e', &mesh->edge_property_container());
+                    result.emplace_back('f', &mesh->face_property_container());
+                    result.emplace_back('m', &mesh->model_property_container());
+                } else if (auto graph = dynamic_cast<Graph *>(model)) {
+                    result.emplace_back('v', &graph->vertex_property_container());
+                    result.emplace_back('e', &graph->edge_property_container());
+                    result.emplace_back('m', &graph->model_property_container());
+                } else if (auto poly = dynamic_cast<PolyMesh *>(model)) {
+                    result.emplace_back('v', &poly->vertex_property_container());
+                    result.emplace_back('e', &poly->edge_property_container());
+                    result.emplace_back('h', &poly->halfface_property_container());
+                    result.emplace_back('f', &poly->face_property_container());
+                    result.emplace_back('c', &poly->cell_property_container());
+                    result.emplace_back('m', &poly->model_property_container());
+                }
+                return result;
+            }
+
+
+            //-------------------------------------------------------------------------------------------------------
+
+            template<typename T>
+            BasePropertyArray *create(const std::string &name) {
+                return new PropertyArray<T>(name);
+            }
+
+            // types that are stored as raw memory
+            template<typename T>
+            const char *raw_data(const BasePropertyArray *array) {
+                static_assert(std::is_trivially_copyable<T>::value, "the type must be trivially copyable");
+                return reinterpret_cast<const char *>(static_cast<const PropertyArray<T> *>(array)->data());
+            }
+
+            template<typename T>
+            char *raw_data(BasePropertyArray *array) {
+                return reinterpret_cast<char *>(static_cast<PropertyArray<T> *>(array)->vector().data());
+            }
+
+            // types with variable length (or without contiguous storage) are stored element by element
+            template<typename T>
+            void write_element(std::ostream &output, const T &value) { value.write(output); }
+            template<typename T>
+            void read_element(std::istream &input, T &value) { value.read(input); }
+
+            template<>
+            void write_element<bool>(std::ostream &output, const bool &value) {
+                const char c = value ? 1 : 0;
+                output.write(&c, 1);
+            }
+            template<>
+            void read_element<bool>(std::istream &input, bool &value) {
+                char c = 0;
+                input.read(&c, 1);
+                value = (c != 0);
+            }
+
+            template<>
+            void write_element<std::string>(std::ostream &output, const std::string &value) {
+                const uint64_t size = value.size();
+                output.write(reinterpret_cast<const char *>(&size), sizeof(uint64_t));
+                output.write(value.data(), size);
+            }
+            template<>
+            void read_element<std::string>(std::istream &input, std::string &value) {
+                uint64_t size = 0;
+                input.read(reinterpret_cast<char *>(&size), sizeof(uint64_t));
+                if (!input || size > (1ull << 32)) {
+                    input.setstate(std::ios::failbit);
+                    return;
+                }
+                value.resize(size);
+                input.read(&value[0], size);
+            }
+
+            template<>
+            void write_element<Graph::VertexConnectivity>(std::ostream &output, const Graph::VertexConnectivity &value) {
+                const uint32_t size = static_cast<uint32_t>(value.edges_.size());
+                output.write(reinterpret_cast<const char *>(&size), sizeof(uint32_t));
+                if (size > 0)
+                    output.write(reinterpret_cast<const char *>(value.edges_.data()), size * sizeof(Graph::Edge));
+            }
+            template<>
+            void read_element<Graph::VertexConnectivity>(std::istream &input, Graph::VertexConnectivity &value) {
+                uint32_t size = 0;
+                input.read(reinterpret_cast<char *>(&size), sizeof(uint32_t));
+                if (!input || size > (1u << 28)) {
+                    input.setstate(std::ios::failbit);
+                    return;
+                }
+                value.edges_.resize(size);
+                if (size > 0)
+                    input.read(reinterpret_cast<char *>(value.edges_.data()), size * sizeof(Graph::Edge));
+            }
+
+            template<typename T>
+            void encode(const BasePropertyArray *array, std::size_t n, std::ostream &output) {
+                const PropertyArray<T> &a = *static_cast<const PropertyArray<T> *>(array);
+                for (std::size_t i = 0; i < n; ++i)
+                    write_element<T>(output, a[i]);
+            }
+
+            template<typename T>
+            bool decode(BasePropertyArray *array, std::size_t n, std::istream &input) {
+                auto &values = static_cast<PropertyArray<T> *>(array)->vector();
+                for (std::size_t i = 0; i < n && input; ++i) {
+                    T value;
+                    read_element<T>(input, value);
+                    values[i] = std::move(value);
+                }
+                return !input.fail();
+            }
+
+
+            // a registered type
+            struct Type {
+                const char *name;
+                const std::type_info *info;
+                std::size_t size;   // 0 for types stored element by element
+                BasePropertyArray *(*create)(const std::string &);
+                // for types stored as raw memory
+                const char *(*raw_read)(const BasePropertyArray *);
+                char *(*raw_write)(BasePropertyArray *);
+                // for types stored element by element
+                void (*encode)(const BasePropertyArray *, std::size_t, std::ostream &);
+                bool (*decode)(BasePropertyArray *, std::size_t, std::istream &);
+            };
+
+#define EASY3D_SNAPSHOT_RAW_TYPE(T)     {#T, &typeid(T), sizeof(T), &create<T>, &raw_data<T>, &raw_data<T>, nullptr, nullptr}
+#define EASY3D_SNAPSHOT_ENCODED_TYPE(T) {#T, &typeid(T), 0, &create<T>, nullptr, nullptr, &encode<T>, &decode<T>}
+
+            const std::vector<Type> &registered_types() {
+                static const std::vector<Type> types = {
+                        EASY3D_SNAPSHOT_ENCODED_TYPE(bool),
+                        EASY3D_SNAPSHOT_RAW_TYPE(char),
+                        EASY3D_SNAPSHOT_RAW_TYPE(unsigned char),
+                        EASY3D_SNAPSHOT_RAW_TYPE(int),
+                        EASY3D_SNAPSHOT_RAW_TYPE(unsigned int),
+                        EASY3D_SNAPSHOT_RAW_TYPE(int64_t),
+                        EASY3D_SNAPSHOT_RAW_TYPE(uint64_t),
+                        EASY3D_SNAPSHOT_RAW_TYPE(float),
+                        EASY3D_SNAPSHOT_RAW_TYPE(double),
+                        EASY3D_SNAPSHOT_RAW_TYPE(vec2),
+                        EASY3D_SNAPSHOT_RAW_TYPE(vec3),
+                        EASY3D_SNAPSHOT_RAW_TYPE(vec4),
+                        EASY3D_SNAPSHOT_RAW_TYPE(dvec2),
+                        EASY3D_SNAPSHOT_RAW_TYPE(dvec3),
+                        EASY3D_SNAPSHOT_RAW_TYPE(dvec4),
+                        EASY3D_SNAPSHOT_RAW_TYPE(ivec2),
+                        EASY3D_SNAPSHOT_RAW_TYPE(ivec3),
+                        EASY3D_SNAPSHOT_RAW_TYPE(ivec4),
+                        EASY3D_SNAPSHOT_RAW_TYPE(mat3),
+                        EASY3D_SNAPSHOT_RAW_TYPE(mat4),
+                        EASY3D_SNAPSHOT_RAW_TYPE(dmat3),
+                        EASY3D_SNAPSHOT_RAW_TYPE(dmat4),
+                        EASY3D_SNAPSHOT_ENCODED_TYPE(std::string),
+                        // point cloud
+                        EASY3D_SNAPSHOT_RAW_TYPE(PointCloud::Vertex),
+                        // surface mesh
+                        EASY3D_SNAPSHOT_RAW_TYPE(SurfaceMesh::Vertex),
+                        EASY3D_SNAPSHOT_RAW_TYPE(SurfaceMesh::Halfedge),
+                        EASY3D_SNAPSHOT_RAW_TYPE(SurfaceMesh::Edge),
+                        EASY3D_SNAPSHOT_RAW_TYPE(SurfaceMesh::Face),
+                        EASY3D_SNAPSHOT_RAW_TYPE(SurfaceMesh::VertexConnectivity),
+                        EASY3D_SNAPSHOT_RAW_TYPE(SurfaceMesh::HalfedgeConnectivity),
+                        EASY3D_SNAPSHOT_RAW_TYPE(SurfaceMesh::FaceConnectivity),
+                        // graph
+                        EASY3D_SNAPSHOT_RAW_TYPE(Graph::Vertex),
+                        EASY3D_SNAPSHOT_RAW_TYPE(Graph::Edge),
+                        EASY3D_SNAPSHOT_ENCODED_TYPE(Graph::VertexConnectivity),
+                        EASY3D_SNAPSHOT_RAW_TYPE(Graph::EdgeConnectivity),
+                        // polyhedral mesh
+                        EASY3D_SNAPSHOT_RAW_TYPE(PolyMesh::Vertex),
+                        EASY3D_SNAPSHOT_RAW_TYPE(PolyMesh::Edge),
+                        EASY3D_SNAPSHOT_RAW_TYPE(PolyMesh::HalfFace),
+                        EASY3D_SNAPSHOT_RAW_TYPE(PolyMesh::Face),
+                        EASY3D_SNAPSHOT_RAW_TYPE(PolyMesh::Cell),
+                        EASY3D_SNAPSHOT_ENCODED_TYPE(PolyMesh::VertexConnectivity),
+                        EASY3D_SNAPSHOT_ENCODED_TYPE(PolyMesh::EdgeConnectivity),
+                        EASY3D_SNAPSHOT_ENCODED_TYPE(PolyMesh::HalfFaceConnectivity),
+                        EASY3D_SNAPSHOT_ENCODED_TYPE(PolyMesh::CellConnectivity)
+                };
+                return types;
+            }
+
+#undef EASY3D_SNAPSHOT_RAW_TYPE
+#undef EASY3D_SNAPSHOT_ENCODED_TYPE
+
+            const Type *find_type(const std::type_info &info) {
+                for (const auto &t : registered_types()) {
+                    if (*t.info == info)
+                        return &t;
+                }
+                return nullptr;
+            }
+
+            const Type *find_type(const std::string &name) {
+                for (const auto &t : registered_types()) {
+                    if (name == t.name)
+                        return &t;
+                }
+                return nullptr;
+            }
+
+
+            //-------------------------------------------------------------------------------------------------------
+
+            // Byte shuffling groups the k-th bytes of all elements together. Neighboring elements of an array of
+            // numbers usually share their high-order bytes, which results in long repetitions after shuffling.
+
+            void shuffle(const char *src, std::size_t size, std::size_t element_size, char *dst) {
+                const std::size_t n = size / element_size;
+                for (std::size_t b = 0; b < element_size; ++b) {
+                    for (std::size_t i = 0; i < n; ++i)
+                        dst[b * n + i] = src[i * element_size + b];
+                }
+                std::memcpy(dst + n * element_size, src + n * element_size, size - n * element_size);
+            }
+
+            void unshuffle(const char *src, std::size_t size, std::size_t element_size, char *dst) {
+                const std::size_t n = size / element_size;
+                for (std::size_t b = 0; b < element_size; ++b) {
+                    for (std::size_t i = 0; i < n; ++i)
+                        dst[i * element_size + b] = src[b * n + i];
+                }
+                std::memcpy(dst + n * element_size, src + n * element_size, size - n * element_size);
+            }
+
+            // A greedy LZ77 compressor producing the LZ4 block format: each sequence starts with a token holding the
+            // number of literals (high 4 bits) and the match length minus 4 (low 4 bits), followed by the extra bytes
+            // of the number of literals, the literals, a 2-byte offset, and the extra bytes of the match length. The
+            // last sequence has only literals.
+
+            const std::size_t min_match = 4;
+            const std::size_t last_literals = 5;    // the last bytes are always literals
+            const std::size_t match_limit = 12;     // a match cannot start within the last bytes
+            const int hash_bits = 16;
+
+            inline uint32_t read32(const unsigned char *p) {
+                uint32_t v;
+                std::memcpy(&v, p, sizeof(uint32_t));
+                return v;
+            }
+
+            inline uint32_t hash(uint32_t v) {
+                return (v * 2654435761u) >> (32 - hash_bits);
+            }
+
+            void write_length(std::string &output, std::size_t length) {
+                for (; length >= 255; length -= 255)
+                    output.push_back(static_cast<char>(255));
+                output.push_back(static_cast<char>(length));
+            }
+
+            void write_sequence(std::string &output, const unsigned char *literals, std::size_t num_literals,
+                                std::size_t offset, std::size_t match_length) {
+                const std::size_t ml = match_length > 0 ? match_length - min_match : 0;
+                const unsigned char token = static_cast<unsigned char>((std::min<std::size_t>(num_literals, 15) << 4) |
+                                                                        std::min<std::size_t>(ml, 15));
+                output.push_back(static_cast<char>(token));
+                if (num_literals >= 15)
+                    write_length(output, num_literals - 15);
+                output.append(reinterpret_cast<const char *>(literals), num_literals);
+                if (match_length > 0) {
+                    output.push_back(static_cast<char>(offset & 0xff));
+                    output.push_back(static_cast<char>(offset >> 8));
+                    if (ml >= 15)
+                        write_length(output, ml - 15);
+                }
+            }
+
+            void compress(const char *data, std::size_t size, std::string &output) {
+                const unsigned char *src = reinterpret_cast<const unsigned char *>(data);
+                output.clear();
+                output.reserve(size / 2);
+
+                std::vector<uint32_t> table(std::size_t(1) << hash_bits, 0);  // positions + 1 (0 means empty)
+                std::size_t anchor = 0;
+                if (size > match_limit) {
+                    const std::size_t limit = size - match_limit;
+                    const std::size_t end = size - last_literals;
+                    std::size_t i = 0;
+                    while (i < limit) {
+                        const uint32_t sequence = read32(src + i);
+                        uint32_t &entry = table[hash(sequence)];
+                        const std::size_t candidate = entry;
+                        entry = static_cast<uint32_t>(i + 1);
+                        if (candidate > 0 && i - (candidate - 1) <= 65535 && read32(src + candidate - 1) == sequence) {
+                            const std::size_t ref = candidate - 1;
+                            std::size_t length = min_match;
+                            while (i + length < end && src[ref + length] == src[i + length])
+                                ++length;
+                            write_sequence(output, src + anchor, i - anchor, i - ref, length);
+                            i += length;
+                            anchor = i;
+                        } else
+                            ++i;
+                    }
+                }
+                write_sequence(output, src + anchor, size - anchor, 0, 0);
+            }
+
+            bool read_length(const unsigned char *src, std::size_t size, std::size_t &pos, std::size_t &length) {
+                unsigned char b = 0;
+                do {
+                    if (pos >= size)
+                        return false;
+                    b = src[pos++];
+                    length += b;
+                } while (b == 255);
+                return true;
+            }
+
+            bool decompress(const char *data, std::size_t size, char *output, std::size_t raw_size) {
+                const unsigned char *src = reinterpret_cast<const unsigned char *>(data);
+                std::size_t ip = 0, op = 0;
+                while (ip < size) {
+                    const unsigned char token = src[ip++];
+                    std::size_t num_literals = token >> 4;
+                    if (num_literals == 15 && !read_length(src, size, ip, num_literals))
+                        return false;
+                    if (num_literals > size - ip || num_literals > raw_size - op)
+                        return false;
+                    std::memcpy(output + op, src + ip, num_literals);
+                    ip += num_literals;
+                    op += num_literals;
+                    if (ip == size)     // the last sequence
+                        break;
+
+                    if (size - ip < 2)
+                        return false;
+                    const std::size_t offset = src[ip] | (std::size_t(src[ip + 1]) << 8);
+                    ip += 2;
+                    std::size_t length = token & 15;
+                    if (length == 15 && !read_length(src, size, ip, length))
+                        return false;
+                    length += min_match;
+                    if (offset == 0 || offset > op || length > raw_size - op)
+                        return false;
+                    for (std::size_t k = 0; k < length; ++k, ++op)    // the match may overlap the output
+                        output[op] = output[op - offset];
+                }
+                return op == raw_size;
+            }
+
+
+            //-------------------------------------------------------------------------------------------------------
+
+            // the table is built in memory and written/parsed as a whole
+
+            template<typename T>
+            void put(std::string &table, const T &value) {
+                table.append(reinterpret_cast<const char *>(&value), sizeof(T));
+            }
+
+            void put(std::string &table, const std::string &str) {
+                put(table, static_cast<uint32_t>(str.size()));
+                table.append(str);
+            }
+
+            class TableReader {
+            public:
+                TableReader(const std::string &table) : table_(table), pos_(0), end_(table.size()), ok_(true) {}
+
+                template<typename T>
+                T get() {
+                    T value = T();
+                    if (end_ - pos_ < sizeof(T))
+                        ok_ = false;
+                    else {
+                        std::memcpy(&value, table_.data() + pos_, sizeof(T));
+                        pos_ += sizeof(T);
+                    }
+                    return value;
+                }
+
+                std::string get_string() {
+                    const uint32_t size = get<uint32_t>();
+                    if (!ok_ || end_ - pos_ < size) {
+                        ok_ = false;
+                        return "";
+                    }
+                    std::string str = table_.substr(pos_, size);
+                    pos_ += size;
+                    return str;
+                }
+
+                // restricts reading to the next 'size' bytes (i.e., an entry), or lifts the restriction
+                void begin_entry(std::size_t size) {
+                    if (table_.size() - pos_ < size) ok_ = false;
+                    else end_ = pos_ + size;
+                }
+                void end_entry() {
+                    pos_ = end_;
+                    end_ = table_.size();
+                }
+
+                bool ok() const { return ok_; }
+
+            private:
+                const std::string &table_;
+                std::size_t pos_;
+                std::size_t end_;
+                bool ok_;
+            };
+
+
+            bool read_header(std::ifstream &input, Header &header, const std::string &file_name) {
+                input.read(reinterpret_cast<char *>(&header), sizeof(Header));
+                if (!input || std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+                    LOG(ERROR) << "not a snapshot file: " << file_name;
+                    return false;
+                }
+                if (header.byte_order != 0 && header.byte_order != byte_order_mark) {
+                    LOG(ERROR) << "the snapshot was written on a machine with a different byte order: " << file_name;
+                    return false;
+                }
+                if (header.version > version) {
+                    LOG(ERROR) << "snapshot version " << header.version << " is not supported (the latest supported "
+                               << "version is " << version << "): " << file_name;
+                    return false;
+                }
+                return true;
+            }
+
+
+            // reads a chunk into an array (of the chunk's type and number of elements)
+            bool read_chunk(std::istream &input, const Chunk &chunk, const Type *t, BasePropertyArray *array) {
+                input.seekg(chunk.offset);
+                if (chunk.codec == CODEC_NONE && t->size > 0) {  // read directly into the array
+                    if (chunk.raw_size > 0)
+                        input.read(t->raw_write(array), chunk.raw_size);
+                    return !input.fail();
+                }
+
+                std::string stored(chunk.stored_size, '\0');
+                if (chunk.stored_size > 0)
+                    input.read(&stored[0], chunk.stored_size);
+                if (input.fail())
+                    return false;
+
+                if (chunk.codec == CODEC_SHUFFLE_LZ) {
+                    std::string raw(chunk.raw_size, '\0');
+                    if (!decompress(stored.data(), stored.size(), &raw[0], raw.size()))
+                        return false;
+                    if (t->size > 1) {
+                        stored.resize(raw.size());
+                        unshuffle(raw.data(), raw.size(), t->size, &stored[0]);
+                    } else
+                        stored.swap(raw);
+                }
+
+                if (t->size > 0) {
+                    if (chunk.raw_size > 0)
+                        std::memcpy(t->raw_write(array), stored.data(), chunk.raw_size);
+                    return true;
+                } else {
+                    std::istringstream stream(stored, std::ios::binary);
+                    return t->decode(array, chunk.num_elements, stream);
+                }
+            }
+
+            // loads a deferred property from the snapshot file when it is first accessed
+            class DeferredLoader {
+            public:
+                DeferredLoader(const std::string &file_name, const Chunk &chunk, const Type *type)
+                        : file_name_(file_name), chunk_(chunk), type_(type) {}
+
+                BasePropertyArray *operator()(const std::string &name, std::size_t size) const {
+                    if (size != chunk_.num_elements) {
+                        LOG(ERROR) << "the number of elements has changed since property '" << chunk_.name
+                                   << "' was deferred";
+                        return nullptr;
+                    }
+
+                    std::ifstream input(file_name_.c_str(), std::fstream::binary);
+                    Header header;
+                    if (input.fail() || !read_header(input, header, file_name_)) {
+                        LOG(ERROR) << "could not read property '" << chunk_.name << "' from file: " << file_name_;
+                        return nullptr;
+                    }
+
+                    BasePropertyArray *array = type_->create(name);
+                    array->resize(size);
+                    if (!read_chunk(input, chunk_, type_, array)) {
+                        LOG(ERROR) << "failed reading property '" << chunk_.name << "' from file: " << file_name_;
+                        delete array;
+                        return nullptr;
+                    }
+                    return array;
+                }
+
+            private:
+                std::string file_name_;
+                Chunk chunk_;
+                const Type *type_;
+            };
+
+        } // namespace details
+
+
+        bool save_snapshot(const std::string &file_name, const Model *model, bool compress) {
+            if (!model) {
+                LOG(ERROR) << "null model pointer";
+                return false;
+            }
+
+            // models with deleted elements are saved as if the garbage had been collected
+            const Model *source = model;
+            std::unique_ptr<Model> copy;
+            if (auto cloud = dynamic_cast<const PointCloud *>(model)) {
+                if (cloud->has_garbage()) {
+                    auto c = new PointCloud(*cloud);
+                    c->collect_garbage();
+                    copy.reset(c);
+                }
+            } else if (auto mesh = dynamic_cast<const SurfaceMesh *>(model)) {
+                if (mesh->has_garbage()) {
+                    auto m = new SurfaceMesh(*mesh);
+                    m->collect_garbage();
+                    copy.reset(m);
+                }
+            } else if (auto graph = dynamic_cast<const Graph *>(model)) {
+                if (graph->has_garbage()) {
+                    auto g = new Graph(*graph);
+                    g->collect_garbage();
+                    copy.reset(g);
+                }
+            }
+            if (copy)
+                source = copy.get();
+
+            const details::ModelType type = details::model_type(source);
+            if (type == details::UNKNOWN_MODEL) {
+                LOG(ERROR) << "unknown model type (only PointCloud, SurfaceMesh, Graph, and PolyMesh are supported)";
+                return false;
+            }
+
+            // the deferred properties are loaded before the file is opened (and truncated), which may be the file
+            // they are loaded from, i.e., when a lazily loaded model is saved back to its snapshot file
+            const auto containers = details::containers(source);
+            for (const auto &c : containers)
+                c.second->load_deferred();
+
+            std::ofstream output(file_name.c_str(), std::fstream::binary);
+            if (output.fail()) {
+                LOG(ERROR) << "could not open file: " << file_name;
+                return false;
+            }
+
+            details::Header header;
+            std::memset(&header, 0, sizeof(details::Header));
+            std::memcpy(header.magic, details::magic, sizeof(details::magic));
+            header.version = details::version;
+            header.model_type = type;
+            header.byte_order = details::byte_order_mark;
+            output.write(reinterpret_cast<const char *>(&header), sizeof(details::Header));
+
+            std::vector<details::Chunk> chunks;
+            std::string encoded, compressed, shuffled;
+            const char padding[details::page_size] = {0};
+
+            for (const auto &c : containers) {
+                const PropertyContainer &container = *c.second;
+                for (const BasePropertyArray *array : container.arrays()) {
+                    const details::Type *t = details::find_type(array->type());
+                    if (!t) {
+                        LOG(WARNING) << "property '" << array->name() << "' not saved (type '" << array->type().name()
+                                     << "' not supported)";
+                        continue;
+                    }
+
+                    details::Chunk chunk;
+                    chunk.kind = c.first;
+                    chunk.type = t->name;
+                    chunk.name = array->name();
+                    chunk.element_size = t->size;
+                    chunk.num_elements = container.size();
+
+                    // the data of the chunk
+                    const char *data = nullptr;
+                    if (t->size > 0) {
+                        chunk.raw_size = container.size() * t->size;
+                        if (container.size() > 0)
+                            data = t->raw_read(array);
+                    } else {
+                        std::ostringstream stream(std::ios::binary);
+                        t->encode(array, container.size(), stream);
+                        encoded = stream.str();
+                        chunk.raw_size = encoded.size();
+                        data = encoded.data();
+                    }
+                    chunk.stored_size = chunk.raw_size;
+
+                    if (compress && chunk.raw_size > details::page_size && chunk.raw_size < (1ull << 31)) {
+                        const char *input = data;
+                        if (t->size > 1) {
+                            shuffled.resize(chunk.raw_size);
+                            details::shuffle(data, chunk.raw_size, t->size, &shuffled[0]);
+                            input = shuffled.data();
+                        }
+                        details::compress(input, chunk.raw_size, compressed);
+                        if (compressed.size() < chunk.raw_size) {
+                            chunk.codec = details::CODEC_SHUFFLE_LZ;
+                            chunk.stored_size = compressed.size();
+                            data = compressed.data();
+                        }
+                    }
+
+                    // uncompressed chunks start at page boundaries (to allow memory mapping), others are 8-byte aligned
+                    const uint64_t alignment = (chunk.codec == details::CODEC_NONE) ? details::page_size : 8;
+                    const uint64_t pos = static_cast<uint64_t>(output.tellp());
+                    chunk.offset = (pos + alignment - 1) / alignment * alignment;
+                    output.write(padding, chunk.offset - pos);
+                    if (chunk.stored_size > 0)
+                        output.write(data, chunk.stored_size);
+                    chunks.push_back(chunk);
+                }
+            }
+
+            // the table
+            std::string table;
+            for (const auto &c : containers) {
+                details::put(table, c.first);
+                details::put(table, static_cast<uint64_t>(c.second->size()));
+            }
+            for (const auto &chunk : chunks) {
+                std::string entry;
+                details::put(entry, chunk.kind);
+                details::put(entry, chunk.codec);
+                details::put(entry, static_cast<uint16_t>(0));  // reserved
+                details::put(entry, chunk.element_size);
+                details::put(entry, chunk.num_elements);
+                details::put(entry, chunk.offset);
+                details::put(entry, chunk.stored_size);
+                details::put(entry, chunk.raw_size);
+                details::put(entry, chunk.type);
+                details::put(entry, chunk.name);
+                details::put(table, static_cast<uint32_t>(entry.size()));
+                table.append(entry);
+            }
+
+            const uint64_t pos = static_cast<uint64_t>(output.tellp());
+            header.table_offset = (pos + 7) / 8 * 8;
+            header.table_size = table.size();
+            header.num_containers = static_cast<uint32_t>(containers.size());
+            header.num_chunks = static_cast<uint32_t>(chunks.size());
+            output.write(padding, header.table_offset - pos);
+            output.write(table.data(), table.size());
+            output.seekp(0);
+            output.write(reinterpret_cast<const char *>(&header), sizeof(details::Header));
+
+            if (output.fail()) {
+                LOG(ERROR) << "failed writing file: " << file_name;
+                return false;
+            }
+            return true;
+        }
+
+
+        bool load_snapshot(const std::string &file_name, Model *model, bool lazy) {
+            if (!model) {
+                LOG(ERROR) << "null model pointer";
+                return false;
+            }
+
+            std::ifstream input(file_name.c_str(), std::fstream::binary);
+            if (input.fail()) {
+                LOG(ERROR) << "could not open file: " << file_name;
+                return false;
+            }
+
+            details::Header header;
+            if (!details::read_header(input, header, file_name))
+                return false;
+
+            if (header.model_type != static_cast<uint32_t>(details::model_type(model))) {
+                LOG(ERROR) << "the model type stored in the snapshot does not match the given model: " << file_name;
+                return false;
+            }
+
+            std::string table(header.table_size, '\0');
+            input.seekg(header.table_offset);
+            if (header.table_size > 0)
+                input.read(&table[0], header.table_size);
+            if (!input) {
+                LOG(ERROR) << "failed reading the table of the snapshot: " << file_name;
+                return false;
+            }
+
+            // start from an empty model
+            if (auto cloud = dynamic_cast<PointCloud *>(model)) cloud->clear();
+            else if (auto mesh = dynamic_cast<SurfaceMesh *>(model)) mesh->clear();
+            else if (auto graph = dynamic_cast<Graph *>(model)) graph->clear();
+            else if (auto poly = dynamic_cast<PolyMesh *>(model)) poly->clear();
+
+            auto containers = details::containers(model);
+            details::TableReader reader(table);
+            for (uint32_t i = 0; i < header.num_containers; ++i) {
+                const char kind = reader.get<char>();
+                const uint64_t size = reader.get<uint64_t>();
+                for (auto &c : containers) {
+                    if (c.first == kind)
+                        c.second->resize(size);
+                }
+            }
+
+            for (uint32_t i = 0; i < header.num_chunks && reader.ok(); ++i) {
+                details::Chunk chunk;
+                reader.begin_entry(reader.get<uint32_t>());
+                chunk.kind = reader.get<char>();
+                chunk.codec = reader.get<uint8_t>();
+                reader.get<uint16_t>(); // reserved
+                chunk.element_size = reader.get<uint64_t>();
+                chunk.num_elements = reader.get<uint64_t>();
+                chunk.offset = reader.get<uint64_t>();
+                chunk.stored_size = reader.get<uint64_t>();
+                chunk.raw_size = reader.get<uint64_t>();
+                chunk.type = reader.get_string();
+                chunk.name = reader.get_string();
+                reader.end_entry();
+                if (!reader.ok())
+                    break;
+
+                PropertyContainer *container = nullptr;
+                for (auto &c : containers) {
+                    if (c.first == chunk.kind)
+                        container = c.second;
+                }
+
+                const details::Type *t = details::find_type(chunk.type);
+                if (!container || !t || t->size != chunk.element_size || chunk.num_elements != container->size() ||
+                    (t->size > 0 && chunk.raw_size != t->size * chunk.num_elements) ||
+                    chunk.codec > details::CODEC_SHUFFLE_LZ) {
+                    LOG(WARNING) << "property '" << chunk.name << "' (type '" << chunk.type << "') skipped";
+                    continue;
+                }
+
+                // the standard properties (e.g., connectivity and points) already exist and are always loaded
+                BasePropertyArray *array = nullptr;
+                for (auto a : container->arrays()) {
+                    if (a->name() == chunk.name)
+                        array = a;
+                }
+                if (array && array->type() != *t->info) {
+                    LOG(WARNING) << "property '" << chunk.name << "' (type '" << chunk.type << "') skipped (a property "
+                                 << "with the same name but a different type exists)";
+                    continue;
+                }
+
+                if (!array) {
+                    if (lazy) {
+                        container->add_deferred(chunk.name, *t->info, details::DeferredLoader(file_name, chunk, t));
+                        continue;
+                    }
+                    array = t->create(chunk.name);
+                    array->resize(container->size());
+                    container->arrays().push_back(array);
+                }
+
+                const bool success = details::read_chunk(input, chunk, t, array);
+                if (!success) {
+                    LOG(ERROR) << "failed reading property '" << chunk.name << "' from file: " << file_name;
+                    return false;
+                }
+            }
+
+            if (!reader.ok()) {
+                LOG(ERROR) << "corrupted table in snapshot file: " << file_name;
+                return false;
+            }
+
+            return true;
+        }
+
+
+        Model *load_snapshot(const std::string &file_name, bool lazy) {
+            std::ifstream input(file_name.c_str(), std::fstream::binary);
+            if (input.fail()) {
+                LOG(ERROR) << "could not open file: " << file_name;
+                return nullptr;
+            }
+
+            details::Header header;
+            if (!details::read_header(input, header, file_name))
+                return nullptr;
+            input.close();
+
+            Model *model = nullptr;
+            switch (header.model_type) {
+                case details::POINT_CLOUD:  model = new PointCloud;  break;
+                case details::SURFACE_MESH: model = new SurfaceMesh; break;
+                case details::GRAPH:        model = new Graph;       break;
+                case details::POLY_MESH:    model = new PolyMesh;    break;
+                default:
+                    LOG(ERROR) << "unknown model type (" << header.model_type << ") in snapshot file: " << file_name;
+                    return nullptr;
+            }
+
+            model->set_name(file_name);
+            if (!load_snapshot(file_name, model, lazy)) {
+                delete model;
+                return nullptr;
+            }
+            return model;
+        }
+
+    } // namespace io
+
+} // namespace easy3d
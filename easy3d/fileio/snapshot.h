@@ -0,0 +1,84 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_FILEIO_SNAPSHOT_H
+#define EASY3D_FILEIO_SNAPSHOT_H
+
+
+#include <string>
+
+
+namespace easy3d {
+
+    class Model;
+
+    namespace io {
+
+        /**
+         * \brief Saves a model (PointCloud, SurfaceMesh, Graph, or PolyMesh) into a snapshot file.
+         * \details A snapshot is a versioned binary container that stores every property of a model, i.e., all the
+         *      vertex/halfedge/edge/face/cell/model properties including their names and types, such that a model is
+         *      restored exactly (as opposed to other formats that only keep the geometry and a few known properties).
+         *      The file consists of a fixed-size header, one chunk per property array, and a table describing the
+         *      property containers and the chunks (element kind, type name, property name, offset, and size).
+         *      Uncompressed chunks are aligned to pages, so they can be read with a single read or memory-mapped.
+         *      The data is stored in the native byte order, so a snapshot can only be loaded on a machine with the
+         *      same byte order (which is checked when loading).
+         *      Properties of types that cannot be serialized (e.g., std::vector<T>) are skipped with a warning.
+         *      A model with deleted elements is stored as if collect_garbage() had been called.
+         * \param file_name The file name (the extension is typically "snap").
+         * \param model The model to be saved.
+         * \param compress \c true to compress the chunks (using byte shuffling followed by a fast LZ77 compression in
+         *      the style of LZ4). Chunks that do not benefit from compression are stored uncompressed.
+         * \return \c true on success.
+         */
+        bool save_snapshot(const std::string& file_name, const Model* model, bool compress = false);
+
+        /**
+         * \brief Loads a snapshot file into an existing model.
+         * \details The model is cleared first and must be of the type stored in the file.
+         * \param lazy If \c true, only the standard properties (e.g., connectivity and points) are loaded. The other
+         *      properties are added as deferred properties (see PropertyContainer), which are read from the file when
+         *      they are first accessed, e.g., by get_vertex_property(). The file must thus remain unchanged while the
+         *      model is in use. property_stats() reports the properties that have not been loaded yet.
+         * \return \c true on success.
+         */
+        bool load_snapshot(const std::string& file_name, Model* model, bool lazy = false);
+
+        /**
+         * \brief Loads a snapshot file. The type of the model (PointCloud, SurfaceMesh, Graph, or PolyMesh) is
+         *      determined by the file.
+         * \param lazy If \c true, the non-standard properties are only loaded when they are first accessed.
+         * \return The model (nullptr if failed).
+         */
+        Model* load_snapshot(const std::string& file_name, bool lazy = false);
+
+    } // namespace io
+
+} // namespace easy3d
+
+
+#endif  // EASY3D_FILEIO_SNAPSHOT_H
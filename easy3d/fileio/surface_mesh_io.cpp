@@ -28,9 +28,11 @@
 
 #include <clocale>
 
+#include <easy3d/fileio/snapshot.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/stop_watch.h>
+#include <easy3d/util/tracing.h>
 #include <easy3d/util/logging.h>
 
 
@@ -38,6 +40,7 @@ namespace easy3d {
 
 
     SurfaceMesh *SurfaceMeshIO::load(const std::string &file_name) {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshIO::load", "io");
         std::setlocale(LC_NUMERIC, "C");
 
         SurfaceMesh *mesh = new SurfaceMesh;
@@ -51,6 +54,8 @@ namespace easy3d {
             success = io::load_ply(file_name, mesh);
         else if (ext == "sm")
             success = io::load_sm(file_name, mesh);
+        else if (ext == "snap")
+            success = io::load_snapshot(file_name, mesh);
         else if (ext == "obj")
             success = io::load_obj(file_name, mesh);
         else if (ext == "off")
@@ -89,6 +94,7 @@ namespace easy3d {
 
 
     bool SurfaceMeshIO::save(const std::string &file_name, const SurfaceMesh *mesh) {
+        EASY3D_TRACE_ZONE_CATEGORY("SurfaceMeshIO::save", "io");
         if (!mesh || mesh->n_faces() == 0) {
             LOG(ERROR) << "surface mesh is null";
             return false;
@@ -108,6 +114,8 @@ namespace easy3d {
             success = io::save_ply(final_name, mesh, true);
         } else if (ext == "sm")
             success = io::save_sm(final_name, mesh);
+        else if (ext == "snap")
+            success = io::save_snapshot(final_name, mesh);
         else if (ext == "obj")
             success = io::save_obj(final_name, mesh);
         else if (ext == "off")
@@ -46,7 +46,7 @@ namespace easy3d {
 
         /**
          * \brief Reads a surface mesh from a file.
-         * \details File extension determines file format (ply, obj, off, stl, poly) and type (i.e. binary or ASCII).
+         * \details File extension determines file format (ply, obj, off, stl, sm, snap) and type (i.e. binary or ASCII).
          * \param file_name The file name.
          * \return The pointer of the surface mesh (nullptr if failed).
          */
@@ -54,7 +54,7 @@ namespace easy3d {
 
         /**
          * \brief Saves a surface mesh to a file.
-         * \details File extension determines file format (ply, obj, off, stl, poly) and type (i.e. binary or ASCII).
+         * \details File extension determines file format (ply, obj, off, stl, sm, snap) and type (i.e. binary or ASCII).
          * \param file_name The file name.
          * \param mesh The surface mesh.
          * \return The status of the operation
@@ -29,6 +29,7 @@
 #include <easy3d/fileio/ply_reader_writer.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/core/surface_mesh_builder.h>
+#include <easy3d/core/vec3_kernels.h>
 #include <easy3d/util/logging.h>
 
 
@@ -265,8 +266,7 @@ namespace easy3d {
                 const dvec3 origin(p0.data());
                 Translator::instance()->set_translation(origin);
 
-                for (auto& p: points)
-                    p -= p0;
+                kernels::translate(points, -p0);
 
                 auto trans = mesh->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
                 trans[0] = origin;
@@ -275,11 +275,7 @@ namespace easy3d {
             } else if (Translator::instance()->status() == Translator::TRANSLATE_USE_LAST_KNOWN_OFFSET) {
                 const dvec3 &origin = Translator::instance()->translation();
                 auto& points = mesh->get_vertex_property<vec3>("v:point").vector();
-                for (auto& p: points) {
-                    p.x -= origin.x;
-                    p.y -= origin.y;
-                    p.z -= origin.z;
-                }
+                kernels::translate(points, -origin);
 
                 auto trans = mesh->add_model_property<dvec3>("translation", dvec3(0, 0, 0));
                 trans[0] = origin;
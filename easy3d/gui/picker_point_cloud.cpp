@@ -27,6 +27,7 @@
 
 #include <easy3d/gui/picker_point_cloud.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/core/selection_set.h>
 #include <easy3d/renderer/manipulator.h>
 #include <easy3d/renderer/renderer.h>
 #include <easy3d/renderer/shader_manager.h>
@@ -276,7 +277,9 @@ namespace easy3d {
         int num = static_cast<int>(points.size());
         const mat4 &m = camera()->modelViewProjectionMatrix() * model->manipulator()->matrix();
 
-        auto &select = model->vertex_property<bool>("v:select").vector();
+        // the points inside the rectangle are collected in a bitset, which (unlike std::vector<bool>) can be
+        // safely written from multiple threads.
+        SelectionSet hits(num);
 
 #pragma omp parallel for
         for (int i = 0; i < num; ++i) {
@@ -291,11 +294,10 @@ namespace easy3d {
             y = 0.5f * y + 0.5f;
 
             if (x >= xmin && x <= xmax && y >= ymin && y <= ymax)
-                select[i] = !deselect;
+                hits.set(i);
         }
 
-        auto count = std::count(select.begin(), select.end(), 1);
-        LOG(INFO) << "current selection: " << count << " points";
+        apply(model, hits, deselect);
     }
 
 
@@ -326,7 +328,7 @@ namespace easy3d {
         int num = static_cast<int>(points.size());
         const mat4 &m = camera()->modelViewProjectionMatrix() * model->manipulator()->matrix();
 
-        auto& select = model->vertex_property<bool>("v:select").vector();
+        SelectionSet hits(num);
 
 #pragma omp parallel for
         for (int i = 0; i < num; ++i) {
@@ -342,12 +344,19 @@ namespace easy3d {
 
             if (x >= xmin && x <= xmax && y >= ymin && y <= ymax) {
                 if (geom::point_in_polygon(vec2(x, y), region))
-                    select[i] = !deselect;
+                    hits.set(i);
             }
         }
 
-        auto count = std::count(select.begin(), select.end(), 1);
-        LOG(INFO) << "current selection: " << count << " points";
+        apply(model, hits, deselect);
+    }
+
+
+    void PointCloudPicker::apply(PointCloud *model, const SelectionSet &hits, bool deselect) {
+        // only the picked points are visited (32 points are skipped at a time if none of them is picked)
+        auto &select = model->vertex_property<bool>("v:select", false).vector();
+        hits.for_each([&select, deselect](std::size_t i) { select[i] = !deselect; });
+        LOG(INFO) << hits.count() << " points " << (deselect ? "deselected" : "selected");
     }
 
 }
@@ -35,6 +35,7 @@
 namespace easy3d {
 
     class ShaderProgram;
+    class SelectionSet;
 
     /**
      * \brief Implementation of picking points from a point cloud.
@@ -84,6 +85,9 @@ namespace easy3d {
         // pick sphere points implemented in GPU (using shader program)
         PointCloud::Vertex pick_vertex_gpu_sphere(PointCloud *model, int x, int y);
 
+        // marks the picked points (or unmarks them if deselect is true) in vertex property "v:select"
+        void apply(PointCloud *model, const SelectionSet &hits, bool deselect);
+
     private:
         unsigned int hit_resolution_;     // in pixels
         ShaderProgram*	 program_;
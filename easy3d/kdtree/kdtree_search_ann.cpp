@@ -28,6 +28,7 @@
 
 #include <easy3d/kdtree/kdtree_search_ann.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/util/tracing.h>
 
 #include <3rd_party/kdtree/ANN/ANN.h>
 
@@ -83,6 +84,7 @@ namespace easy3d {
 
 
     void KdTreeSearch_ANN::end()  {
+        EASY3D_TRACE_ZONE_CATEGORY("KdTreeSearch_ANN: build", "kdtree");
         tree_ = new ANNkd_tree(points_, points_num_, 3);
     }
 
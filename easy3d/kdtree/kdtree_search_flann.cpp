@@ -26,6 +26,7 @@
 
 #include <easy3d/kdtree/kdtree_search_flann.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/util/tracing.h>
 
 #include <3rd_party/kdtree/FLANN/flann.hpp>
 
@@ -60,6 +61,7 @@ namespace easy3d {
 
 
     void KdTreeSearch_FLANN::end()  {
+        EASY3D_TRACE_ZONE_CATEGORY("KdTreeSearch_FLANN: build", "kdtree");
         flann::Matrix<float> dataset(points_, points_num_, 3);
 
         // construct a single kd-tree optimized for searching lower dimensionality data
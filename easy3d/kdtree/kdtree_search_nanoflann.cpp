@@ -26,6 +26,7 @@
 
 #include <easy3d/kdtree/kdtree_search_nanoflann.h>
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/util/tracing.h>
 
 #include <3rd_party/kdtree/nanoflann/nanoflann.hpp>
 
@@ -89,6 +90,7 @@ namespace easy3d {
 
 
     void KdTreeSearch_NanoFLANN::end() {
+        EASY3D_TRACE_ZONE_CATEGORY("KdTreeSearch_NanoFLANN: build", "kdtree");
         PointSet* pset = new PointSet(points_);
         KdTree* tree = new KdTree(pset);
         tree->buildIndex();
@@ -0,0 +1,275 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/renderer/async_readback.h>
+
+#include <cstring>
+#include <algorithm>
+
+#include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/opengl_error.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+
+    AsyncReadback::AsyncReadback(const Consumer &consumer, unsigned int num_buffers)
+            : consumer_(consumer), slots_(std::max(num_buffers, 1u)), next_slot_(0), num_pending_(0)
+            , num_frames_(0), resolve_fbo_(nullptr), busy_(false), stopped_(false)
+    {
+        worker_ = std::thread(&AsyncReadback::work, this);
+    }
+
+
+    AsyncReadback::~AsyncReadback() {
+        finish();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        condition_.notify_all();
+        worker_.join();
+
+        for (auto &slot : slots_) {
+            if (slot.fence)
+                glDeleteSync(slot.fence);
+            if (slot.pbo)
+                glDeleteBuffers(1, &slot.pbo);
+        }
+        easy3d_debug_log_gl_error;
+        delete resolve_fbo_;
+    }
+
+
+    bool AsyncReadback::read_color(FramebufferObject *fbo, unsigned int index, unsigned int format, bool flip_vertically) {
+        if (!fbo || !fbo->has_color_attachment(index)) {
+            LOG(ERROR) << "color attachment " << index << " does not exist";
+            return false;
+        }
+
+        GLint read_fbo = 0, draw_fbo = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_fbo);     easy3d_debug_log_gl_error;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_fbo);     easy3d_debug_log_gl_error;
+
+        FramebufferObject *source = fbo;
+        if (fbo->samaples() > 0) {  // resolve the multisample framebuffer first
+            if (!resolve_fbo_) {
+                resolve_fbo_ = new FramebufferObject(fbo->width(), fbo->height(), 0);
+                resolve_fbo_->add_color_buffer();
+            } else
+                resolve_fbo_->ensure_size(fbo->width(), fbo->height());
+            FramebufferObject::blit_framebuffer(resolve_fbo_, fbo, 0, index, GL_COLOR_BUFFER_BIT);
+            source = resolve_fbo_;
+            index = 0;
+        }
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, source->handle());      easy3d_debug_log_gl_error;
+        glReadBuffer(GL_COLOR_ATTACHMENT0 + index);                     easy3d_debug_log_gl_error;
+        const bool status = start(0, 0, source->width(), source->height(), format, flip_vertically);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, read_fbo);               easy3d_debug_log_gl_error;
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_fbo);               easy3d_debug_log_gl_error;
+        return status;
+    }
+
+
+    bool AsyncReadback::read_color(unsigned int format, bool flip_vertically) {
+        int viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);                           easy3d_debug_log_gl_error;
+        return start(viewport[0], viewport[1], viewport[2], viewport[3], format, flip_vertically);
+    }
+
+
+    bool AsyncReadback::start(int x, int y, int w, int h, unsigned int format, bool flip_vertically) {
+        if (format != GL_RGB && format != GL_BGR && format != GL_RGBA && format != GL_BGRA) {
+            LOG(ERROR) << "to read color buffer, the format must be one of GL_RGB, GL_BGR, GL_RGBA, and GL_BGRA.";
+            return false;
+        }
+        if (w <= 0 || h <= 0) {
+            LOG(ERROR) << "invalid image size: " << w << " x " << h;
+            return false;
+        }
+
+        // hand over the frames that are ready, and make sure the next slot is free
+        collect(false);
+        while (num_pending_ == slots_.size())
+            collect(true);
+
+        Slot &slot = slots_[next_slot_];
+        // always read in GL_RGBA (the fast path of most drivers). The conversion is done by the worker.
+        const std::size_t size = static_cast<std::size_t>(w) * h * 4;
+        if (!slot.pbo)
+            glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);                   easy3d_debug_log_gl_error;
+        if (slot.size != size) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);  easy3d_debug_log_gl_error;
+            slot.size = size;
+        }
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);                            easy3d_debug_log_gl_error;
+        // with a pixel pack buffer bound, the last argument is the offset into the buffer
+        glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);   easy3d_debug_log_gl_error;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);                          easy3d_debug_log_gl_error;
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);     easy3d_debug_log_gl_error;
+        slot.width = w;
+        slot.height = h;
+        slot.format = format;
+        slot.flip = flip_vertically;
+        slot.frame = num_frames_++;
+
+        next_slot_ = (next_slot_ + 1) % slots_.size();
+        ++num_pending_;
+        return true;
+    }
+
+
+    void AsyncReadback::collect(bool wait) {
+        while (num_pending_ > 0) {
+            Slot &slot = slots_[(next_slot_ + slots_.size() - num_pending_) % slots_.size()];  // the oldest one
+
+            // make sure the fence will be signaled (i.e., the commands are flushed) before waiting for it
+            const GLuint64 timeout = wait ? 1000000000ull : 0;    // in nanoseconds
+            GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            while (wait && status == GL_TIMEOUT_EXPIRED)
+                status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            if (status == GL_TIMEOUT_EXPIRED)
+                return;     // not ready yet, and the later ones cannot be ready either
+            if (status == GL_WAIT_FAILED)
+                LOG(ERROR) << "failed waiting for the pixels of frame " << slot.frame;
+
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+            --num_pending_;
+
+            Job job;
+            job.width = slot.width;
+            job.height = slot.height;
+            job.format = slot.format;
+            job.flip = slot.flip;
+            job.frame = slot.frame;
+            job.rgba.resize(slot.size);
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);              easy3d_debug_log_gl_error;
+            const void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.size, GL_MAP_READ_BIT);
+            easy3d_debug_log_gl_error;
+            if (data) {
+                std::memcpy(job.rgba.data(), data, slot.size);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);                    easy3d_debug_log_gl_error;
+            } else
+                LOG(ERROR) << "failed mapping the pixels of frame " << slot.frame;
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);                      easy3d_debug_log_gl_error;
+
+            submit(std::move(job));
+            wait = false;   // we only need to wait for one
+        }
+    }
+
+
+    void AsyncReadback::submit(Job &&job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // limit the number of frames waiting for the consumer (in case it is slower than rendering)
+        condition_.wait(lock, [this]() { return jobs_.size() < slots_.size(); });
+        jobs_.push_back(std::move(job));
+        lock.unlock();
+        condition_.notify_all();
+    }
+
+
+    void AsyncReadback::finish() {
+        while (num_pending_ > 0)
+            collect(true);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return jobs_.empty() && !busy_; });
+    }
+
+
+    namespace details {
+
+        // flips the image (if required) and converts the pixels from RGBA to the requested format
+        void convert(const std::vector<unsigned char> &rgba, int w, int h, unsigned int format, bool flip,
+                     std::vector<unsigned char> &result)
+        {
+            const bool swap_rb = (format == GL_BGR || format == GL_BGRA);
+            const std::size_t channels = (format == GL_RGB || format == GL_BGR) ? 3 : 4;
+            const std::size_t src_row_size = static_cast<std::size_t>(w) * 4;
+            const std::size_t dst_row_size = static_cast<std::size_t>(w) * channels;
+            result.resize(dst_row_size * h);
+
+            for (int j = 0; j < h; ++j) {
+                const unsigned char *src = rgba.data() + (flip ? h - 1 - j : j) * src_row_size;
+                unsigned char *dst = result.data() + j * dst_row_size;
+                if (channels == 4 && !swap_rb)
+                    std::memcpy(dst, src, src_row_size);
+                else {
+                    for (int i = 0; i < w; ++i, src += 4, dst += channels) {
+                        dst[0] = src[swap_rb ? 2 : 0];
+                        dst[1] = src[1];
+                        dst[2] = src[swap_rb ? 0 : 2];
+                        if (channels == 4)
+                            dst[3] = src[3];
+                    }
+                }
+            }
+        }
+
+    }
+
+
+    void AsyncReadback::work() {
+        std::vector<unsigned char> pixels;
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this]() { return stopped_ || !jobs_.empty(); });
+                if (jobs_.empty())
+                    return;     // stopped
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+                busy_ = true;
+            }
+            condition_.notify_all();    // a job can be submitted now
+
+            if (job.format == GL_RGBA && !job.flip)
+                pixels.swap(job.rgba);
+            else
+                details::convert(job.rgba, job.width, job.height, job.format, job.flip, pixels);
+            if (consumer_)
+                consumer_(job.frame, pixels, job.width, job.height);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                busy_ = false;
+            }
+            condition_.notify_all();
+        }
+    }
+
+}
@@ -0,0 +1,172 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_RENDERER_ASYNC_READBACK_H
+#define EASY3D_RENDERER_ASYNC_READBACK_H
+
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <easy3d/renderer/opengl.h>
+
+
+namespace easy3d {
+
+    class FramebufferObject;
+
+    /**
+     * \brief Asynchronous, pipelined readback of rendered images.
+     * \class AsyncReadback easy3d/renderer/async_readback.h
+     * \details Reading the pixels with glReadPixels() into client memory (e.g., FramebufferObject::read_color())
+     *      stalls the CPU until the GPU has finished rendering and the data has been transferred. When many frames
+     *      are read in a row (e.g., recording a video or rendering a large image in tiles), AsyncReadback avoids the
+     *      stalls by reading into a ring of pixel buffer objects (PBOs). A fence is inserted after each read, and the
+     *      pixels of a frame are only mapped when the fence has been signaled, i.e., frame N's pixels are transferred
+     *      while frame N+1 is being rendered. The vertical flip and the conversion to the requested format are done on
+     *      a worker thread, which then hands the pixels to the consumer (e.g., for saving the image or encoding the
+     *      video), in the order of the frames.
+     *
+     *      Example usage:
+     *      \code
+     *          AsyncReadback readback([](std::size_t frame, std::vector<unsigned char>& pixels, int w, int h) {
+     *              ImageIO::save("frame-" + std::to_string(frame) + ".png", pixels, w, h, 4);
+     *          });
+     *          for (...) {
+     *              fbo.bind();
+     *              // draw the frame...
+     *              fbo.release();
+     *              readback.read_color(&fbo, 0, GL_RGBA);  // returns immediately
+     *          }
+     *          readback.finish();  // waits until all the frames have been consumed
+     *      \endcode
+     *
+     * \note All the functions (including the destructor) must be called with the same OpenGL context current, except
+     *      that the consumer is called on the worker thread (and it must not make any OpenGL calls).
+     */
+    class AsyncReadback {
+    public:
+        /**
+         * The function consuming the pixels of a frame. It is called on the worker thread.
+         * \param frame The index of the frame, i.e., the number of reads before this one.
+         * \param pixels The pixels in the requested format. The consumer can take them over (e.g., by swapping).
+         * \param width/height The size of the image.
+         */
+        typedef std::function<void(std::size_t frame, std::vector<unsigned char> &pixels, int width, int height)> Consumer;
+
+        /**
+         * \brief Constructor.
+         * \param consumer The function consuming the pixels of each frame.
+         * \param num_buffers The number of pixel buffer objects, i.e., the number of frames that can be in flight.
+         */
+        explicit AsyncReadback(const Consumer &consumer, unsigned int num_buffers = 3);
+
+        /// Destructor. It waits for all the pending frames to be consumed (see finish()).
+        ~AsyncReadback();
+
+        /**
+         * \brief Starts reading the pixels of a color attachment of a framebuffer object. It returns immediately.
+         * \param fbo The framebuffer object, which can also be a multisample one (then it is resolved first).
+         * \param index The index of the color attachment.
+         * \param format The format of the pixels, which must be one of GL_RGB, GL_BGR, GL_RGBA, and GL_BGRA.
+         * \param flip_vertically If true, the first row of the pixels will be the top of the image.
+         * \return false if the readback could not be started (e.g., the attachment does not exist).
+         */
+        bool read_color(FramebufferObject *fbo, unsigned int index, unsigned int format, bool flip_vertically = true);
+
+        /**
+         * \brief Starts reading the pixels of the current read framebuffer (within the viewport). It returns
+         *      immediately. This is for framebuffers not managed by FramebufferObject. The current read framebuffer
+         *      must not be a multisample one.
+         * \param format The format of the pixels, which must be one of GL_RGB, GL_BGR, GL_RGBA, and GL_BGRA.
+         * \param flip_vertically If true, the first row of the pixels will be the top of the image.
+         */
+        bool read_color(unsigned int format, bool flip_vertically = true);
+
+        /// Waits until all the pending frames have been read back and consumed.
+        void finish();
+
+        /// Returns the number of frames that have been requested so far.
+        std::size_t num_frames() const { return num_frames_; }
+
+    private:
+        // a pixel buffer object and the fence of the read into it
+        struct Slot {
+            GLuint pbo = 0;
+            GLsync fence = nullptr;
+            std::size_t size = 0;   // the allocated size of the pbo
+            int width = 0, height = 0;
+            unsigned int format = 0;
+            bool flip = false;
+            std::size_t frame = 0;
+        };
+
+        // the pixels (in GL_RGBA) of a frame to be flipped, converted, and consumed by the worker
+        struct Job {
+            std::vector<unsigned char> rgba;
+            int width = 0, height = 0;
+            unsigned int format = 0;
+            bool flip = false;
+            std::size_t frame = 0;
+        };
+
+        bool start(int x, int y, int w, int h, unsigned int format, bool flip_vertically);
+        // moves the frames whose pixels are available to the worker (in order). If wait is true, it waits for the
+        // oldest one even if it is not available yet.
+        void collect(bool wait);
+        void submit(Job &&job);
+        void work();
+
+    private:
+        Consumer consumer_;
+        std::vector<Slot> slots_;
+        std::size_t next_slot_;     // the slot for the next read
+        std::size_t num_pending_;   // the number of slots in flight
+        std::size_t num_frames_;
+        FramebufferObject *resolve_fbo_;
+
+        // worker
+        std::thread worker_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::deque<Job> jobs_;
+        bool busy_;
+        bool stopped_;
+
+    private:
+        //copying disabled
+        AsyncReadback(const AsyncReadback &);
+        AsyncReadback &operator=(const AsyncReadback &);
+    };
+
+}
+
+
+#endif  // EASY3D_RENDERER_ASYNC_READBACK_H
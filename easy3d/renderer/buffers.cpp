@@ -27,17 +27,21 @@
 #include <easy3d/renderer/buffers.h>
 
 #include <algorithm>
+#include <list>
+#include <mutex>
 
 #include <easy3d/core/graph.h>
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/core/poly_mesh.h>
+#include <easy3d/core/scalar_statistics.h>
 #include <easy3d/renderer/renderer.h>
 #include <easy3d/renderer/drawable_points.h>
 #include <easy3d/renderer/drawable_lines.h>
 #include <easy3d/renderer/drawable_triangles.h>
 #include <easy3d/renderer/texture_manager.h>
 #include <easy3d/algo/tessellator.h>
+#include <easy3d/util/tracing.h>
 
 
 namespace easy3d {
@@ -47,52 +51,162 @@ namespace easy3d {
 
         namespace details {
 
+            // The buffers of every drawable of a model are updated from the points and normals of its vertices, so
+            // these two properties are looked up by the handles cached by the renderer of the model (if any).
+            template<typename MODEL>
+            inline typename MODEL::template VertexProperty<vec3> vertex_points(MODEL *model) {
+                if (model->renderer()) {
+                    const auto prop = model->renderer()->cached_points().get(model->vertex_property_container());
+                    return typename MODEL::template VertexProperty<vec3>(prop);
+                }
+                return model->template get_vertex_property<vec3>("v:point");
+            }
+
+            template<typename MODEL>
+            inline typename MODEL::template VertexProperty<vec3> vertex_normals(MODEL *model) {
+                if (model->renderer()) {
+                    const auto prop = model->renderer()->cached_normals().get(model->vertex_property_container());
+                    return typename MODEL::template VertexProperty<vec3>(prop);
+                }
+                return model->template get_vertex_property<vec3>("v:normal");
+            }
+
+
+            // The statistics of the scalar fields are cached, so changing the clamp range or switching between
+            // scalar fields doesn't recompute them. An entry is identified by the stamp of the property container
+            // (which is unique and changes whenever a property is added, removed, or renamed) and the name, type,
+            // and size of the property. The values are not checked, so the entries of a model are discarded when its
+            // data changes, i.e., by invalidate_statistics() (called in Renderer::update() and Drawable::update()).
+            struct StatisticsEntry {
+                std::size_t stamp;
+                std::string name;
+                const std::type_info *type;
+                std::size_t size;
+                ScalarStatistics statistics;
+            };
+
+            const std::size_t max_cached_statistics = 16;
+
+            inline std::mutex &statistics_mutex() {
+                static std::mutex mutex;
+                return mutex;
+            }
+
+            inline std::list<StatisticsEntry> &statistics_cache() {  // the most recently used is at the front
+                static std::list<StatisticsEntry> cache;
+                return cache;
+            }
+
+            template<typename FT>
+            inline ScalarStatistics statistics(const PropertyContainer &container, const Property<FT> &property) {
+                const std::vector<FT> &values = property.vector();
+                {
+                    std::lock_guard<std::mutex> lock(statistics_mutex());
+                    auto &cache = statistics_cache();
+                    for (auto it = cache.begin(); it != cache.end(); ++it) {
+                        if (it->stamp == container.stamp() && it->name == property.name() &&
+                            *it->type == typeid(FT) && it->size == values.size()) {
+                            cache.splice(cache.begin(), cache, it);
+                            return cache.front().statistics;
+                        }
+                    }
+                }
+
+                StatisticsEntry entry{container.stamp(), property.name(), &typeid(FT), values.size(),
+                                      ScalarStatistics(values)};
+                std::lock_guard<std::mutex> lock(statistics_mutex());
+                auto &cache = statistics_cache();
+                cache.push_front(entry);
+                if (cache.size() > max_cached_statistics)
+                    cache.pop_back();
+                return entry.statistics;
+            }
+
+            // discards the cached statistics of the properties in the given containers
+            inline void invalidate_statistics(const std::vector<const PropertyContainer *> &containers) {
+                std::lock_guard<std::mutex> lock(statistics_mutex());
+                statistics_cache().remove_if([&containers](const StatisticsEntry &entry) -> bool {
+                    for (auto c : containers) {
+                        if (c->stamp() == entry.stamp)
+                            return true;
+                    }
+                    return false;
+                });
+            }
+
+
             // clamps scalar field values by the percentages specified by dummy_lower and dummy_upper.
             // min_value and max_value return the expected value range.
-            template<typename FT>
             inline void
-            clamp_scalar_field(const std::vector<FT> &property, float &min_value, float &max_value,
+            clamp_scalar_field(const ScalarStatistics &stats, bool boolean, float &min_value, float &max_value,
                                float dummy_lower_percent,
                                float dummy_upper_percent) {
-                if (property.empty()) {
-                    LOG(WARNING) << "empty property";
+                if (stats.empty()) {
+                    LOG(WARNING) << "property has no finite values";
                     return;
                 }
 
-                // sort curvature values
-                std::vector<FT> values = property;;
-                std::sort(values.begin(), values.end());
-
-                const std::size_t n = values.size() - 1;
-                const std::size_t index_lower = n * dummy_lower_percent;
-                const std::size_t index_upper = n - n * dummy_upper_percent;
-
-                min_value = values[index_lower];
-                max_value = values[index_upper];
+                min_value = stats.quantile(dummy_lower_percent);
+                max_value = stats.quantile(1.0f - dummy_upper_percent);
                 if (min_value >= max_value) { // if so, we cannot clamp
-                    min_value = values.front();
-                    max_value = values.back();
+                    min_value = stats.min();
+                    max_value = stats.max();
                 }
 
                 // special treatment for boolean scalar fields if the values are the same
-                if (min_value >= max_value && typeid(FT) == typeid(bool)) {
+                if (min_value >= max_value && boolean) {
                     min_value = 0.0f;
                     max_value = 1.0f;
                 }
 
                 const int lower = static_cast<int>(dummy_lower_percent * 100);
                 const int upper = static_cast<int>(dummy_upper_percent * 100);
-                if ((lower > 0 || upper > 0) && values.front() < values.back())
-                    LOG(INFO) << "scalar field range ["
-                              << static_cast<float>(values.front()) << ", " << static_cast<float>(values.back()) << "]"
+                if ((lower > 0 || upper > 0) && stats.min() < stats.max())
+                    LOG(INFO) << "scalar field range [" << stats.min() << ", " << stats.max() << "]"
                               << " clamped (" << lower << "%, " << upper << "%) to [" << min_value << ", " << max_value
                               << "]";
             }
 
 
-            template<typename MODEL, typename FT>
+            template<typename FT>
             inline void
-            update_scalar_on_vertices(MODEL *model, PointsDrawable *drawable, typename MODEL::template VertexProperty<FT> prop) {
+            clamp_scalar_field(const PropertyContainer &container, const Property<FT> &property,
+                               float &min_value, float &max_value,
+                               float dummy_lower_percent,
+                               float dummy_upper_percent) {
+                if (property.vector().empty()) {
+                    LOG(WARNING) << "empty property";
+                    return;
+                }
+                clamp_scalar_field(statistics(container, property), typeid(FT) == typeid(bool), min_value, max_value,
+                                   dummy_lower_percent, dummy_upper_percent);
+            }
+
+
+            // the statistics of a computed property are not cached, because its values are not stored (so they may
+            // change without notice). They are computed without materializing the values.
+            template<typename FT>
+            inline void
+            clamp_scalar_field(const PropertyContainer &, const ComputedProperty<FT> &property,
+                               float &min_value, float &max_value,
+                               float dummy_lower_percent,
+                               float dummy_upper_percent) {
+                if (property.size() == 0) {
+                    LOG(WARNING) << "empty property";
+                    return;
+                }
+                const ScalarStatistics stats(property.size(), [&property](std::size_t i) -> float {
+                    return static_cast<float>(property[i]);
+                });
+                clamp_scalar_field(stats, typeid(FT) == typeid(bool), min_value, max_value,
+                                   dummy_lower_percent, dummy_upper_percent);
+            }
+
+
+            // PROP is a vertex property or a computed property of the vertices
+            template<typename MODEL, typename PROP>
+            inline void
+            update_scalar_on_vertices(MODEL *model, PointsDrawable *drawable, PROP prop) {
                 assert(model);
                 assert(drawable);
                 assert(prop);
@@ -106,9 +220,9 @@ namespace easy3d {
                 const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                 float min_value = std::numeric_limits<float>::max();
                 float max_value = -std::numeric_limits<float>::max();
-                details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                details::clamp_scalar_field(model->vertex_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
 
                 std::vector<vec2> d_texcoords;
                 d_texcoords.reserve(model->n_vertices());
@@ -119,15 +233,16 @@ namespace easy3d {
                 drawable->update_vertex_buffer(points.vector());
                 drawable->update_texcoord_buffer(d_texcoords);
 
-                auto normals = model->template get_vertex_property<vec3>("v:normal");
+                auto normals = details::vertex_normals(model);
                 if (normals)
                     drawable->update_normal_buffer(normals.vector());
             }
 
 
-            template<typename MODEL, typename FT>
+            // PROP is an edge property or a computed property of the edges
+            template<typename MODEL, typename PROP>
             inline void
-            update_scalar_on_edges(MODEL *model, LinesDrawable *drawable, typename MODEL::template EdgeProperty<FT> prop) {
+            update_scalar_on_edges(MODEL *model, LinesDrawable *drawable, PROP prop) {
                 assert(model);
                 assert(drawable);
                 assert(prop);
@@ -141,9 +256,9 @@ namespace easy3d {
                 const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                 float min_value = std::numeric_limits<float>::max();
                 float max_value = -std::numeric_limits<float>::max();
-                details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                details::clamp_scalar_field(model->edge_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 std::vector<vec3> d_points;
                 d_points.reserve(model->n_edges() * 2);
                 std::vector<vec2> d_texcoords;
@@ -163,9 +278,10 @@ namespace easy3d {
             }
 
 
-            template<typename MODEL, typename FT>
+            // PROP is a vertex property or a computed property of the vertices
+            template<typename MODEL, typename PROP>
             inline void
-            update_scalar_on_vertices(MODEL *model, LinesDrawable *drawable, typename MODEL::template VertexProperty<FT> prop) {
+            update_scalar_on_vertices(MODEL *model, LinesDrawable *drawable, PROP prop) {
                 assert(model);
                 assert(drawable);
                 assert(prop);
@@ -179,9 +295,9 @@ namespace easy3d {
                 const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                 float min_value = std::numeric_limits<float>::max();
                 float max_value = -std::numeric_limits<float>::max();
-                details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                details::clamp_scalar_field(model->vertex_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 drawable->update_vertex_buffer(points.vector());
 
                 std::vector<vec2> d_texcoords;
@@ -204,9 +320,10 @@ namespace easy3d {
             }
 
 
-            template<typename FT>
+            // PROP is a face property or a computed property of the faces
+            template<typename PROP>
             inline void
-            update_scalar_on_faces(SurfaceMesh *model, TrianglesDrawable *drawable, SurfaceMesh::FaceProperty<FT> prop) {
+            update_scalar_on_faces(SurfaceMesh *model, TrianglesDrawable *drawable, PROP prop) {
                 assert(model);
                 assert(drawable);
                 assert(prop);
@@ -217,15 +334,15 @@ namespace easy3d {
                 }
 
                 if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
                     const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                     float min_value = std::numeric_limits<float>::max();
                     float max_value = -std::numeric_limits<float>::max();
-                    details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                    details::clamp_scalar_field(model->face_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
                     std::vector<vec3> d_points, d_normals;
                     std::vector<vec2> d_texcoords;
@@ -275,15 +392,15 @@ namespace easy3d {
                      * between flat and smooth shading without transferring different data to the GPU.
                      */
 
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
                     const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                     float min_value = std::numeric_limits<float>::max();
                     float max_value = -std::numeric_limits<float>::max();
-                    details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                    details::clamp_scalar_field(model->face_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
                     std::vector<vec3> d_points, d_normals;
                     std::vector<vec2> d_texcoords;
@@ -339,9 +456,10 @@ namespace easy3d {
             }
 
 
-            template<typename FT>
+            // PROP is a vertex property or a computed property of the vertices
+            template<typename PROP>
             inline void
-            update_scalar_on_vertices(SurfaceMesh *model, TrianglesDrawable *drawable, SurfaceMesh::VertexProperty<FT> prop) {
+            update_scalar_on_vertices(SurfaceMesh *model, TrianglesDrawable *drawable, PROP prop) {
                 assert(model);
                 assert(drawable);
                 assert(prop);
@@ -352,15 +470,15 @@ namespace easy3d {
                 }
 
                 if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
                     const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                     float min_value = std::numeric_limits<float>::max();
                     float max_value = -std::numeric_limits<float>::max();
-                    details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                    details::clamp_scalar_field(model->vertex_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
                     std::vector<vec2> d_texcoords;
                     d_texcoords.reserve(model->n_vertices());
@@ -414,15 +532,15 @@ namespace easy3d {
                      * between flat and smooth shading without transferring different data to the GPU.
                      */
 
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
                     const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                     float min_value = std::numeric_limits<float>::max();
                     float max_value = -std::numeric_limits<float>::max();
-                    details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                    details::clamp_scalar_field(model->vertex_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
                     for (auto face : model->faces()) {
                         tessellator.begin_polygon(model->compute_face_normal(face));
@@ -483,7 +601,7 @@ namespace easy3d {
                 }
 
                 model->update_vertex_normals();
-                auto normals = model->get_vertex_property<vec3>("v:normal");
+                auto normals = details::vertex_normals(model);
 
                 // since we have two parts, no need to transfer all vertices and normals
                 // I just use the tessellator
@@ -559,8 +677,8 @@ namespace easy3d {
                 }
 
                 model->update_vertex_normals();
-                auto normals = model->get_vertex_property<vec3>("v:normal");
-                auto points = model->get_vertex_property<vec3>("v:point");
+                auto normals = details::vertex_normals(model);
+                auto points = details::vertex_points(model);
 
                 /**
                  * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
@@ -622,8 +740,8 @@ namespace easy3d {
                 }
 
                 model->update_vertex_normals();
-                auto normals = model->get_vertex_property<vec3>("v:normal");
-                auto points = model->get_vertex_property<vec3>("v:point");
+                auto normals = details::vertex_normals(model);
+                auto points = details::vertex_points(model);
 
                 /**
                  * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
@@ -686,8 +804,8 @@ namespace easy3d {
                 }
 
                 model->update_vertex_normals();
-                auto normals = model->get_vertex_property<vec3>("v:normal");
-                auto points = model->get_vertex_property<vec3>("v:point");
+                auto normals = details::vertex_normals(model);
+                auto points = details::vertex_points(model);
 
                 /**
                  * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
@@ -750,14 +868,14 @@ namespace easy3d {
                 }
 
                 model->update_vertex_normals();
-                auto normals = model->get_vertex_property<vec3>("v:normal");
-                auto points = model->get_vertex_property<vec3>("v:point");
+                auto normals = details::vertex_normals(model);
+                auto points = details::vertex_points(model);
 
                 const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
                 const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                 float min_value = std::numeric_limits<float>::max();
                 float max_value = -std::numeric_limits<float>::max();
-                details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                details::clamp_scalar_field(model->vertex_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
                 /**
                  * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
@@ -821,14 +939,14 @@ namespace easy3d {
                 }
 
                 model->update_vertex_normals();
-                auto normals = model->get_vertex_property<vec3>("v:normal");
-                auto points = model->get_vertex_property<vec3>("v:point");
+                auto normals = details::vertex_normals(model);
+                auto points = details::vertex_points(model);
 
                 const float dummy_lower = (drawable->clamp_range() ? drawable->clamp_lower() : 0.0f);
                 const float dummy_upper = (drawable->clamp_range() ? drawable->clamp_upper() : 0.0f);
                 float min_value = std::numeric_limits<float>::max();
                 float max_value = -std::numeric_limits<float>::max();
-                details::clamp_scalar_field(prop.vector(), min_value, max_value, dummy_lower, dummy_upper);
+                details::clamp_scalar_field(model->face_property_container(), prop, min_value, max_value, dummy_lower, dummy_upper);
 
                 /**
                  * We use the Tessellator to eliminate duplicate vertices. This allows us to take advantage of element
@@ -890,11 +1008,11 @@ namespace easy3d {
                     return;
                 }
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 drawable->update_vertex_buffer(points.vector());
                 drawable->update_color_buffer(prop.vector());
 
-                auto normals = model->template get_vertex_property<vec3>("v:normal");
+                auto normals = details::vertex_normals(model);
                 if (normals)
                     drawable->update_normal_buffer(normals.vector());
             }
@@ -911,11 +1029,11 @@ namespace easy3d {
                     return;
                 }
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 drawable->update_vertex_buffer(points.vector());
                 drawable->update_texcoord_buffer(prop.vector());
 
-                auto normals = model->template get_vertex_property<vec3>("v:normal");
+                auto normals = details::vertex_normals(model);
                 if (normals)
                     drawable->update_normal_buffer(normals.vector());
             }
@@ -932,7 +1050,7 @@ namespace easy3d {
 
                 if (model->is_triangle_mesh()) {
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     std::vector<unsigned int> d_indices;
                     d_indices.reserve(model->n_faces() * 3);
@@ -977,9 +1095,9 @@ namespace easy3d {
                      * between flat and smooth shading without transferring different data to the GPU.
                      */
 
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     for (auto face : model->faces()) {
                         tessellator.begin_polygon(model->compute_face_normal(face));
@@ -1034,9 +1152,9 @@ namespace easy3d {
                 }
 
                 if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     std::vector<vec3> d_points, d_normals, d_colors;
                     d_points.reserve(model->n_faces() * 3);
@@ -1090,9 +1208,9 @@ namespace easy3d {
                      * between flat and smooth shading without transferring different data to the GPU.
                      */
 
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     for (auto face : model->faces()) {
                         tessellator.begin_polygon(model->compute_face_normal(face));
@@ -1153,9 +1271,9 @@ namespace easy3d {
                 }
 
                 if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     std::vector<unsigned int> d_indices;
                     d_indices.reserve(model->n_faces() * 3);
@@ -1201,9 +1319,9 @@ namespace easy3d {
                      * Then, by adding a boolean uniform 'smooth_shading' to the fragment shader, client code can easily switch
                      * between flat and smooth shading without transferring different data to the GPU.
                      */
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     for (auto face : model->faces()) {
                         tessellator.begin_polygon(model->compute_face_normal(face));
@@ -1264,9 +1382,9 @@ namespace easy3d {
                 }
 
                 if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     std::vector<unsigned int> d_indices;
                     d_indices.reserve(model->n_faces() * 3);
@@ -1313,9 +1431,9 @@ namespace easy3d {
                      * between flat and smooth shading without transferring different data to the GPU.
                      */
 
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     for (auto face : model->faces()) {
                         tessellator.begin_polygon(model->compute_face_normal(face));
@@ -1377,9 +1495,9 @@ namespace easy3d {
                 }
 
                 if (model->is_triangle_mesh()) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     std::vector<vec3> d_points, d_normals;
                     std::vector<vec2> d_texcoords;
@@ -1433,9 +1551,9 @@ namespace easy3d {
                      * between flat and smooth shading without transferring different data to the GPU.
                      */
 
-                    auto points = model->get_vertex_property<vec3>("v:point");
+                    auto points = details::vertex_points(model);
                     model->update_vertex_normals();
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto normals = details::vertex_normals(model);
 
                     for (auto face : model->faces()) {
                         tessellator.begin_polygon(model->compute_face_normal(face));
@@ -1496,7 +1614,7 @@ namespace easy3d {
                     return;
                 }
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 std::vector<vec3> d_points, d_colors;
                 d_points.reserve(model->n_edges() * 2);
                 d_colors.reserve(model->n_edges() * 2);
@@ -1526,7 +1644,7 @@ namespace easy3d {
                     return;
                 }
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 std::vector<vec3> d_points, d_colors;
                 d_points.reserve(model->n_edges() * 2);
                 d_colors.reserve(model->n_edges() * 2);
@@ -1556,7 +1674,7 @@ namespace easy3d {
                     return;
                 }
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 std::vector<vec3> d_points;
                 d_points.reserve(model->n_edges() * 2);
                 std::vector<vec2> d_texcoords;
@@ -1585,7 +1703,7 @@ namespace easy3d {
                     return;
                 }
 
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 std::vector<vec3> d_points;
                 d_points.reserve(model->n_edges() * 2);
                 std::vector<vec2> d_texcoords;
@@ -1610,7 +1728,7 @@ namespace easy3d {
                     return;
                 }
 
-                auto prop = model->get_vertex_property<vec3>("v:point");
+                auto prop = details::vertex_points(model);
                 std::vector<vec3> points;
                 points.reserve(model->n_edges() * 2);
                 for (auto e : model->edges()) {
@@ -1631,8 +1749,8 @@ namespace easy3d {
 
                 auto locked = model->get_vertex_property<bool>("v:locked");
                 if (locked) {
-                    auto points = model->get_vertex_property<vec3>("v:point");
-                    auto normals = model->get_vertex_property<vec3>("v:normal");
+                    auto points = details::vertex_points(model);
+                    auto normals = details::vertex_normals(model);
                     std::vector<vec3> d_points, d_normals;
                     for (auto v : model->vertices()) {
                         if (locked[v]) {
@@ -1649,9 +1767,9 @@ namespace easy3d {
 
             template<typename MODEL>
             void update_uniform_colors(MODEL *model, PointsDrawable *drawable) {
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 drawable->update_vertex_buffer(points.vector());
-                auto normals = model->template get_vertex_property<vec3>("v:normal");
+                auto normals = details::vertex_normals(model);
                 if (normals)
                     drawable->update_normal_buffer(normals.vector());
             }
@@ -1667,7 +1785,7 @@ namespace easy3d {
                     indices.push_back(s.idx());
                     indices.push_back(t.idx());
                 }
-                auto points = model->template get_vertex_property<vec3>("v:point");
+                auto points = details::vertex_points(model);
                 drawable->update_vertex_buffer(points.vector());
                 drawable->update_element_buffer(indices);
             }
@@ -1757,9 +1875,10 @@ namespace easy3d {
             }
 
 
+            // looks up the scalar field 'name' among the vertex properties (including the computed ones)
             template<typename MODEL, typename DRAWABLE>
             inline void
-            update_scalar_on_vertices(MODEL *model, DRAWABLE *drawable, const std::string &name) {
+            update_scalar_field_on_vertices(MODEL *model, DRAWABLE *drawable, const std::string &name) {
                 if (model->template get_vertex_property<float>(name)) {
                     auto prop = model->template get_vertex_property<float>(name);
                     details::update_scalar_on_vertices<MODEL>(model, drawable, prop);
@@ -1781,6 +1900,12 @@ namespace easy3d {
                 } else if (model->template get_vertex_property<bool>(name)) {
                     auto prop = model->template get_vertex_property<bool>(name);
                     details::update_scalar_on_vertices<MODEL>(model, drawable, prop);
+                } else if (model->vertex_property_container().template get_computed<float>(name)) {
+                    auto prop = model->vertex_property_container().template get_computed<float>(name);
+                    details::update_scalar_on_vertices<MODEL>(model, drawable, prop);
+                } else if (model->vertex_property_container().template get_computed<double>(name)) {
+                    auto prop = model->vertex_property_container().template get_computed<double>(name);
+                    details::update_scalar_on_vertices<MODEL>(model, drawable, prop);
                 } else {
                     LOG(WARNING) << "scalar field \'" << name
                                  << "\' not found from vertex properties (use uniform coloring)";
@@ -1790,9 +1915,10 @@ namespace easy3d {
             }
 
 
+            // looks up the scalar field 'name' among the edge properties (including the computed ones)
             template<typename MODEL>
             inline void
-            update_scalar_on_edges(MODEL *model, LinesDrawable *drawable, const std::string &name) {
+            update_scalar_field_on_edges(MODEL *model, LinesDrawable *drawable, const std::string &name) {
                 if (model->template get_edge_property<float>(name)) {
                     auto prop = model->template get_edge_property<float>(name);
                     details::update_scalar_on_edges<MODEL>(model, drawable, prop);
@@ -1814,6 +1940,12 @@ namespace easy3d {
                 } else if (model->template get_edge_property<bool>(name)) {
                     auto prop = model->template get_edge_property<bool>(name);
                     details::update_scalar_on_edges<MODEL>(model, drawable, prop);
+                } else if (model->edge_property_container().template get_computed<float>(name)) {
+                    auto prop = model->edge_property_container().template get_computed<float>(name);
+                    details::update_scalar_on_edges<MODEL>(model, drawable, prop);
+                } else if (model->edge_property_container().template get_computed<double>(name)) {
+                    auto prop = model->edge_property_container().template get_computed<double>(name);
+                    details::update_scalar_on_edges<MODEL>(model, drawable, prop);
                 } else {
                     LOG(WARNING) << "scalar field \'" << name
                                  << "\' not found from edge properties (use uniform coloring)";
@@ -1872,10 +2004,10 @@ namespace easy3d {
                     case State::SCALAR_FIELD: {
                         switch (drawable->property_location()) {
                             case State::EDGE:
-                                details::update_scalar_on_edges<MODEL>(model, drawable, name);
+                                details::update_scalar_field_on_edges<MODEL>(model, drawable, name);
                                 break;
                             case State::VERTEX:
-                                details::update_scalar_on_vertices<MODEL>(model, drawable, name);
+                                details::update_scalar_field_on_vertices<MODEL>(model, drawable, name);
                                 break;
                             case State::FACE:
                             case State::HALFEDGE:
@@ -1915,7 +2047,7 @@ namespace easy3d {
                         break;
 
                     case State::SCALAR_FIELD:
-                        details::update_scalar_on_vertices<MODEL>(model, drawable, name);
+                        details::update_scalar_field_on_vertices<MODEL>(model, drawable, name);
                         break;
 
                     default:  // uniform color
@@ -1934,11 +2066,13 @@ namespace easy3d {
 
 
         void update(PointCloud *model, PointsDrawable *drawable) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(PointCloud, points)", "renderer");
             details::update<PointCloud>(model, drawable);
         }
 
 
         void update(PointCloud *model, LinesDrawable *drawable, const std::string &field, float scale) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(PointCloud, vector field)", "renderer");
             if (model->empty()) {
                 LOG(WARNING) << "model has no valid geometry";
                 return;
@@ -1950,7 +2084,7 @@ namespace easy3d {
                 return;
             }
 
-            auto points = model->get_vertex_property<vec3>("v:point");
+            auto points = details::vertex_points(model);
             float length = model->bounding_box().diagonal_length() * 0.5f * 0.01f * scale;
 
             std::vector<vec3> vertices(model->n_vertices() * 2, vec3(0.0f, 0.0f, 0.0f));
@@ -1968,6 +2102,7 @@ namespace easy3d {
 
 
         void update(SurfaceMesh *model, PointsDrawable *drawable) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(SurfaceMesh, points)", "renderer");
             if (drawable->name() == "locks") {
                 details::update_mesh_locked_vertices(model, drawable);
                 return;
@@ -1980,6 +2115,7 @@ namespace easy3d {
 
 
         void update(SurfaceMesh *model, LinesDrawable *drawable) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(SurfaceMesh, lines)", "renderer");
             if (drawable->name() == "borders") {
                 details::update_mesh_borders(model, drawable);
                 return;
@@ -1990,6 +2126,7 @@ namespace easy3d {
 
 
         void update(SurfaceMesh *model, LinesDrawable *drawable, const std::string &field, State::Location location, float scale) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(SurfaceMesh, vector field)", "renderer");
             if (model->empty()) {
                 LOG(WARNING) << "model has no valid geometry";
                 return;
@@ -2019,7 +2156,7 @@ namespace easy3d {
                     return;
             }
 
-            auto points = model->get_vertex_property<vec3>("v:point");
+            auto points = details::vertex_points(model);
 
             // use a limited number of edge to compute the length of the vectors.
             float avg_edge_length = 0.0f;
@@ -2083,6 +2220,7 @@ namespace easy3d {
 
 
         void update(SurfaceMesh *model, TrianglesDrawable *drawable) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(SurfaceMesh, triangles)", "renderer");
             assert(model);
             assert(drawable);
 
@@ -2189,6 +2327,12 @@ namespace easy3d {
                             } else if (model->get_face_property<bool>(name)) {
                                 auto prop = model->get_face_property<bool>(name);
                                 details::update_scalar_on_faces(model, drawable, prop);
+                            } else if (model->face_property_container().get_computed<float>(name)) {
+                                auto prop = model->face_property_container().get_computed<float>(name);
+                                details::update_scalar_on_faces(model, drawable, prop);
+                            } else if (model->face_property_container().get_computed<double>(name)) {
+                                auto prop = model->face_property_container().get_computed<double>(name);
+                                details::update_scalar_on_faces(model, drawable, prop);
                             } else {
                                 LOG(WARNING) << "scalar field \'" << name
                                              << "\' not found on faces (use uniform coloring)";
@@ -2220,6 +2364,12 @@ namespace easy3d {
                             } else if (model->get_vertex_property<bool>(name)) {
                                 auto prop = model->get_vertex_property<bool>(name);
                                 details::update_scalar_on_vertices(model, drawable, prop);
+                            } else if (model->vertex_property_container().get_computed<float>(name)) {
+                                auto prop = model->vertex_property_container().get_computed<float>(name);
+                                details::update_scalar_on_vertices(model, drawable, prop);
+                            } else if (model->vertex_property_container().get_computed<double>(name)) {
+                                auto prop = model->vertex_property_container().get_computed<double>(name);
+                                details::update_scalar_on_vertices(model, drawable, prop);
                             } else {
                                 LOG(WARNING) << "scalar field \'" << name
                                              << "\' not found on vertices (use uniform coloring)";
@@ -2253,11 +2403,13 @@ namespace easy3d {
 
 
         void update(Graph *model, PointsDrawable *drawable) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(Graph, points)", "renderer");
             details::update<Graph>(model, drawable);
         }
 
 
         void update(Graph *model, LinesDrawable *drawable) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(Graph, lines)", "renderer");
             details::update<Graph>(model, drawable);
         }
 
@@ -2266,16 +2418,19 @@ namespace easy3d {
 
 
         void update(PolyMesh* model, PointsDrawable* drawable) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(PolyMesh, points)", "renderer");
             details::update<PolyMesh>(model, drawable);
         }
 
 
         void update(PolyMesh* model, LinesDrawable* drawable) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(PolyMesh, lines)", "renderer");
             details::update<PolyMesh>(model, drawable);
         }
 
 
         void update(PolyMesh *model, TrianglesDrawable *drawable, bool border) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(PolyMesh, triangles)", "renderer");
             assert(model);
             assert(drawable);
 
@@ -2430,6 +2585,7 @@ namespace easy3d {
 
 
         void update(PolyMesh *model, LinesDrawable *drawable, const std::string &field, State::Location location, float scale) {
+            EASY3D_TRACE_ZONE_CATEGORY("buffers::update(PolyMesh, vector field)", "renderer");
             if (model->empty()) {
                 LOG(WARNING) << "model has no valid geometry";
                 return;
@@ -2461,7 +2617,7 @@ namespace easy3d {
                     return;
             }
 
-            auto points = model->get_vertex_property<vec3>("v:point");
+            auto points = details::vertex_points(model);
 
             // use a limited number of edge to compute the length of the vectors.
             float avg_edge_length = 0.0f;
@@ -2599,6 +2755,28 @@ namespace easy3d {
                 }
             }
         }
+
+
+        void invalidate_statistics(const Model *model) {
+            std::vector<const PropertyContainer *> containers;
+            if (dynamic_cast<const SurfaceMesh *>(model)) {
+                auto mesh = dynamic_cast<const SurfaceMesh *>(model);
+                containers = {&mesh->vertex_property_container(), &mesh->halfedge_property_container(),
+                              &mesh->edge_property_container(), &mesh->face_property_container()};
+            } else if (dynamic_cast<const PointCloud *>(model)) {
+                auto cloud = dynamic_cast<const PointCloud *>(model);
+                containers = {&cloud->vertex_property_container()};
+            } else if (dynamic_cast<const Graph *>(model)) {
+                auto graph = dynamic_cast<const Graph *>(model);
+                containers = {&graph->vertex_property_container(), &graph->edge_property_container()};
+            } else if (dynamic_cast<const PolyMesh *>(model)) {
+                auto mesh = dynamic_cast<const PolyMesh *>(model);
+                containers = {&mesh->vertex_property_container(), &mesh->edge_property_container(),
+                              &mesh->halfface_property_container(), &mesh->face_property_container(),
+                              &mesh->cell_property_container()};
+            }
+            details::invalidate_statistics(containers);
+        }
     }
 
 }
@@ -54,10 +54,23 @@ namespace easy3d {
 
         /**
          * @brief Update render buffers of a drawable. Coloring determined by the drawable's coloring scheme.
+         * @details If the drawable is colored by a scalar field, the range of the scalar field is clamped using the
+         *      cached statistics of its values, which are not recomputed when the values are modified. So after
+         *      modifying the values, the statistics must be discarded by invalidate_statistics() before calling this
+         *      function, which is done by Renderer::update() and Drawable::update().
          * @param model     The model.
          * @param drawable  The drawable.
          */
         void update(Model* model, Drawable* drawable);
+
+        /**
+         * @brief Discard the cached statistics of the scalar fields of a model.
+         * @details The statistics (used for clamping the scalar fields) are cached per property and they are not
+         *      recomputed when the values of a property are modified. So they must be discarded after the data of
+         *      the model changes, which is done by Renderer::update() and Drawable::update().
+         * @param model     The model.
+         */
+        void invalidate_statistics(const Model* model);
         //@}
 
         /// \name Render buffer update for PointCloud
@@ -0,0 +1,301 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/renderer/culling.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <easy3d/core/model.h>
+#include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/renderer.h>
+#include <easy3d/renderer/manipulator.h>
+#include <easy3d/renderer/drawable_lines.h>
+#include <easy3d/renderer/drawable_points.h>
+#include <easy3d/renderer/drawable_triangles.h>
+
+
+namespace easy3d {
+
+
+    namespace details {
+
+        // the bounding box of a box transformed by a matrix
+        Box3 transform_box(const Box3 &box, const mat4 &m) {
+            if (!box.is_valid())
+                return box;
+            const vec3 &a = box.min_point();
+            const vec3 &b = box.max_point();
+            Box3 result;
+            for (int i = 0; i < 8; ++i) {
+                const vec3 p((i & 1) ? b.x : a.x, (i & 2) ? b.y : a.y, (i & 4) ? b.z : a.z);
+                result.grow(m * p);
+            }
+            return result;
+        }
+
+        // the bounding box of a model in the world coordinate system
+        Box3 world_box(const Model *model) {
+            const Box3 &box = model->bounding_box();
+            if (model->manipulator())
+                return transform_box(box, model->manipulator()->matrix());
+            return box;
+        }
+
+        inline bool same(const Box3 &a, const Box3 &b) {
+            if (a.is_valid() != b.is_valid())
+                return false;
+            return !a.is_valid() || (a.min_point() == b.min_point() && a.max_point() == b.max_point());
+        }
+
+        // the number of visible drawables of a model
+        std::size_t num_visible_drawables(const Model *model) {
+            const Renderer *renderer = model->renderer();
+            if (!renderer || !renderer->is_visible())
+                return 0;
+            std::size_t num = 0;
+            for (auto d : renderer->lines_drawables())
+                num += d->is_visible();
+            for (auto d : renderer->points_drawables())
+                num += d->is_visible();
+            for (auto d : renderer->triangles_drawables())
+                num += d->is_visible();
+            return num;
+        }
+
+    }
+
+
+    Culler::Culler()
+            : frustum_culling_(true), min_screen_size_(0.0f), camera_(nullptr)
+    {
+    }
+
+
+    void Culler::cull(const std::vector<Model *> &models, const Camera *camera) {
+        stats_ = Statistics();
+        camera_ = camera;
+        camera->getFrustumPlanesCoefficients(planes_);
+
+        bool changed = (models.size() != models_.size());
+        for (std::size_t i = 0; !changed && i < models.size(); ++i)
+            changed = (models[i] != models_[i]);
+
+        if (changed)
+            build(models);
+        else {
+            // refit the nodes of the models that have moved (or whose geometry has changed)
+            std::vector<int> moved;
+            for (std::size_t i = 0; i < models.size(); ++i) {
+                const Box3 box = details::world_box(models[i]);
+                if (!details::same(box, boxes_[i])) {
+                    boxes_[i] = box;
+                    moved.push_back(static_cast<int>(i));
+                }
+            }
+            // refitting many leaves is not cheaper than rebuilding, and rebuilding gives a tighter hierarchy
+            if (moved.size() * 4 > models.size())
+                build(models);
+            else {
+                for (auto i : moved)
+                    refit(leaves_[i]);
+            }
+        }
+
+        if (frustum_culling_ || min_screen_size_ > 0.0f) {
+            std::fill(results_.begin(), results_.end(), FRUSTUM_CULLED);
+            if (!nodes_.empty())
+                traverse(0, frustum_culling_ ? 0x3f : 0x0);
+        }
+        else
+            std::fill(results_.begin(), results_.end(), VISIBLE);
+
+        for (std::size_t i = 0; i < models_.size(); ++i)
+            count(models_[i], results_[i]);
+    }
+
+
+    Culler::Result Culler::test(const Model *model) const {
+        auto pos = indices_.find(model);
+        if (pos == indices_.end())
+            return VISIBLE;
+        return results_[pos->second];
+    }
+
+
+    Culler::Result Culler::test(const Drawable *drawable) {
+        Result result = VISIBLE;
+        if (camera_) {
+            const Box3 box = details::transform_box(drawable->bounding_box(), drawable->manipulated_matrix());
+            unsigned int mask = frustum_culling_ ? 0x3f : 0x0;
+            if (box.is_valid()) {
+                if (!intersects(box, mask))
+                    result = FRUSTUM_CULLED;
+                else if (too_small(box))
+                    result = SIZE_CULLED;
+            }
+        }
+
+        switch (result) {
+            case VISIBLE:        ++stats_.drawn; break;
+            case FRUSTUM_CULLED: ++stats_.frustum_culled; break;
+            case SIZE_CULLED:    ++stats_.size_culled; break;
+        }
+        return result;
+    }
+
+
+    void Culler::build(const std::vector<Model *> &models) {
+        models_.assign(models.begin(), models.end());
+        boxes_.resize(models.size());
+        leaves_.assign(models.size(), -1);
+        results_.assign(models.size(), VISIBLE);
+        indices_.clear();
+        for (std::size_t i = 0; i < models.size(); ++i) {
+            boxes_[i] = details::world_box(models[i]);
+            indices_[models[i]] = static_cast<int>(i);
+        }
+
+        nodes_.clear();
+        if (models.empty())
+            return;
+        nodes_.reserve(models.size() * 2 - 1);
+        std::vector<int> items(models.size());
+        for (std::size_t i = 0; i < items.size(); ++i)
+            items[i] = static_cast<int>(i);
+        build(items, 0, items.size(), -1);
+    }
+
+
+    int Culler::build(std::vector<int> &items, std::size_t begin, std::size_t end, int parent) {
+        const int index = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+        nodes_[index].parent = parent;
+
+        if (end - begin == 1) {
+            const int item = items[begin];
+            nodes_[index].item = item;
+            nodes_[index].box = boxes_[item];
+            leaves_[item] = index;
+            return index;
+        }
+
+        // split at the median of the box centers along the axis with the largest extent
+        Box3 centers;
+        for (std::size_t i = begin; i < end; ++i) {
+            const Box3 &box = boxes_[items[i]];
+            if (box.is_valid())
+                centers.grow(box.center());
+        }
+        const unsigned int axis = centers.is_valid() ? centers.max_range_axis() : 0;
+        const std::size_t mid = begin + (end - begin) / 2;
+        std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+                         [this, axis](int a, int b) -> bool {
+                             const Box3 &ba = boxes_[a];
+                             const Box3 &bb = boxes_[b];
+                             // invalid (i.e., empty) boxes go to the end
+                             if (!ba.is_valid() || !bb.is_valid())
+                                 return ba.is_valid() && !bb.is_valid();
+                             return ba.center()[axis] < bb.center()[axis];
+                         });
+
+        const int left = build(items, begin, mid, index);
+        const int right = build(items, mid, end, index);
+        nodes_[index].left = left;
+        nodes_[index].right = right;
+        nodes_[index].box = nodes_[left].box + nodes_[right].box;
+        return index;
+    }
+
+
+    void Culler::refit(int leaf) {
+        Node &node = nodes_[leaf];
+        node.box = boxes_[node.item];
+        for (int n = node.parent; n != -1; n = nodes_[n].parent)
+            nodes_[n].box = nodes_[nodes_[n].left].box + nodes_[nodes_[n].right].box;
+    }
+
+
+    void Culler::traverse(int index, unsigned int mask) {
+        const Node &node = nodes_[index];
+        // models with an empty bounding box are not culled
+        if (node.box.is_valid() && !intersects(node.box, mask))
+            return;
+
+        if (node.item != -1) {
+            const Box3 &box = boxes_[node.item];
+            results_[node.item] = (box.is_valid() && too_small(box)) ? SIZE_CULLED : VISIBLE;
+        }
+        else {
+            traverse(node.left, mask);
+            traverse(node.right, mask);
+        }
+    }
+
+
+    bool Culler::intersects(const Box3 &box, unsigned int &mask) const {
+        if (mask == 0)
+            return true;
+
+        const vec3 center = box.center();
+        const vec3 extent = box.diagonal_vector() * 0.5f;
+        for (int i = 0; i < 6; ++i) {
+            const unsigned int bit = 1u << i;
+            if (!(mask & bit))
+                continue;
+            const float *p = planes_[i];
+            // the signed distance of the center, and the projected radius of the box on the plane normal
+            const float s = p[0] * center.x + p[1] * center.y + p[2] * center.z - p[3];
+            const float r = std::fabs(p[0]) * extent.x + std::fabs(p[1]) * extent.y + std::fabs(p[2]) * extent.z;
+            if (s - r > 0.0f)   // completely outside
+                return false;
+            if (s + r <= 0.0f)  // completely inside, so the children don't need to be tested against this plane
+                mask &= ~bit;
+        }
+        return true;
+    }
+
+
+    bool Culler::too_small(const Box3 &box) const {
+        if (min_screen_size_ <= 0.0f)
+            return false;
+        const float ratio = camera_->pixelGLRatio(box.center());
+        if (ratio <= 0.0f)  // the camera is at the center
+            return false;
+        return box.diagonal_length() / ratio < min_screen_size_;
+    }
+
+
+    void Culler::count(const Model *model, Result result) {
+        const std::size_t num = details::num_visible_drawables(model);
+        switch (result) {
+            case VISIBLE:        stats_.drawn += num; break;
+            case FRUSTUM_CULLED: stats_.frustum_culled += num; break;
+            case SIZE_CULLED:    stats_.size_culled += num; break;
+        }
+    }
+
+}
@@ -0,0 +1,164 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_RENDERER_CULLING_H
+#define EASY3D_RENDERER_CULLING_H
+
+
+#include <vector>
+#include <unordered_map>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    class Model;
+    class Camera;
+    class Drawable;
+
+    /**
+     * \brief Frustum culling and small-feature culling of models and drawables.
+     * \class Culler easy3d/renderer/culling.h
+     * \details A Culler maintains a bounding volume hierarchy (BVH) over the bounding boxes of the models of a scene
+     *      (in world coordinates, i.e., with their manipulated transformations applied). Each frame, cull() traverses
+     *      the BVH against the view frustum of the camera, so models outside the frustum are rejected in subtrees.
+     *      A model that is inside (or intersects) the frustum is further rejected if its projected size on screen is
+     *      smaller than a threshold (see set_min_screen_size()). The BVH is rebuilt only when the set of models
+     *      changes. When a model moves (or its geometry changes), only its leaf and the ancestors are refitted.
+     *
+     *      Example usage:
+     *      \code
+     *          culler->cull(models, camera);
+     *          for (auto m : models) {
+     *              if (culler->test(m) != Culler::VISIBLE)
+     *                  continue;
+     *              // draw the drawables of the model...
+     *          }
+     *          const Culler::Statistics& stats = culler->statistics();
+     *      \endcode
+     *
+     * \note The bounding box of a model is retrieved by Model::bounding_box(). It is invalidated by Renderer::update()
+     *      and Renderer::update_geometry(). Client code that changes the geometry of a model without updating its
+     *      renderer should call Model::invalidate_bounding_box().
+     */
+    class Culler {
+    public:
+        /// The result of the culling test of a model or drawable.
+        enum Result {
+            VISIBLE = 0,        ///< it is (potentially) visible and should be drawn.
+            FRUSTUM_CULLED = 1, ///< it is completely outside the view frustum.
+            SIZE_CULLED = 2     ///< it is in the view frustum, but its projected size is below the threshold.
+        };
+
+        /// The number of drawables drawn and culled in the last frame.
+        struct Statistics {
+            std::size_t drawn = 0;
+            std::size_t frustum_culled = 0;
+            std::size_t size_culled = 0;
+        };
+
+    public:
+        Culler();
+
+        /// Enables/Disables frustum culling. It is enabled by default.
+        void set_frustum_culling(bool b) { frustum_culling_ = b; }
+        /// Returns whether frustum culling is enabled.
+        bool frustum_culling() const { return frustum_culling_; }
+
+        /// Sets the minimum projected size (i.e., the diameter of the bounding box, in pixels) of a visible model or
+        /// drawable. A value of 0 (the default) disables small-feature culling.
+        void set_min_screen_size(float pixels) { min_screen_size_ = pixels; }
+        /// Returns the minimum projected size (in pixels) of a visible model or drawable.
+        float min_screen_size() const { return min_screen_size_; }
+
+        /**
+         * \brief Performs culling of the models for a new frame.
+         * \details It updates the BVH (if the models have changed or moved), classifies the models, and resets the
+         *      statistics. The visible drawables of the visible models are counted as drawn, and those of the culled
+         *      models as culled.
+         * \param models The models of the scene.
+         * \param camera The camera, which provides the view frustum and the pixel size.
+         */
+        void cull(const std::vector<Model *> &models, const Camera *camera);
+
+        /// Returns the result of a model in the last call to cull(). Models unknown to the last cull() are visible.
+        Result test(const Model *model) const;
+
+        /**
+         * \brief Tests a drawable that does not belong to a model (e.g., a drawable owned by the viewer) against the
+         *      view of the last call to cull(). It also updates the statistics.
+         */
+        Result test(const Drawable *drawable);
+
+        /// Returns the number of drawables drawn and culled in the last frame.
+        const Statistics &statistics() const { return stats_; }
+
+        /// Returns the number of BVH nodes, e.g., for debugging purposes.
+        std::size_t num_nodes() const { return nodes_.size(); }
+
+    private:
+        struct Node {
+            Box3 box;
+            int left = -1;
+            int right = -1;
+            int parent = -1;
+            int item = -1;  // the index of the model (for a leaf node), or -1 (for an internal node)
+        };
+
+        void build(const std::vector<Model *> &models);
+        int build(std::vector<int> &items, std::size_t begin, std::size_t end, int parent);
+        void refit(int leaf);
+        void traverse(int node, unsigned int mask);
+        // tests a box against the planes in mask. It returns false if the box is outside. The planes the box is
+        // completely inside are removed from mask.
+        bool intersects(const Box3 &box, unsigned int &mask) const;
+        bool too_small(const Box3 &box) const;
+        void count(const Model *model, Result result);
+
+    private:
+        bool frustum_culling_;
+        float min_screen_size_;
+
+        std::vector<const Model *> models_;     // the models (in the order of the last cull())
+        std::vector<Box3> boxes_;               // the world bounding boxes of the models
+        std::vector<int> leaves_;               // the leaf node of each model
+        std::vector<Result> results_;           // the result of each model
+        std::unordered_map<const Model *, int> indices_;
+
+        std::vector<Node> nodes_;
+
+        // the view of the last cull()
+        const Camera *camera_;
+        float planes_[6][4];
+
+        Statistics stats_;
+    };
+
+}
+
+
+#endif  // EASY3D_RENDERER_CULLING_H
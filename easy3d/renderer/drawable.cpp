@@ -28,7 +28,11 @@
 
 #include <cassert>
 
-#include <easy3d/core/model.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/core/vec3_kernels.h>
 #include <easy3d/renderer/opengl.h>
 #include <easy3d/renderer/vertex_array_object.h>
 #include <easy3d/renderer/shader_program.h>
@@ -45,7 +49,9 @@ namespace easy3d {
 
     Drawable::Drawable(const std::string &name, Model *model)
             : name_(name), model_(model), vao_(nullptr), num_vertices_(0), num_indices_(0),
-              update_needed_(false), update_func_(nullptr), vertex_buffer_(0), color_buffer_(0), normal_buffer_(0),
+              update_needed_(false), update_func_(nullptr), points_mirrored_(false), normals_mirrored_(false),
+              geometry_update_needed_(false), buffers_built_(false),
+              vertex_buffer_(0), color_buffer_(0), normal_buffer_(0),
               texcoord_buffer_(0), element_buffer_(0), manipulator_(nullptr) {
         vao_ = new VertexArrayObject;
         material_ = Material(setting::material_ambient, setting::material_specular, setting::material_shininess);
@@ -95,6 +101,24 @@ namespace easy3d {
     void Drawable::update() {
         bbox_.clear();
         update_needed_ = true;
+
+        // if the buffers are updated for the same coloring (i.e., not for a change of the scalar field or the clamp
+        // range), the values of the scalar field may have changed
+        const Coloring &c = built_coloring_;
+        if (model_ && buffers_built_ && coloring_method() == SCALAR_FIELD && c.method == coloring_method() &&
+            c.location == property_location() && c.name == property_name() && c.clamp_range == clamp_range() &&
+            c.clamp_lower == clamp_lower() && c.clamp_upper == clamp_upper())
+            buffers::invalidate_statistics(model_);
+    }
+
+
+    void Drawable::update_geometry() {
+        if (update_func_ || update_needed_ || vertex_buffer_ == 0 || !points_mirrored_ ||
+            (normal_buffer_ && !normals_mirrored_)) {
+            update();   // the buffers don't mirror the model and have to be rebuilt
+            return;
+        }
+        geometry_update_needed_ = true;
     }
 
 
@@ -108,6 +132,8 @@ namespace easy3d {
         num_vertices_ = 0;
         num_indices_ = 0;
         bbox_.clear();
+        points_mirrored_ = false;
+        normals_mirrored_ = false;
     }
 
 
@@ -137,6 +163,55 @@ namespace easy3d {
         LOG_IF(w.elapsed_seconds() > 0.5, INFO) << "updating rendering buffers for drawable '" << name()
                                                 << "' took " << w.time_string();
         update_needed_ = false;
+        geometry_update_needed_ = false;  // the buffers have been built from the current model
+        built_coloring_ = {coloring_method(), property_location(), property_name(), clamp_range(), clamp_lower(),
+                           clamp_upper()};
+        buffers_built_ = true;
+    }
+
+
+    namespace details {
+        // returns the per-vertex normals ("v:normal") of a model, or nullptr if it doesn't have them
+        const std::vector<vec3>* vertex_normals(const Model *model) {
+            if (dynamic_cast<const SurfaceMesh *>(model)) {
+                const auto prop = dynamic_cast<const SurfaceMesh *>(model)->get_vertex_property<vec3>("v:normal");
+                return prop ? &prop.vector() : nullptr;
+            } else if (dynamic_cast<const PointCloud *>(model)) {
+                const auto prop = dynamic_cast<const PointCloud *>(model)->get_vertex_property<vec3>("v:normal");
+                return prop ? &prop.vector() : nullptr;
+            } else if (dynamic_cast<const Graph *>(model)) {
+                const auto prop = dynamic_cast<const Graph *>(model)->get_vertex_property<vec3>("v:normal");
+                return prop ? &prop.vector() : nullptr;
+            } else if (dynamic_cast<const PolyMesh *>(model)) {
+                const auto prop = dynamic_cast<const PolyMesh *>(model)->get_vertex_property<vec3>("v:normal");
+                return prop ? &prop.vector() : nullptr;
+            }
+            return nullptr;
+        }
+
+        // overwrites the content of an array buffer (without reallocating it)
+        void write_array_buffer(GLuint buffer, const std::vector<vec3> &data) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);                                  easy3d_debug_log_gl_error;
+            glBufferSubData(GL_ARRAY_BUFFER, 0, data.size() * sizeof(vec3), data.data());   easy3d_debug_log_gl_error;
+            glBindBuffer(GL_ARRAY_BUFFER, 0);                                       easy3d_debug_log_gl_error;
+        }
+    }
+
+
+    void Drawable::internal_update_geometry() {
+        geometry_update_needed_ = false;
+
+        const Model *model = model_;
+        const std::vector<vec3> &points = model->points();
+        const std::vector<vec3> *normals = normal_buffer_ ? details::vertex_normals(model) : nullptr;
+        if (points.size() != num_vertices_ || (normal_buffer_ && (!normals || normals->size() != num_vertices_))) {
+            internal_update_buffers();  // the model has changed more than its geometry
+            return;
+        }
+
+        details::write_array_buffer(vertex_buffer_, points);
+        if (normal_buffer_)
+            details::write_array_buffer(normal_buffer_, *normals);
     }
 
 
@@ -148,6 +223,9 @@ namespace easy3d {
 
         LOG_IF(!success, ERROR) << "failed creating vertex buffer";
 
+        const Model *model_const = model_;
+        points_mirrored_ = success && model_const && model_const->points().data() == vertices.data();
+
         if (!success)
             num_vertices_ = 0;
         else {
@@ -157,9 +235,7 @@ namespace easy3d {
                 bbox_ = model()->bounding_box();
             else {
                 // update bounding box
-                bbox_.clear();
-                for (const auto &p : vertices)
-                    bbox_.grow(p);
+                bbox_ = kernels::bounding_box(vertices);
             }
         }
     }
@@ -179,6 +255,9 @@ namespace easy3d {
         bool success = vao_->create_array_buffer(normal_buffer_, ShaderProgram::NORMAL, normals.data(),
                                                  normals.size() * sizeof(vec3), 3, dynamic);
         LOG_IF(!success, ERROR) << "failed updating normal buffer";
+
+        const std::vector<vec3> *model_normals = model_ ? details::vertex_normals(model_) : nullptr;
+        normals_mirrored_ = success && model_normals && model_normals->data() == normals.data();
     }
 
 
@@ -225,6 +304,8 @@ namespace easy3d {
     void Drawable::gl_draw() const {
         if (update_needed_ || vertex_buffer_ == 0)
             const_cast<Drawable*>(this)->internal_update_buffers();
+        else if (geometry_update_needed_)
+            const_cast<Drawable*>(this)->internal_update_geometry();
 
         vao_->bind();
 
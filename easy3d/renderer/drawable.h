@@ -138,6 +138,10 @@ namespace easy3d {
          * @brief Requests an update of the OpenGL buffers.
          * @details This function sets the status to trigger an update of the OpenGL buffers. The actual update does
          *      not occur immediately but is deferred to the rendering phase.
+         *      If the drawable is colored by a scalar field, the cached statistics of the scalar fields of the model
+         *      are discarded, as the values may have changed, unless the coloring (e.g., the scalar field or the
+         *      clamp range) has changed since the buffers were built. So if the coloring and the values change
+         *      together, call Renderer::update() instead.
          * @note This method works for both standard drawables (no update function required) and non-standard
          *      drawable (update function required). Standard drawables include:
          *            - SurfaceMesh: "faces", "edges", "vertices", "borders", and "locks";
@@ -156,6 +160,19 @@ namespace easy3d {
          */
         void set_update_func(const std::function<void(Model*, Drawable*)>& func) { update_func_ = func; }
 
+        /**
+         * @brief Requests an update of only the vertex and normal buffers from the model.
+         * @details This is for keeping the rendering buffers consistent with a model whose points (and normals) have
+         *      been modified in place, e.g., transformed by Manipulator::apply(). If the vertex buffer mirrors the
+         *      model's points (and the normal buffer, if any, mirrors its "v:normal"), the two buffers are re-uploaded
+         *      from the model, and the other buffers (e.g., the element buffer, colors, and texture coordinates) are
+         *      kept. Otherwise (e.g., per-corner vertices for flat shading, or a drawable with an update function), the
+         *      drawable is updated from the model as update() does. Like update(), the actual work is deferred to the
+         *      rendering phase.
+         * \sa update()
+         */
+        void update_geometry();
+
         ///@}
 
         /// \name Manipulation
@@ -188,6 +205,7 @@ namespace easy3d {
 
     protected:
         void internal_update_buffers();
+        void internal_update_geometry();
 
         void clear();
 
@@ -205,6 +223,23 @@ namespace easy3d {
         bool update_needed_;
         std::function<void(Model*, Drawable*)> update_func_;
 
+        // the vertex/normal buffer was uploaded from the model's points/"v:normal" as is (see update_geometry())
+        bool points_mirrored_;
+        bool normals_mirrored_;
+        bool geometry_update_needed_;
+
+        // the coloring the buffers were built with (see update())
+        struct Coloring {
+            Method method;
+            Location location;
+            std::string name;
+            bool clamp_range;
+            float clamp_lower;
+            float clamp_upper;
+        };
+        Coloring built_coloring_;
+        bool buffers_built_;
+
         unsigned int vertex_buffer_;
         unsigned int color_buffer_;
         unsigned int normal_buffer_;
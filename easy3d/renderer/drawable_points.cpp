@@ -33,7 +33,9 @@
 #include <easy3d/renderer/opengl.h>
 #include <easy3d/renderer/opengl_error.h>
 #include <easy3d/renderer/clipping_plane.h>
+#include <easy3d/renderer/vertex_array_object.h>
 #include <easy3d/renderer/transform.h>
+#include <easy3d/core/selection_set.h>
 #include <easy3d/util/logging.h>
 
 
@@ -41,6 +43,7 @@ namespace easy3d {
 
     PointsDrawable::PointsDrawable(const std::string &name /*= ""*/, Model* model)
             : Drawable(name, model), point_size_(2.0f), impostor_type_(PLAIN)
+            , selection_buffer_(0), selection_texture_(0), selection_size_(0)
     {
         lighting_two_sides_ = setting::points_drawable_two_side_lighting;
         distinct_back_color_ = setting::points_drawable_distinct_backside_color;
@@ -49,6 +52,74 @@ namespace easy3d {
     }
 
 
+    PointsDrawable::~PointsDrawable() {
+        if (selection_texture_)
+            glDeleteTextures(1, &selection_texture_);
+        VertexArrayObject::release_buffer(selection_buffer_);
+    }
+
+
+    void PointsDrawable::update_selection_buffer(const SelectionSet &selection) {
+        if (selection.size() == 0) {
+            if (selection_texture_)
+                glDeleteTextures(1, &selection_texture_);
+            selection_texture_ = 0;
+            VertexArrayObject::release_buffer(selection_buffer_);
+            selection_size_ = 0;
+            return;
+        }
+
+        std::vector<SelectionSet::word_type> words;
+        selection.get_words(words);
+
+        GLint max_texels = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels);
+        if (words.size() > static_cast<std::size_t>(max_texels)) {
+            LOG(WARNING) << "drawable \'" << name() << "\': selection of " << selection.size()
+                         << " points exceeds the maximum size of a texture buffer";
+            return;
+        }
+
+        if (!selection_buffer_)
+            glGenBuffers(1, &selection_buffer_);
+        glBindBuffer(GL_TEXTURE_BUFFER, selection_buffer_);
+        glBufferData(GL_TEXTURE_BUFFER, words.size() * sizeof(SelectionSet::word_type), words.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        if (!selection_texture_) {
+            glGenTextures(1, &selection_texture_);
+            glBindTexture(GL_TEXTURE_BUFFER, selection_texture_);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, selection_buffer_);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+        }
+        easy3d_debug_log_gl_error;
+
+        selection_size_ = selection.size();
+    }
+
+
+    void PointsDrawable::bind_selection_buffer(ShaderProgram *program) const {
+        const bool enabled = selection_texture_ && selection_size_ == num_vertices();
+        program->set_uniform("per_point_selection", enabled);
+        // the sampler always refers to its own unit (samplers of different types must not share a unit)
+        program->set_uniform("selection", 1);
+        if (enabled) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_BUFFER, selection_texture_);
+            glActiveTexture(GL_TEXTURE0);
+        }
+    }
+
+
+    void PointsDrawable::release_selection_buffer() const {
+        if (selection_texture_ && selection_size_ == num_vertices()) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+            glActiveTexture(GL_TEXTURE0);
+        }
+    }
+
+
     Drawable::Type PointsDrawable::type() const {
         return DT_POINTS;
     }
@@ -144,11 +215,13 @@ namespace easy3d {
                 ->set_uniform("highlight_id_max",highlight_range().second);
 
         program->set_uniform("selected", is_selected());
+        bind_selection_buffer(program);
 
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
         gl_draw();
+        release_selection_buffer();
         program->release();
     }
 
@@ -197,11 +270,13 @@ namespace easy3d {
                 ->set_uniform("highlight_id_max",highlight_range().second);
 
         program->set_uniform("selected", is_selected());
+        bind_selection_buffer(program);
 
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
         gl_draw();
+        release_selection_buffer();
         program->release();
 
         glDisable(GL_VERTEX_PROGRAM_POINT_SIZE); // starting from GL3.2, using GL_PROGRAM_POINT_SIZE
@@ -249,11 +324,13 @@ namespace easy3d {
                 ->set_uniform("highlight_id_max", highlight_range().second);
 
         program->set_uniform("selected", is_selected());
+        bind_selection_buffer(program);
 
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
         gl_draw();
+        release_selection_buffer();
         program->release();
     }
 
@@ -311,6 +388,7 @@ namespace easy3d {
                 ->bind_texture("textureID",texture()->id(), 0);
 
         program->set_uniform("selected", is_selected());
+        bind_selection_buffer(program);
 
 
         program->set_uniform("highlight",highlight())
@@ -321,6 +399,7 @@ namespace easy3d {
             setting::clipping_plane->set_program(program);
 
         gl_draw();
+        release_selection_buffer();
         program->release_texture();
 
         program->release();
@@ -383,12 +462,14 @@ namespace easy3d {
                 ->set_uniform("highlight_id_max",highlight_range().second);
 
         program->set_uniform("selected", is_selected());
+        bind_selection_buffer(program);
 
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
         program->bind_texture("textureID",texture()->id(), 0);
         gl_draw();
+        release_selection_buffer();
         program->release_texture();
 
         program->release();
@@ -454,11 +535,13 @@ namespace easy3d {
                 ->set_block_uniform("Material", "shininess", &material().shininess);
 
         program->set_uniform("selected", is_selected());
+        bind_selection_buffer(program);
 
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
         gl_draw();
+        release_selection_buffer();
         program->release();
     }
 
@@ -520,12 +603,14 @@ namespace easy3d {
                 ->set_uniform("highlight_id_max",highlight_range().second);
 
         program->set_uniform("selected", is_selected());
+        bind_selection_buffer(program);
 
         if (setting::clipping_plane)
             setting::clipping_plane->set_program(program);
 
         program->bind_texture("textureID",texture()->id(), 0);
         gl_draw();
+        release_selection_buffer();
         program->release_texture();
 
         program->release();
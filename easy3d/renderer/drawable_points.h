@@ -32,6 +32,8 @@
 
 namespace easy3d {
 
+    class ShaderProgram;
+    class SelectionSet;
 
     /**
      * \brief The drawable for rendering a set of points, e.g., point clouds, vertices of a mesh.
@@ -42,6 +44,7 @@ namespace easy3d {
 	class PointsDrawable : public Drawable {
 	public:
         PointsDrawable(const std::string& name = "", Model* model = nullptr);
+        ~PointsDrawable() override;
 
         Type type() const override;
 
@@ -60,6 +63,13 @@ namespace easy3d {
         float point_size() const { return point_size_; }
         void set_point_size(float s) { point_size_ = s; }
 
+        /**
+         * \brief Uploads the selection state of the points to the GPU (one bit per point, i.e., 32 times smaller than
+         *      the color/texcoord buffer). The selected points are highlighted regardless of the coloring method. The
+         *      selection is ignored if its size doesn't match the number of points. An empty selection disables it.
+         */
+        void update_selection_buffer(const SelectionSet& selection);
+
         // Rendering.
         virtual void draw(const Camera* camera) const override;
 
@@ -76,9 +86,17 @@ namespace easy3d {
         void _draw_spheres_with_texture_geometry(const Camera* camera) const;
         void _draw_surfels_with_texture(const Camera* camera) const;
 
+        // binds/releases the selection buffer (as a texture buffer) for a program
+        void bind_selection_buffer(ShaderProgram* program) const;
+        void release_selection_buffer() const;
+
 	private:
         float           point_size_;
         ImposterType    impostor_type_;
+
+        unsigned int    selection_buffer_;
+        unsigned int    selection_texture_;
+        std::size_t     selection_size_;    // the number of points of the selection
 	};
 
 }
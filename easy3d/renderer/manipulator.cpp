@@ -27,6 +27,13 @@
 
 #include <easy3d/renderer/manipulator.h>
 #include <easy3d/core/model.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/vec3_kernels.h>
+#include <easy3d/renderer/renderer.h>
+#include <easy3d/renderer/transform.h>
 #include <easy3d/renderer/manipulated_frame.h>
 #include <easy3d/renderer/shapes.h>
 #include <easy3d/renderer/camera.h>
@@ -76,6 +83,49 @@ namespace easy3d {
     }
 
 
+    namespace details {
+        template<typename Property>
+        void transform_normals(Property normals, const mat3 &N) {
+            if (normals) {
+                kernels::transform(normals.vector(), N);
+                kernels::normalize(normals.vector());
+            }
+        }
+    }
+
+
+    void Manipulator::apply() {
+        if (!model_)
+            return;
+
+        const mat4 m = matrix();
+        kernels::transform(model_->points(), m);
+        model_->invalidate_bounding_box();
+
+        const mat3 N = transform::normal_matrix(m);
+        if (dynamic_cast<SurfaceMesh *>(model_)) {
+            auto mesh = dynamic_cast<SurfaceMesh *>(model_);
+            details::transform_normals(mesh->get_vertex_property<vec3>("v:normal"), N);
+            details::transform_normals(mesh->get_face_property<vec3>("f:normal"), N);
+        } else if (dynamic_cast<PointCloud *>(model_)) {
+            auto cloud = dynamic_cast<PointCloud *>(model_);
+            details::transform_normals(cloud->get_vertex_property<vec3>("v:normal"), N);
+        } else if (dynamic_cast<Graph *>(model_)) {
+            auto graph = dynamic_cast<Graph *>(model_);
+            details::transform_normals(graph->get_vertex_property<vec3>("v:normal"), N);
+        } else if (dynamic_cast<PolyMesh *>(model_)) {
+            auto mesh = dynamic_cast<PolyMesh *>(model_);
+            details::transform_normals(mesh->get_vertex_property<vec3>("v:normal"), N);
+            details::transform_normals(mesh->get_face_property<vec3>("f:normal"), N);
+        }
+
+        if (model_->renderer())
+            model_->renderer()->update_geometry();
+
+        reset();
+    }
+
+
     void Manipulator::draw_frame( Camera *cam) const {
         if (!model_ || !cam)
             return;
@@ -64,6 +64,15 @@ namespace easy3d {
         /// \note Rotation is performed around the 'center' of the object.
         mat4 matrix() const;
 
+        /**
+         * @brief Applies the transformation introduced by this manipulator to the model, and then resets.
+         * @details The points and the normals (i.e., "v:normal", and also "f:normal" for meshes) of the model are
+         *      transformed in parallel. The vertex and normal buffers of the model's drawables are re-uploaded from
+         *      the model instead of being rebuilt where possible.
+         * \sa Renderer::update_geometry()
+         */
+        void apply();
+
         /// Draws the manipulated frame.
         void draw_frame(Camera* cam) const;
 
@@ -53,6 +53,11 @@ namespace easy3d {
         GLenum status = glewInit();
         _glew_initialized = true;
 
+        // With a surfaceless EGL context (e.g., for offscreen rendering), GLEW fails to initialize GLX because there
+        // is no X display. This is not a problem because the OpenGL functions have been loaded anyway.
+        if (status == GLEW_ERROR_NO_GLX_DISPLAY)
+            status = GLEW_OK;
+
         if (GLEW_OK != status) {
             // Problem: glewInit failed, something is seriously wrong.
             LOG(ERROR) << glewGetErrorString(status);
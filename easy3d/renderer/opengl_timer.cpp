@@ -28,6 +28,7 @@
 
 #include <easy3d/renderer/opengl.h>
 #include <easy3d/renderer/opengl_error.h>
+#include <easy3d/util/tracing.h>
 
 #include <cassert>
 
@@ -85,4 +86,85 @@ namespace easy3d {
         return static_cast<double>(query_time) / 1000000.0; // in milliseconds
     }
 
+
+    bool OpenGLTimer::is_available() const {
+        if (running_)
+            return false;
+        GLuint available = 0;
+        glGetQueryObjectuiv(query_id_, GL_QUERY_RESULT_AVAILABLE, &available);
+        return available == GL_TRUE;
+    }
+
+    //_________________________________________________________
+
+
+    OpenGLTraceTimer::OpenGLTraceTimer(const char* name, unsigned int latency)
+        : name_(name)
+        , track_(tracing::track("GPU"))
+        , current_(0)
+        , running_(false)
+    {
+        slots_.resize(latency > 0 ? latency : 1);
+        for (auto& slot : slots_) {
+            glGenQueries(1, &slot.query_id); easy3d_debug_log_gl_error;
+            slot.begin = 0;
+            slot.pending = false;
+        }
+    }
+
+
+    OpenGLTraceTimer::~OpenGLTraceTimer() {
+        if (running_)
+            glEndQuery(GL_TIME_ELAPSED);
+        for (auto& slot : slots_) {
+            if (slot.query_id) {
+                glDeleteQueries(1, &slot.query_id); easy3d_debug_log_gl_error;
+            }
+        }
+    }
+
+
+    void OpenGLTraceTimer::collect(unsigned int index, bool wait) {
+        Slot& slot = slots_[index];
+        if (!slot.pending)
+            return;
+        GLuint available = 0;
+        glGetQueryObjectuiv(slot.query_id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available && !wait)
+            return;
+        GLuint64 elapsed = 0;   // in nanoseconds
+        glGetQueryObjectui64v(slot.query_id, GL_QUERY_RESULT, &elapsed);   easy3d_debug_log_gl_error;
+        tracing::record(name_, "gpu", slot.begin, static_cast<int64_t>(elapsed), track_);
+        slot.pending = false;
+    }
+
+
+    void OpenGLTraceTimer::start() {
+        assert(!running_);
+        if (!tracing::is_running())
+            return;
+
+        for (unsigned int i = 0; i < slots_.size(); ++i) {
+            if (i != current_)
+                collect(i, false);
+        }
+        // the query of this slot was issued 'latency' rounds ago, so waiting for it (if ever) is short
+        collect(current_, true);
+
+        Slot& slot = slots_[current_];
+        glBeginQuery(GL_TIME_ELAPSED, slot.query_id);	easy3d_debug_log_gl_error;
+        slot.begin = tracing::now();
+        running_ = true;
+    }
+
+
+    void OpenGLTraceTimer::stop() {
+        if (!running_)
+            return;
+        glEndQuery(GL_TIME_ELAPSED);
+        slots_[current_].pending = true;
+        current_ = (current_ + 1) % static_cast<unsigned int>(slots_.size());
+        running_ = false;
+    }
+
 }
@@ -27,6 +27,9 @@
 #ifndef EASY3D_RENDERER_OPENGL_TIMER_H
 #define EASY3D_RENDERER_OPENGL_TIMER_H
 
+#include <vector>
+#include <cstdint>
+
 namespace easy3d {
 
     /**
@@ -71,11 +74,66 @@ namespace easy3d {
         // return the GPU time consumed since last start (in milliseconds).
         double	time();
 
+        // Is the result available, i.e., can time() return without waiting for the GPU.
+        bool    is_available() const;
+
     protected:
         unsigned int query_id_;
         bool         running_;
     };
 
+
+    /**
+     * \brief Traces the GPU time of repeated OpenGL work (e.g., the frames of a viewer) without stalling the pipeline.
+     *
+     * \class OpenGLTraceTimer easy3d/renderer/opengl_timer.h
+     *
+     * \details Each start()/stop() pair is timed by a query, and the results are collected a few rounds later, when
+     * they are available, and recorded on the "GPU" track of the trace (see tracing::record()). Nothing is measured
+     * if tracing is not running. The GPU events are placed at the time the commands were issued by the CPU, so they
+     * show the GPU cost of each round but not the exact time it was executed.
+     * Only one query of this kind can be active at a time, so timers must not be nested.
+     *
+     * Usage example:
+     *      \code
+     *      OpenGLTraceTimer gpu("frame");
+     *      while (...) {
+     *          gpu.start();
+     *          draw();
+     *          gpu.stop();
+     *          swap_buffers();
+     *      }
+     *      \endcode
+     */
+    class OpenGLTraceTimer
+    {
+    public:
+        // \p name must be a string literal. \p latency is the number of rounds the results are collected later.
+        OpenGLTraceTimer(const char* name, unsigned int latency = 3);
+        // must be called from a thread with the OpenGL context bound.
+        ~OpenGLTraceTimer();
+
+        // Start timing. It records the results of the earlier rounds that are available.
+        void	start();
+        // Stop timing.
+        void    stop();
+
+    protected:
+        void    collect(unsigned int slot, bool wait);
+
+    protected:
+        const char* name_;
+        int         track_;
+        unsigned int current_;
+        bool        running_;
+        struct Slot {
+            unsigned int query_id;
+            int64_t      begin;     // the CPU time (in nanoseconds) when the timed commands were issued
+            bool         pending;
+        };
+        std::vector<Slot> slots_;
+    };
+
 }
 
 
@@ -29,6 +29,7 @@
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/core/poly_mesh.h>
+#include <easy3d/renderer/buffers.h>
 #include <easy3d/renderer/drawable_points.h>
 #include <easy3d/renderer/drawable_lines.h>
 #include <easy3d/renderer/drawable_triangles.h>
@@ -40,6 +41,8 @@ namespace easy3d {
     Renderer::Renderer(Model* model, bool create)
             : visible_(true)
             , selected_(false)
+            , cached_points_("v:point")
+            , cached_normals_("v:normal")
     {
         model_ = model;
         if (model_) {
@@ -267,6 +270,8 @@ namespace easy3d {
 
 
     void Renderer::update() {
+        model_->invalidate_bounding_box();
+        buffers::invalidate_statistics(model_);
         for (auto d : points_drawables_)
             d->update();
         for (auto d : lines_drawables_)
@@ -276,6 +281,17 @@ namespace easy3d {
     }
 
 
+    void Renderer::update_geometry() {
+        model_->invalidate_bounding_box();
+        for (auto d : points_drawables_)
+            d->update_geometry();
+        for (auto d : lines_drawables_)
+            d->update_geometry();
+        for (auto d : triangles_drawables_)
+            d->update_geometry();
+    }
+
+
     PointsDrawable* Renderer::get_points_drawable(const std::string& name) const {
         for (auto d : points_drawables_) {
             if (d->name() == name)
@@ -96,12 +96,34 @@ namespace easy3d {
          * @brief Invalidates the rendering buffers of the model and thus updates the rendering (delayed in rendering).
          * @details This method triggers an update of the rendering buffers of all the drawables of the model to which
          *      this renderer is attached. The effect is equivalent to calling Drawable::update() functions for all
-         *      the drawables of this model.
+         *      the drawables of this model. The bounding box of the model is also invalidated (see
+         *      Model::invalidate_bounding_box()), as the geometry may have changed, and so are the cached statistics
+         *      of its scalar fields (see buffers::invalidate_statistics()). So call this method after modifying the
+         *      values of a property (Drawable::update() keeps the statistics if the coloring of the drawable has also
+         *      changed).
          * todo: for better performance, it is wise to update only the affected drawables and buffers.
          * \sa  Drawable::update()
          */
         void update();
 
+        /**
+         * @brief The cached handles of the vertex points ("v:point") and normals ("v:normal") of the model.
+         * @details The rendering buffers of all the drawables of the model are updated from these two properties, so
+         *      the handles are cached (see CachedProperty) instead of being looked up by name for each drawable.
+         */
+        CachedProperty<vec3>& cached_points() { return cached_points_; }
+        CachedProperty<vec3>& cached_normals() { return cached_normals_; }
+
+        /**
+         * @brief Updates only the vertex and normal buffers of all the drawables of the model.
+         * @details This keeps the rendering consistent with a model whose points (and normals) have been modified in
+         *      place (e.g., transformed), without rebuilding the other rendering buffers where possible. The effect is
+         *      equivalent to calling Drawable::update_geometry() for all the drawables of this model. The bounding box of
+         *      the model is also invalidated.
+         * \sa  Drawable::update_geometry(), Manipulator::apply()
+         */
+        void update_geometry();
+
         //-------------------- drawable management  -----------------------
 
         /**
@@ -258,6 +280,9 @@ namespace easy3d {
         bool visible_;
         bool selected_;
 
+        CachedProperty<vec3> cached_points_;
+        CachedProperty<vec3> cached_normals_;
+
         std::vector<PointsDrawable *> points_drawables_;
         std::vector<LinesDrawable *> lines_drawables_;
         std::vector<TrianglesDrawable *> triangles_drawables_;
@@ -13,6 +13,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <mutex>
 
 
 namespace easy3d {
@@ -24,25 +25,30 @@ namespace easy3d {
         public:
             static Progress* instance();
 
+            // notifies the client (if exists). The notifications are serialized.
             virtual void notify(std::size_t percent, bool update_viewer);
 
-            void set_client(ProgressClient *c) { client_ = c; }
+            void set_client(ProgressClient *c) { client_.store(c); }
+            void remove_client(ProgressClient *c) { client_.compare_exchange_strong(c, nullptr); }
+            bool has_client() const { return client_.load() != nullptr; }
 
-            void push();
+            // returns the new level. A new task (i.e., level 1) gets a new cancellation token.
+            int push();
             void pop();
 
-            void cancel() { canceled_ = true; }
-            void clear_canceled() { canceled_ = false; }
-            bool is_canceled() const { return canceled_; }
+            void cancel();
+            CancellationToken token() const;
 
         protected:
-            Progress() : client_(nullptr), level_(0), canceled_(false) {}
+            Progress() : client_(nullptr), level_(0) {}
 
             virtual ~Progress() {}
 
-            ProgressClient *client_;
-            int level_;
-            bool canceled_;
+            std::atomic<ProgressClient*> client_;
+            std::atomic<int> level_;
+            CancellationToken token_;
+            mutable std::mutex token_mutex_;
+            std::recursive_mutex notify_mutex_;
         };
 
         Progress* Progress::instance() {
@@ -50,11 +56,13 @@ namespace easy3d {
             return &instance;
         }
 
-        void Progress::push() {
-            level_++;
-            if (level_ == 1) {
-                clear_canceled();
+        int Progress::push() {
+            const int level = ++level_;
+            if (level == 1) {
+                std::lock_guard<std::mutex> lock(token_mutex_);
+                token_ = CancellationToken();
             }
+            return level;
         }
 
         void Progress::pop() {
@@ -62,9 +70,21 @@ namespace easy3d {
             level_--;
         }
 
+        void Progress::cancel() {
+            std::lock_guard<std::mutex> lock(token_mutex_);
+            token_.cancel();
+        }
+
+        CancellationToken Progress::token() const {
+            std::lock_guard<std::mutex> lock(token_mutex_);
+            return token_;
+        }
+
         void Progress::notify(std::size_t percent, bool update_viewer) {
-            if (client_ != nullptr && level_ < 2)
-                client_->notify(percent, update_viewer);
+            std::lock_guard<std::recursive_mutex> lock(notify_mutex_);
+            ProgressClient *client = client_.load();
+            if (client != nullptr)
+                client->notify(percent, update_viewer);
         }
     }
     //  \endcond
@@ -76,6 +96,10 @@ namespace easy3d {
         details::Progress::instance()->set_client(this);
     }
 
+    ProgressClient::~ProgressClient() {
+        details::Progress::instance()->remove_client(this);
+    }
+
     void ProgressClient::cancel() {
         details::Progress::instance()->cancel();
     }
@@ -83,41 +107,92 @@ namespace easy3d {
     //_________________________________________________________
 
 
+    const std::uint64_t ProgressLogger::ticks_per_step;
+
+
     ProgressLogger::ProgressLogger(std::size_t max_val, bool update_viewer, bool quiet)
-            : max_val_(max_val)
-            , cur_val_(0)
+            : parent_(nullptr)
+            , parent_steps_(0)
+            , reported_ticks_(0)
+            , max_val_(max_val)
+            , ticks_(0)
             , cur_percent_(0)
             , quiet_(quiet)
             , update_viewer_(update_viewer)
+            , active_(false)
+            , nested_(false)
+    {
+        details::Progress* progress = details::Progress::instance();
+        nested_ = progress->push() > 1;
+        token_ = progress->token();
+        external_token_ = token_;
+        active_ = !quiet_ && !nested_ && progress->has_client();
+        if (active_)
+            progress->notify(0, update_viewer_);
+    }
+
+
+    ProgressLogger::ProgressLogger(std::size_t max_val, bool update_viewer, bool quiet, const CancellationToken& token)
+            : ProgressLogger(max_val, update_viewer, quiet)
+    {
+        external_token_ = token;
+    }
+
+
+    ProgressLogger::ProgressLogger(ProgressLogger& parent, std::size_t parent_steps, std::size_t max_val)
+            : parent_(&parent)
+            , parent_steps_(parent_steps)
+            , reported_ticks_(0)
+            , max_val_(max_val)
+            , ticks_(0)
+            , cur_percent_(0)
+            , quiet_(parent.quiet_)
+            , update_viewer_(parent.update_viewer_)
+            , active_(parent.active_)
+            , nested_(false)
+            , token_(parent.token_)
+            , external_token_(parent.external_token_)
     {
-        details::Progress::instance()->push();
-        if (!quiet_) {
-            details::Progress::instance()->notify(0, update_viewer_);
-        }
     }
 
 
     ProgressLogger::~ProgressLogger() {
+        if (parent_) {
+            // make sure the parent advances by exactly the steps of this sub-task
+            if (active_) {
+                const std::uint64_t target = parent_steps_ * ticks_per_step;
+                const std::uint64_t reported = reported_ticks_.exchange(target);
+                parent_->ticks_.fetch_add(target - reported);
+                parent_->update();
+            }
+            return;
+        }
+
         // one more notification to make sure the progress reaches its end
-        details::Progress::instance()->notify(100, update_viewer_);
+        if (!nested_)
+            details::Progress::instance()->notify(100, update_viewer_);
         details::Progress::instance()->pop();
     }
 
 
     void ProgressLogger::notify(std::size_t new_value) {
-        cur_val_ = new_value;
+        if (!active_)
+            return;
+        ticks_.store(new_value * ticks_per_step, std::memory_order_relaxed);
         update();
     }
 
 
-    void ProgressLogger::next() {
-        cur_val_++;
+    void ProgressLogger::advance(std::size_t steps) {
+        if (!active_)
+            return;
+        ticks_.fetch_add(steps * ticks_per_step, std::memory_order_relaxed);
         update();
     }
 
 
     bool ProgressLogger::is_canceled() const {
-        return details::Progress::instance()->is_canceled();
+        return token_.is_canceled() || external_token_.is_canceled();
     }
 
 
@@ -128,13 +203,24 @@ namespace easy3d {
 
 
     void ProgressLogger::update() {
-        std::size_t percent = cur_val_ * 100 / std::max<std::size_t>(1, max_val_ - 1);
-        if (percent != cur_percent_) {
-            cur_percent_ = percent;
-            if (!quiet_) {
-                details::Progress::instance()->notify(std::min<std::size_t>(cur_percent_, 100), update_viewer_);
+        const std::uint64_t range = (max_val_ > 1 ? max_val_ - 1 : 1) * ticks_per_step;
+        const auto ticks = static_cast<double>(ticks_.load(std::memory_order_relaxed));
+        const std::size_t percent = std::min<std::size_t>(static_cast<std::size_t>(ticks * 100.0 / range), 100);
+        // only the thread that changes the percentage reports it
+        if (cur_percent_.load(std::memory_order_relaxed) == percent ||
+            cur_percent_.exchange(percent, std::memory_order_relaxed) == percent)
+            return;
+
+        if (parent_) {
+            const std::uint64_t target = parent_steps_ * ticks_per_step * percent / 100;
+            const std::uint64_t reported = reported_ticks_.exchange(target);
+            if (reported != target) {
+                parent_->ticks_.fetch_add(target - reported);   // (modular arithmetic if the progress is reset)
+                parent_->update();
             }
         }
+        else
+            details::Progress::instance()->notify(percent, update_viewer_);
     }
 
-}
\ No newline at end of file
+}
@@ -13,19 +13,58 @@
 
 
 #include <string>
+#include <memory>
+#include <atomic>
+#include <cstdint>
 
 
 namespace easy3d {
 
+    /**
+     * \brief A cooperative cancellation token.
+     * \class CancellationToken easy3d/util/progress.h
+     * \details Copies of a token share the same state, so a token can be passed (by value or reference) into an
+     *      algorithm, which checks is_canceled() from any of its (worker) threads, while another thread (e.g., the
+     *      GUI) calls cancel(). Checking a token is a relaxed atomic load.
+     *
+     *      Example usage:
+     *      \code
+     *          CancellationToken token;
+     *          std::thread worker([&]() { PointCloudNormals().estimate(cloud, 16, false, token); });
+     *          ...
+     *          token.cancel();     // e.g., the user clicked the "cancel" button
+     *          worker.join();
+     *      \endcode
+     */
+    class CancellationToken {
+    public:
+        /// Creates a new token, which is not canceled.
+        CancellationToken() : canceled_(std::make_shared<std::atomic<bool> >(false)) {}
+
+        /// Requests the cancellation. It can be called from any thread.
+        void cancel() const { canceled_->store(true, std::memory_order_relaxed); }
+        /// Returns whether the cancellation has been requested. It can be called from any thread.
+        bool is_canceled() const { return canceled_->load(std::memory_order_relaxed); }
+
+    private:
+        std::shared_ptr<std::atomic<bool> > canceled_;
+    };
+
+    //_________________________________________________________
+
     /**
      * \brief The based class of GUI element reporting the progress.
      * \class ProgressClient easy3d/util/progress.h
+     * \details The client may be notified from worker threads (e.g., by the sub-tasks of a parallel algorithm). The
+     *      notifications are serialized, i.e., notify() is never called concurrently, but a GUI client should make
+     *      sure its widgets are only updated in the GUI thread.
      */
     class ProgressClient {
     public:
         ProgressClient();
-        virtual ~ProgressClient() {}
+        virtual ~ProgressClient();
         virtual void notify(std::size_t percent, bool update_viewer) = 0;
+        /// Cancels the current task, i.e., cancels the token of the current top-level ProgressLogger.
         virtual void cancel();
     };
 
@@ -34,6 +73,28 @@ namespace easy3d {
     /**
      * \brief An implementation of progress logging mechanism.
      * \class ProgressLogger easy3d/util/progress.h
+     * \details The progress is an atomic counter, so next(), advance(), and is_canceled() can be called from multiple
+     *      threads (e.g., inside an OpenMP loop). The client is only notified when the percentage changes. A logger
+     *      is active (i.e., it reports progress) only if it is not quiet, a client is attached, and it is not nested in
+     *      another logger. An inactive logger does not count at all, so its overhead is negligible.
+     *
+     *      A task can be split into sub-tasks, each of which covers a number of steps of its parent and reports its
+     *      own progress as a fraction of these steps, e.g.,
+     *      \code
+     *          ProgressLogger progress(10, false);         // 10 steps in total
+     *          {
+     *              ProgressLogger sub(progress, 7, n);     // this sub-task counts 7 steps of the parent
+     *              #pragma omp parallel for
+     *              for (int i = 0; i < n; ++i) {
+     *                  if (sub.is_canceled())
+     *                      continue;
+     *                  ...
+     *                  sub.next();
+     *              }
+     *          }   // now the parent is at step 7
+     *          ...
+     *      \endcode
+     *      Sub-tasks can also run in parallel.
      */
     class ProgressLogger {
     public:
@@ -41,13 +102,29 @@ namespace easy3d {
         /// \param update_viewer \c true to trigger the viewer to update for each step.
         /// \param quiet \c true to make the logger quiet (i.e., don't notify the client).
         ProgressLogger(std::size_t max_val, bool update_viewer, bool quiet = false);
+        /// Same as above, and the task is also canceled by the given \p token (in addition to the client).
+        ProgressLogger(std::size_t max_val, bool update_viewer, bool quiet, const CancellationToken& token);
+        /// Creates a sub-task of \p parent. The sub-task covers \p parent_steps steps of its parent, and it has its
+        /// own progress range [0, max_val]. When the sub-task is destroyed, its parent has advanced by
+        /// \p parent_steps. A sub-task is canceled if its parent is canceled.
+        ProgressLogger(ProgressLogger& parent, std::size_t parent_steps, std::size_t max_val);
         virtual ~ProgressLogger();
 
+        /// Sets the current progress value. Unlike next() and advance(), it should not be mixed with sub-tasks or
+        /// called concurrently with other modifications.
         virtual void notify(std::size_t new_value);
-        virtual void next();
+        /// Advances the progress by one step. It can be called from multiple threads.
+        virtual void next() { advance(1); }
+        /// Advances the progress by \p steps steps. It can be called from multiple threads. In a tight parallel
+        /// loop, advancing by a batch of steps reduces the contention on the counter.
+        void advance(std::size_t steps);
         virtual void done() { notify(max_val_); }
 
+        /// Returns whether the task has been canceled (by the client or the token). It can be called from
+        /// multiple threads.
         bool is_canceled() const;
+        /// Returns the token that cancels this task, e.g., to pass it into an algorithm.
+        const CancellationToken& token() const { return token_; }
 
         /// Resets the progress logger without changing the progress range.
         void reset() { notify(0); }
@@ -58,11 +135,22 @@ namespace easy3d {
         virtual void update();
 
     private:
+        // the progress is counted in ticks, i.e., fractions of a step, so sub-tasks can report partial steps.
+        static const std::uint64_t ticks_per_step = 1024;
+
+        ProgressLogger* parent_;
+        std::size_t parent_steps_;
+        std::atomic<std::uint64_t> reported_ticks_;  // the ticks of the parent reported by this sub-task
+
         std::size_t max_val_;
-        std::size_t cur_val_;
-        std::size_t cur_percent_;
+        std::atomic<std::uint64_t> ticks_;
+        std::atomic<std::size_t> cur_percent_;
         bool quiet_;
         bool update_viewer_;
+        bool active_;
+        bool nested_;       // a plain logger nested in another one, which doesn't report progress
+        CancellationToken token_;
+        CancellationToken external_token_;
     };
 
 }   // namespace easy3d
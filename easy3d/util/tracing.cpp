@@ -0,0 +1,260 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/util/tracing.h>
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+    namespace tracing {
+
+        namespace details {
+
+            std::atomic<bool> running(false);
+
+            struct Event {
+                const char *name;
+                const char *category;
+                int64_t begin;
+                int64_t duration;
+                int track;
+            };
+
+            // The events of a thread. Only the owner thread writes, so no locks are needed for recording. The buffers
+            // are never freed (a thread may have exited before the events are saved).
+            struct ThreadBuffer {
+                ThreadBuffer(int id, std::size_t capacity) : id(id), events(capacity), count(0) {}
+                int id;
+                std::string name;
+                std::vector<Event> events;
+                std::atomic<std::size_t> count;   // the total number of events recorded (also the overwritten ones)
+            };
+
+            // The first thread is 1. The IDs of the tracks start from a large number to avoid conflicts with threads.
+            const int first_track_id = 100000;
+
+            struct Registry {
+                Registry() : buffer_size(65536) {}
+                std::mutex mutex;
+                std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+                std::vector<std::string> tracks;
+                std::size_t buffer_size;
+            };
+
+            // intentionally leaked, so it outlives the threads recording events during the static destruction
+            Registry &registry() {
+                static Registry *r = new Registry;
+                return *r;
+            }
+
+            thread_local ThreadBuffer *local_buffer = nullptr;
+
+            ThreadBuffer *thread_buffer() {
+                if (!local_buffer) {
+                    Registry &r = registry();
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    const int id = static_cast<int>(r.buffers.size()) + 1;
+                    r.buffers.emplace_back(new ThreadBuffer(id, std::max<std::size_t>(r.buffer_size, 1)));
+                    local_buffer = r.buffers.back().get();
+                    local_buffer->name = "thread " + std::to_string(id);
+                }
+                return local_buffer;
+            }
+
+            std::string escape(const char *s) {
+                std::string result;
+                for (; s && *s; ++s) {
+                    const char c = *s;
+                    if (c == '"' || c == '\\')
+                        result += '\\';
+                    if (static_cast<unsigned char>(c) < 0x20)
+                        result += ' ';
+                    else
+                        result += c;
+                }
+                return result;
+            }
+
+            // in microseconds, the time unit of the Chrome trace format
+            std::string microseconds(int64_t ns) {
+                char buf[32];
+                std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(ns) / 1000.0);
+                return buf;
+            }
+        }
+
+
+        void start(std::size_t buffer_size) {
+            details::Registry &r = details::registry();
+            {
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.buffer_size = buffer_size;
+            }
+            now();  // fixes the time base
+            details::running.store(true, std::memory_order_relaxed);
+        }
+
+
+        void stop() {
+            details::running.store(false, std::memory_order_relaxed);
+        }
+
+
+        void clear() {
+            details::Registry &r = details::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (auto &b : r.buffers)
+                b->count.store(0, std::memory_order_release);
+        }
+
+
+        std::size_t num_events() {
+            details::Registry &r = details::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            std::size_t num = 0;
+            for (const auto &b : r.buffers)
+                num += std::min(b->count.load(std::memory_order_acquire), b->events.size());
+            return num;
+        }
+
+
+        bool initialize_from_environment() {
+            static std::string file_name;
+            if (!file_name.empty())  // already initialized
+                return true;
+            const char *value = std::getenv("EASY3D_TRACE_FILE");
+            if (!value || !*value)
+                return false;
+
+            file_name = value;
+            start();
+            std::atexit([]() {
+                stop();
+                save(file_name);
+            });
+            LOG(INFO) << "tracing started (the trace will be saved to " << file_name << " on exit)";
+            return true;
+        }
+
+
+        int64_t now() {
+            static const auto base = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - base).count();
+        }
+
+
+        void set_thread_name(const std::string &name) {
+            details::ThreadBuffer *buffer = details::thread_buffer();
+            std::lock_guard<std::mutex> lock(details::registry().mutex);
+            buffer->name = name;
+        }
+
+
+        int track(const std::string &name) {
+            details::Registry &r = details::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            auto pos = std::find(r.tracks.begin(), r.tracks.end(), name);
+            if (pos == r.tracks.end())
+                pos = r.tracks.insert(r.tracks.end(), name);
+            return details::first_track_id + static_cast<int>(pos - r.tracks.begin());
+        }
+
+
+        void record(const char *name, const char *category, int64_t begin, int64_t duration, int track) {
+            details::ThreadBuffer *buffer = details::thread_buffer();
+            const std::size_t index = buffer->count.load(std::memory_order_relaxed);
+            details::Event &e = buffer->events[index % buffer->events.size()];
+            e.name = name;
+            e.category = category;
+            e.begin = begin;
+            e.duration = duration;
+            e.track = track;
+            buffer->count.store(index + 1, std::memory_order_release);
+        }
+
+
+        bool save(const std::string &file_name) {
+            std::ofstream output(file_name.c_str());
+            if (output.fail()) {
+                LOG(ERROR) << "could not open file: " << file_name;
+                return false;
+            }
+
+            details::Registry &r = details::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+
+            output << "{\"traceEvents\":[\n";
+            bool first = true;
+            auto metadata = [&](int id, const std::string &name) {
+                output << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << id
+                       << ",\"args\":{\"name\":\"" << details::escape(name.c_str()) << "\"}}";
+                first = false;
+            };
+            for (const auto &b : r.buffers)
+                metadata(b->id, b->name);
+            for (std::size_t i = 0; i < r.tracks.size(); ++i)
+                metadata(details::first_track_id + static_cast<int>(i), r.tracks[i]);
+
+            std::size_t num = 0;
+            for (const auto &b : r.buffers) {
+                const std::size_t count = b->count.load(std::memory_order_acquire);
+                const std::size_t capacity = b->events.size();
+                // the oldest events have been overwritten if the buffer is full
+                for (std::size_t i = (count > capacity ? count - capacity : 0); i < count; ++i) {
+                    const details::Event &e = b->events[i % capacity];
+                    output << (first ? "" : ",\n")
+                           << "{\"name\":\"" << details::escape(e.name) << "\",\"cat\":\""
+                           << details::escape(e.category) << "\",\"ph\":\"X\",\"ts\":" << details::microseconds(e.begin)
+                           << ",\"dur\":" << details::microseconds(e.duration) << ",\"pid\":1,\"tid\":"
+                           << (e.track ? e.track : b->id) << "}";
+                    first = false;
+                    ++num;
+                }
+            }
+            output << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+            if (output.fail()) {
+                LOG(ERROR) << "failed writing file: " << file_name;
+                return false;
+            }
+            LOG(INFO) << num << " events saved to " << file_name;
+            return true;
+        }
+
+    } // namespace tracing
+
+} // namespace easy3d
@@ -0,0 +1,169 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_UTIL_TRACING_H
+#define EASY3D_UTIL_TRACING_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+
+namespace easy3d {
+
+    /**
+     * \brief Lightweight tracing of the time spent in (nested) zones of code, for profiling without an external
+     *      profiler.
+     * \namespace easy3d::tracing
+     * \details A zone is a scope marked by EASY3D_TRACE_ZONE. While tracing is running (see start()), the begin and
+     *      the duration of each zone are recorded into a ring buffer of the calling thread, so recording is cheap
+     *      (no locks) and the most recent events are kept if a buffer is full. When tracing is not running, a zone
+     *      costs a relaxed atomic load. The recorded events can be saved in the Chrome trace format, which can be
+     *      viewed in chrome://tracing or https://ui.perfetto.dev. Example:
+     *      \code
+     *          void SurfaceMeshFoo::apply() {
+     *              EASY3D_TRACE_ZONE("SurfaceMeshFoo::apply");
+     *              {
+     *                  EASY3D_TRACE_ZONE("SurfaceMeshFoo::apply: initialization");
+     *                  ...
+     *              }
+     *              ...
+     *          }
+     *
+     *          tracing::start();
+     *          foo.apply();
+     *          tracing::stop();
+     *          tracing::save("trace.json");
+     *      \endcode
+     *      Tracing can be removed at compile time by switching off the CMake option EASY3D_ENABLE_TRACING, in which
+     *      case the macros expand to nothing.
+     * \note The names and categories of the zones are not copied, so they must be string literals (or otherwise
+     *      outlive the recorded events).
+     */
+    namespace tracing {
+
+        /// Starts recording. \p buffer_size is the number of events kept per thread (only affects the buffers of
+        /// threads that have not recorded any events yet).
+        void start(std::size_t buffer_size = 65536);
+
+        /// Stops recording. The recorded events are kept until clear() or the next start().
+        void stop();
+
+        /// Returns whether tracing is running.
+        inline bool is_running();
+
+        /// Discards all the recorded events.
+        void clear();
+
+        /// Returns the number of recorded events (of all threads).
+        std::size_t num_events();
+
+        /**
+         * \brief Saves the recorded events in the Chrome trace format (JSON).
+         * \details It should be called when no zones are being recorded, e.g., after stop().
+         * \return \c true on success.
+         */
+        bool save(const std::string &file_name);
+
+        /**
+         * \brief Starts tracing if the environment variable EASY3D_TRACE_FILE is set, and saves the trace into the
+         *      file it specifies when the program exits. This allows profiling an application without modifying it.
+         * \return \c true if tracing has been started.
+         */
+        bool initialize_from_environment();
+
+        /// Returns the time (in nanoseconds) since an arbitrary but fixed point (the time base of the events).
+        int64_t now();
+
+        /// Names the calling thread in the exported trace, e.g., "main" or "worker".
+        void set_thread_name(const std::string &name);
+
+        /**
+         * \brief Returns the ID of a track with the given name, for events that do not belong to a CPU thread, e.g.,
+         *      the timings of the GPU.
+         * \details The same ID is returned for the same name. The track appears as a thread in the exported trace.
+         */
+        int track(const std::string &name);
+
+        /**
+         * \brief Records an event explicitly, e.g., a duration measured by other means (such as a GPU timer).
+         * \param name The name of the event (see the note about names in the namespace).
+         * \param category The category of the event.
+         * \param begin The begin of the event (in nanoseconds, see now()).
+         * \param duration The duration of the event (in nanoseconds).
+         * \param track The track of the event (see track()), or 0 for the calling thread.
+         */
+        void record(const char *name, const char *category, int64_t begin, int64_t duration, int track = 0);
+
+
+        /// \brief A zone recording the time between its construction and destruction. Use EASY3D_TRACE_ZONE instead.
+        class Zone {
+        public:
+            Zone(const char *name, const char *category) : name_(name), category_(category), begin_(-1) {
+                if (is_running())
+                    begin_ = now();
+            }
+            ~Zone() {
+                if (begin_ >= 0 && is_running())
+                    record(name_, category_, begin_, now() - begin_);
+            }
+
+        private:
+            const char *name_;
+            const char *category_;
+            int64_t begin_;
+        };
+
+
+        namespace details {
+            extern std::atomic<bool> running;
+        }
+
+        inline bool is_running() { return details::running.load(std::memory_order_relaxed); }
+
+    } // namespace tracing
+
+} // namespace easy3d
+
+
+#define EASY3D_TRACE_CONCAT_(a, b) a##b
+#define EASY3D_TRACE_CONCAT(a, b) EASY3D_TRACE_CONCAT_(a, b)
+
+#ifdef EASY3D_ENABLE_TRACING
+/// Records the time spent in the enclosing scope as a zone named \p name (a string literal).
+#define EASY3D_TRACE_ZONE(name) \
+    ::easy3d::tracing::Zone EASY3D_TRACE_CONCAT(easy3d_trace_zone_, __LINE__)(name, "easy3d")
+/// Records the time spent in the enclosing scope as a zone named \p name in the category \p category.
+#define EASY3D_TRACE_ZONE_CATEGORY(name, category) \
+    ::easy3d::tracing::Zone EASY3D_TRACE_CONCAT(easy3d_trace_zone_, __LINE__)(name, category)
+#else
+#define EASY3D_TRACE_ZONE(name)
+#define EASY3D_TRACE_ZONE_CATEGORY(name, category)
+#endif
+
+
+#endif  // EASY3D_UTIL_TRACING_H
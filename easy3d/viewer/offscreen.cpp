@@ -0,0 +1,479 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/viewer/offscreen.h>
+
+#include <cstring>
+#include <algorithm>
+
+#include <easy3d/renderer/opengl.h>        // Initialize with glewInit()
+
+#ifdef EASY3D_HAS_EGL
+#  define EGL_NO_X11                      // we don't need the X11 types (and their macros)
+#  define MESA_EGL_NO_X11_HEADERS
+#  include <EGL/egl.h>
+#  include <EGL/eglext.h>
+#else
+#  include <3rd_party/glfw/include/GLFW/glfw3.h>    // Include glfw3.h after our OpenGL definitions
+#endif
+
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/renderer/renderer.h>
+#include <easy3d/renderer/manipulator.h>
+#include <easy3d/renderer/drawable_points.h>
+#include <easy3d/renderer/drawable_lines.h>
+#include <easy3d/renderer/drawable_triangles.h>
+#include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/framebuffer_object.h>
+#include <easy3d/renderer/async_readback.h>
+#include <easy3d/renderer/shader_manager.h>
+#include <easy3d/renderer/texture_manager.h>
+#include <easy3d/renderer/opengl_error.h>
+#include <easy3d/fileio/point_cloud_io.h>
+#include <easy3d/fileio/graph_io.h>
+#include <easy3d/fileio/surface_mesh_io.h>
+#include <easy3d/fileio/poly_mesh_io.h>
+#include <easy3d/fileio/ply_reader_writer.h>
+#include <easy3d/util/file_system.h>
+#include <easy3d/util/logging.h>
+
+
+namespace easy3d {
+
+
+    struct OffScreen::Context {
+#ifdef EASY3D_HAS_EGL
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLSurface surface = EGL_NO_SURFACE;    // only if surfaceless contexts are not supported
+        EGLContext context = EGL_NO_CONTEXT;
+#else
+        GLFWwindow *window = nullptr;
+#endif
+    };
+
+
+    OffScreen::OffScreen(int width, int height, int samples, int gl_major, int gl_minor)
+            : context_(nullptr), width_(width), height_(height), samples_(0)
+            , background_color_(1.0f, 1.0f, 1.0f, 1.0f), camera_(nullptr), fbo_(nullptr)
+    {
+        // Initialize logging (if it has not been initialized yet)
+        if (!logging::is_initialized())
+            logging::initialize();
+
+        // Avoid locale-related number parsing issues.
+        setlocale(LC_NUMERIC, "C");
+
+        if (!create_context(gl_major, gl_minor))
+            return;
+
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LESS);
+
+        int max_samples = 0;
+        glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+        samples_ = std::min(samples, max_samples);
+        if (samples > 0 && samples_ != samples)
+            LOG(WARNING) << "MSAA is available with " << samples_ << " samples (" << samples
+                         << " requested but max support is " << max_samples << ")";
+
+        fbo_ = new FramebufferObject(width_, height_, samples_);
+        fbo_->add_color_buffer();
+        fbo_->add_depth_buffer();
+
+        // the same default view as the Viewer
+        camera_ = new Camera;
+        camera_->setType(Camera::PERSPECTIVE);
+        camera_->setUpVector(vec3(0, 0, 1)); // Z pointing up
+        camera_->setViewDirection(vec3(-1, 0, 0)); // X pointing out
+        camera_->setScreenWidthAndHeight(width_, height_);
+        camera_->showEntireScene();
+    }
+
+
+    OffScreen::~OffScreen() {
+        if (make_current()) {
+            clear_models();
+            delete fbo_;
+            ShaderManager::terminate();
+            TextureManager::terminate();
+        }
+        delete camera_;
+        destroy_context();
+    }
+
+
+#ifdef EASY3D_HAS_EGL
+
+    bool OffScreen::create_context(int gl_major, int gl_minor) {
+        context_ = new Context;
+
+        // prefer the surfaceless platform (Mesa), which needs neither a display server nor a GPU
+        const char *client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (get_platform_display && client_extensions &&
+            std::strstr(client_extensions, "EGL_MESA_platform_surfaceless"))
+            context_->display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (context_->display == EGL_NO_DISPLAY)
+            context_->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        EGLint major = 0, minor = 0;
+        if (context_->display == EGL_NO_DISPLAY || !eglInitialize(context_->display, &major, &minor)) {
+            LOG(ERROR) << "failed to initialize EGL (error code: 0x" << std::hex << eglGetError() << std::dec << ")";
+            destroy_context();
+            return false;
+        }
+        VLOG(1) << "EGL version: " << major << "." << minor;
+
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            LOG(ERROR) << "EGL does not support desktop OpenGL";
+            destroy_context();
+            return false;
+        }
+
+        // the default framebuffer is not used (we always render into a framebuffer object)
+        const EGLint config_attributes[] = {
+                EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+                EGL_NONE
+        };
+        EGLConfig config = nullptr;
+        EGLint num_configs = 0;
+        if (!eglChooseConfig(context_->display, config_attributes, &config, 1, &num_configs) || num_configs < 1) {
+            LOG(ERROR) << "no suitable EGL configuration";
+            destroy_context();
+            return false;
+        }
+
+        const EGLint context_attributes[] = {
+                EGL_CONTEXT_MAJOR_VERSION, gl_major,
+                EGL_CONTEXT_MINOR_VERSION, gl_minor,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE
+        };
+        context_->context = eglCreateContext(context_->display, config, EGL_NO_CONTEXT, context_attributes);
+        if (context_->context == EGL_NO_CONTEXT) {
+            LOG(ERROR) << "failed to create OpenGL " << gl_major << "." << gl_minor << " context (error code: 0x"
+                       << std::hex << eglGetError() << std::dec << ")";
+            destroy_context();
+            return false;
+        }
+
+        const char *display_extensions = eglQueryString(context_->display, EGL_EXTENSIONS);
+        if (!display_extensions || !std::strstr(display_extensions, "EGL_KHR_surfaceless_context")) {
+            const EGLint pbuffer_attributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+            context_->surface = eglCreatePbufferSurface(context_->display, config, pbuffer_attributes);
+        }
+
+        if (!make_current()) {
+            LOG(ERROR) << "failed to make the EGL context current";
+            destroy_context();
+            return false;
+        }
+
+        // Load OpenGL and its extensions. GLEW also initializes GLX, which fails without an X display. This is
+        // expected here because the OpenGL functions have been loaded anyway.
+        const GLenum status = glewInit();
+        if (status != GLEW_OK && status != GLEW_ERROR_NO_GLX_DISPLAY) {
+            glGetError(); // pull and ignore unhandled errors like GL_INVALID_ENUM
+            LOG(ERROR) << "failed to load OpenGL and its extensions";
+            destroy_context();
+            return false;
+        }
+        glGetError(); // pull and ignore unhandled errors like GL_INVALID_ENUM
+
+        VLOG(1) << "OpenGL vendor: " << glGetString(GL_VENDOR);
+        VLOG(1) << "OpenGL renderer: " << glGetString(GL_RENDERER);
+        VLOG(1) << "OpenGL version received: " << glGetString(GL_VERSION);
+        return true;
+    }
+
+
+    void OffScreen::destroy_context() {
+        if (!context_)
+            return;
+        if (context_->display != EGL_NO_DISPLAY) {
+            eglMakeCurrent(context_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (context_->context != EGL_NO_CONTEXT)
+                eglDestroyContext(context_->display, context_->context);
+            if (context_->surface != EGL_NO_SURFACE)
+                eglDestroySurface(context_->display, context_->surface);
+            eglTerminate(context_->display);
+        }
+        delete context_;
+        context_ = nullptr;
+    }
+
+
+    bool OffScreen::make_current() const {
+        if (!context_ || context_->context == EGL_NO_CONTEXT)
+            return false;
+        if (eglGetCurrentContext() == context_->context)
+            return true;
+        return eglMakeCurrent(context_->display, context_->surface, context_->surface, context_->context) == EGL_TRUE;
+    }
+
+#else
+
+    bool OffScreen::create_context(int gl_major, int gl_minor) {
+        if (!glfwInit()) {
+            LOG(ERROR) << "could not initialize GLFW";
+            return false;
+        }
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, gl_major);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, gl_minor);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+        context_ = new Context;
+        context_->window = glfwCreateWindow(1, 1, "Easy3D OffScreen", nullptr, nullptr);
+        if (!context_->window) {
+            LOG(ERROR) << "failed to create OpenGL " << gl_major << "." << gl_minor << " context";
+            destroy_context();
+            return false;
+        }
+        glfwMakeContextCurrent(context_->window);
+
+        // Load OpenGL and its extensions
+        if (glewInit() != GLEW_OK) {
+            glGetError(); // pull and ignore unhandled errors like GL_INVALID_ENUM
+            LOG(ERROR) << "failed to load OpenGL and its extensions";
+            destroy_context();
+            return false;
+        }
+
+        VLOG(1) << "OpenGL vendor: " << glGetString(GL_VENDOR);
+        VLOG(1) << "OpenGL renderer: " << glGetString(GL_RENDERER);
+        VLOG(1) << "OpenGL version received: " << glGetString(GL_VERSION);
+        return true;
+    }
+
+
+    void OffScreen::destroy_context() {
+        if (!context_)
+            return;
+        if (context_->window)
+            glfwDestroyWindow(context_->window);
+        delete context_;
+        context_ = nullptr;
+        glfwTerminate();
+    }
+
+
+    bool OffScreen::make_current() const {
+        if (!context_ || !context_->window)
+            return false;
+        glfwMakeContextCurrent(context_->window);
+        return true;
+    }
+
+#endif
+
+
+    bool OffScreen::is_valid() const {
+        return context_ && fbo_ && fbo_->is_valid();
+    }
+
+
+    void OffScreen::resize(int w, int h) {
+        width_ = w;
+        height_ = h;
+        if (camera_)
+            camera_->setScreenWidthAndHeight(w, h);
+        if (fbo_ && make_current())
+            fbo_->ensure_size(w, h);
+    }
+
+
+    Model *OffScreen::add_model(const std::string &file_name, bool create_default_drawables) {
+        const std::string &ext = file_system::extension(file_name, true);
+        bool is_ply_mesh = false;
+        if (ext == "ply")
+            is_ply_mesh = (io::PlyReader::num_instances(file_name, "face") > 0);
+
+        Model *model = nullptr;
+        if ((ext == "ply" && is_ply_mesh) || ext == "obj" || ext == "off" || ext == "stl" || ext == "sm" || ext == "geojson" || ext == "trilist") { // mesh
+            model = SurfaceMeshIO::load(file_name);
+        } else if (ext == "ply" && io::PlyReader::num_instances(file_name, "edge") > 0) {
+            model = GraphIO::load(file_name);
+        } else if (ext == "plm" || ext == "pm" || ext == "mesh") {
+            model = PolyMeshIO::load(file_name);
+        } else // point cloud
+            model = PointCloudIO::load(file_name);
+
+        if (model) {
+            model->set_name(file_name);
+            add_model(model, create_default_drawables);
+        }
+        return model;
+    }
+
+
+    Model *OffScreen::add_model(Model *model, bool create_default_drawables) {
+        if (!model) {
+            LOG(WARNING) << "model is NULL.";
+            return nullptr;
+        }
+        if (std::find(models_.begin(), models_.end(), model) != models_.end()) {
+            LOG(WARNING) << "model has already been added: " << model->name();
+            return nullptr;
+        }
+
+        make_current();     // the drawables create their vertex array objects
+        model->set_renderer(new Renderer(model, create_default_drawables));
+        model->set_manipulator(new Manipulator(model));
+        models_.push_back(model);
+        return model;
+    }
+
+
+    bool OffScreen::delete_model(Model *model) {
+        auto pos = std::find(models_.begin(), models_.end(), model);
+        if (pos == models_.end()) {
+            LOG(WARNING) << "no such model: " << (model ? model->name() : "NULL");
+            return false;
+        }
+
+        models_.erase(pos);
+        make_current();     // the rendering buffers are released with the drawables
+        delete model->renderer();
+        delete model->manipulator();
+        delete model;
+        return true;
+    }
+
+
+    void OffScreen::clear_models() {
+        make_current();     // the rendering buffers are released with the drawables
+        for (auto m : models_) {
+            delete m->renderer();
+            delete m->manipulator();
+            delete m;
+        }
+        models_.clear();
+    }
+
+
+    void OffScreen::fit_screen() {
+        if (!camera_)
+            return;
+
+        Box3 box;
+        for (auto m : models_) {
+            box.grow(m->bounding_box());
+            for (auto d : m->renderer()->points_drawables()) box.grow(d->bounding_box());
+            for (auto d : m->renderer()->lines_drawables()) box.grow(d->bounding_box());
+            for (auto d : m->renderer()->triangles_drawables()) box.grow(d->bounding_box());
+        }
+
+        if (box.is_valid()) {
+            camera_->setSceneBoundingBox(box.min_point(), box.max_point());
+            camera_->showEntireScene();
+        }
+    }
+
+
+    bool OffScreen::render_to_fbo(bool see_all) {
+        if (!is_valid() || !make_current()) {
+            LOG(ERROR) << "the OpenGL context is not available";
+            return false;
+        }
+
+        if (see_all)
+            fit_screen();
+
+        fbo_->bind();
+        glViewport(0, 0, width_, height_);
+        glClearColor(background_color_[0], background_color_[1], background_color_[2], background_color_[3]);
+        glClearDepth(1.0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        draw();
+        fbo_->release();
+        return true;
+    }
+
+
+    bool OffScreen::render(const std::string &file_name, bool see_all) {
+        if (!render_to_fbo(see_all))
+            return false;
+        return fbo_->snapshot_color(0, file_name);
+    }
+
+
+    bool OffScreen::render(std::vector<unsigned char> &rgba, bool see_all) {
+        if (!render_to_fbo(see_all))
+            return false;
+        return fbo_->read_color(0, rgba, GL_RGBA, true);
+    }
+
+
+    bool OffScreen::render(AsyncReadback &readback, unsigned int format, bool see_all) {
+        if (!render_to_fbo(see_all))
+            return false;
+        return readback.read_color(fbo_, 0, format, true);
+    }
+
+
+    void OffScreen::draw() const {
+        for (const auto m : models_) {
+            if (!m->renderer()->is_visible())
+                continue;
+
+            // Same as the Viewer: if edges and surfaces are both shown, we make the depth coordinates of the surface
+            // smaller, so that displaying the mesh and the surface together does not cause Z-fighting.
+            std::size_t count = 0;
+            for (auto d : m->renderer()->lines_drawables()) {
+                if (d->is_visible()) {
+                    d->draw(camera_); easy3d_debug_log_gl_error;
+                    ++count;
+                }
+            }
+
+            for (auto d : m->renderer()->points_drawables()) {
+                if (d->is_visible())
+                    d->draw(camera_); easy3d_debug_log_gl_error;
+            }
+
+            if (count > 0) {
+                glEnable(GL_POLYGON_OFFSET_FILL);
+                glPolygonOffset(0.5f, -0.0001f);
+            }
+            for (auto d : m->renderer()->triangles_drawables()) {
+                if (d->is_visible())
+                    d->draw(camera_); easy3d_debug_log_gl_error;
+            }
+            if (count > 0)
+                glDisable(GL_POLYGON_OFFSET_FILL);
+        }
+    }
+
+}
@@ -0,0 +1,182 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#ifndef EASY3D_VIEWER_OFFSCREEN_H
+#define EASY3D_VIEWER_OFFSCREEN_H
+
+
+#include <string>
+#include <vector>
+
+#include <easy3d/core/types.h>
+
+
+namespace easy3d {
+
+    class Camera;
+    class Model;
+    class FramebufferObject;
+    class AsyncReadback;
+
+    /**
+     * @brief Offscreen rendering of models into images, without a visible window.
+     * @class OffScreen easy3d/viewer/offscreen.h
+     * @details OffScreen creates an OpenGL context that is not associated with any window. On Linux, if EGL is
+     *      available when building Easy3D, a surfaceless EGL context is created. This does not require a display
+     *      server and also runs on machines without a GPU (e.g., with Mesa's llvmpipe). On other platforms, a hidden
+     *      GLFW window provides the context. The models are rendered with their drawables into a framebuffer object,
+     *      and the results are saved into image files or returned as pixels.
+     *      The context, the framebuffer object, and the shader programs are kept across renderings, so rendering a
+     *      large number of models in a row (e.g., generating thumbnails) does not pay the setup costs again, e.g.,
+     *      \code
+     *          OffScreen os(512, 512);
+     *          for (const auto& file : files) {
+     *              if (os.add_model(file)) {
+     *                  os.render(file_system::replace_extension(file, "png"));
+     *                  os.clear_models();
+     *              }
+     *          }
+     *      \endcode
+     * @note Only one OffScreen (or Viewer) should exist at a time, because they share the shader programs and
+     *      textures managed by ShaderManager and TextureManager.
+     */
+    class OffScreen {
+    public:
+        /**
+         * @brief Creates the OpenGL context and the framebuffer object for rendering.
+         * @param width/height The size (in pixels) of the rendered images.
+         * @param samples The number of samples for multisample antialiasing.
+         * @param gl_major/gl_minor The OpenGL version to request.
+         */
+        OffScreen(int width = 800, int height = 600, int samples = 4, int gl_major = 3, int gl_minor = 2);
+
+        virtual ~OffScreen();
+
+        /// @brief Returns whether the OpenGL context has been successfully created.
+        bool is_valid() const;
+
+        /// @brief Changes the size (in pixels) of the rendered images.
+        void resize(int w, int h);
+        /// @brief Returns the width of the rendered images.
+        int width() const { return width_; }
+        /// @brief Returns the height of the rendered images.
+        int height() const { return height_; }
+        /// @brief Returns the actual number of samples of the framebuffer object.
+        int samples() const { return samples_; }
+
+        /// @brief Sets the background color.
+        void set_background_color(const vec4 &c) { background_color_ = c; }
+        /// @brief Returns the background color.
+        const vec4 &background_color() const { return background_color_; }
+
+        /// @brief Returns the camera used for rendering.
+        Camera *camera() { return camera_; }
+        /// @brief Returns the camera used for rendering.
+        const Camera *camera() const { return camera_; }
+
+        /**
+         * @brief Loads a model from a file and adds it for rendering. The model will be owned by this OffScreen.
+         * @param file_name The file name of the model. The type of the model (i.e., SurfaceMesh, PolyMesh, Graph,
+         *      or PointCloud) is determined by the file extension (and the content for PLY files), the same as for
+         *      the Viewer.
+         * @param create_default_drawables If true, the default drawables will be created.
+         * @return The model on success, otherwise nullptr.
+         */
+        Model *add_model(const std::string &file_name, bool create_default_drawables = true);
+
+        /**
+         * @brief Adds a model for rendering. The model will be owned by this OffScreen.
+         * @return The model on success, otherwise nullptr.
+         */
+        Model *add_model(Model *model, bool create_default_drawables = true);
+
+        /// @brief Deletes a model (and its renderer). Returns false if the model does not belong to this OffScreen.
+        bool delete_model(Model *model);
+
+        /// @brief Deletes all the models. The context and the shader programs are kept for the next models.
+        void clear_models();
+
+        /// @brief Returns the models.
+        const std::vector<Model *> &models() const { return models_; }
+
+        /// @brief Moves the camera so that all the models are visible.
+        void fit_screen();
+
+        /**
+         * @brief Renders the models and saves the result into an image file.
+         * @param file_name The image file name. Supported formats are png, jpg, bmp, ppm, and tga.
+         * @param see_all If true, the camera is moved (see fit_screen()) to see all the models before rendering.
+         * @return true on success.
+         */
+        bool render(const std::string &file_name, bool see_all = true);
+
+        /**
+         * @brief Renders the models and reads back the result.
+         * @param rgba The pixels in RGBA format (the first row is the top of the image).
+         * @param see_all If true, the camera is moved (see fit_screen()) to see all the models before rendering.
+         * @return true on success.
+         */
+        bool render(std::vector<unsigned char> &rgba, bool see_all = true);
+
+        /**
+         * @brief Renders the models and starts reading back the result asynchronously. It returns without waiting
+         *      for the pixels, which will be handed to the consumer of \p readback. This way, the models can be
+         *      changed and the next image can be rendered while the previous one is being transferred and saved.
+         * @param readback The readback (created with the context of this OffScreen, i.e., after its construction).
+         * @param format The format of the pixels, which must be one of GL_RGB, GL_BGR, GL_RGBA, and GL_BGRA.
+         * @param see_all If true, the camera is moved (see fit_screen()) to see all the models before rendering.
+         * @return true on success.
+         */
+        bool render(AsyncReadback &readback, unsigned int format, bool see_all = true);
+
+    protected:
+        /// Draws the models. It can be reimplemented to customize the rendering.
+        virtual void draw() const;
+
+    private:
+        bool create_context(int gl_major, int gl_minor);
+        void destroy_context();
+        bool make_current() const;
+        bool render_to_fbo(bool see_all);
+
+    private:
+        struct Context;  // the platform-dependent OpenGL context
+        Context *context_;
+
+        int width_;
+        int height_;
+        int samples_;
+        vec4 background_color_;
+
+        Camera *camera_;
+        FramebufferObject *fbo_;
+        std::vector<Model *> models_;
+    };
+
+}
+
+
+#endif  // EASY3D_VIEWER_OFFSCREEN_H
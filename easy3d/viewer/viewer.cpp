@@ -53,6 +53,7 @@
 #include <easy3d/renderer/transform.h>
 #include <easy3d/renderer/shapes.h>
 #include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/culling.h>
 #include <easy3d/renderer/manipulated_camera_frame.h>
 #include <easy3d/renderer/key_frame_interpolator.h>
 #include <easy3d/renderer/framebuffer_object.h>
@@ -60,6 +61,7 @@
 #include <easy3d/renderer/setting.h>
 #include <easy3d/renderer/text_renderer.h>
 #include <easy3d/renderer/texture_manager.h>
+#include <easy3d/renderer/opengl_timer.h>
 #include <easy3d/fileio/resources.h>
 #include <easy3d/fileio/point_cloud_io.h>
 #include <easy3d/fileio/graph_io.h>
@@ -71,6 +73,7 @@
 #include <easy3d/util/file_system.h>
 #include <easy3d/util/logging.h>
 #include <easy3d/util/timer.h>
+#include <easy3d/util/tracing.h>
 #include <easy3d/util/string.h>
 
 
@@ -102,12 +105,14 @@ namespace easy3d {
         , dpi_scaling_(1.0)
         , title_(title)
         , camera_(nullptr)
+        , culler_(nullptr)
         , is_animating_(false)
         , samples_(0)
         , full_screen_(full_screen)
         , background_color_(0.9f, 0.9f, 1.0f, 1.0f)
         , process_events_(true)
         , texter_(nullptr)
+        , gpu_timer_(nullptr)
         , pressed_button_(-1)
         , modifiers_(-1)
         , drag_active_(false)
@@ -128,6 +133,8 @@ namespace easy3d {
         // Initialize logging (if it has not been initialized yet)
         if (!logging::is_initialized())
             logging::initialize();
+        // profile the viewer if requested (by the environment variable EASY3D_TRACE_FILE)
+        tracing::initialize_from_environment();
 
         // Avoid locale-related number parsing issues.
         setlocale(LC_NUMERIC, "C");
@@ -146,6 +153,8 @@ namespace easy3d {
 
         easy3d::connect(&camera_->frame_modified, this, &Viewer::update);
 
+        culler_ = new Culler;
+
         kfi_ = new KeyFrameInterpolator(camera_->frame());
         easy3d::connect(&kfi_->interpolation_stopped, this, &Viewer::update);
 
@@ -536,9 +545,12 @@ namespace easy3d {
             return;
 
         delete camera_;
+        delete culler_;
         delete kfi_;
         delete drawable_axes_;
         delete texter_;
+        delete gpu_timer_;
+        gpu_timer_ = nullptr;
 
         clear_scene();
 
@@ -1026,6 +1038,12 @@ namespace easy3d {
         // show the window
         glfwShowWindow(window_);
 
+#ifdef EASY3D_ENABLE_TRACING
+        tracing::set_thread_name("viewer");
+        if (!gpu_timer_)
+            gpu_timer_ = new OpenGLTraceTimer("Viewer::draw");
+#endif
+
         try {   // main loop
             static int frame_counter = 0;
             double last_time = glfwGetTime();   // for frame rate counter
@@ -1048,10 +1066,24 @@ namespace easy3d {
                     }
                 }
 
-                pre_draw();
-                draw();
-                post_draw();
-                glfwSwapBuffers(window_);
+                {
+                    EASY3D_TRACE_ZONE_CATEGORY("Viewer::frame", "viewer");
+                    pre_draw();
+                    if (gpu_timer_)
+                        gpu_timer_->start();
+                    {
+                        EASY3D_TRACE_ZONE_CATEGORY("Viewer::draw", "viewer");
+                        draw();
+                    }
+                    {
+                        EASY3D_TRACE_ZONE_CATEGORY("Viewer::post_draw", "viewer");
+                        post_draw();
+                    }
+                    if (gpu_timer_)
+                        gpu_timer_->stop();
+                    EASY3D_TRACE_ZONE_CATEGORY("Viewer::swap_buffers", "viewer");
+                    glfwSwapBuffers(window_);
+                }
 
                 if (is_animating_ && animation_func_) {
                     glfwPollEvents();
@@ -1570,8 +1602,14 @@ namespace easy3d {
             const float offset = 20.0f * dpi_scaling();
             texter_->draw("Easy3D", offset, offset, font_size, 0);
 
-            if (show_frame_rate_)
+            if (show_frame_rate_) {
                 texter_->draw(gpu_time_, offset, 50.0f * dpi_scaling(), 16, 1);
+                const Culler::Statistics &stats = culler_->statistics();
+                char culling[64];
+                sprintf(culling, "drawables: %zu drawn, %zu culled", stats.drawn,
+                        stats.frustum_culled + stats.size_culled);
+                texter_->draw(culling, offset, 80.0f * dpi_scaling(), 16, 1);
+            }
         }
 
         // shown only when it is not animating
@@ -1729,8 +1767,11 @@ namespace easy3d {
 
 
     void Viewer::draw() const {
+        // models (and thus their drawables) outside the view frustum or too small on screen are skipped
+        culler_->cull(models_, camera());
+
         for (const auto m : models_) {
-            if (!m->renderer()->is_visible())
+            if (!m->renderer()->is_visible() || culler_->test(m) != Culler::VISIBLE)
                 continue;
 
             // Let's check if edges and surfaces are both shown. If true, we
@@ -1762,7 +1803,7 @@ namespace easy3d {
         }
 
         for (auto d : drawables_) {
-            if (d->is_visible())
+            if (d->is_visible() && culler_->test(d) == Culler::VISIBLE)
                 d->draw(camera());
         }
 
@@ -39,11 +39,13 @@ struct GLFWwindow;
 namespace easy3d {
 
 	class Camera;
+	class Culler;
 	class Model;
     class Drawable;
     class TrianglesDrawable;
     class TextRenderer;
     class KeyFrameInterpolator;
+    class OpenGLTraceTimer;
 
     /**
      * @brief The built-in Easy3D Viewer.
@@ -160,6 +162,12 @@ namespace easy3d {
         Camera* camera() { return camera_; }
         /// @brief Returns the camera used by the viewer. See \c Camera.
         const Camera* camera() const { return camera_; }
+
+        /// @brief Returns the culler used by the viewer, e.g., to enable/disable frustum culling, to set the
+        ///        threshold of small-feature culling, or to query the number of drawn/culled drawables. See \c Culler.
+        Culler* culler() { return culler_; }
+        /// @brief Returns the culler used by the viewer. See \c Culler.
+        const Culler* culler() const { return culler_; }
         //@}
 
         /// @name File IO
@@ -465,6 +473,7 @@ namespace easy3d {
 
 		std::string	title_;
 		Camera*		camera_;
+		Culler*		culler_;
 
         KeyFrameInterpolator* kfi_;
         bool is_animating_;
@@ -479,6 +488,7 @@ namespace easy3d {
 		char   gpu_time_[48];       // show the frame rate
 
         TextRenderer* texter_;
+        OpenGLTraceTimer* gpu_timer_;   // the GPU time of the frames (only when tracing)
 
 		// mouse
 		int		pressed_button_;    // for mouse drag
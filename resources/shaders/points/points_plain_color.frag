@@ -48,11 +48,24 @@ uniform int  highlight_id_max;
 
 uniform bool selected = false;
 
+// the selection state of the points (one bit per point)
+uniform bool            per_point_selection = false;
+uniform usamplerBuffer  selection;
+
+bool point_selected(int index) {
+    if (!per_point_selection)
+        return false;
+    int addr = index >> 5;
+    int offs = index & 31;
+    return (texelFetch(selection, addr).r & (1u << offs)) != 0u;
+}
+
 
 in Data{
     vec4 color;
     vec3 position;
     vec3 normal;
+    flat int point_index;  // the index of the point
 } DataIn;
 
 out vec4 outputF;
@@ -60,7 +73,7 @@ out vec4 outputF;
 void main(void) {
     if (!lighting) {
         outputF = DataIn.color;
-        if (selected)
+        if (selected || point_selected(DataIn.point_index))
             outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
         if (highlight) {
             if (gl_PrimitiveID >= highlight_id_min && gl_PrimitiveID <= highlight_id_max)
@@ -86,7 +99,7 @@ void main(void) {
             color = backside_color;
     }
 
-    if (selected)
+    if (selected || point_selected(DataIn.point_index))
         color = mix(color, vec3(1.0, 0.0, 0.0), 0.6);
 
     float df = 0.0;	// diffuse factor
@@ -46,6 +46,7 @@ out Data{
     vec4 color;
     vec3 position;
     vec3 normal;
+    flat int point_index;  // the index of the point
 } DataOut;
 
 
@@ -54,6 +55,7 @@ void main(void) {
 
     DataOut.position = vtx_position;
     DataOut.normal = NORMAL * vtx_normal;
+    DataOut.point_index = gl_VertexID;
 
     if (per_vertex_color)
         DataOut.color = vec4(vtx_color, 1.0);
@@ -53,10 +53,23 @@ uniform int  highlight_id_max;
 
 uniform bool selected = false;
 
+// the selection state of the points (one bit per point)
+uniform bool            per_point_selection = false;
+uniform usamplerBuffer  selection;
+
+bool point_selected(int index) {
+    if (!per_point_selection)
+        return false;
+    int addr = index >> 5;
+    int offs = index & 31;
+    return (texelFetch(selection, addr).r & (1u << offs)) != 0u;
+}
+
 in Data{
 	vec3 position;
 	vec2 texcoord;
 	vec3 normal;
+	flat	int		point_index;	// the index of the point
 } DataIn;
 
 
@@ -68,7 +81,7 @@ void main()
 	vec3 color = texture(textureID, DataIn.texcoord).rgb;
 	if (!lighting) {
 		outputF = vec4(color, 1.0);
-		if (selected)
+		if (selected || point_selected(DataIn.point_index))
 			outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
 		return;
 	}
@@ -87,7 +100,7 @@ void main()
 			color = backside_color;
 	}
 
-	if (selected)
+	if (selected || point_selected(DataIn.point_index))
 		color = mix(color, vec3(1.0, 0.0, 0.0), 0.6);
 
 	float df = 0.0;// diffuse factor
@@ -46,6 +46,7 @@ out Data{
     vec3 position;
     vec2 texcoord;
     vec3 normal;
+    flat int point_index;  // the index of the point
 } DataOut;
 
 
@@ -55,6 +56,7 @@ void main() {
     DataOut.position = vtx_position;
     DataOut.texcoord = vtx_texcoord;
     DataOut.normal = NORMAL * vtx_normal;
+    DataOut.point_index = gl_VertexID;
 
     if (clippingPlaneEnabled) {
         gl_ClipDistance[0] = dot(new_position, clippingPlane0);
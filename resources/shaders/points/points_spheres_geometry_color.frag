@@ -47,10 +47,23 @@ uniform int  highlight_id_max;
 
 uniform bool selected = false;
 
+// the selection state of the points (one bit per point)
+uniform bool            per_point_selection = false;
+uniform usamplerBuffer  selection;
+
+bool point_selected(int index) {
+    if (!per_point_selection)
+        return false;
+    int addr = index >> 5;
+    int offs = index & 31;
+    return (texelFetch(selection, addr).r & (1u << offs)) != 0u;
+}
+
 in Data{
 	flat    vec4    sphere_color;
 	smooth  vec2    tex;
 	flat    vec4    position;
+	flat    int     point_index;  // the index of the point
 } DataIn;
 
 out vec4 outputF;
@@ -89,7 +102,7 @@ void main()
 
 		if (!lighting) {
 			outputF = DataIn.sphere_color;
-			if (selected)
+			if (selected || point_selected(DataIn.point_index))
 			outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
 			return;
 		}
@@ -137,7 +150,7 @@ void main()
 
 		if (!lighting) {
 			outputF = DataIn.sphere_color;
-			if (selected)
+			if (selected || point_selected(DataIn.point_index))
 			outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
 			return;
 		}
@@ -165,6 +178,6 @@ void main()
 		outputF = vec4(color * df + specular * sf + ambient, DataIn.sphere_color.a);
 	}
 
-	if (selected)
+	if (selected || point_selected(DataIn.point_index))
 		outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
 }
@@ -36,12 +36,14 @@ uniform bool per_vertex_color;
 uniform mat4 MANIP = mat4(1.0);
 
 out vec4 sphere_color_in;
+flat out int point_index_in;   // the index of the point
 
 void main()
 {
     vec4 new_position = MANIP * vec4(vtx_position, 1.0);
 
     gl_Position = new_position;
+    point_index_in = gl_VertexID;
 
 	if (per_vertex_color)
         sphere_color_in = vec4(vtx_color, 1.0);
@@ -33,6 +33,7 @@ in vec3  vtx_position;
 in vec2  vtx_texcoord;
 
 out vec2 texcoord;
+flat out int point_index_in;   // the index of the point
 
 void main()
 {
@@ -41,4 +42,5 @@ void main()
 	texcoord = vtx_texcoord;
 
 	gl_Position = new_position;
+	point_index_in = gl_VertexID;
 }
\ No newline at end of file
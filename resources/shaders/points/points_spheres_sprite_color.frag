@@ -50,10 +50,23 @@ uniform int  highlight_id_max;
 
 uniform bool selected = false;
 
+// the selection state of the points (one bit per point)
+uniform bool            per_point_selection = false;
+uniform usamplerBuffer  selection;
+
+bool point_selected(int index) {
+    if (!per_point_selection)
+        return false;
+    int addr = index >> 5;
+    int offs = index & 31;
+    return (texelFetch(selection, addr).r & (1u << offs)) != 0u;
+}
+
 in Data{
     vec4    position;// in eye space
     vec4    sphere_color;
 //float	sphere_radius;
+    flat int point_index;  // the index of the point
 } DataIn;
 
 out vec4 outputF;
@@ -99,7 +112,7 @@ void main()
 
         if (!lighting) {
             outputF = DataIn.sphere_color;
-            if (selected)
+            if (selected || point_selected(DataIn.point_index))
             outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
             return;
         }
@@ -148,7 +161,7 @@ void main()
 
         if (!lighting) {
             outputF = DataIn.sphere_color;
-            if (selected)
+            if (selected || point_selected(DataIn.point_index))
             outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
             return;
         }
@@ -176,6 +189,6 @@ void main()
         outputF = vec4(color * df + specular * sf + ambient, DataIn.sphere_color.a);
     }
 
-    if (selected)
+    if (selected || point_selected(DataIn.point_index))
         outputF = mix(outputF, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
 }
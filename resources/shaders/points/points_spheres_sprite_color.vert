@@ -46,6 +46,7 @@ out Data {
     vec4    position;// in eye space
     vec4    sphere_color;
 //float	sphere_radius;
+    flat int point_index;  // the index of the point
 } DataOut;
 
 
@@ -58,6 +59,7 @@ void main()
     else
         DataOut.sphere_color = default_color;
 	//DataOut.sphere_radius = sphere_radius;
+    DataOut.point_index = gl_VertexID;
 
 	// Output vertex position
         DataOut.position = MV * new_position; // eye space
@@ -33,6 +33,7 @@ in FragmentData
     vec4 color;
     vec3 point;
     vec3 normal;
+    flat int point_index;  // the index of the point
 } FragmentIn;
 
 
@@ -53,6 +54,18 @@ uniform int  highlight_id_max;
 
 uniform bool selected = false;
 
+// the selection state of the points (one bit per point)
+uniform bool            per_point_selection = false;
+uniform usamplerBuffer  selection;
+
+bool point_selected(int index) {
+    if (!per_point_selection)
+        return false;
+    int addr = index >> 5;
+    int offs = index & 31;
+    return (texelFetch(selection, addr).r & (1u << offs)) != 0u;
+}
+
 layout(std140) uniform Material {
         vec3	ambient;		// in [0, 1], r==g==b;
         vec3	specular;		// in [0, 1], r==g==b;
@@ -71,7 +84,7 @@ void main()
 
     if (!lighting) {
         fragmentColor = FragmentIn.color;
-        if (selected)
+        if (selected || point_selected(FragmentIn.point_index))
         fragmentColor = mix(fragmentColor, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
         return;
     }
@@ -82,7 +95,7 @@ void main()
             color = mix(color, vec3(1.0, 0.0, 0.0), 0.8);
     }
 
-    if (selected)
+    if (selected || point_selected(FragmentIn.point_index))
         color = mix(color, vec3(1.0, 0.0, 0.0), 0.6);
 
     vec3 view_dir = normalize(wCamPos - FragmentIn.point);// compute view direction and normalize it
@@ -41,6 +41,7 @@ out VertexData
 {
     vec4  color;
     vec3  normal;
+    flat int point_index;  // the index of the point
 } vertexOut;
 
 
@@ -56,4 +57,5 @@ void main()
         vertexOut.color = default_color;
 
     vertexOut.normal = NORMAL * vtx_normal;
+    vertexOut.point_index = gl_VertexID;
 }
@@ -33,6 +33,7 @@ in FragmentData
     vec2 tex;       // the local
     vec3 point;
     vec3 normal;
+    flat int point_index;  // the index of the point
 } FragmentIn;
 
 
@@ -61,6 +62,18 @@ uniform sampler2D	textureID;
 
 uniform bool selected = false;
 
+// the selection state of the points (one bit per point)
+uniform bool            per_point_selection = false;
+uniform usamplerBuffer  selection;
+
+bool point_selected(int index) {
+    if (!per_point_selection)
+        return false;
+    int addr = index >> 5;
+    int offs = index & 31;
+    return (texelFetch(selection, addr).r & (1u << offs)) != 0u;
+}
+
 out vec4 fragmentColor;
 
 void main()
@@ -73,7 +86,7 @@ void main()
     vec3 color = texture(textureID, FragmentIn.texcoord).rgb;
     if (!lighting) {
         fragmentColor = vec4(color, 1.0);
-        if (selected)
+        if (selected || point_selected(FragmentIn.point_index))
         fragmentColor = mix(fragmentColor, vec4(1.0, 0.0, 0.0, 1.0), 0.6);
         return;
     }
@@ -83,7 +96,7 @@ void main()
             color = mix(color, vec3(1.0, 0.0, 0.0), 0.8);
     }
 
-    if (selected)
+    if (selected || point_selected(FragmentIn.point_index))
         color = mix(color, vec3(1.0, 0.0, 0.0), 0.6);
 
     vec3 view_dir = normalize(wCamPos - FragmentIn.point);// compute view direction and normalize it
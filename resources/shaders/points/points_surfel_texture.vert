@@ -38,6 +38,7 @@ out VertexData
 {
     vec2  texcoord;
     vec3  normal;
+    flat int point_index;  // the index of the point
 } vertexOut;
 
 
@@ -49,4 +50,5 @@ void main()
 
     vertexOut.texcoord = vtx_texcoord;
     vertexOut.normal = NORMAL * vtx_normal;
+    vertexOut.point_index = gl_VertexID;
 }
@@ -0,0 +1,122 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/renderer/camera.h>
+#include <easy3d/renderer/culling.h>
+#include <easy3d/util/logging.h>
+
+
+using namespace easy3d;
+
+
+namespace details {
+
+    // a point cloud of the 8 corners of a cube
+    PointCloud *cube(const vec3 &center, float size) {
+        auto cloud = new PointCloud;
+        const float h = size * 0.5f;
+        for (int i = 0; i < 8; ++i)
+            cloud->add_vertex(center + vec3((i & 1) ? h : -h, (i & 2) ? h : -h, (i & 4) ? h : -h));
+        return cloud;
+    }
+
+}
+
+
+// Tests the culling of models against the view frustum of a known camera. No OpenGL context is required.
+int test_culling() {
+    std::cout << "testing frustum and small-feature culling..." << std::endl;
+
+    // the camera is at (0, 0, 10), looking at the origin, and the scene is within [-10, 10]^3
+    Camera camera;
+    camera.setType(Camera::PERSPECTIVE);
+    camera.setScreenWidthAndHeight(800, 600);
+    camera.setSceneBoundingBox(vec3(-10, -10, -10), vec3(10, 10, 10));
+    camera.setPosition(vec3(0, 0, 10));
+    camera.lookAt(vec3(0, 0, 0));
+
+    std::vector<Model *> models = {
+            details::cube(vec3(0, 0, 0), 1.0f),         // 0: in front of the camera
+            details::cube(vec3(100, 0, 0), 1.0f),       // 1: far to the right
+            details::cube(vec3(0, 0, 20), 1.0f),        // 2: behind the camera
+            details::cube(vec3(0, 0, -5), 0.001f),      // 3: in front of the camera, but tiny
+            details::cube(vec3(0, 0, 0), 100.0f)        // 4: the camera is inside it
+    };
+
+    bool success = true;
+    auto check = [&](const Culler &culler, std::size_t index, Culler::Result expected, const std::string &when) {
+        if (culler.test(models[index]) != expected) {
+            LOG(ERROR) << "model " << index << " " << when << ": culling result " << culler.test(models[index])
+                       << " (expected " << expected << ")";
+            success = false;
+        }
+    };
+
+    Culler culler;
+    culler.cull(models, &camera);
+    check(culler, 0, Culler::VISIBLE, "in view");
+    check(culler, 1, Culler::FRUSTUM_CULLED, "outside the frustum");
+    check(culler, 2, Culler::FRUSTUM_CULLED, "behind the camera");
+    check(culler, 3, Culler::VISIBLE, "tiny (small-feature culling disabled)");
+    check(culler, 4, Culler::VISIBLE, "around the camera");
+    if (culler.num_nodes() != 2 * models.size() - 1) {
+        LOG(ERROR) << "the BVH has " << culler.num_nodes() << " nodes (expected " << 2 * models.size() - 1 << ")";
+        success = false;
+    }
+
+    // small-feature culling: the projected size of model 3 is far below a pixel, and model 0 covers many pixels
+    culler.set_min_screen_size(2.0f);
+    culler.cull(models, &camera);
+    check(culler, 0, Culler::VISIBLE, "in view (small-feature culling enabled)");
+    check(culler, 1, Culler::FRUSTUM_CULLED, "outside the frustum (small-feature culling enabled)");
+    check(culler, 3, Culler::SIZE_CULLED, "tiny (small-feature culling enabled)");
+    culler.set_min_screen_size(0.0f);
+
+    // moving model 1 into the view (and invalidating its bounding box) refits the BVH, and moving model 0 out of
+    // the view makes it culled
+    for (auto &p : models[1]->points())
+        p -= vec3(100, 0, 0);
+    models[1]->invalidate_bounding_box();
+    for (auto &p : models[0]->points())
+        p += vec3(0, -100, 0);
+    models[0]->invalidate_bounding_box();
+    culler.cull(models, &camera);
+    check(culler, 0, Culler::FRUSTUM_CULLED, "after moving out of the view");
+    check(culler, 1, Culler::VISIBLE, "after moving into the view");
+    check(culler, 2, Culler::FRUSTUM_CULLED, "behind the camera (after refitting)");
+
+    // disabling frustum culling makes all the models visible
+    culler.set_frustum_culling(false);
+    culler.cull(models, &camera);
+    for (std::size_t i = 0; i < models.size(); ++i)
+        check(culler, i, Culler::VISIBLE, "(frustum culling disabled)");
+
+    for (auto m : models)
+        delete m;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
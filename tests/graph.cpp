@@ -26,6 +26,7 @@
 
 #include <easy3d/core/graph.h>
 #include <easy3d/fileio/graph_io.h>
+#include <easy3d/fileio/snapshot.h>
 #include <easy3d/fileio/resources.h>
 #include <easy3d/util/file_system.h>
 
@@ -163,5 +164,70 @@ int test_graph() {
         delete graph;
     }
 
+    //		- save a graph with all its properties into a snapshot file and load it back.
+    {
+        Graph* graph = GraphIO::load(resource::directory() + "/data/graph.ply");
+        if (!graph) {
+            LOG(ERROR) << "Error: failed to load model. Please make sure the file exists and format is correct.";
+            return EXIT_FAILURE;
+        }
+
+        auto lengths = graph->add_edge_property<float>("e:length");
+        auto long_edges = graph->add_edge_property<bool>("e:long");
+        for (auto e : graph->edges()) {
+            lengths[e] = graph->edge_length(e);
+            long_edges[e] = lengths[e] > 0.1f;
+        }
+        auto ids = graph->add_vertex_property<int>("v:id");
+        for (auto v : graph->vertices())
+            ids[v] = v.idx() * 3;
+        graph->add_model_property<std::string>("source")[0] = "graph.ply";
+
+        bool identical = true;
+        for (bool compress : {false, true}) {
+            const std::string snapshot_file_name = "./graph-copy.snap";
+            Graph* copy = nullptr;
+            if (io::save_snapshot(snapshot_file_name, graph, compress))
+                copy = GraphIO::load(snapshot_file_name);
+            file_system::delete_file(snapshot_file_name);
+
+            identical = identical && copy && copy->n_vertices() == graph->n_vertices() &&
+                        copy->n_edges() == graph->n_edges() && copy->points() == graph->points();
+            for (auto e : graph->edges()) {
+                if (!identical)
+                    break;
+                identical = copy->vertex(e, 0) == graph->vertex(e, 0) && copy->vertex(e, 1) == graph->vertex(e, 1);
+            }
+            for (auto v : graph->vertices()) {
+                if (!identical)
+                    break;
+                std::vector<Graph::Edge> edges, copy_edges;
+                for (auto e : graph->edges(v))
+                    edges.push_back(e);
+                for (auto e : copy->edges(v))
+                    copy_edges.push_back(e);
+                identical = copy_edges == edges;
+            }
+            if (identical) {
+                auto copy_lengths = copy->get_edge_property<float>("e:length");
+                auto copy_long_edges = copy->get_edge_property<bool>("e:long");
+                auto copy_ids = copy->get_vertex_property<int>("v:id");
+                auto copy_source = copy->get_model_property<std::string>("source");
+                identical = copy_lengths && copy_lengths.vector() == lengths.vector() &&
+                            copy_long_edges && copy_long_edges.vector() == long_edges.vector() &&
+                            copy_ids && copy_ids.vector() == ids.vector() &&
+                            copy_source && copy_source[0] == "graph.ply";
+            }
+            delete copy;
+        }
+
+        delete graph;
+        if (!identical) {
+            std::cerr << "the snapshot does not restore the graph" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "snapshot saved and restored" << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
@@ -35,6 +35,8 @@ int test_point_cloud();
 int test_surface_mesh();
 int test_polyhedral_mesh();
 int test_graph();
+int test_culling();
+int test_model_snapshots();
 
 int test_point_cloud_algorithms();
 int test_surface_mesh_algorithms();
@@ -53,6 +55,7 @@ int test_texture_mesh(int duration);
 int test_text_rendering(int duration);
 int test_text_mesher(int duration);
 int test_animation(int duration);
+int test_manipulator();
 int test_ambient_occlusion(int duration);
 int test_hard_shadow(int duration);
 int test_soft_shadow(int duration);
@@ -81,6 +84,8 @@ int main(int argc, char* argv[]) {
     result += test_surface_mesh();
     result += test_polyhedral_mesh();
     result += test_graph();
+    result += test_culling();
+    result += test_model_snapshots();
 
     result += test_point_cloud_algorithms();
     result += test_surface_mesh_algorithms();
@@ -100,6 +105,7 @@ int main(int argc, char* argv[]) {
     result += test_text_rendering(duration);
     result += test_text_mesher(duration);
     result += test_animation(duration);
+    result += test_manipulator();
     result += test_ambient_occlusion(duration);
     result += test_hard_shadow(duration);
     result += test_soft_shadow(duration);
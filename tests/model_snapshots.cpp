@@ -0,0 +1,282 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <memory>
+
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/core/graph.h>
+#include <easy3d/core/poly_mesh.h>
+#include <easy3d/core/model_diff.h>
+#include <easy3d/util/logging.h>
+
+
+using namespace easy3d;
+
+
+// Undo/redo of modifications of models as done by UndoStack in Mapple: a copy of the model is taken before it is
+// modified, and it is reduced to the difference between the two states (see ModelDiff) after the modification.
+// Applying the difference restores the model, and applying it again redoes the modification.
+
+
+namespace details {
+
+    // the data of a model that are compared
+    struct State {
+        std::vector<vec3> points;
+        std::vector<float> values;      // a property added by the user
+        std::vector<int> topology;      // the connectivity as indices
+
+        bool operator==(const State &other) const {
+            return points == other.points && values == other.values && topology == other.topology;
+        }
+        bool operator!=(const State &other) const { return !(*this == other); }
+    };
+
+    std::vector<float> values(const PropertyContainer &container, const std::string &name) {
+        for (auto array : container.arrays()) {
+            auto values = dynamic_cast<const PropertyArray<float> *>(array);
+            if (values && array->name() == name)
+                return values->vector();
+        }
+        return std::vector<float>();
+    }
+
+    State state(const PointCloud *cloud) {
+        return {cloud->points(), values(cloud->vertex_property_container(), "v:value"), {}};
+    }
+
+    State state(const SurfaceMesh *mesh) {
+        State s{mesh->points(), values(mesh->face_property_container(), "f:value"), {}};
+        for (auto h : mesh->halfedges()) {
+            s.topology.push_back(mesh->target(h).idx());
+            s.topology.push_back(mesh->next(h).idx());
+            s.topology.push_back(mesh->face(h).idx());
+        }
+        return s;
+    }
+
+    State state(const Graph *graph) {
+        State s{graph->points(), values(graph->edge_property_container(), "e:value"), {}};
+        for (auto e : graph->edges()) {
+            s.topology.push_back(graph->source(e).idx());
+            s.topology.push_back(graph->target(e).idx());
+        }
+        return s;
+    }
+
+    State state(const PolyMesh *mesh) {
+        State s{mesh->points(), values(mesh->cell_property_container(), "c:value"), {}};
+        for (auto c : mesh->cells()) {
+            for (auto v : mesh->vertices(c))
+                s.topology.push_back(v.idx());
+            s.topology.push_back(-1);
+        }
+        return s;
+    }
+
+
+    // copies the model, modifies it, and undoes and redoes the modification. A copy must not change with the model
+    // (also if it is modified through a handle acquired before the copy was taken), and undoing and redoing must
+    // restore the states exactly.
+    template<typename MODEL, typename EDIT>
+    bool snapshot_modify_restore(MODEL *model, EDIT edit) {
+        const State original = state(model);
+
+        auto points = model->template get_vertex_property<vec3>("v:point");
+        std::unique_ptr<MODEL> before(new MODEL(*model));                       // UndoStack::push()
+        const typename MODEL::Vertex v(0);
+        points[v] += vec3(1.0f, 1.0f, 1.0f);
+        bool ok = state(before.get()) == original;
+        points[v] -= vec3(1.0f, 1.0f, 1.0f);
+
+        edit(model);
+        const State modified = state(model);
+        ok = ok && modified != original && state(before.get()) == original;
+
+        ModelDiff diff;
+        ok = ok && diff.record(before.release(), model) && !diff.is_complete();  // the step is complete
+        ok = ok && diff.apply(model) && state(model) == original;               // UndoStack::undo()
+        ok = ok && diff.apply(model) && state(model) == modified;               // UndoStack::redo()
+        ok = ok && diff.apply(model) && state(model) == original;               // undoing again
+        if (!ok)
+            LOG(ERROR) << "a copy of a " << model->name() << " changed with the model (or was not restored)";
+        return ok;
+    }
+}
+
+
+int test_model_snapshots() {
+    bool success = true;
+
+    // a point cloud: the points are modified through the handle held by the cloud, the values through a handle
+    // acquired after the snapshot, and the vertices are deleted
+    {
+        PointCloud cloud;
+        cloud.set_name("point cloud");
+        for (int i = 0; i < 100; ++i)
+            cloud.add_vertex(vec3(static_cast<float>(i), 0.0f, 0.0f));
+        cloud.add_vertex_property<float>("v:value", 1.0f);
+        success = details::snapshot_modify_restore(&cloud, [](PointCloud *model) {
+            model->position(PointCloud::Vertex(0)) += vec3(0.0f, 1.0f, 0.0f);
+            auto values = model->get_vertex_property<float>("v:value");
+            values[PointCloud::Vertex(1)] = 2.0f;
+            model->delete_vertex(PointCloud::Vertex(2));
+            model->collect_garbage();
+            model->add_vertex(vec3(-1.0f, 0.0f, 0.0f));
+        }) && success;
+    }
+
+    // a surface mesh (a grid of triangles): the points, the values of the faces, and the connectivity
+    {
+        SurfaceMesh mesh;
+        mesh.set_name("surface mesh");
+        const int n = 10;
+        for (int j = 0; j <= n; ++j) {
+            for (int i = 0; i <= n; ++i)
+                mesh.add_vertex(vec3(static_cast<float>(i), static_cast<float>(j), 0.0f));
+        }
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) {
+                const SurfaceMesh::Vertex v(j * (n + 1) + i);
+                const SurfaceMesh::Vertex right(v.idx() + 1), up(v.idx() + n + 1), diagonal(v.idx() + n + 2);
+                mesh.add_triangle(v, right, diagonal);
+                mesh.add_triangle(v, diagonal, up);
+            }
+        }
+        mesh.add_face_property<float>("f:value", 1.0f);
+        success = details::snapshot_modify_restore(&mesh, [](SurfaceMesh *model) {
+            model->position(SurfaceMesh::Vertex(0)) += vec3(0.0f, 0.0f, 1.0f);
+            auto values = model->get_face_property<float>("f:value");
+            values[SurfaceMesh::Face(1)] = 2.0f;
+            model->delete_face(SurfaceMesh::Face(2));
+            model->collect_garbage();
+            auto v = model->add_vertex(vec3(-1.0f, -1.0f, 0.0f));
+            model->add_triangle(v, SurfaceMesh::Vertex(1), SurfaceMesh::Vertex(0));
+        }) && success;
+    }
+
+    // a graph (a polyline): the points, the values of the edges, and the edges
+    {
+        Graph graph;
+        graph.set_name("graph");
+        for (int i = 0; i < 100; ++i)
+            graph.add_vertex(vec3(static_cast<float>(i), 0.0f, 0.0f));
+        for (int i = 0; i < 99; ++i)
+            graph.add_edge(Graph::Vertex(i), Graph::Vertex(i + 1));
+        graph.add_edge_property<float>("e:value", 1.0f);
+        success = details::snapshot_modify_restore(&graph, [](Graph *model) {
+            model->position(Graph::Vertex(0)) += vec3(0.0f, 1.0f, 0.0f);
+            auto values = model->get_edge_property<float>("e:value");
+            values[Graph::Edge(1)] = 2.0f;
+            model->delete_vertex(Graph::Vertex(50));
+            model->collect_garbage();
+            model->add_edge(Graph::Vertex(0), Graph::Vertex(2));
+        }) && success;
+    }
+
+    // a polyhedral mesh (a strip of tetrahedra): the points, the values of the cells, and the cells
+    {
+        PolyMesh mesh;
+        mesh.set_name("polyhedral mesh");
+        for (int i = 0; i < 20; ++i)
+            mesh.add_vertex(vec3(static_cast<float>(i), static_cast<float>(i % 2), static_cast<float>(i % 3)));
+        for (int i = 0; i + 3 < 20; i += 3) {
+            mesh.add_tetra(PolyMesh::Vertex(i), PolyMesh::Vertex(i + 1), PolyMesh::Vertex(i + 2),
+                           PolyMesh::Vertex(i + 3));
+        }
+        mesh.add_cell_property<float>("c:value", 1.0f);
+        success = details::snapshot_modify_restore(&mesh, [](PolyMesh *model) {
+            auto points = model->get_vertex_property<vec3>("v:point");
+            points[PolyMesh::Vertex(0)] += vec3(0.0f, 0.0f, 1.0f);
+            auto values = model->get_cell_property<float>("c:value");
+            values[PolyMesh::Cell(1)] = 2.0f;
+            auto v = model->add_vertex(vec3(-1.0f, -1.0f, -1.0f));
+            model->add_tetra(v, PolyMesh::Vertex(0), PolyMesh::Vertex(1), PolyMesh::Vertex(2));
+        }) && success;
+    }
+
+    // a copy doesn't change when the model is modified through a handle acquired before the copy was taken
+    {
+        SurfaceMesh mesh;
+        mesh.add_triangle(mesh.add_vertex(vec3(0, 0, 0)), mesh.add_vertex(vec3(1, 0, 0)), mesh.add_vertex(vec3(0, 1, 0)));
+        auto quality = mesh.add_vertex_property<float>("v:quality", 1.0f);
+        const SurfaceMesh copy(mesh);
+        quality[SurfaceMesh::Vertex(0)] = 42.0f;
+        if (copy.get_vertex_property<float>("v:quality")[SurfaceMesh::Vertex(0)] != 1.0f) {
+            LOG(ERROR) << "a copy of a surface mesh was modified through a handle of the original";
+            success = false;
+        }
+    }
+
+    // a difference keeps only the changed properties, and it can add and remove properties
+    {
+        SurfaceMesh mesh;
+        mesh.set_name("surface mesh");
+        for (int i = 0; i < 100; ++i)
+            mesh.add_vertex(vec3(static_cast<float>(i), static_cast<float>(i % 2), 0.0f));
+        for (int i = 0; i + 2 < 100; ++i) {   // a strip of consistently oriented triangles
+            if (i % 2 == 0)
+                mesh.add_triangle(SurfaceMesh::Vertex(i), SurfaceMesh::Vertex(i + 1), SurfaceMesh::Vertex(i + 2));
+            else
+                mesh.add_triangle(SurfaceMesh::Vertex(i + 1), SurfaceMesh::Vertex(i), SurfaceMesh::Vertex(i + 2));
+        }
+        const details::State original = details::state(&mesh);
+
+        // smoothing-like: only the points change
+        ModelDiff diff;
+        SurfaceMesh *before = new SurfaceMesh(mesh);
+        for (auto v : mesh.vertices())
+            mesh.position(v).z = 1.0f;
+        bool ok = diff.record(before, &mesh) && diff.num_arrays() == 1;
+        ok = ok && diff.apply(&mesh) && details::state(&mesh) == original;
+        ok = ok && diff.apply(&mesh) && mesh.position(SurfaceMesh::Vertex(0)).z == 1.0f;
+        ok = ok && diff.apply(&mesh) && details::state(&mesh) == original;
+
+        // a property is added, which is removed by undoing (and the mesh must not keep a handle to it)
+        before = new SurfaceMesh(mesh);
+        mesh.update_vertex_normals();
+        const std::vector<vec3> normals = mesh.get_vertex_property<vec3>("v:normal").vector();
+        ok = ok && diff.record(before, &mesh) && diff.num_arrays() == 0 && diff.apply(&mesh) &&
+             !mesh.get_vertex_property<vec3>("v:normal") && diff.apply(&mesh) &&
+             mesh.get_vertex_property<vec3>("v:normal").vector() == normals && diff.apply(&mesh);
+        mesh.update_vertex_normals();
+        ok = ok && mesh.get_vertex_property<vec3>("v:normal").vector() == normals;
+        mesh.remove_vertex_property("v:normal");
+
+        // a state with deleted elements is kept completely
+        before = new SurfaceMesh(mesh);
+        mesh.delete_face(SurfaceMesh::Face(0));
+        ok = ok && diff.record(before, &mesh) && diff.is_complete() && diff.apply(&mesh) &&
+             details::state(&mesh) == original && !mesh.has_garbage() && diff.apply(&mesh) && mesh.has_garbage();
+        if (!ok) {
+            LOG(ERROR) << "unexpected difference of two states of a surface mesh";
+            success = false;
+        }
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -24,10 +24,16 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  ********************************************************************/
 
+#include <cstring>
+
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/random.h>
+#include <easy3d/core/selection_set.h>
+#include <easy3d/core/vec3_kernels.h>
 #include <easy3d/fileio/point_cloud_io.h>
 #include <easy3d/fileio/resources.h>
+#include <easy3d/fileio/snapshot.h>
+#include <easy3d/renderer/transform.h>
 #include <easy3d/util/file_system.h>
 
 
@@ -110,6 +116,211 @@ int test_point_cloud() {
                 std::cerr << "failed to delete the saved file" << std::endl;
         }
     }
-    
+
+    // This example checks the vectorized kernels for bulk operations on arrays of points (see vec3_kernels.h)
+    // against the plain loops they replace, for each instruction set supported by the CPU (see
+    // benchmarks/bench_core.cpp for their performance).
+    {
+        const std::size_t num = 1000003; // not a multiple of the block sizes, to also exercise the remainders
+        std::vector<vec3> points(num), vectors(num);
+        for (std::size_t i = 0; i < num; ++i) {
+            points[i] = vec3(random_float(), random_float(), random_float()) * 1000.0f - vec3(500.0f);
+            vectors[i] = vec3(random_float(), random_float(), random_float()) - vec3(0.5f);
+        }
+        const mat4 affine = mat4::translation(1, 2, 3) * mat4::rotation(vec3(1, 1, 0), 0.5f) * mat4::scale(2, 2, 2, 1);
+        const mat4 projective = transform::perspective(0.8f, 1.5f, 0.1f, 100.0f) * affine;
+        const mat3 linear = transform::normal_matrix(affine);
+        const dvec3 offset(-12345678.25, 2345678.5, -345678.75);
+
+        auto same = [](const std::vector<vec3> &a, const std::vector<vec3> &b) -> bool {
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                if (distance2(a[i], b[i]) > 1e-10f * (1.0f + a[i].length2()))
+                    return false;
+            }
+            return true;
+        };
+
+        // the plain loops
+        Box3 box;
+        for (const auto &p : points)
+            box.grow(p);
+
+        std::vector<vec3> translated = points;
+        for (auto &p : translated) {
+            p.x += offset.x;
+            p.y += offset.y;
+            p.z += offset.z;
+        }
+
+        std::vector<vec3> transformed = points;
+        for (auto &p : transformed)
+            p = affine * p;
+
+        std::vector<vec3> projected = points;
+        for (auto &p : projected)
+            p = projective * p;
+
+        std::vector<vec3> rotated = vectors;
+        for (auto &v : rotated)
+            v = linear * v;
+
+        std::vector<vec3> normalized = vectors;
+        for (auto &v : normalized)
+            v.normalize();
+
+        std::vector<vec3> crossed(num);
+        for (std::size_t i = 0; i < num; ++i)
+            crossed[i] = cross(points[i], vectors[i]);
+
+        const kernels::InstructionSet default_isa = kernels::instruction_set();
+        for (int i = kernels::SCALAR; i <= kernels::AVX2; ++i) {
+            const auto isa = static_cast<kernels::InstructionSet>(i);
+            if (!kernels::set_instruction_set(isa))
+                continue;
+
+            const Box3 kbox = kernels::bounding_box(points);
+
+            std::vector<vec3> ktranslated = points;
+            kernels::translate(ktranslated, offset);
+
+            std::vector<vec3> ktransformed = points;
+            kernels::transform(ktransformed, affine);
+
+            std::vector<vec3> kprojected = points;
+            kernels::transform(kprojected, projective);
+
+            std::vector<vec3> krotated = vectors;
+            kernels::transform(krotated, linear);
+
+            std::vector<vec3> knormalized = vectors;
+            kernels::normalize(knormalized);
+
+            std::vector<vec3> kcrossed(num);
+            kernels::cross(points.data(), vectors.data(), kcrossed.data(), num);
+            std::vector<float> kdots(num);
+            kernels::dot(points.data(), vectors.data(), kdots.data(), num);
+            bool dots_ok = true;
+            for (std::size_t j = 0; j < num && dots_ok; ++j)
+                dots_ok = std::abs(kdots[j] - dot(points[j], vectors[j])) <= 1e-5f * (1.0f + std::abs(kdots[j]));
+
+            const bool ok = kbox.min_point() == box.min_point() && kbox.max_point() == box.max_point() &&
+                            same(ktranslated, translated) && same(ktransformed, transformed) &&
+                            same(kprojected, projected) && same(krotated, rotated) &&
+                            same(knormalized, normalized) && same(kcrossed, crossed) && dots_ok;
+            if (!ok) {
+                std::cerr << "the " << kernels::instruction_set_name(isa)
+                          << " kernels give results different from the plain loops" << std::endl;
+                kernels::set_instruction_set(default_isa);
+                return EXIT_FAILURE;
+            }
+        }
+        kernels::set_instruction_set(default_isa);
+    }
+
+    // selection sets: concurrent selection, range operations, and conversion from/to bool properties
+    {
+        PointCloud cloud;
+        const int num = 1000003;
+        for (int i = 0; i < num; ++i)
+            cloud.add_vertex(vec3(random_float(), random_float(), random_float()));
+        const auto& points = cloud.points();
+
+        std::cout << "selecting points (in parallel)..." << std::endl;
+        SelectionSet selection(cloud.n_vertices());
+#pragma omp parallel for
+        for (int i = 0; i < num; ++i) {
+            if (points[i].x < 0.5f)
+                selection.set(i);
+        }
+
+        auto select = cloud.vertex_property<bool>("v:select", false);
+        for (auto v : cloud.vertices())
+            select[v] = points[v.idx()].x < 0.5f;
+        const std::size_t expected = std::count(select.vector().begin(), select.vector().end(), true);
+
+        std::size_t visited = 0;
+        bool ok = selection.count() == expected;
+        selection.for_each([&](std::size_t i) { ok = ok && select.vector()[i]; ++visited; });
+        ok = ok && visited == expected && selection.indices().size() == expected;
+
+        SelectionSet copy(select.vector());
+        copy -= selection;
+        ok = ok && copy.none();
+
+        selection.flip();
+        ok = ok && selection.count() == num - expected;
+        selection.reset();
+        selection.set_range(5, 100);
+        selection.set_range(num - 3, num);
+        ok = ok && selection.count() == 98 && !selection.test(4) && selection.test(5) && selection.test(99) &&
+             !selection.test(100) && selection.test(num - 1);
+        selection.resize(num - 2);
+        ok = ok && selection.count() == 96;
+
+        std::vector<bool> flags;
+        selection.get(flags);
+        ok = ok && flags.size() == selection.size() && flags[5] && !flags[100];
+        if (!ok) {
+            std::cerr << "unexpected results of selection sets" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    //		- save a point cloud with all its properties into a snapshot file and load it back.
+    {
+        PointCloud cloud;
+        for (int i = 0; i < 10000; ++i)
+            cloud.add_vertex(vec3(random_float(), random_float(), random_float()));
+        auto colors = cloud.add_vertex_property<vec3>("v:color");
+        auto select = cloud.add_vertex_property<bool>("v:select");
+        auto names = cloud.add_vertex_property<std::string>("v:name");
+        for (auto v : cloud.vertices()) {
+            colors[v] = random_color();
+            select[v] = (v.idx() % 3 == 0);
+            names[v] = "p" + std::to_string(v.idx());
+        }
+        const mat4 transformation = mat4::translation(1.0f, 2.0f, 3.0f);
+        cloud.add_model_property<mat4>("transformation")[0] = transformation;
+
+        // a point cloud with deleted points is stored as if the garbage had been collected
+        for (int i = 0; i < 10000; i += 7)
+            cloud.delete_vertex(PointCloud::Vertex(i));
+        PointCloud expected(cloud);
+        expected.collect_garbage();
+
+        bool identical = true;
+        for (bool compress : {false, true}) {
+            const std::string snapshot_file_name = "./cloud-copy.snap";
+            PointCloud* copy = nullptr;
+            if (io::save_snapshot(snapshot_file_name, &cloud, compress))
+                copy = PointCloudIO::load(snapshot_file_name);
+            file_system::delete_file(snapshot_file_name);
+
+            identical = identical && copy && copy->n_vertices() == expected.n_vertices() &&
+                        copy->vertices_size() == expected.n_vertices() && copy->points() == expected.points();
+            if (identical) {
+                auto copy_colors = copy->get_vertex_property<vec3>("v:color");
+                auto copy_select = copy->get_vertex_property<bool>("v:select");
+                auto copy_names = copy->get_vertex_property<std::string>("v:name");
+                auto copy_transformation = copy->get_model_property<mat4>("transformation");
+                auto expected_colors = expected.get_vertex_property<vec3>("v:color");
+                auto expected_select = expected.get_vertex_property<bool>("v:select");
+                auto expected_names = expected.get_vertex_property<std::string>("v:name");
+                identical = copy_colors && copy_colors.vector() == expected_colors.vector() &&
+                            copy_select && copy_select.vector() == expected_select.vector() &&
+                            copy_names && copy_names.vector() == expected_names.vector() &&
+                            copy_transformation &&
+                            std::memcmp(&copy_transformation[0], &transformation, sizeof(mat4)) == 0;
+            }
+            delete copy;
+        }
+
+        if (!identical) {
+            std::cerr << "the snapshot does not restore the point cloud" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "snapshot saved and restored" << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
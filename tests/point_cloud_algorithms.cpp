@@ -24,6 +24,12 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  ********************************************************************/
 
+#include <fstream>
+#include <map>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/algo/point_cloud_normals.h>
@@ -34,6 +40,7 @@
 #include <easy3d/algo/point_cloud_simplification.h>
 #include <easy3d/fileio/point_cloud_io.h>
 #include <easy3d/fileio/resources.h>
+#include <easy3d/util/tracing.h>
 
 
 using namespace easy3d;
@@ -49,13 +56,88 @@ bool test_algo_point_cloud_normal_estimation() {
     PointCloudNormals algo;
 
     std::cout << "estimating point cloud normals..." << std::endl;
-    if (algo.estimate(cloud, 16)) {
-        std::cout << "reorienting point cloud normals..." << std::endl;
-        if (algo.reorient(cloud, 16)) {
+    if (!algo.estimate(cloud, 16)) {
+        delete cloud;
+        return false;
+    }
+
+#ifdef EASY3D_ENABLE_TRACING
+    std::cout << "tracing point cloud normal estimation..." << std::endl;
+    {
+        tracing::start();
+        const bool success = algo.estimate(cloud, 16);
+        tracing::stop();
+        const std::string trace_file = resource::directory() + "/data/normal_estimation_trace.json";
+        const bool saved = tracing::save(trace_file);
+        std::ifstream input(trace_file.c_str());
+        const std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        input.close();
+        std::remove(trace_file.c_str());
+        tracing::clear();
+        if (!success || !saved || content.find("\"PointCloudNormals::estimate\"") == std::string::npos) {
+            std::cerr << "normal estimation was not traced" << std::endl;
             delete cloud;
-            return true;
+            return false;
         }
     }
+#endif
+
+    std::cout << "estimating point cloud normals with progress reporting and cancellation..." << std::endl;
+    {
+        // a client recording the progress (which is reported from the worker threads)
+        class Client : public ProgressClient {
+        public:
+            void notify(std::size_t percent, bool) override { percents.push_back(percent); }
+            std::vector<std::size_t> percents;
+        } client;
+
+        // two sub-tasks (running in parallel) of 2 and 8 steps of the task
+        {
+            ProgressLogger progress(10, false);
+#pragma omp parallel sections
+            {
+#pragma omp section
+                {
+                    ProgressLogger sub(progress, 2, 1000);
+                    for (int i = 0; i < 1000; ++i)
+                        sub.next();
+                }
+#pragma omp section
+                {
+                    ProgressLogger sub(progress, 8, 1000);
+                    for (int i = 0; i < 1000; ++i)
+                        sub.next();
+                }
+            }
+        }
+        if (client.percents.empty() || client.percents.front() != 0 || client.percents.back() != 100 ||
+            client.percents.size() > 102) {
+            std::cerr << "unexpected progress notifications" << std::endl;
+            delete cloud;
+            return false;
+        }
+
+        client.percents.clear();
+        if (!algo.estimate(cloud, 16) || client.percents.empty() || client.percents.back() != 100) {
+            std::cerr << "progress of normal estimation not reported" << std::endl;
+            delete cloud;
+            return false;
+        }
+
+        CancellationToken token;
+        token.cancel();
+        if (algo.estimate(cloud, 16, false, token)) {
+            std::cerr << "normal estimation was not cancelled" << std::endl;
+            delete cloud;
+            return false;
+        }
+    }
+
+    std::cout << "reorienting point cloud normals..." << std::endl;
+    if (algo.reorient(cloud, 16)) {
+        delete cloud;
+        return true;
+    }
 
     delete cloud;
     return false;
@@ -114,10 +196,22 @@ bool test_algo_point_cloud_poisson_reconstruction() {
     algo.set_depth(depth);
     std::cout << "Poisson surface reconstruction (depth = " << depth << ")..." << std::endl;
     Model *surface = algo.apply(cloud);
+
+    CancellationToken token;
+    token.cancel();
+    Model *cancelled = algo.apply(cloud, "v:density", token);
     delete cloud;
+    if (cancelled) {
+        std::cerr << "Poisson surface reconstruction was not cancelled" << std::endl;
+        delete cancelled;
+        delete surface;
+        return false;
+    }
 
-    if (surface)
+    if (surface) {
+        delete surface;
         return true;
+    }
 
     return false;
 }
@@ -161,6 +255,163 @@ bool test_algo_point_cloud_delaunay_triangulation_3D() {
     Delaunay3 delaunay;
     delaunay.set_vertices(points);
 
+    std::cout << "querying nearest vertices and containing tetrahedra..." << std::endl;
+    const vec3 center = cloud->bounding_box().center();
+    std::vector<vec3> queries;
+    for (std::size_t i = 0; i < points.size(); i += 10)
+        queries.push_back(points[i] * 0.9f + center * 0.1f);
+
+    std::vector<unsigned int> nearest;
+    delaunay.nearest_vertices(queries, nearest);
+    std::vector<int> tets;
+    delaunay.locate(queries, tets);
+
+    // p is in tetrahedron t if it is not strictly beyond any of its faces (up to rounding errors)
+    auto contains = [&](int t, const vec3 &p) -> bool {
+        if (t < 0)
+            return false;
+        const vec3 &a = points[delaunay.tet_vertex(t, 0)], &b = points[delaunay.tet_vertex(t, 1)];
+        const vec3 &c = points[delaunay.tet_vertex(t, 2)], &d = points[delaunay.tet_vertex(t, 3)];
+        const double volume = dot(cross(b - a, c - a), d - a);
+        for (int lf = 0; lf < 4; ++lf) {
+            vec3 w[4] = {a, b, c, d};
+            w[lf] = p;  // the volume of the tetrahedron with vertex lf replaced by p has the same sign if p is inside
+            const double sub = dot(cross(w[1] - w[0], w[2] - w[0]), w[3] - w[0]);
+            if (sub * volume < 0.0 && std::abs(sub) > 1e-6 * std::abs(volume))
+                return false;
+        }
+        return true;
+    };
+
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const unsigned int v = delaunay.nearest_vertex(queries[i], 0);   // walking from the first vertex
+        if (distance2(queries[i], points[v]) != distance2(queries[i], points[nearest[i]])) {
+            std::cerr << "nearest vertex mismatch" << std::endl;
+            delete cloud;
+            return false;
+        }
+        // the queries are between a point and the center of the bounding box, so they are all in the convex hull
+        if (!contains(tets[i], queries[i]) || !contains(delaunay.locate(queries[i], 0), queries[i])) {
+            std::cerr << "query point " << i << " is not in the located tetrahedron" << std::endl;
+            delete cloud;
+            return false;
+        }
+    }
+
+    const vec3 outside = center + vec3(10.0f * cloud->bounding_box().radius(), 0.0f, 0.0f);
+    if (delaunay.locate(outside) != -1) {
+        std::cerr << "a point outside the convex hull was located in a tetrahedron" << std::endl;
+        delete cloud;
+        return false;
+    }
+
+    std::cout << "computing Voronoi cells..." << std::endl;
+    std::vector<VoronoiCell3d> cells;
+    delaunay.get_voronoi_cells(cells);
+    std::vector<float> volumes;
+    std::vector<vec3> centroids;
+    delaunay.get_voronoi_cell_volumes(volumes, &centroids);
+    if (cells.size() != points.size() || volumes.size() != points.size()) {
+        std::cerr << "unexpected number of Voronoi cells" << std::endl;
+        delete cloud;
+        return false;
+    }
+
+    // compare with the cells constructed one by one.
+    // The two constructions visit the tetrahedra in different orders, so the facets (identified by their bisectors)
+    // and their vertices (identified by their edge bisectors) are compared regardless of their order.
+    typedef std::map<int, std::vector<std::pair<int, vec3> > > Facets;
+    auto facets_of = [](const VoronoiCell3d &cell) -> Facets {
+        Facets facets;
+        for (unsigned int f = 0; f < cell.nb_facets(); ++f) {
+            auto &vertices = facets[cell.facet_bisector(f)];
+            for (unsigned int i = cell.facet_begin(f); i < cell.facet_end(f); ++i)
+                vertices.emplace_back(cell.vertex_is_infinite(i) ? -2 - cell.edge_bisector(i) : cell.edge_bisector(i),
+                                      cell.vertex(i));
+            std::sort(vertices.begin(), vertices.end(),
+                      [](const std::pair<int, vec3> &a, const std::pair<int, vec3> &b) { return a.first < b.first; });
+        }
+        return facets;
+    };
+
+    const float radius = cloud->bounding_box().radius();
+    for (std::size_t v = 0; v < points.size(); v += 10) {
+        VoronoiCell3d cell;
+        delaunay.get_voronoi_cell(static_cast<unsigned int>(v), cell);
+        const Facets expected = facets_of(cell), facets = facets_of(cells[v]);
+        bool same = (cell.nb_facets() == cells[v].nb_facets() && expected.size() == facets.size());
+        for (auto it = expected.begin(), jt = facets.begin(); same && it != expected.end(); ++it, ++jt) {
+            same = it->first == jt->first && it->second.size() == jt->second.size();
+            for (std::size_t i = 0; same && i < it->second.size(); ++i) {
+                same = it->second[i].first == jt->second[i].first &&
+                       distance(it->second[i].second, jt->second[i].second) <= radius * 1e-6f;
+            }
+        }
+        if (!same) {
+            std::cerr << "the Voronoi cell of vertex " << v << " differs from the one constructed alone" << std::endl;
+            delete cloud;
+            return false;
+        }
+    }
+
+    // the volumes and centroids are compared with the ones computed from the facets on random points (the points of
+    // a scan are close to a surface, so many tetrahedra are slivers whose circumcenters are inaccurate in single
+    // precision, making the facets of the cells non-planar)
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<vec3> random_points(5000);
+    for (auto &p : random_points)
+        p = vec3(uniform(rng), uniform(rng), uniform(rng));
+
+    Delaunay3 random_delaunay;
+    random_delaunay.set_vertices(random_points);
+    random_delaunay.get_voronoi_cells(cells);
+    random_delaunay.get_voronoi_cell_volumes(volumes, &centroids);
+    std::size_t num_bounded = 0;
+    for (std::size_t v = 0; v < random_points.size(); ++v) {
+        // each facet is convex: a fan of its vertices and the site gives a decomposition of the (convex) cell
+        const VoronoiCell3d &cell = cells[v];
+        bool bounded = true;
+        double volume = 0.0;
+        dvec3 centroid(0, 0, 0);
+        const dvec3 site(random_points[v]);
+        for (unsigned int f = 0; bounded && f < cell.nb_facets(); ++f) {
+            const unsigned int first = cell.facet_begin(f);
+            for (unsigned int i = first; i < cell.facet_end(f); ++i)
+                bounded = bounded && !cell.vertex_is_infinite(i);
+            for (unsigned int i = first + 1; bounded && i + 1 < cell.facet_end(f); ++i) {
+                const dvec3 a(cell.vertex(first)), b(cell.vertex(i)), c(cell.vertex(i + 1));
+                const double vol = std::abs(dot(cross(b - a, c - a), site - a)) / 6.0;
+                volume += vol;
+                centroid += vol * (site + a + b + c) / 4.0;
+            }
+        }
+        if (!bounded) {
+            if (volumes[v] != -1.0f) {
+                std::cerr << "the volume of the unbounded Voronoi cell of vertex " << v << " is " << volumes[v]
+                          << std::endl;
+                delete cloud;
+                return false;
+            }
+            continue;
+        }
+
+        ++num_bounded;
+        centroid /= volume;     // the cells on the convex hull can be far away from the points
+        const double tolerance = 1e-5 * (1.0 + length(centroid));
+        if (std::abs(volumes[v] - volume) > 1e-4 * volume || distance(dvec3(centroids[v]), centroid) > tolerance) {
+            std::cerr << "the volume or centroid of the Voronoi cell of vertex " << v << " is " << volumes[v] << ", "
+                      << centroids[v] << " (expected " << volume << ", " << centroid << ")" << std::endl;
+            delete cloud;
+            return false;
+        }
+    }
+    if (num_bounded == 0) {
+        std::cerr << "no bounded Voronoi cells" << std::endl;
+        delete cloud;
+        return false;
+    }
+
     delete cloud;
     return true;
 }
@@ -26,6 +26,7 @@
 
 #include <easy3d/core/poly_mesh.h>
 #include <easy3d/fileio/poly_mesh_io.h>
+#include <easy3d/fileio/snapshot.h>
 #include <easy3d/fileio/resources.h>
 #include <easy3d/util/file_system.h>
 
@@ -309,6 +310,77 @@ int test_polyhedral_mesh() {
         delete mesh;
     }
 
+    //		- save a polyhedral mesh with all its properties into a snapshot file and load it back.
+    {
+        PolyMesh* mesh = PolyMeshIO::load(resource::directory() + "/data/sphere.plm");
+        if (!mesh) {
+            LOG(ERROR) << "Error: failed to load model. Please make sure the file exists and format is correct.";
+            return EXIT_FAILURE;
+        }
+
+        auto labels = mesh->add_cell_property<int>("c:label");
+        for (auto c : mesh->cells())
+            labels[c] = c.idx() % 5;
+        auto border = mesh->add_face_property<bool>("f:border");
+        for (auto f : mesh->faces())
+            border[f] = mesh->is_border(f);
+        auto centers = mesh->add_halfface_property<vec3>("h:center");
+        for (auto h : mesh->halffaces()) {
+            for (auto v : mesh->vertices(h))
+                centers[h] += mesh->position(v);
+            centers[h] /= static_cast<float>(mesh->vertices(h).size());
+        }
+        mesh->add_model_property<std::string>("source")[0] = "sphere.plm";
+
+        bool identical = true;
+        for (bool compress : {false, true}) {
+            const std::string snapshot_file_name = "./sphere-copy.snap";
+            PolyMesh* copy = nullptr;
+            if (io::save_snapshot(snapshot_file_name, mesh, compress))
+                copy = PolyMeshIO::load(snapshot_file_name);
+            file_system::delete_file(snapshot_file_name);
+
+            identical = identical && copy && copy->n_vertices() == mesh->n_vertices() &&
+                        copy->n_edges() == mesh->n_edges() && copy->n_faces() == mesh->n_faces() &&
+                        copy->n_cells() == mesh->n_cells() && copy->points() == mesh->points();
+            for (auto c : mesh->cells()) {
+                if (!identical)
+                    break;
+                identical = copy->vertices(c) == mesh->vertices(c) && copy->edges(c) == mesh->edges(c) &&
+                            copy->halffaces(c) == mesh->halffaces(c);
+            }
+            for (auto h : mesh->halffaces()) {
+                if (!identical)
+                    break;
+                identical = copy->vertices(h) == mesh->vertices(h) && copy->opposite(h) == mesh->opposite(h) &&
+                            copy->cell(h) == mesh->cell(h);
+            }
+            for (auto v : mesh->vertices()) {
+                if (!identical)
+                    break;
+                identical = copy->cells(v) == mesh->cells(v) && copy->edges(v) == mesh->edges(v);
+            }
+            if (identical) {
+                auto copy_labels = copy->get_cell_property<int>("c:label");
+                auto copy_border = copy->get_face_property<bool>("f:border");
+                auto copy_centers = copy->get_halfface_property<vec3>("h:center");
+                auto copy_source = copy->get_model_property<std::string>("source");
+                identical = copy_labels && copy_labels.vector() == labels.vector() &&
+                            copy_border && copy_border.vector() == border.vector() &&
+                            copy_centers && copy_centers.vector() == centers.vector() &&
+                            copy_source && copy_source[0] == "sphere.plm";
+            }
+            delete copy;
+        }
+
+        delete mesh;
+        if (!identical) {
+            std::cerr << "the snapshot does not restore the polyhedral mesh" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "snapshot saved and restored" << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -24,9 +24,20 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  ********************************************************************/
 
+#include <random>
+#include <fstream>
+#include <cstdint>
+#include <algorithm>
+
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/core/surface_mesh_builder.h>
+#include <easy3d/core/scalar_statistics.h>
+#include <easy3d/core/random.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/algo/surface_mesh_geometry.h>
+#include <easy3d/algo/reordering.h>
 #include <easy3d/fileio/surface_mesh_io.h>
+#include <easy3d/fileio/snapshot.h>
 #include <easy3d/fileio/resources.h>
 #include <easy3d/util/file_system.h>
 
@@ -317,6 +328,397 @@ int test_surface_mesh() {
             std::cerr << "failed to delete the saved file" << std::endl;
     }
 
+    //		- save a surface mesh with all its properties into a snapshot file and load it back.
+    {
+        SurfaceMesh* mesh = SurfaceMeshIO::load(resource::directory() + "/data/sphere.obj");
+        if (!mesh) {
+            LOG(ERROR) << "Error: failed to load model. Please make sure the file exists and format is correct.";
+            return EXIT_FAILURE;
+        }
+
+        auto label = mesh->add_face_property<int>("f:label");
+        for (auto f : mesh->faces())
+            label[f] = f.idx() % 7;
+        mesh->add_model_property<std::string>("source", "sphere.obj")[0] = "sphere.obj";
+
+        const std::string snapshot_file_name = "./sphere-copy.snap";
+        if (!io::save_snapshot(snapshot_file_name, mesh, true)) {
+            std::cerr << "failed to save the snapshot" << std::endl;
+            delete mesh;
+            return EXIT_FAILURE;
+        }
+
+        SurfaceMesh* copy = SurfaceMeshIO::load(snapshot_file_name);
+        // with lazy loading, the custom properties are read only when they are accessed
+        SurfaceMesh lazy_copy;
+        bool identical = io::load_snapshot(snapshot_file_name, &lazy_copy, true) &&
+                         lazy_copy.face_property_container().is_deferred("f:label");
+        if (identical) {
+            auto lazy_label = lazy_copy.get_face_property<int>("f:label");
+            identical = lazy_label && lazy_label.vector() == label.vector();
+        }
+
+        // a lazily loaded model saved back to its own snapshot file keeps the properties not accessed yet
+        {
+            SurfaceMesh lazy;
+            identical = identical && io::load_snapshot(snapshot_file_name, &lazy, true);
+            lazy.add_face_property<float>("f:quality", 0.5f);
+            identical = identical && io::save_snapshot(snapshot_file_name, &lazy, true);
+            SurfaceMesh reloaded;
+            identical = identical && io::load_snapshot(snapshot_file_name, &reloaded);
+            auto reloaded_label = reloaded.get_face_property<int>("f:label");
+            auto reloaded_quality = reloaded.get_face_property<float>("f:quality");
+            identical = identical && reloaded_label && reloaded_label.vector() == label.vector() &&
+                        reloaded_quality && reloaded_quality[SurfaceMesh::Face(0)] == 0.5f &&
+                        reloaded.get_model_property<std::string>("source") &&
+                        reloaded.get_model_property<std::string>("source")[0] == "sphere.obj";
+        }
+
+        // a snapshot written on a machine with another byte order is rejected (the byte order mark follows the
+        // magic, the version, the model type, the numbers of containers and chunks, and the table offset and size)
+        {
+            std::fstream file(snapshot_file_name, std::ios::in | std::ios::out | std::ios::binary);
+            const uint32_t swapped = 0x04030201;
+            file.seekp(40);
+            file.write(reinterpret_cast<const char *>(&swapped), sizeof(swapped));
+        }
+        SurfaceMesh swapped_copy;
+        identical = identical && !io::load_snapshot(snapshot_file_name, &swapped_copy);
+        file_system::delete_file(snapshot_file_name);
+        identical = identical && copy && copy->n_vertices() == mesh->n_vertices() && copy->n_faces() == mesh->n_faces();
+        if (identical) {
+            auto copy_label = copy->get_face_property<int>("f:label");
+            identical = copy_label && copy_label.vector() == label.vector() && copy->points() == mesh->points() &&
+                        copy->get_model_property<std::string>("source")[0] == "sphere.obj";
+        }
+        delete mesh;
+        delete copy;
+        if (!identical) {
+            std::cerr << "the snapshot does not restore the mesh" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "snapshot saved and restored" << std::endl;
+    }
+
+    // This example accesses properties by name on a mesh with many properties, and shows how to cache a property
+    // handle across calls (see benchmarks/bench_core.cpp for the cost of the lookups).
+    {
+        SurfaceMesh mesh;
+        for (int i = 0; i < 1000; ++i)
+            mesh.add_vertex(vec3(static_cast<float>(i), 0.0f, 0.0f));
+        for (int i = 0; i < 60; ++i)
+            mesh.add_vertex_property<float>("v:scalar_" + std::to_string(i), static_cast<float>(i));
+
+        const PropertyContainer& container = mesh.vertex_property_container();
+        const std::string name = "v:scalar_59";
+        CachedProperty<float> cached(name);
+        bool lookup_ok = true;
+        for (int i = 0; i < 1000; ++i) {
+            lookup_ok = lookup_ok && mesh.get_vertex_property<float>(name)[SurfaceMesh::Vertex(i)] == 59.0f &&
+                        cached.get(container)[i] == 59.0f;
+        }
+
+        // the cached handle follows the changes of the properties
+        mesh.rename_vertex_property(name, "v:renamed");
+        const bool renamed_ok = !cached.get(container) && !mesh.get_vertex_property<float>(name) &&
+                                mesh.get_vertex_property<float>("v:renamed")[SurfaceMesh::Vertex(0)] == 59.0f;
+        mesh.rename_vertex_property("v:renamed", name);
+        mesh.remove_vertex_property("v:scalar_0");
+        const bool removed_ok = cached.get(container) && cached.get(container)[0] == 59.0f &&
+                                mesh.get_vertex_property<float>("v:scalar_30")[SurfaceMesh::Vertex(0)] == 30.0f;
+
+        // with fewer properties, the lookups are linear searches, and the index is rebuilt when there are many again
+        bool threshold_ok = true;
+        for (int i = 1; i < 50; ++i)
+            threshold_ok = threshold_ok && mesh.remove_vertex_property("v:scalar_" + std::to_string(i));
+        threshold_ok = threshold_ok && container.arrays().size() < 20 && cached.get(container)[0] == 59.0f &&
+                       mesh.get_vertex_property<float>("v:scalar_50")[SurfaceMesh::Vertex(0)] == 50.0f &&
+                       !mesh.get_vertex_property<float>("v:scalar_30");
+        for (int i = 0; i < 50; ++i)
+            mesh.add_vertex_property<float>("v:scalar_" + std::to_string(i), static_cast<float>(i));
+        for (int i = 0; i < 60; ++i) {
+            threshold_ok = threshold_ok && mesh.get_vertex_property<float>("v:scalar_" + std::to_string(i))[
+                    SurfaceMesh::Vertex(0)] == static_cast<float>(i);
+        }
+        if (!lookup_ok || !renamed_ok || !removed_ok || !threshold_ok) {
+            std::cerr << "property lookup by name failed" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // statistics of a scalar field: quantiles from the sketch vs. sorting
+    {
+        const std::size_t num = 3000000;
+        std::vector<float> values(num);
+        for (auto &v : values)
+            v = random_float() * random_float() * 100.0f;   // a skewed distribution
+        values[num / 2] = 1e6f;                             // an outlier
+
+        std::vector<float> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        const ScalarStatistics stats(values);
+
+        bool ok = stats.count() == num && stats.min() == sorted.front() && stats.max() == sorted.back();
+        for (float q = 0.0f; q <= 1.0f; q += 0.01f) {
+            const float v = stats.quantile(q);
+            // the rank of the value must be within the error bound of the sketch
+            const auto rank = std::lower_bound(sorted.begin(), sorted.end(), v) - sorted.begin();
+            ok = ok && std::abs(static_cast<double>(rank) / (num - 1) - q) < 2.0 / ScalarStatistics::default_resolution;
+        }
+
+        // merging the statistics of the two halves
+        ScalarStatistics first(std::vector<float>(values.begin(), values.begin() + num / 2));
+        first.merge(ScalarStatistics(std::vector<float>(values.begin() + num / 2, values.end())));
+        ok = ok && first.count() == num && std::abs(first.quantile(0.5f) - stats.quantile(0.5f)) < 0.5f;
+
+        // small fields are exact
+        const ScalarStatistics small(std::vector<int>{5, 1, 4, 2, 3});
+        ok = ok && small.quantile(0.0f) == 1 && small.quantile(0.5f) == 3 && small.quantile(1.0f) == 5;
+
+        if (!ok) {
+            std::cerr << "unexpected statistics of a scalar field" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // computed properties: values computed on demand (optionally cached in blocks) instead of stored
+    {
+        SurfaceMesh mesh;
+        for (int i = 0; i < 1000; ++i)
+            mesh.add_vertex(vec3(static_cast<float>(i), 0.0f, static_cast<float>(i % 10)));
+
+        PropertyContainer& props = mesh.vertex_property_container();
+        const std::size_t num_arrays = props.n_properties();
+        auto height = props.add_computed<float>("v:height", [&mesh](std::size_t i) -> float {
+            return mesh.position(SurfaceMesh::Vertex(static_cast<int>(i))).z;
+        });
+        std::atomic<int> num_calls(0);
+        auto cached = props.add_computed<double>("v:cached", [&mesh, &num_calls](std::size_t i) -> double {
+            ++num_calls;
+            return mesh.position(SurfaceMesh::Vertex(static_cast<int>(i))).x;
+        }, 64);
+
+        bool ok = height && cached && props.n_properties() == num_arrays && props.n_computed_properties() == 2;
+        ok = ok && !props.add_computed<float>("v:point", [](std::size_t) { return 0.0f; });    // name is taken
+        ok = ok && !mesh.add_vertex_property<float>("v:height");                              // name is taken
+        ok = ok && !props.get_computed<int>("v:height") && props.get_computed_type("v:height") == typeid(float);
+        ok = ok && height.size() == mesh.n_vertices() && height[SurfaceMesh::Vertex(13)] == 3.0f;
+
+        // each value of a block is computed once, and the blocks are computed concurrently
+        double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+        for (int i = 0; i < 1000; ++i)
+            sum += cached[SurfaceMesh::Vertex(i)] + cached[static_cast<std::size_t>(i)];
+        ok = ok && sum == 999000.0 && num_calls >= 1000 && num_calls < 2000;
+
+        // the cache follows the changes of the elements, and invalidate() discards it after other changes
+        mesh.add_vertex(vec3(1000.0f, 0.0f, 7.0f));
+        ok = ok && height.size() == 1001 && cached[SurfaceMesh::Vertex(1000)] == 1000.0;
+        ok = ok && cached[SurfaceMesh::Vertex(0)] == 0.0;
+        mesh.position(SurfaceMesh::Vertex(0)) = vec3(-1.0f, 0.0f, 0.0f);
+        ok = ok && cached[SurfaceMesh::Vertex(0)] == 0.0;    // the cached value
+        cached.invalidate();
+        ok = ok && cached[SurfaceMesh::Vertex(0)] == -1.0;
+
+        // statistics of a computed property without materializing the values
+        const ScalarStatistics stats(height.size(), [&height](std::size_t i) -> float { return height[i]; });
+        ok = ok && stats.count() == 1001 && stats.min() == 0.0f && stats.max() == 9.0f;
+
+        // copies do not have the computed properties (their functions refer to the source mesh)
+        SurfaceMesh copy = mesh;
+        ok = ok && copy.vertex_property_container().n_computed_properties() == 0;
+
+        ok = ok && mesh.rename_vertex_property("v:height", "v:z") && props.get_computed<float>("v:z");
+        ok = ok && mesh.remove_vertex_property("v:z") && props.n_computed_properties() == 1;
+        if (!ok) {
+            std::cerr << "unexpected behavior of computed properties" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // reordering: the elements are permuted with all their properties, and the connectivity is kept consistent
+    {
+        const std::string file_name = resource::directory() + "/data/bunny.ply";
+        SurfaceMesh* mesh = SurfaceMeshIO::load(file_name);
+        if (!mesh) {
+            LOG(ERROR) << "Error: failed to load model. Please make sure the file exists and format is correct.";
+            return EXIT_FAILURE;
+        }
+
+        // each vertex/face remembers its position/centroid
+        auto vpos = mesh->add_vertex_property<vec3>("v:original");
+        for (auto v : mesh->vertices())
+            vpos[v] = mesh->position(v);
+        auto fcenter = mesh->add_face_property<vec3>("f:original");
+        for (auto f : mesh->faces())
+            fcenter[f] = geom::centroid(mesh, f);
+
+        // a random order, as if the mesh came from a scanner
+        std::vector<SurfaceMesh::Vertex> vorder;
+        std::vector<SurfaceMesh::Face> forder;
+        std::vector<SurfaceMesh::Edge> eorder;
+        for (auto v : mesh->vertices()) vorder.push_back(v);
+        for (auto f : mesh->faces()) forder.push_back(f);
+        for (auto e : mesh->edges()) eorder.push_back(e);
+        std::mt19937 rng(7);
+        std::shuffle(vorder.begin(), vorder.end(), rng);
+        std::shuffle(forder.begin(), forder.end(), rng);
+        std::shuffle(eorder.begin(), eorder.end(), rng);
+        bool ok = mesh->permute_vertices(vorder) && mesh->permute_faces(forder) && mesh->permute_edges(eorder);
+        ok = ok && !mesh->permute_vertices(std::vector<SurfaceMesh::Vertex>(mesh->n_vertices()));   // not a permutation
+        const float shuffled_acmr = Reordering::average_cache_miss_ratio(mesh);
+        const std::vector<vec3> shuffled_points = mesh->points();
+
+        auto consistent = [&]() -> bool {
+            for (auto h : mesh->halfedges()) {
+                if (mesh->prev(mesh->next(h)) != h || mesh->opposite(mesh->opposite(h)) != h)
+                    return false;
+                if (!mesh->is_border(h) && mesh->face(mesh->next(h)) != mesh->face(h))
+                    return false;
+            }
+            for (auto v : mesh->vertices()) {
+                if (mesh->position(v) != vpos[v] || mesh->source(mesh->out_halfedge(v)) != v)
+                    return false;
+            }
+            for (auto f : mesh->faces()) {
+                if (mesh->face(mesh->halfedge(f)) != f || distance(geom::centroid(mesh, f), fcenter[f]) > 1e-6f)
+                    return false;
+            }
+            return true;
+        };
+        ok = ok && consistent();
+
+        ok = ok && Reordering::apply(mesh) && consistent();
+        // consecutive vertices are close in space
+        float spatial = 0.0f, shuffled = 0.0f;
+        for (std::size_t i = 1; i < mesh->n_vertices(); ++i) {
+            spatial += distance(mesh->position(SurfaceMesh::Vertex(i)), mesh->position(SurfaceMesh::Vertex(i - 1)));
+            shuffled += distance(shuffled_points[i], shuffled_points[i - 1]);
+        }
+        ok = ok && spatial < 0.2f * shuffled;
+
+        ok = ok && Reordering::optimize_vertex_cache(mesh) && consistent();
+        const float optimized_acmr = Reordering::average_cache_miss_ratio(mesh);
+        std::cout << "average cache miss ratio: " << shuffled_acmr << " (shuffled), " << optimized_acmr
+                  << " (optimized)" << std::endl;
+        ok = ok && optimized_acmr < 0.8f && optimized_acmr < 0.5f * shuffled_acmr;
+
+        PointCloud cloud;
+        for (const auto& p : shuffled_points)
+            cloud.add_vertex(p);
+        auto ids = cloud.add_vertex_property<int>("v:id");
+        for (auto v : cloud.vertices())
+            ids[v] = v.idx();
+        ok = ok && Reordering::apply(&cloud, Reordering::MORTON);
+        for (auto v : cloud.vertices())
+            ok = ok && cloud.position(v) == shuffled_points[ids[v]];
+
+        delete mesh;
+        if (!ok) {
+            std::cerr << "unexpected behavior of reordering" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // garbage collection: the kept elements (with their properties) end up in the same order as by repeatedly moving
+    // the last kept element into the first hole
+    {
+        const std::string file_name = resource::directory() + "/data/bunny.ply";
+        SurfaceMesh* mesh = SurfaceMeshIO::load(file_name);
+        if (!mesh) {
+            LOG(ERROR) << "Error: failed to load model. Please make sure the file exists and format is correct.";
+            return EXIT_FAILURE;
+        }
+
+        auto fids = mesh->add_face_property<int>("f:id");
+        for (auto f : mesh->faces())
+            fids[f] = f.idx();
+        std::vector<SurfaceMesh::Face> faces;
+        for (auto f : mesh->faces())
+            faces.push_back(f);
+        std::shuffle(faces.begin(), faces.end(), std::mt19937(3));
+        for (std::size_t i = 0; i < faces.size() / 3; ++i)
+            mesh->delete_face(faces[i]);
+
+        // the expected order of the faces (-1 for the deleted ones)
+        std::vector<int> ids(mesh->faces_size());
+        for (std::size_t i = 0; i < ids.size(); ++i)
+            ids[i] = mesh->is_deleted(SurfaceMesh::Face(static_cast<int>(i))) ? -1 : static_cast<int>(i);
+        std::size_t i0 = 0, i1 = ids.size();
+        while (true) {
+            while (i0 < i1 && ids[i0] >= 0) ++i0;
+            while (i0 < i1 && ids[i1 - 1] < 0) --i1;
+            if (i0 >= i1)
+                break;
+            std::swap(ids[i0], ids[i1 - 1]);
+        }
+        ids.resize(mesh->n_faces());
+
+        mesh->collect_garbage();
+        bool ok = !mesh->has_garbage() && mesh->faces_size() == ids.size();
+        for (auto f : mesh->faces()) {
+            ok = ok && fids[f] == ids[f.idx()] && mesh->face(mesh->halfedge(f)) == f;
+            for (auto h : mesh->halfedges(f))
+                ok = ok && mesh->face(h) == f;
+        }
+        for (auto h : mesh->halfedges())
+            ok = ok && mesh->prev(mesh->next(h)) == h && mesh->opposite(mesh->opposite(h)) == h;
+        for (auto v : mesh->vertices())
+            ok = ok && !mesh->is_isolated(v) && mesh->source(mesh->out_halfedge(v)) == v;
+
+        delete mesh;
+        if (!ok) {
+            std::cerr << "unexpected behavior of garbage collection" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // a copy of a mesh is independent of the original
+    {
+        const std::string file_name = resource::directory() + "/data/bunny.ply";
+        SurfaceMesh* mesh = SurfaceMeshIO::load(file_name);
+        if (!mesh) {
+            LOG(ERROR) << "Error: failed to load model. Please make sure the file exists and format is correct.";
+            return EXIT_FAILURE;
+        }
+
+        auto quality = mesh->add_vertex_property<float>("v:quality", 1.0f);
+        const std::vector<vec3> original = mesh->points();
+        SurfaceMesh* copy = new SurfaceMesh(*mesh);
+        bool ok = true;
+
+        // modifying the copy (in parallel) leaves the original unchanged
+        auto copy_points = copy->get_vertex_property<vec3>("v:point");
+        auto copy_quality = copy->get_vertex_property<float>("v:quality");
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(copy->n_vertices()); ++i) {
+            copy_points[SurfaceMesh::Vertex(i)] += vec3(1.0f, 0.0f, 0.0f);
+            copy_quality[SurfaceMesh::Vertex(i)] = 2.0f;
+        }
+        ok = ok && mesh->points() == original;
+        for (auto v : copy->vertices()) {
+            ok = ok && copy_points[v] == original[v.idx()] + vec3(1.0f, 0.0f, 0.0f);
+            ok = ok && quality[v] == 1.0f && copy_quality[v] == 2.0f;
+        }
+
+        // the connectivity of the original can change without affecting the copy
+        const unsigned int num_faces = copy->n_faces();
+        mesh->delete_face(SurfaceMesh::Face(0));
+        mesh->collect_garbage();
+        ok = ok && copy->n_faces() == num_faces && mesh->n_faces() == num_faces - 1;
+        for (auto f : copy->faces()) {
+            for (auto h : copy->halfedges(f))
+                ok = ok && copy->face(h) == f;
+        }
+
+        delete copy;
+        delete mesh;
+        if (!ok) {
+            std::cerr << "a copy of a mesh is not independent of the original" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     return EXIT_SUCCESS;
 }
 
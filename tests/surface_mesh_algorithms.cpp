@@ -24,11 +24,15 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  ********************************************************************/
 
+#include <algorithm>
+
 #include <easy3d/core/point_cloud.h>
 #include <easy3d/core/surface_mesh.h>
 #include <easy3d/core/poly_mesh.h>
+#include <easy3d/core/selection_set.h>
 #include <easy3d/algo/surface_mesh_components.h>
 #include <easy3d/algo/surface_mesh_curvature.h>
+#include <easy3d/algo/surface_mesh_distance.h>
 #include <easy3d/algo/surface_mesh_enumerator.h>
 #include <easy3d/algo/surface_mesh_fairing.h>
 #include <easy3d/algo/surface_mesh_geodesic.h>
@@ -45,6 +49,9 @@
 #include <easy3d/algo/surface_mesh_topology.h>
 #include <easy3d/algo/surface_mesh_triangulation.h>
 #include <easy3d/algo/surface_mesh_features.h>
+#include <easy3d/algo/surface_mesh_factory.h>
+#include <easy3d/algo/surface_mesh_geometry.h>
+#include <easy3d/algo/triangle_mesh_kdtree.h>
 #include <easy3d/fileio/surface_mesh_io.h>
 #include <easy3d/fileio/resources.h>
 
@@ -141,8 +148,17 @@ bool test_algo_surface_mesh_curvature() {
     SurfaceMeshCurvature analyzer(mesh);
 
     std::cout << "computing surface mesh principle curvatures..." << std::endl;
+    analyzer.analyze(2);
     analyzer.analyze_tensor(2, true);
 
+    std::cout << "computing surface mesh vertex curvatures..." << std::endl;
+    std::vector<geom::VertexCurvature> curvatures;
+    geom::vertex_curvatures(mesh, curvatures);
+    if (curvatures.size() != mesh->vertices_size()) {
+        delete mesh;
+        return false;
+    }
+
     std::cout << "computing surface mesh mean curvatures..." << std::endl;
     analyzer.compute_mean_curvature();
 
@@ -153,7 +169,216 @@ bool test_algo_surface_mesh_curvature() {
     analyzer.compute_max_abs_curvature();
 
     delete mesh;
-    return true;
+
+    // on a sphere of radius r, both principal curvatures are 1/r
+    std::cout << "checking the curvatures of a sphere..." << std::endl;
+    const float r = 2.0f;
+    SurfaceMesh sphere = SurfaceMeshFactory::icosphere(4);
+    for (auto v : sphere.vertices())
+        sphere.position(v) = normalize(sphere.position(v)) * r;
+
+    // all curvatures are close to the exact ones (the error is the discretization error)
+    auto near_exact = [r](float mean, float gauss, float tolerance) -> bool {
+        return std::abs(mean * r - 1.0f) < tolerance && std::abs(gauss * r * r - 1.0f) < 2.0f * tolerance;
+    };
+
+    bool ok = true;
+    SurfaceMeshCurvature sphere_analyzer(&sphere);
+    sphere_analyzer.analyze(0);
+    for (auto v : sphere.vertices()) {
+        if (!near_exact(sphere_analyzer.mean_curvature(v), sphere_analyzer.gauss_curvature(v), 0.01f)) {
+            std::cerr << "analyze(): wrong curvature at " << v << ": " << sphere_analyzer.mean_curvature(v)
+                      << " (expected " << 1.0f / r << ")" << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    sphere_analyzer.analyze_tensor(0, false);
+    for (auto v : sphere.vertices()) {
+        if (!near_exact(sphere_analyzer.mean_curvature(v), sphere_analyzer.gauss_curvature(v), 0.05f)) {
+            std::cerr << "analyze_tensor(): wrong curvature at " << v << ": " << sphere_analyzer.mean_curvature(v)
+                      << " (expected " << 1.0f / r << ")" << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    geom::vertex_curvatures(&sphere, curvatures);
+    for (auto v : sphere.vertices()) {
+        const geom::VertexCurvature &c = curvatures[v.idx()];
+        const geom::VertexCurvature ref = geom::vertex_curvature(&sphere, v);
+        if (!near_exact(c.mean, c.gauss, 0.01f) || std::abs(c.mean - ref.mean) > 1e-4f ||
+            std::abs(c.gauss - ref.gauss) > 1e-4f) {
+            std::cerr << "vertex_curvatures(): wrong curvature at " << v << ": " << c.mean
+                      << " (expected " << 1.0f / r << ")" << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    // deleted vertices (not garbage collected) are skipped, and the others are not affected
+    sphere.delete_vertex(SurfaceMesh::Vertex(0));
+    sphere_analyzer.analyze(0);
+    sphere_analyzer.compute_mean_curvature();
+    auto mean = sphere.get_vertex_property<float>("v:curv-mean");
+    if (!mean || mean[SurfaceMesh::Vertex(0)] != 0.0f) {
+        std::cerr << "curvature computed for a deleted vertex" << std::endl;
+        ok = false;
+    }
+    for (auto v : sphere.vertices()) {
+        if (!sphere.is_border(v) && !near_exact(mean[v], sphere_analyzer.gauss_curvature(v), 0.01f)) {
+            std::cerr << "wrong curvature at " << v << " after deleting a vertex" << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    return ok;
+}
+
+
+bool test_algo_surface_mesh_distance() {
+    const std::string file = resource::directory() + "/data/bunny.ply";
+    SurfaceMesh *mesh = SurfaceMeshIO::load(file);
+    if (!mesh) {
+        std::cerr << "Error: failed to load model. Please make sure the file exists and format is correct."
+                  << std::endl;
+        return false;
+    }
+
+    std::cout << "sampling surface mesh..." << std::endl;
+    SurfaceMeshSampler sampler;
+    PointCloud *cloud = sampler.apply(mesh, 100000);
+    if (!cloud) {
+        delete mesh;
+        return false;
+    }
+
+    const float radius = mesh->bounding_box().radius();
+    bool ok = true;
+    {
+        std::cout << "computing signed distances from point cloud (sampled on the mesh) to surface mesh..." << std::endl;
+        SurfaceMeshDistance dist(mesh);
+        const auto stats = dist.compute(cloud, true);
+        auto distances = cloud->get_vertex_property<float>("v:distance");
+        ok = ok && stats.count == cloud->n_vertices() && stats.max < radius * 1e-5f && distances;
+        for (auto v : cloud->vertices())
+            ok = ok && std::abs(distances[v]) <= stats.max;
+
+        // the distances cannot be stored in a property of another type
+        cloud->add_vertex_property<int>("v:label");
+        ok = ok && dist.compute(cloud, false, "v:label").count == 0;
+    }
+
+    {
+        std::cout << "computing Hausdorff distance between two surface meshes..." << std::endl;
+        SurfaceMesh copy = *mesh;
+        ok = ok && SurfaceMeshDistance::hausdorff(mesh, &copy, 10000).max < radius * 1e-5f;
+        SurfaceMeshSmoothing smoother(&copy);
+        smoother.explicit_smoothing(10, false);
+        const auto stats = SurfaceMeshDistance::hausdorff(mesh, &copy, 100000);
+        ok = ok && stats.count > 0 && stats.max > radius * 1e-3f && stats.min <= stats.mean &&
+             stats.mean <= stats.rms && stats.rms <= stats.max;
+    }
+
+    {
+        std::cout << "computing signed distances to a sphere (the reference is a quad mesh)..." << std::endl;
+        SurfaceMesh sphere = SurfaceMeshFactory::quad_sphere(5);
+        for (auto v : sphere.vertices())
+            sphere.position(v).normalize();
+        SurfaceMeshDistance dist(&sphere);
+
+        // points outside (at distance 0.5) and inside (at distance -0.5) the unit sphere
+        std::vector<vec3> points;
+        for (int i = 0; i < 1000; ++i) {
+            const vec3 dir = normalize(vec3(static_cast<float>(rand()) / RAND_MAX - 0.5f,
+                                            static_cast<float>(rand()) / RAND_MAX - 0.5f,
+                                            static_cast<float>(rand()) / RAND_MAX - 0.5f));
+            points.push_back(dir * (i % 2 ? 1.5f : 0.5f));
+        }
+        std::vector<float> distances;
+        dist.distances(points, distances, true);
+        for (std::size_t i = 0; i < points.size(); ++i)
+            ok = ok && std::abs(distances[i] - (i % 2 ? 0.5f : -0.5f)) < 0.01f;
+    }
+
+    {
+        std::cout << "computing signed distances to a surface mesh with deleted faces..." << std::endl;
+        SurfaceMesh garbage = *mesh;
+        const vec3 center = garbage.bounding_box().center();
+        for (auto f : garbage.faces()) {
+            if (garbage.position(garbage.target(garbage.halfedge(f))).x > center.x)
+                garbage.delete_face(f);
+        }
+        SurfaceMesh collected = garbage;
+        collected.collect_garbage();
+        ok = ok && garbage.has_garbage() && garbage.n_faces() < garbage.faces_size();
+
+        // the distances to the mesh with garbage are the same as to the mesh after garbage collection
+        const std::vector<vec3> points(cloud->points().begin(), cloud->points().begin() + 1000);
+        std::vector<float> distances, expected;
+        SurfaceMeshDistance(&garbage).distances(points, distances, true);
+        SurfaceMeshDistance(&collected).distances(points, expected, true);
+        for (std::size_t i = 0; i < points.size(); ++i)
+            ok = ok && std::abs(distances[i] - expected[i]) < radius * 1e-5f;
+    }
+
+    delete cloud;
+    delete mesh;
+    return ok;
+}
+
+
+bool test_algo_triangle_mesh_kdtree() {
+    const std::string file = resource::directory() + "/data/bunny.ply";
+    SurfaceMesh *mesh = SurfaceMeshIO::load(file);
+    if (!mesh) {
+        std::cerr << "Error: failed to load model. Please make sure the file exists and format is correct."
+                  << std::endl;
+        return false;
+    }
+
+    std::cout << "querying the nearest triangles (SIMD) vs. brute force (scalar)..." << std::endl;
+    TriangleMeshKdTree tree(mesh);
+
+    // query points around the mesh (in a box twice as large as the bounding box)
+    const Box3 &box = mesh->bounding_box();
+    std::vector<vec3> points;
+    for (int i = 0; i < 200; ++i) {
+        vec3 p;
+        for (int j = 0; j < 3; ++j)
+            p[j] = box.min_coord(j) + (static_cast<float>(rand()) / RAND_MAX * 2.0f - 0.5f) * box.range(j);
+        points.push_back(p);
+    }
+    // and the vertices (the distances are zero)
+    for (int i = 0; i < 50; ++i)
+        points.push_back(mesh->position(SurfaceMesh::Vertex(i * 97 % mesh->n_vertices())));
+
+    std::vector<float> distances;
+    std::vector<SurfaceMesh::Face> faces;
+    std::vector<vec3> nearest_points;
+    tree.nearest(points, distances, faces, nearest_points);
+
+    const float tolerance = box.radius() * 1e-5f;
+    bool ok = true;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        float brute_force = std::numeric_limits<float>::max();
+        for (auto f : mesh->faces()) {
+            auto h = mesh->halfedge(f);
+            const vec3 &a = mesh->position(mesh->target(h));
+            const vec3 &b = mesh->position(mesh->target(mesh->next(h)));
+            const vec3 &c = mesh->position(mesh->target(mesh->prev(h)));
+            vec3 q;
+            brute_force = std::min(brute_force, geom::dist_point_triangle(points[i], a, b, c, q));
+        }
+        const auto nn = tree.nearest(points[i]);
+        ok = ok && std::abs(distances[i] - brute_force) <= tolerance && nn.dist == distances[i] &&
+             nn.face == faces[i] && distance(nearest_points[i], points[i]) - distances[i] <= tolerance;
+    }
+
+    delete mesh;
+    return ok;
 }
 
 
@@ -206,6 +431,39 @@ bool test_algo_surface_mesh_fairing() {
         fair.fair(3);
     }
 
+    std::cout << "fairing of selected vertices..." << std::endl;
+    {
+        // select the vertices on one side. Fairing must not move the others.
+        const float center = mesh->bounding_box(true).center().x;
+        SelectionSet selected(mesh->vertices_size());
+        for (auto v : mesh->vertices()) {
+            if (mesh->position(v).x < center)
+                selected.set(v.idx());
+        }
+        SurfaceMesh copy(*mesh);
+        SurfaceMeshFairing fair(mesh);
+        fair.set_selection(selected);
+        fair.fair(3);
+
+        // the same selection given by the bool property "v:selected"
+        auto vselected = copy.add_vertex_property<bool>("v:selected");
+        selected.get(vselected.vector());
+        SurfaceMeshFairing(&copy).fair(3);
+
+        for (auto v : mesh->vertices()) {
+            if (!selected.test(v.idx()) && mesh->position(v) != copy.position(v)) {
+                std::cerr << "fairing moved unselected vertex " << v << std::endl;
+                delete mesh;
+                return false;
+            }
+            if (distance(mesh->position(v), copy.position(v)) > 1e-5f) {
+                std::cerr << "fairing with \"v:selected\" gives a different result at vertex " << v << std::endl;
+                delete mesh;
+                return false;
+            }
+        }
+    }
+
     delete mesh;
     return true;
 }
@@ -226,9 +484,101 @@ bool test_algo_surface_mesh_geodesic() {
     // compute geodesic distance
     SurfaceMeshGeodesic geodist(mesh);
     geodist.compute(seeds);
+    std::vector<float> exact;
+    float max_dist = 0.0f;
+    for (auto v : mesh->vertices()) {
+        exact.push_back(geodist(v));
+        max_dist = std::max(max_dist, geodist(v));
+    }
+
+    std::cout << "computing geodesic distance using the heat method..." << std::endl;
+    const std::vector<SurfaceMesh::Vertex> other(1, SurfaceMesh::Vertex(mesh->n_vertices() / 2));
+    if (!geodist.compute_heat(other)) {
+        delete mesh;
+        return false;
+    }
+
+    // another query reuses the factorizations: it must give the same distances as compute() (up to the error of the
+    // heat method) and as a fresh factorization
+    bool ok = geodist.compute_heat(seeds);
+    SurfaceMesh copy(*mesh);
+    SurfaceMeshGeodesic fresh(&copy);
+    ok = ok && fresh.compute_heat(seeds);
+    if (ok) {
+        double error = 0.0;
+        for (auto v : mesh->vertices()) {
+            error += std::abs(geodist(v) - exact[v.idx()]);
+            if (std::abs(geodist(v) - fresh(v)) > max_dist * 1e-5f) {
+                std::cerr << "the cached factorization gives a different distance at " << v << ": " << geodist(v)
+                          << " vs. " << fresh(v) << std::endl;
+                ok = false;
+                break;
+            }
+        }
+        error /= mesh->n_vertices();
+        if (error > max_dist * 0.05) {
+            std::cerr << "the heat method deviates from compute(): mean error " << error << " (max distance "
+                      << max_dist << ")" << std::endl;
+            ok = false;
+        }
+    }
+
+    // a mesh with deleted vertices (i.e., garbage) gives the same distances as after garbage collection
+    {
+        SurfaceMesh garbage(*mesh);
+        auto id = garbage.add_vertex_property<int>("v:id");
+        for (auto v : garbage.vertices())
+            id[v] = v.idx();
+        const Box3 box = garbage.bounding_box();
+        const float threshold = box.max_point().x - 0.1f * box.range(0);
+        for (auto v : garbage.vertices()) {
+            if (v != seeds[0] && garbage.position(v).x > threshold)
+                garbage.delete_vertex(v);
+        }
+        SurfaceMesh collected(garbage);
+        collected.collect_garbage();
+        std::vector<SurfaceMesh::Vertex> collected_seeds;
+        for (auto v : collected.vertices()) {
+            if (collected.get_vertex_property<int>("v:id")[v] == seeds[0].idx())
+                collected_seeds.push_back(v);
+        }
+
+        SurfaceMeshGeodesic with_garbage(&garbage), without_garbage(&collected);
+        if (!garbage.has_garbage() || !with_garbage.compute_heat(seeds) ||
+            !without_garbage.compute_heat(collected_seeds)) {
+            std::cerr << "the heat method failed on a mesh with deleted vertices" << std::endl;
+            ok = false;
+        } else {
+            std::vector<float> expected(garbage.vertices_size(), 0.0f);
+            auto collected_id = collected.get_vertex_property<int>("v:id");
+            for (auto v : collected.vertices())
+                expected[collected_id[v]] = without_garbage(v);
+            for (auto v : garbage.vertices()) {
+                if (std::abs(with_garbage(v) - expected[v.idx()]) > max_dist * 1e-4f) {
+                    std::cerr << "the heat method gives a different distance on a mesh with garbage at " << v
+                              << ": " << with_garbage(v) << " vs. " << expected[v.idx()] << std::endl;
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // invalid input is rejected
+    if (geodist.compute_heat(seeds, 0.0f) || geodist.compute_heat(seeds, -1.0f)) {
+        std::cerr << "a non-positive time factor was accepted" << std::endl;
+        ok = false;
+    }
+    SurfaceMesh points;
+    const std::vector<SurfaceMesh::Vertex> point_seeds(1, points.add_vertex(vec3(0, 0, 0)));
+    points.add_vertex(vec3(1, 0, 0));
+    if (SurfaceMeshGeodesic(&points).compute_heat(point_seeds)) {
+        std::cerr << "the heat method was applied to a mesh without edges" << std::endl;
+        ok = false;
+    }
 
     delete mesh;
-    return true;
+    return ok;
 }
 
 
@@ -389,7 +739,17 @@ bool test_algo_surface_mesh_sampler() {
     std::cout << "sampling surface mesh..." << std::endl;
     SurfaceMeshSampler sampler;
     PointCloud *cloud = sampler.apply(mesh, 100000);
+
+    CancellationToken token;
+    token.cancel();
+    PointCloud *cancelled = sampler.apply(mesh, 100000, token);
     delete mesh;
+    if (cancelled) {
+        std::cerr << "sampling was not cancelled" << std::endl;
+        delete cancelled;
+        delete cloud;
+        return false;
+    }
 
     if (cloud) {
         delete cloud;
@@ -417,6 +777,64 @@ bool test_algo_surface_mesh_simplification() {
     ss.initialize(aspect_ratio, 0.0, 0.0, normal_deviation, 0.0);
     ss.simplify(expected_vertex_number);
 
+    std::cout << "simplification of selected vertices..." << std::endl;
+    {
+        delete mesh;
+        mesh = SurfaceMeshIO::load(file);
+        // only the vertices on one side can be removed. Simplification doesn't move the remaining vertices (but
+        // collects garbage), so the points of the unselected vertices must remain.
+        const float center = mesh->bounding_box(true).center().x;
+        SelectionSet selected(mesh->vertices_size());
+        std::vector<vec3> unselected;
+        for (auto v : mesh->vertices()) {
+            if (mesh->position(v).x < center)
+                selected.set(v.idx());
+            else
+                unselected.push_back(mesh->position(v));
+        }
+        const unsigned int num_before = mesh->n_vertices();
+
+        SurfaceMeshSimplification simplifier(mesh);
+        simplifier.set_selection(selected);
+        simplifier.initialize(aspect_ratio, 0.0, 0.0, normal_deviation, 0.0);
+        simplifier.simplify(num_before / 2);
+
+        auto less = [](const vec3 &a, const vec3 &b) {
+            return std::lexicographical_compare(a.data(), a.data() + 3, b.data(), b.data() + 3);
+        };
+        std::vector<vec3> remaining = mesh->points();
+        std::sort(remaining.begin(), remaining.end(), less);
+        for (const auto &p : unselected) {
+            if (!std::binary_search(remaining.begin(), remaining.end(), p, less)) {
+                std::cerr << "simplification removed unselected vertex at " << p << std::endl;
+                delete mesh;
+                return false;
+            }
+        }
+        if (mesh->n_vertices() >= num_before) {
+            std::cerr << "simplification of the selected vertices removed no vertices" << std::endl;
+            delete mesh;
+            return false;
+        }
+    }
+
+    std::cout << "cancelling simplification..." << std::endl;
+    {
+        delete mesh;
+        mesh = SurfaceMeshIO::load(file);
+        const unsigned int num_before = mesh->n_vertices();
+        CancellationToken token;
+        token.cancel();
+        SurfaceMeshSimplification simplifier(mesh);
+        simplifier.initialize(aspect_ratio, 0.0, 0.0, normal_deviation, 0.0);
+        simplifier.simplify(num_before / 2, token);
+        if (mesh->n_vertices() != num_before || mesh->get_vertex_property<float>("v:prio")) {
+            std::cerr << "simplification was not cancelled (or not cleaned up)" << std::endl;
+            delete mesh;
+            return false;
+        }
+    }
+
     delete mesh;
     return true;
 }
@@ -454,8 +872,69 @@ bool test_algo_surface_mesh_smoothing() {
         smoother.implicit_smoothing(timestep, true, rescale);
     }
 
+    std::cout << "implicit smoothing with cached factorizations..." << std::endl;
+    bool ok = true;
+    {
+        // with the uniform Laplacian, the matrix only depends on the connectivity, so the second step reuses the
+        // factorization of the first one
+        SurfaceMesh cached_mesh = *mesh, uncached_mesh = *mesh;
+        SurfaceMeshSmoothing cached(&cached_mesh);
+        cached.implicit_smoothing(0.001f, true, false);
+        cached.implicit_smoothing(0.001f, true, false);
+        const SparseSolver::Timing &timing = cached.solver().timing();
+        ok = ok && timing.num_analysis == 1 && timing.num_factorization == 1 && timing.num_solving == 2;
+
+        for (int i = 0; i < 2; ++i) {
+            SurfaceMeshSmoothing uncached(&uncached_mesh);  // a new solver for each step
+            uncached.implicit_smoothing(0.001f, true, false);
+            ok = ok && uncached.solver().timing().num_factorization == 1;
+        }
+        const float radius = mesh->bounding_box().radius();
+        for (auto v : mesh->vertices())
+            ok = ok && distance(cached_mesh.position(v), uncached_mesh.position(v)) < radius * 1e-6f;
+    }
+
+    std::cout << "solving with cached factorizations..." << std::endl;
+    {
+        // a 1D Laplacian plus identity, whose values change but the sparsity pattern does not
+        const int n = 100;
+        auto matrix = [n](double diagonal) {
+            std::vector<SparseSolver::Triplet> triplets;
+            for (int i = 0; i < n; ++i) {
+                triplets.emplace_back(i, i, diagonal);
+                if (i > 0) triplets.emplace_back(i, i - 1, -1.0);
+                if (i + 1 < n) triplets.emplace_back(i, i + 1, -1.0);
+            }
+            return triplets;
+        };
+        std::vector<double> b1(n), b2(n);
+        for (int i = 0; i < n; ++i) {
+            b1[i] = std::sin(i * 0.1);
+            b2[i] = i % 7;
+        }
+
+        SparseSolver cached;
+        std::vector<double> x1, x2, x3;
+        ok = ok && cached.factorize(n, matrix(3.0)) && cached.solve(b1, x1) &&
+             cached.factorize(n, matrix(3.0)) && cached.solve(b2, x2);
+        ok = ok && cached.timing().num_analysis == 1 && cached.timing().num_factorization == 1;
+        ok = ok && cached.factorize(n, matrix(4.0)) && cached.solve(b1, x3);
+        ok = ok && cached.timing().num_analysis == 1 && cached.timing().num_factorization == 2;
+
+        const std::vector<double> *results[3] = {&x1, &x2, &x3};
+        const std::vector<double> *rhs[3] = {&b1, &b2, &b1};
+        const double diagonals[3] = {3.0, 3.0, 4.0};
+        for (int k = 0; k < 3; ++k) {
+            SparseSolver uncached;
+            std::vector<double> x;
+            ok = ok && uncached.factorize(n, matrix(diagonals[k])) && uncached.solve(*rhs[k], x);
+            for (int i = 0; i < n && ok; ++i)
+                ok = std::abs(x[i] - (*results[k])[i]) < 1e-10;
+        }
+    }
+
     delete mesh;
-    return true;
+    return ok;
 }
 
 
@@ -689,6 +1168,12 @@ int test_surface_mesh_algorithms() {
     if (!test_algo_surface_mesh_curvature())
         return EXIT_FAILURE;
 
+    if (!test_algo_triangle_mesh_kdtree())
+        return EXIT_FAILURE;
+
+    if (!test_algo_surface_mesh_distance())
+        return EXIT_FAILURE;
+
     if (!test_algo_surface_mesh_enumerator())
         return EXIT_FAILURE;
 
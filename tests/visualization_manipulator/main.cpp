@@ -0,0 +1,178 @@
+/********************************************************************
+ * Copyright (C) 2015 Liangliang Nan <liangliang.nan@gmail.com>
+ * https://3d.bk.tudelft.nl/liangliang/
+ *
+ * This file is part of Easy3D. If it is useful in your research/work,
+ * I would be grateful if you show your appreciation by citing it:
+ * ------------------------------------------------------------------
+ *      Liangliang Nan.
+ *      Easy3D: a lightweight, easy-to-use, and efficient C++ library
+ *      for processing and rendering 3D data.
+ *      Journal of Open Source Software, 6(64), 3255, 2021.
+ * ------------------------------------------------------------------
+ *
+ * Easy3D is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License Version 3
+ * as published by the Free Software Foundation.
+ *
+ * Easy3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ********************************************************************/
+
+#include <easy3d/viewer/offscreen.h>
+#include <easy3d/core/point_cloud.h>
+#include <easy3d/core/surface_mesh.h>
+#include <easy3d/renderer/renderer.h>
+#include <easy3d/renderer/drawable_points.h>
+#include <easy3d/renderer/drawable_triangles.h>
+#include <easy3d/renderer/manipulator.h>
+#include <easy3d/renderer/manipulated_frame.h>
+#include <easy3d/renderer/transform.h>
+#include <easy3d/renderer/opengl.h>
+#include <easy3d/util/logging.h>
+
+
+using namespace easy3d;
+
+
+namespace details {
+
+    // reads back the content of a vertex (or normal) buffer
+    std::vector<vec3> read_buffer(unsigned int buffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        GLint size = 0;
+        glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+        std::vector<vec3> data(static_cast<std::size_t>(size) / sizeof(vec3));
+        if (!data.empty())
+            glGetBufferSubData(GL_ARRAY_BUFFER, 0, data.size() * sizeof(vec3), data.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return data;
+    }
+
+    bool equal(const std::vector<vec3> &a, const std::vector<vec3> &b) {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (distance(a[i], b[i]) > 1e-4f)
+                return false;
+        }
+        return true;
+    }
+
+    // the drawable's buffers must be drawn (i.e., updated) before they are read back
+    bool check_drawable(const Drawable *d, const std::vector<vec3> &points, const std::vector<vec3> &normals) {
+        if (!equal(read_buffer(d->vertex_buffer()), points)) {
+            LOG(ERROR) << "vertex buffer of drawable '" << d->name() << "' is not consistent with the model";
+            return false;
+        }
+        if (d->normal_buffer() && !equal(read_buffer(d->normal_buffer()), normals)) {
+            LOG(ERROR) << "normal buffer of drawable '" << d->name() << "' is not consistent with the model";
+            return false;
+        }
+        return true;
+    }
+
+    // the positions of the triangle corners, i.e., the bounding box of a buffer of a faces drawable
+    Box3 bounding_box(const std::vector<vec3> &points) {
+        Box3 box;
+        for (const auto &p : points)
+            box.grow(p);
+        return box;
+    }
+
+}
+
+
+// Tests that the models and their rendering buffers are consistent after the transformation introduced by a
+// manipulator is applied (i.e., Manipulator::apply()).
+int test_manipulator() {
+    OffScreen os(64, 64, 0);
+    if (!os.is_valid()) {
+        LOG(ERROR) << "failed creating the OpenGL context for offscreen rendering";
+        return EXIT_FAILURE;
+    }
+
+    auto cloud = new PointCloud;
+    auto cloud_normals = cloud->add_vertex_property<vec3>("v:normal");
+    for (int i = 0; i < 20; ++i) {
+        for (int j = 0; j < 20; ++j) {
+            auto v = cloud->add_vertex(vec3(i * 0.1f, j * 0.1f, 0.05f * (i + j)));
+            cloud_normals[v] = normalize(vec3(0.1f * i, 0.2f, 1.0f));
+        }
+    }
+    os.add_model(cloud);
+
+    auto mesh = new SurfaceMesh;
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10; ++j)
+            mesh->add_vertex(vec3(i * 0.1f, j * 0.1f, 0.02f * i * j));
+    }
+    for (int i = 0; i < 9; ++i) {
+        for (int j = 0; j < 9; ++j)
+            mesh->add_quad(SurfaceMesh::Vertex(i * 10 + j), SurfaceMesh::Vertex((i + 1) * 10 + j),
+                           SurfaceMesh::Vertex((i + 1) * 10 + j + 1), SurfaceMesh::Vertex(i * 10 + j + 1));
+    }
+    os.add_model(mesh);
+    mesh->renderer()->get_points_drawable("vertices")->set_visible(true);
+
+    // the buffers are created when the models are rendered for the first time
+    std::vector<unsigned char> pixels;
+    if (!os.render(pixels))
+        return EXIT_FAILURE;
+
+    std::cout << "applying the manipulated transformations to the models..." << std::endl;
+
+    for (auto model : os.models()) {
+        auto frame = model->manipulator()->frame();
+        frame->rotate(quat(normalize(vec3(1, 2, 3)), static_cast<float>(M_PI / 3)));
+        frame->translate(vec3(1, -2, 0.5f));
+
+        const mat4 m = model->manipulator()->matrix();
+        std::vector<vec3> expected = model->points();
+        for (auto &p : expected)
+            p = m * p;
+
+        std::vector<vec3> expected_normals;
+        if (model == cloud) {
+            const mat3 N = transform::normal_matrix(m);
+            for (const auto &n : cloud_normals.vector())
+                expected_normals.push_back(normalize(N * n));
+        }
+
+        model->manipulator()->apply();
+        if (!details::equal(model->points(), expected)) {
+            LOG(ERROR) << "the points of model '" << model->name() << "' are not correctly transformed";
+            return EXIT_FAILURE;
+        }
+        if (model == cloud && !details::equal(cloud_normals.vector(), expected_normals)) {
+            LOG(ERROR) << "the normals of model '" << model->name() << "' are not correctly transformed";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!os.render(pixels))
+        return EXIT_FAILURE;
+
+    // the vertex and normal buffers of these drawables mirror the models' points (and normals)
+    if (!details::check_drawable(cloud->renderer()->get_points_drawable("vertices"), cloud->points(), cloud_normals.vector()))
+        return EXIT_FAILURE;
+    auto mesh_normals = mesh->get_vertex_property<vec3>("v:normal");
+    if (!details::check_drawable(mesh->renderer()->get_points_drawable("vertices"), mesh->points(),
+                                 mesh_normals ? mesh_normals.vector() : std::vector<vec3>()))
+        return EXIT_FAILURE;
+
+    // the faces drawable may have per-corner vertices (e.g., flat shading), so only its extent is checked
+    const Box3 box = details::bounding_box(details::read_buffer(mesh->renderer()->get_triangles_drawable("faces")->vertex_buffer()));
+    if (distance(box.min_point(), mesh->bounding_box(true).min_point()) > 1e-4f ||
+        distance(box.max_point(), mesh->bounding_box(true).max_point()) > 1e-4f) {
+        LOG(ERROR) << "vertex buffer of drawable 'faces' is not consistent with the model";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
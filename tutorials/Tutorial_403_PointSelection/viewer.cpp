@@ -26,6 +26,7 @@
 
 #include "viewer.h"
 #include <easy3d/core/point_cloud.h>
+#include <easy3d/core/selection_set.h>
 #include <easy3d/gui/picker_point_cloud.h>
 #include <easy3d/renderer/shapes.h>
 #include <easy3d/renderer/drawable_points.h>
@@ -126,9 +127,6 @@ void PointSelection::post_draw() {
 void PointSelection::mark_selection(PointCloud *cloud) {
     auto drawable = cloud->renderer()->get_points_drawable("vertices");
     auto select = cloud->vertex_property<bool>("v:select");
-    auto colors = cloud->vertex_property<vec3>("v:color");
-    for(auto v : cloud->vertices())
-        colors[v] = select[v] ? vec3(1,0,0) : drawable->color();    // mark selected points red
-    drawable->set_coloring(easy3d::State::COLOR_PROPERTY, easy3d::State::VERTEX, "v:color");
-    drawable->update();
+    // upload the selection (one bit per point) to the GPU. The selected points will be highlighted.
+    drawable->update_selection_buffer(SelectionSet(select.vector()));
 }
\ No newline at end of file